@@ -7,6 +7,7 @@
 #include <boost/asio/steady_timer.hpp>
 
 #include <atomic>
+#include <cstdint>
 #include <ctime>
 #include <functional>
 #include <memory>
@@ -55,18 +56,20 @@ namespace communicator
         GetCommandsFromManager(std::function<void(const int, const std::string&)> onSuccess);
 
         /// @brief Processes messages in a stateful manner
-        /// @param getMessages A function to retrieve a message from the queue
-        /// @param onSuccess A callback function to execute when a message is processed
+        /// @param getMessages A function to retrieve a batch of messages from the queue, given its size and id
+        /// @param onSuccess A callback function to execute when the batch with the given id is processed
         boost::asio::awaitable<void> StatefulMessageProcessingTask(
-            std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t)> getMessages,
-            std::function<void(const int, const std::string&)> onSuccess);
+            std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t, const uint64_t)>
+                getMessages,
+            std::function<void(const uint64_t, const int, const std::string&)> onSuccess);
 
         /// @brief Processes messages in a stateless manner
-        /// @param getMessages A function to retrieve a message from the queue
-        /// @param onSuccess A callback function to execute when a message is processed
+        /// @param getMessages A function to retrieve a batch of messages from the queue, given its size and id
+        /// @param onSuccess A callback function to execute when the batch with the given id is processed
         boost::asio::awaitable<void> StatelessMessageProcessingTask(
-            std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t)> getMessages,
-            std::function<void(const int, const std::string&)> onSuccess);
+            std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t, const uint64_t)>
+                getMessages,
+            std::function<void(const uint64_t, const int, const std::string&)> onSuccess);
 
         /// @brief Retrieves group configuration from the manager
         /// @param groupName The name of the group to retrieve the configuration for
@@ -87,12 +90,32 @@ namespace communicator
 
         /// @brief Executes a request loop
         /// @param reqParams The parameters for the request
-        /// @param messageGetter Function to retrieve messages
         /// @param onSuccess Action to take on successful request
-        boost::asio::awaitable<void> ExecuteRequestLoop(
+        boost::asio::awaitable<void> ExecuteRequestLoop(http_client::HttpRequestParams reqParams,
+                                                        std::function<void(const int, const std::string&)> onSuccess);
+
+        /// @brief Executes a request loop that keeps up to the configured number of batches in flight
+        /// @details Batches are retrieved as soon as there is room for them, without waiting between requests.
+        /// Must run on a strand, which the batch requests share.
+        /// @param reqParams The parameters for the requests
+        /// @param messageGetter Function to retrieve a batch of messages, given its size and id
+        /// @param onSuccess Action to take when the batch with the given id is sent successfully
+        boost::asio::awaitable<void> ExecuteBatchRequestLoop(
             http_client::HttpRequestParams reqParams,
-            std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t)> messageGetter = {},
-            std::function<void(const int, const std::string&)> onSuccess = {});
+            std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t, const uint64_t)>
+                messageGetter,
+            std::function<void(const uint64_t, const int, const std::string&)> onSuccess);
+
+        /// @brief Sends a batch until it succeeds or the communication process stops
+        /// @param reqParams The parameters for the request, holding the batch
+        /// @param messagesCount The number of messages in the batch
+        /// @param batchId The id of the batch
+        /// @param onSuccess Action to take when the batch is sent successfully
+        boost::asio::awaitable<void>
+        SendBatch(http_client::HttpRequestParams reqParams,
+                  const int messagesCount,
+                  const uint64_t batchId,
+                  std::function<void(const uint64_t, const int, const std::string&)> onSuccess);
 
         /// @brief Indicates if the communication process should keep running
         std::atomic<bool> m_keepRunning = true;
@@ -112,6 +135,12 @@ namespace communicator
         /// @brief Size for batch requests
         size_t m_batchSize;
 
+        /// @brief Maximum number of batch requests waiting for a response per channel
+        size_t m_maxBatchesInFlight;
+
+        /// @brief gzip level for batch request bodies, 0 sends them uncompressed
+        int m_compressionLevel;
+
         /// @brief The server URL
         std::string m_serverUrl;
 
@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <exception>
 #include <fstream>
 #include <thread>
 #include <utility>
@@ -20,6 +21,8 @@ namespace
 {
     constexpr auto MIN_BATCH_SIZE = 1000ULL;
     constexpr auto MAX_BATCH_SIZE = 100000000ULL;
+    constexpr size_t MAX_BATCHES_IN_FLIGHT = 64;
+    constexpr int MAX_COMPRESSION_LEVEL = 9;
 
     boost::asio::awaitable<void> WaitForTimer(std::shared_ptr<boost::asio::steady_timer> timer,
                                               const std::time_t retryInMillis)
@@ -33,6 +36,15 @@ namespace
         (*timer).expires_after(duration);
         co_await timer->async_wait(boost::asio::use_awaitable);
     }
+
+    boost::asio::awaitable<void> WaitForTimerOrCancel(std::shared_ptr<boost::asio::steady_timer> timer,
+                                                      const std::time_t timeoutInMillis)
+    {
+        timer->expires_after(std::chrono::milliseconds(timeoutInMillis));
+
+        boost::system::error_code ec;
+        co_await timer->async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+    }
 } // namespace
 
 namespace communicator
@@ -78,6 +90,12 @@ namespace communicator
         m_batchSize = configurationParser->GetBytesConfigInRangeOrDefault(
             config::agent::DEFAULT_BATCH_SIZE, MIN_BATCH_SIZE, MAX_BATCH_SIZE, "events", "batch_size");
 
+        m_maxBatchesInFlight = configurationParser->GetConfigInRangeOrDefault<size_t>(
+            config::agent::DEFAULT_MAX_BATCHES_IN_FLIGHT, 1, MAX_BATCHES_IN_FLIGHT, "events", "max_batches_in_flight");
+
+        m_compressionLevel = configurationParser->GetConfigInRangeOrDefault<int>(
+            config::agent::DEFAULT_COMPRESSION_LEVEL, 0, MAX_COMPRESSION_LEVEL, "events", "compression_level");
+
         m_verificationMode = configurationParser->GetConfigOrDefault(
             config::agent::DEFAULT_VERIFICATION_MODE, "agent", "verification_mode");
 
@@ -265,31 +283,37 @@ namespace communicator
                                                               "",
                                                               "",
                                                               m_timeoutCommands);
-        co_await ExecuteRequestLoop(reqParams, {}, onSuccess);
+        co_await ExecuteRequestLoop(reqParams, onSuccess);
     }
 
     boost::asio::awaitable<void> Communicator::StatefulMessageProcessingTask(
-        std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t)> getMessages,
-        std::function<void(const int, const std::string&)> onSuccess)
+        std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t, const uint64_t)> getMessages,
+        std::function<void(const uint64_t, const int, const std::string&)> onSuccess)
     {
-        const auto reqParams = http_client::HttpRequestParams(http_client::MethodType::POST,
-                                                              m_serverUrl,
-                                                              "/api/v1/events/stateful",
-                                                              m_getHeaderInfo ? m_getHeaderInfo() : "",
-                                                              m_verificationMode);
-        co_await ExecuteRequestLoop(reqParams, getMessages, onSuccess);
+        auto reqParams = http_client::HttpRequestParams(http_client::MethodType::POST,
+                                                        m_serverUrl,
+                                                        "/api/v1/events/stateful",
+                                                        m_getHeaderInfo ? m_getHeaderInfo() : "",
+                                                        m_verificationMode);
+        reqParams.CompressionLevel = m_compressionLevel;
+        const auto strand = boost::asio::make_strand(co_await boost::asio::this_coro::executor);
+        co_await boost::asio::co_spawn(
+            strand, ExecuteBatchRequestLoop(reqParams, getMessages, onSuccess), boost::asio::use_awaitable);
     }
 
     boost::asio::awaitable<void> Communicator::StatelessMessageProcessingTask(
-        std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t)> getMessages,
-        std::function<void(const int, const std::string&)> onSuccess)
+        std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t, const uint64_t)> getMessages,
+        std::function<void(const uint64_t, const int, const std::string&)> onSuccess)
     {
-        const auto reqParams = http_client::HttpRequestParams(http_client::MethodType::POST,
-                                                              m_serverUrl,
-                                                              "/api/v1/events/stateless",
-                                                              m_getHeaderInfo ? m_getHeaderInfo() : "",
-                                                              m_verificationMode);
-        co_await ExecuteRequestLoop(reqParams, getMessages, onSuccess);
+        auto reqParams = http_client::HttpRequestParams(http_client::MethodType::POST,
+                                                        m_serverUrl,
+                                                        "/api/v1/events/stateless",
+                                                        m_getHeaderInfo ? m_getHeaderInfo() : "",
+                                                        m_verificationMode);
+        reqParams.CompressionLevel = m_compressionLevel;
+        const auto strand = boost::asio::make_strand(co_await boost::asio::this_coro::executor);
+        co_await boost::asio::co_spawn(
+            strand, ExecuteBatchRequestLoop(reqParams, getMessages, onSuccess), boost::asio::use_awaitable);
     }
 
     void Communicator::TryReAuthenticate()
@@ -352,10 +376,9 @@ namespace communicator
         co_return downloaded;
     }
 
-    boost::asio::awaitable<void> Communicator::ExecuteRequestLoop(
-        http_client::HttpRequestParams reqParams,
-        std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t)> messageGetter,
-        std::function<void(const int, const std::string&)> onSuccess)
+    boost::asio::awaitable<void>
+    Communicator::ExecuteRequestLoop(http_client::HttpRequestParams reqParams,
+                                     std::function<void(const int, const std::string&)> onSuccess)
     {
         using namespace std::chrono_literals;
 
@@ -370,28 +393,7 @@ namespace communicator
                 continue;
             }
 
-            auto messagesCount = 0;
-
-            if (messageGetter != nullptr)
-            {
-                while (m_keepRunning.load())
-                {
-                    const auto messages = co_await messageGetter(m_batchSize);
-                    messagesCount = std::get<0>(messages);
-
-                    if (messagesCount)
-                    {
-                        LogTrace("Items count: {}", messagesCount);
-                        reqParams.Body = std::get<1>(messages);
-                        break;
-                    }
-                }
-            }
-            else
-            {
-                reqParams.Body = "";
-            }
-
+            reqParams.Body = "";
             reqParams.Token = *m_token;
 
             const auto [statusCode, responseBody] = co_await m_httpClient->Co_PerformHttpRequest(reqParams);
@@ -402,7 +404,7 @@ namespace communicator
             {
                 if (onSuccess != nullptr)
                 {
-                    onSuccess(messagesCount, responseBody);
+                    onSuccess(0, responseBody);
                 }
             }
             else
@@ -421,6 +423,127 @@ namespace communicator
         } while (m_keepRunning.load());
     }
 
+    boost::asio::awaitable<void> Communicator::ExecuteBatchRequestLoop(
+        http_client::HttpRequestParams reqParams,
+        std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t, const uint64_t)> messageGetter,
+        std::function<void(const uint64_t, const int, const std::string&)> onSuccess)
+    {
+        auto executor = co_await boost::asio::this_coro::executor;
+        auto timer = std::make_shared<boost::asio::steady_timer>(executor);
+
+        // Cancelled each time a batch leaves flight. Batch requests complete on the same strand as this loop,
+        // so the count can't change between checking it and waiting.
+        auto batchDone = std::make_shared<boost::asio::steady_timer>(executor);
+        auto batchesInFlight = std::make_shared<size_t>(0);
+        uint64_t nextBatchId = 0;
+
+        while (m_keepRunning.load())
+        {
+            if (!m_token || m_token->empty())
+            {
+                co_await WaitForTimer(timer, A_SECOND_IN_MILLIS);
+                continue;
+            }
+
+            if (*batchesInFlight >= m_maxBatchesInFlight)
+            {
+                co_await WaitForTimerOrCancel(batchDone, A_SECOND_IN_MILLIS);
+                continue;
+            }
+
+            const auto batchId = nextBatchId;
+            auto messages = co_await messageGetter(m_batchSize, batchId);
+            const auto messagesCount = std::get<0>(messages);
+
+            if (!messagesCount)
+            {
+                // Whatever is stored is already in flight, so there is nothing to read until a batch leaves it
+                if (*batchesInFlight > 0)
+                {
+                    co_await WaitForTimerOrCancel(batchDone, A_SECOND_IN_MILLIS);
+                }
+                continue;
+            }
+
+            LogTrace("Items count: {}", messagesCount);
+
+            auto batchParams = reqParams;
+            batchParams.Body = std::move(std::get<1>(messages));
+
+            ++nextBatchId;
+            ++(*batchesInFlight);
+
+            boost::asio::co_spawn(executor,
+                                  SendBatch(std::move(batchParams), messagesCount, batchId, onSuccess),
+                                  [batchesInFlight, batchDone](std::exception_ptr ep)
+                                  {
+                                      --(*batchesInFlight);
+                                      batchDone->cancel();
+
+                                      if (ep)
+                                      {
+                                          try
+                                          {
+                                              std::rethrow_exception(ep);
+                                          }
+                                          catch (const std::exception& e)
+                                          {
+                                              LogError("Batch request exited with an exception: {}", e.what());
+                                          }
+                                      }
+                                  });
+        }
+
+        // Batch requests stop retrying once the communication process stops
+        while (*batchesInFlight > 0)
+        {
+            co_await WaitForTimerOrCancel(batchDone, A_SECOND_IN_MILLIS);
+        }
+    }
+
+    boost::asio::awaitable<void>
+    Communicator::SendBatch(http_client::HttpRequestParams reqParams,
+                            const int messagesCount,
+                            const uint64_t batchId,
+                            std::function<void(const uint64_t, const int, const std::string&)> onSuccess)
+    {
+        auto timer = std::make_shared<boost::asio::steady_timer>(co_await boost::asio::this_coro::executor);
+
+        // The body is compressed once, retries send the same compressed bytes
+        reqParams.CompressBody();
+
+        // A failed batch is sent again as it is, so batches sent meanwhile are not affected by the retry
+        while (m_keepRunning.load())
+        {
+            if (!m_token || m_token->empty())
+            {
+                co_await WaitForTimer(timer, A_SECOND_IN_MILLIS);
+                continue;
+            }
+
+            reqParams.Token = *m_token;
+
+            const auto [statusCode, responseBody] = co_await m_httpClient->Co_PerformHttpRequest(reqParams);
+
+            if (statusCode >= http_client::HTTP_CODE_OK && statusCode < http_client::HTTP_CODE_MULTIPLE_CHOICES)
+            {
+                if (onSuccess != nullptr)
+                {
+                    onSuccess(batchId, messagesCount, responseBody);
+                }
+                co_return;
+            }
+
+            if (statusCode == http_client::HTTP_CODE_UNAUTHORIZED || statusCode == http_client::HTTP_CODE_FORBIDDEN)
+            {
+                TryReAuthenticate();
+            }
+
+            co_await WaitForTimer(timer,
+                                  statusCode != http_client::HTTP_CODE_TIMEOUT ? m_retryInterval : A_SECOND_IN_MILLIS);
+        }
+    }
+
     void Communicator::Stop()
     {
         m_keepRunning.store(false);
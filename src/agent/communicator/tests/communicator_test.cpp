@@ -15,11 +15,12 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 // NOLINTBEGIN(cppcoreguidelines-avoid-capturing-lambda-coroutines)
 
 using namespace testing;
-using GetMessagesFuncType = std::function<boost::asio::awaitable<intStringTuple>(const size_t)>;
+using GetMessagesFuncType = std::function<boost::asio::awaitable<intStringTuple>(const size_t, const uint64_t)>;
 
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-const-or-ref-data-members)
 MATCHER_P3(HttpRequestParamsCheck, expected, token, body, "Check http request params")
@@ -54,6 +55,15 @@ namespace
           batch_size: 1
     )"));
 
+    boost::asio::awaitable<intStringTuple> RespondAfter(const std::chrono::milliseconds delay, size_t& requestsInFlight)
+    {
+        boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor, delay);
+        co_await timer.async_wait(boost::asio::use_awaitable);
+
+        --requestsInFlight;
+        co_return intStringTuple {http_client::HTTP_CODE_OK, "Dummy response"};
+    }
+
     void SpawnCoroutine(std::function<boost::asio::awaitable<void>()> func)
     {
         boost::asio::io_context ioContext;
@@ -137,12 +147,12 @@ TEST_F(CommunicatorTest, StatelessMessageProcessingTask_FailedAuthenticationLeav
         {
             m_communicator->SendAuthenticationRequest();
             co_await m_communicator->StatelessMessageProcessingTask(
-                [&getMessagesCalled](const size_t) -> boost::asio::awaitable<intStringTuple>
+                [&getMessagesCalled](const size_t, const uint64_t) -> boost::asio::awaitable<intStringTuple>
                 {
                     getMessagesCalled = true;
                     co_return intStringTuple {1, std::string {"message"}};
                 },
-                [&onSuccessCalled](const int, const std::string&) { onSuccessCalled = true; });
+                [&onSuccessCalled](const uint64_t, const int, const std::string&) { onSuccessCalled = true; });
         });
 
     EXPECT_FALSE(getMessagesCalled);
@@ -171,18 +181,155 @@ TEST_F(CommunicatorTest, StatelessMessageProcessingTask_CallsWithValidToken)
         {
             m_communicator->SendAuthenticationRequest();
             co_await m_communicator->StatelessMessageProcessingTask(
-                [&getMessagesCalled](const size_t) -> boost::asio::awaitable<intStringTuple>
+                [&getMessagesCalled](const size_t, const uint64_t) -> boost::asio::awaitable<intStringTuple>
                 {
                     getMessagesCalled = true;
                     co_return intStringTuple {1, std::string {"message"}};
                 },
-                [&onSuccessCalled](const int, const std::string&) { onSuccessCalled = true; });
+                [&onSuccessCalled](const uint64_t, const int, const std::string&) { onSuccessCalled = true; });
         });
 
     EXPECT_TRUE(getMessagesCalled);
     EXPECT_TRUE(onSuccessCalled);
 }
 
+TEST_F(CommunicatorTest, StatefulMessageProcessingTask_SendsBatchesWithoutWaitingBetweenThem)
+{
+    EXPECT_CALL(*m_mockHttpClientPtr, Co_PerformHttpRequest(testing::_))
+        .Times(3)
+        .WillRepeatedly(Invoke([]() -> boost::asio::awaitable<intStringTuple>
+                               { co_return intStringTuple {http_client::HTTP_CODE_OK, "Dummy response"}; }));
+
+    std::vector<uint64_t> requestedBatches;
+    std::vector<uint64_t> acknowledgedBatches;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    SpawnCoroutine(
+        [this, &requestedBatches, &acknowledgedBatches]() mutable -> boost::asio::awaitable<void>
+        {
+            m_communicator->SendAuthenticationRequest();
+            co_await m_communicator->StatefulMessageProcessingTask(
+                [&requestedBatches](const size_t, const uint64_t batchId) -> boost::asio::awaitable<intStringTuple>
+                {
+                    requestedBatches.push_back(batchId);
+                    co_return intStringTuple {1, std::string {"message"}};
+                },
+                [this, &acknowledgedBatches](const uint64_t batchId, const int, const std::string&)
+                {
+                    acknowledgedBatches.push_back(batchId);
+                    if (acknowledgedBatches.size() == 3)
+                    {
+                        m_communicator->Stop();
+                    }
+                });
+        });
+
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    EXPECT_THAT(requestedBatches, ElementsAre(0, 1, 2));
+    EXPECT_THAT(acknowledgedBatches, ElementsAre(0, 1, 2));
+}
+
+TEST_F(CommunicatorTest, StatelessMessageProcessingTask_KeepsSeveralBatchesInFlight)
+{
+    const auto configurationParser = std::make_shared<configuration::ConfigurationParser>(std::string(R"(
+        agent:
+          retry_interval: 5
+          verification_mode: none
+        events:
+          batch_size: 1
+          max_batches_in_flight: 3
+    )"));
+
+    auto mockHttpClient = std::make_unique<MockHttpClient>();
+    auto* mockHttpClientPtr = mockHttpClient.get();
+    testing::Mock::AllowLeak(mockHttpClientPtr);
+
+    const auto communicator = std::make_shared<communicator::Communicator>(
+        std::move(mockHttpClient), configurationParser, "uuid", "key", nullptr);
+
+    EXPECT_CALL(*mockHttpClientPtr, PerformHttpRequest(testing::_))
+        .WillRepeatedly(Invoke([token = m_mockedToken]() -> intStringTuple
+                               { return {http_client::HTTP_CODE_OK, R"({"token":")" + token + R"("})"}; }));
+
+    size_t requestsInFlight = 0;
+    size_t maxRequestsInFlight = 0;
+
+    // The first batch sent is the last one answered
+    EXPECT_CALL(*mockHttpClientPtr, Co_PerformHttpRequest(testing::_))
+        .Times(3)
+        .WillRepeatedly(Invoke(
+            [&requestsInFlight, &maxRequestsInFlight](const http_client::HttpRequestParams params)
+            {
+                maxRequestsInFlight = std::max(maxRequestsInFlight, ++requestsInFlight);
+                return RespondAfter(std::chrono::milliseconds(60 - 20 * std::stoi(params.Body)), requestsInFlight);
+            }));
+
+    std::vector<uint64_t> acknowledgedBatches;
+
+    SpawnCoroutine(
+        [&communicator, &acknowledgedBatches]() mutable -> boost::asio::awaitable<void>
+        {
+            communicator->SendAuthenticationRequest();
+            co_await communicator->StatelessMessageProcessingTask(
+                [](const size_t, const uint64_t batchId) -> boost::asio::awaitable<intStringTuple>
+                {
+                    if (batchId < 3)
+                    {
+                        co_return intStringTuple {1, std::to_string(batchId)};
+                    }
+                    co_return intStringTuple {0, std::string {}};
+                },
+                [&communicator, &acknowledgedBatches](const uint64_t batchId, const int, const std::string&)
+                {
+                    acknowledgedBatches.push_back(batchId);
+                    if (acknowledgedBatches.size() == 3)
+                    {
+                        communicator->Stop();
+                    }
+                });
+        });
+
+    EXPECT_EQ(maxRequestsInFlight, 3);
+    EXPECT_THAT(acknowledgedBatches, ElementsAre(2, 1, 0));
+}
+
+TEST_F(CommunicatorTest, StatelessMessageProcessingTask_RetriesFailedBatchAsIs)
+{
+    const auto reqParams = http_client::HttpRequestParams(
+        http_client::MethodType::POST, "https://localhost:27000", "/api/v1/events/stateless", "", "none");
+
+    EXPECT_CALL(*m_mockHttpClientPtr,
+                Co_PerformHttpRequest(HttpRequestParamsCheck(reqParams, m_mockedToken, "message")))
+        .WillOnce(Invoke([]() -> boost::asio::awaitable<intStringTuple>
+                         { co_return intStringTuple {http_client::HTTP_CODE_TIMEOUT, ""}; }))
+        .WillOnce(Invoke([]() -> boost::asio::awaitable<intStringTuple>
+                         { co_return intStringTuple {http_client::HTTP_CODE_OK, "Dummy response"}; }));
+
+    auto getMessagesCalls = 0;
+    std::vector<uint64_t> acknowledgedBatches;
+
+    SpawnCoroutine(
+        [this, &getMessagesCalls, &acknowledgedBatches]() mutable -> boost::asio::awaitable<void>
+        {
+            m_communicator->SendAuthenticationRequest();
+            co_await m_communicator->StatelessMessageProcessingTask(
+                [&getMessagesCalls](const size_t, const uint64_t) -> boost::asio::awaitable<intStringTuple>
+                {
+                    ++getMessagesCalls;
+                    co_return intStringTuple {1, std::string {"message"}};
+                },
+                [this, &acknowledgedBatches](const uint64_t batchId, const int, const std::string&)
+                {
+                    acknowledgedBatches.push_back(batchId);
+                    m_communicator->Stop();
+                });
+        });
+
+    EXPECT_EQ(getMessagesCalls, 1);
+    EXPECT_THAT(acknowledgedBatches, ElementsAre(0));
+}
+
 TEST_F(CommunicatorTest, GetCommandsFromManager_CallsWithValidToken)
 {
     const auto timeout = static_cast<time_t>(11) * 60 * 1000;
@@ -2,7 +2,9 @@
 
 #include <ihttp_client.hpp>
 
+#include <boost/asio/any_io_executor.hpp>
 #include <boost/asio/awaitable.hpp>
+#include <boost/asio/ip/tcp.hpp>
 
 #include <functional>
 #include <memory>
@@ -11,13 +13,16 @@
 
 namespace http_client
 {
+    class HttpConnectionPool;
     class IHttpResolverFactory;
+    class IHttpSocket;
     class IHttpSocketFactory;
 
     /// @brief HTTP client implementation
     ///
     /// This class implements the IHttpClient interface, providing
     /// functionality for creating and performing HTTP requests.
+    /// Asynchronous requests reuse keep-alive connections and resolved endpoints across calls.
     class HttpClient : public IHttpClient
     {
     public:
@@ -27,18 +32,50 @@ namespace http_client
         HttpClient(std::shared_ptr<IHttpResolverFactory> resolverFactory = nullptr,
                    std::shared_ptr<IHttpSocketFactory> socketFactory = nullptr);
 
+        /// @brief Destroys the HttpClient, closing its idle connections
+        ~HttpClient() override;
+
+        /// @brief Delete copy constructor
+        HttpClient(const HttpClient&) = delete;
+
+        /// @brief Delete copy assignment operator
+        HttpClient& operator=(const HttpClient&) = delete;
+
+        /// @brief Delete move constructor
+        HttpClient(HttpClient&&) = delete;
+
+        /// @brief Delete move assignment operator
+        HttpClient& operator=(HttpClient&&) = delete;
+
         /// @copydoc IHttpClient::Co_PerformHttpRequest
         boost::asio::awaitable<std::tuple<int, std::string>>
-        Co_PerformHttpRequest(const HttpRequestParams params) override;
+        Co_PerformHttpRequest(HttpRequestParams params) override;
 
         /// @copydoc IHttpClient::PerformHttpRequest
         std::tuple<int, std::string> PerformHttpRequest(const HttpRequestParams& params) override;
 
     private:
+        /// @brief Resolves the request host, using the cached endpoints when they have not expired
+        /// @param executor The executor to resolve on
+        /// @param params The parameters for the request
+        /// @return The resolved endpoints
+        boost::asio::awaitable<boost::asio::ip::tcp::resolver::results_type>
+        Co_Resolve(const boost::asio::any_io_executor& executor, const HttpRequestParams& params);
+
+        /// @brief Creates a socket and connects it to the request host
+        /// @param executor The executor to bind the socket to
+        /// @param params The parameters for the request
+        /// @return The connected socket
+        boost::asio::awaitable<std::unique_ptr<IHttpSocket>> Co_Connect(const boost::asio::any_io_executor& executor,
+                                                                        const HttpRequestParams& params);
+
         /// @brief HTTP resolver factory
         std::shared_ptr<IHttpResolverFactory> m_resolverFactory;
 
         /// @brief HTTP socket factory
         std::shared_ptr<IHttpSocketFactory> m_socketFactory;
+
+        /// @brief Idle keep-alive connections and resolved endpoints
+        std::unique_ptr<HttpConnectionPool> m_connectionPool;
     };
 } // namespace http_client
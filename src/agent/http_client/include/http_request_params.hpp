@@ -25,6 +25,9 @@ namespace http_client
 
     /// @struct HttpRequestParams
     /// @brief Parameters for HTTP requests
+    ///
+    /// The body is sent as is, with its ContentEncoding if set. CompressBody gzip compresses it with a CompressionLevel
+    /// from 1 to 9, and leaves it as is with 0.
     struct HttpRequestParams
     {
         MethodType Method;
@@ -38,6 +41,8 @@ namespace http_client
         std::string Body;
         bool Use_Https;
         time_t RequestTimeout;
+        int CompressionLevel = 0;
+        std::string ContentEncoding;
 
         /// @brief Constructs HttpRequestParams with specified parameters
         /// @param method The HTTP method to use
@@ -59,6 +64,10 @@ namespace http_client
                           std::string body = "",
                           const time_t requestTimeoutInMilliSeconds = 0);
 
+        /// @brief Compresses the body with CompressionLevel once, so the request can be sent several times without
+        /// compressing it each time. If it can't be compressed, it is sent as is.
+        void CompressBody();
+
         /// @brief Equality operator for comparing two HttpRequestParams objects
         /// @param other The other HttpRequestParams object to compare with
         /// @return True if equal, false otherwise
@@ -0,0 +1,66 @@
+#include "http_body_compression.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace
+{
+    /// @brief Window bits for a 32KB window with a gzip header and trailer
+    constexpr int GZIP_WINDOW_BITS = 15 + 16;
+
+    /// @brief zlib's default memory level
+    constexpr int DEFAULT_MEM_LEVEL = 8;
+
+    /// @brief Bytes handed to or taken from zlib at a time
+    constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+} // namespace
+
+namespace http_client
+{
+    std::optional<std::string> GzipCompress(const std::string& body, int level)
+    {
+        z_stream stream {};
+
+        if (deflateInit2(&stream, level, Z_DEFLATED, GZIP_WINDOW_BITS, DEFAULT_MEM_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            return std::nullopt;
+        }
+
+        std::string output;
+        std::size_t consumed = 0;
+        int result = Z_OK;
+
+        while (result != Z_STREAM_END)
+        {
+            if (stream.avail_in == 0 && consumed < body.size())
+            {
+                const auto chunk = std::min(body.size() - consumed, CHUNK_SIZE);
+                // zlib does not write through next_in, the const_cast only satisfies its C interface
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast,cppcoreguidelines-pro-type-reinterpret-cast)
+                stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(body.data() + consumed));
+                stream.avail_in = static_cast<uInt>(chunk);
+                consumed += chunk;
+            }
+
+            const auto written = output.size();
+            output.resize(written + CHUNK_SIZE);
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            stream.next_out = reinterpret_cast<Bytef*>(output.data() + written);
+            stream.avail_out = static_cast<uInt>(CHUNK_SIZE);
+
+            result = deflate(&stream, consumed == body.size() ? Z_FINISH : Z_NO_FLUSH);
+            output.resize(output.size() - stream.avail_out);
+
+            if (result == Z_STREAM_ERROR)
+            {
+                deflateEnd(&stream);
+                return std::nullopt;
+            }
+        }
+
+        deflateEnd(&stream);
+        return output;
+    }
+} // namespace http_client
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+namespace http_client
+{
+    /// @brief Compresses a request body in gzip format
+    ///
+    /// The body is deflated where it is and the output grows a chunk at a time, so the uncompressed body is never
+    /// copied.
+    /// @param body The body to compress
+    /// @param level The compression level, from 1 (fastest) to 9 (smallest)
+    /// @return The compressed body, or std::nullopt if it could not be compressed
+    std::optional<std::string> GzipCompress(const std::string& body, int level);
+} // namespace http_client
@@ -1,5 +1,6 @@
 #include <http_client.hpp>
 
+#include "http_connection_pool.hpp"
 #include "http_resolver_factory.hpp"
 #include "http_socket_factory.hpp"
 #include "ihttp_resolver_factory.hpp"
@@ -30,7 +31,7 @@ namespace
     }
 
     boost::beast::http::request<boost::beast::http::string_body>
-    CreateHttpRequest(const http_client::HttpRequestParams& params)
+    CreateHttpRequest(const http_client::HttpRequestParams& params, std::string body)
     {
         static constexpr int HttpVersion1_1 = 11;
 
@@ -56,17 +57,50 @@ namespace
             req.set(boost::beast::http::field::authorization, "Basic " + basicAuth);
         }
 
-        if (!params.Body.empty())
+        if (!body.empty())
         {
             req.set(boost::beast::http::field::content_type, "application/json");
-            req.set(boost::beast::http::field::transfer_encoding, "chunked");
-            req.body() = params.Body;
+
+            if (!params.ContentEncoding.empty())
+            {
+                req.set(boost::beast::http::field::content_encoding, params.ContentEncoding);
+            }
+
+            req.body() = std::move(body);
             req.prepare_payload();
         }
 
         return req;
     }
 
+    std::string ConnectionKey(const http_client::HttpRequestParams& params)
+    {
+        return (params.Use_Https ? "https://" : "http://") + params.Host + ":" + params.Port + "|" +
+               params.Verification_Mode;
+    }
+
+    std::chrono::milliseconds RequestTimeout(const http_client::HttpRequestParams& params)
+    {
+        return params.RequestTimeout ? std::chrono::milliseconds(params.RequestTimeout) : http_client::SOCKET_TIMEOUT;
+    }
+
+    /// @brief Whether a request that failed on a reused connection can be sent again on a new one
+    ///
+    /// It can only when the server cannot have received it: the write failed because the server had already
+    /// closed the connection, or the server closed it before sending back any byte of the response.
+    /// @param ec The error the request failed with
+    /// @param written Whether the request had been written
+    bool CanRetryOnNewConnection(const boost::system::error_code& ec, const bool written)
+    {
+        if (!written)
+        {
+            return ec == boost::asio::error::broken_pipe || ec == boost::asio::error::connection_reset ||
+                   ec == boost::asio::error::not_connected || ec == boost::asio::error::eof;
+        }
+
+        return ec == boost::beast::http::error::end_of_stream || ec == boost::asio::error::eof;
+    }
+
     std::string ResponseToString(const std::string& endpoint,
                                  const boost::beast::http::response<boost::beast::http::dynamic_body>& res)
     {
@@ -98,74 +132,148 @@ namespace http_client
         {
             m_socketFactory = std::make_shared<HttpSocketFactory>();
         }
+
+        m_connectionPool = std::make_unique<HttpConnectionPool>();
     }
 
-    boost::asio::awaitable<std::tuple<int, std::string>>
-    HttpClient::Co_PerformHttpRequest(const HttpRequestParams params)
+    HttpClient::~HttpClient() = default;
+
+    boost::asio::awaitable<boost::asio::ip::tcp::resolver::results_type>
+    HttpClient::Co_Resolve(const boost::asio::any_io_executor& executor, const HttpRequestParams& params)
     {
-        boost::beast::http::response<boost::beast::http::dynamic_body> res;
+        if (auto cachedEndpoints = m_connectionPool->GetEndpoints(params.Host, params.Port))
+        {
+            co_return *cachedEndpoints;
+        }
 
-        try
+        auto resolver = m_resolverFactory->Create(executor);
+
+        const auto results = co_await resolver->AsyncResolve(params.Host, params.Port);
+
+        if (results.empty())
         {
-            auto executor = co_await boost::asio::this_coro::executor;
-            auto resolver = m_resolverFactory->Create(executor);
+            throw std::runtime_error("Failed to resolve host.");
+        }
 
-            const auto results = co_await resolver->AsyncResolve(params.Host, params.Port);
+        m_connectionPool->CacheEndpoints(params.Host, params.Port, results);
 
-            if (results.empty())
-            {
-                throw std::runtime_error("Failed to resolve host.");
-            }
+        co_return results;
+    }
 
-            auto socket = m_socketFactory->Create(executor, params.Use_Https);
+    boost::asio::awaitable<std::unique_ptr<IHttpSocket>>
+    HttpClient::Co_Connect(const boost::asio::any_io_executor& executor, const HttpRequestParams& params)
+    {
+        const auto results = co_await Co_Resolve(executor, params);
 
-            if (!socket)
-            {
-                throw std::runtime_error("Failed to create socket.");
-            }
+        auto socket = m_socketFactory->Create(executor, params.Use_Https);
 
-            if (params.Use_Https)
-            {
-                socket->SetVerificationMode(params.Host, params.Verification_Mode);
-            }
+        if (!socket)
+        {
+            throw std::runtime_error("Failed to create socket.");
+        }
 
-            if (params.RequestTimeout)
-            {
-                socket->SetTimeout(std::chrono::milliseconds(params.RequestTimeout));
-            }
+        if (params.Use_Https)
+        {
+            socket->SetVerificationMode(params.Host, params.Verification_Mode);
+        }
+
+        socket->SetTimeout(RequestTimeout(params));
+
+        boost::system::error_code ec;
+
+        co_await socket->AsyncConnect(results, ec);
+
+        if (ec)
+        {
+            // The host may have moved, resolve it again on the next request
+            m_connectionPool->InvalidateEndpoints(params.Host, params.Port);
+            throw std::runtime_error("Error connecting to host: " + ec.message());
+        }
+
+        co_return socket;
+    }
+
+    boost::asio::awaitable<std::tuple<int, std::string>>
+    HttpClient::Co_PerformHttpRequest(HttpRequestParams params)
+    {
+        boost::beast::http::response<boost::beast::http::dynamic_body> res;
+
+        try
+        {
+            auto executor = co_await boost::asio::this_coro::executor;
+
+            const auto connectionKey = ConnectionKey(params);
+
+            // The parameters are this request's own copy, so the body is moved into it rather than copied again
+            const auto req = CreateHttpRequest(params, std::move(params.Body));
 
             boost::system::error_code ec;
 
-            co_await socket->AsyncConnect(results, ec);
+            // An idle connection may have been closed by the server in the meantime. If so, it is dropped and the
+            // request is sent again on a new connection, unless the server may have received it already.
+            auto socket = m_connectionPool->Acquire(connectionKey, executor);
 
-            if (ec)
+            if (socket)
             {
-                throw std::runtime_error("Error connecting to host: " + ec.message());
+                socket->SetTimeout(RequestTimeout(params));
+
+                co_await socket->AsyncWrite(req, ec);
+
+                const auto written = !ec;
+
+                if (written)
+                {
+                    co_await socket->AsyncRead(res, ec);
+                }
+
+                if (ec && !CanRetryOnNewConnection(ec, written))
+                {
+                    throw std::runtime_error((written ? "Error handling response: " : "Error writing request: ") +
+                                             ec.message());
+                }
+
+                if (ec)
+                {
+                    LogDebug("Reused connection was closed: {}. Retrying on a new connection.", ec.message());
+                    socket.reset();
+                    res = {};
+                    ec = {};
+                }
             }
 
-            const auto req = CreateHttpRequest(params);
+            if (!socket)
+            {
+                socket = co_await Co_Connect(executor, params);
 
-            co_await socket->AsyncWrite(req, ec);
+                co_await socket->AsyncWrite(req, ec);
 
-            if (ec)
-            {
-                throw std::runtime_error("Error writing request: " + ec.message());
-            }
+                if (ec)
+                {
+                    throw std::runtime_error("Error writing request: " + ec.message());
+                }
 
-            co_await socket->AsyncRead(res, ec);
+                co_await socket->AsyncRead(res, ec);
 
-            if (ec)
-            {
-                throw std::runtime_error("Error handling response: " + ec.message());
+                if (ec)
+                {
+                    throw std::runtime_error("Error handling response: " + ec.message());
+                }
             }
 
             LogDebug("Request {}: Status {}", params.Endpoint, res.result_int());
             LogTrace("{}", ResponseToString(params.Endpoint, res));
 
-            socket->Shutdown(ec);
-            if (ec)
+            if (res.keep_alive())
             {
-                throw std::runtime_error("Error shutting down socket: " + ec.message());
+                m_connectionPool->Release(connectionKey, executor, std::move(socket));
+            }
+            else
+            {
+                socket->Shutdown(ec);
+                if (ec)
+                {
+                    throw std::runtime_error("Error shutting down socket: " + ec.message());
+                }
             }
         }
         catch (const std::exception& e)
@@ -218,7 +326,7 @@ namespace http_client
                 throw std::runtime_error("Error connecting to host: " + ec.message());
             }
 
-            const auto req = CreateHttpRequest(params);
+            const auto req = CreateHttpRequest(params, params.Body);
 
             socket->Write(req, ec);
             io_context.run();
@@ -0,0 +1,134 @@
+#include <http_connection_pool.hpp>
+
+#include <boost/system/error_code.hpp>
+
+#include <algorithm>
+
+namespace
+{
+    std::string EndpointsKey(const std::string& host, const std::string& port)
+    {
+        return host + ":" + port;
+    }
+} // namespace
+
+namespace http_client
+{
+    HttpConnectionPool::HttpConnectionPool(std::chrono::steady_clock::duration dnsCacheTtl,
+                                           std::chrono::steady_clock::duration idleTimeout,
+                                           std::size_t maxIdlePerHost)
+        : m_dnsCacheTtl(dnsCacheTtl)
+        , m_idleTimeout(idleTimeout)
+        , m_maxIdlePerHost(maxIdlePerHost)
+    {
+    }
+
+    std::unique_ptr<IHttpSocket> HttpConnectionPool::Acquire(const std::string& key,
+                                                             const boost::asio::any_io_executor& executor)
+    {
+        std::vector<IdleConnection> expired;
+        std::unique_ptr<IHttpSocket> socket;
+
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+
+            const auto it = m_idle.find(key);
+            if (it == m_idle.end())
+            {
+                return nullptr;
+            }
+
+            auto& connections = it->second;
+            const auto now = std::chrono::steady_clock::now();
+
+            // The server may have closed connections idle for too long, they are not worth trying
+            const auto firstAlive =
+                std::find_if(connections.begin(),
+                             connections.end(),
+                             [this, now](const IdleConnection& connection)
+                             { return now - connection.since < m_idleTimeout; });
+            expired.insert(expired.end(),
+                           std::make_move_iterator(connections.begin()),
+                           std::make_move_iterator(firstAlive));
+            connections.erase(connections.begin(), firstAlive);
+
+            const auto match = std::find_if(connections.rbegin(),
+                                            connections.rend(),
+                                            [&executor](const IdleConnection& connection)
+                                            { return connection.executor == executor; });
+            if (match != connections.rend())
+            {
+                socket = std::move(match->socket);
+                connections.erase(std::next(match).base());
+            }
+        }
+
+        for (auto& connection : expired)
+        {
+            boost::system::error_code ec;
+            connection.socket->Shutdown(ec);
+        }
+
+        return socket;
+    }
+
+    void HttpConnectionPool::Release(const std::string& key,
+                                     const boost::asio::any_io_executor& executor,
+                                     std::unique_ptr<IHttpSocket> socket)
+    {
+        std::unique_ptr<IHttpSocket> evicted;
+
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+
+            auto& connections = m_idle[key];
+            connections.push_back({executor, std::move(socket), std::chrono::steady_clock::now()});
+
+            if (connections.size() > m_maxIdlePerHost)
+            {
+                evicted = std::move(connections.front().socket);
+                connections.erase(connections.begin());
+            }
+        }
+
+        if (evicted)
+        {
+            boost::system::error_code ec;
+            evicted->Shutdown(ec);
+        }
+    }
+
+    std::optional<boost::asio::ip::tcp::resolver::results_type>
+    HttpConnectionPool::GetEndpoints(const std::string& host, const std::string& port)
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+
+        const auto it = m_endpoints.find(EndpointsKey(host, port));
+        if (it == m_endpoints.end())
+        {
+            return std::nullopt;
+        }
+
+        if (std::chrono::steady_clock::now() >= it->second.expiry)
+        {
+            m_endpoints.erase(it);
+            return std::nullopt;
+        }
+
+        return it->second.endpoints;
+    }
+
+    void HttpConnectionPool::CacheEndpoints(const std::string& host,
+                                            const std::string& port,
+                                            const boost::asio::ip::tcp::resolver::results_type& endpoints)
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_endpoints[EndpointsKey(host, port)] = {endpoints, std::chrono::steady_clock::now() + m_dnsCacheTtl};
+    }
+
+    void HttpConnectionPool::InvalidateEndpoints(const std::string& host, const std::string& port)
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_endpoints.erase(EndpointsKey(host, port));
+    }
+} // namespace http_client
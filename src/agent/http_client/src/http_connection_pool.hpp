@@ -0,0 +1,111 @@
+#pragma once
+
+#include <ihttp_socket.hpp>
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace http_client
+{
+    /// @brief Time resolved endpoints are reused before resolving the host again
+    constexpr auto DNS_CACHE_TTL = std::chrono::seconds {60};
+
+    /// @brief Time an idle connection is kept before being closed
+    constexpr auto IDLE_CONNECTION_TIMEOUT = std::chrono::seconds {30};
+
+    /// @brief Maximum number of idle connections kept per host
+    constexpr std::size_t MAX_IDLE_CONNECTIONS_PER_HOST = 8;
+
+    /// @brief Keeps idle keep-alive connections and resolved endpoints for reuse across requests
+    ///
+    /// Connections are keyed by scheme, host, port and verification mode, so a connection is only reused for
+    /// requests that would have established an identical one. A connection is handed to a single request at a time.
+    class HttpConnectionPool
+    {
+    public:
+        /// @brief Constructs an HttpConnectionPool
+        /// @param dnsCacheTtl Time resolved endpoints are reused
+        /// @param idleTimeout Time an idle connection is kept
+        /// @param maxIdlePerHost Maximum number of idle connections kept per key
+        HttpConnectionPool(std::chrono::steady_clock::duration dnsCacheTtl = DNS_CACHE_TTL,
+                           std::chrono::steady_clock::duration idleTimeout = IDLE_CONNECTION_TIMEOUT,
+                           std::size_t maxIdlePerHost = MAX_IDLE_CONNECTIONS_PER_HOST);
+
+        /// @brief Takes an idle connection out of the pool
+        /// @param key The connection key
+        /// @param executor The executor the connection must be bound to
+        /// @return The connection, or nullptr if there is no usable one
+        std::unique_ptr<IHttpSocket> Acquire(const std::string& key, const boost::asio::any_io_executor& executor);
+
+        /// @brief Returns a connection to the pool after a successful keep-alive exchange
+        /// @param key The connection key
+        /// @param executor The executor the connection is bound to
+        /// @param socket The connection
+        void Release(const std::string& key,
+                     const boost::asio::any_io_executor& executor,
+                     std::unique_ptr<IHttpSocket> socket);
+
+        /// @brief Returns the cached endpoints of a host and port if they have not expired
+        /// @param host The host
+        /// @param port The port
+        /// @return The cached endpoints, if any
+        std::optional<boost::asio::ip::tcp::resolver::results_type> GetEndpoints(const std::string& host,
+                                                                                const std::string& port);
+
+        /// @brief Caches the resolved endpoints of a host and port
+        /// @param host The host
+        /// @param port The port
+        /// @param endpoints The resolved endpoints
+        void CacheEndpoints(const std::string& host,
+                            const std::string& port,
+                            const boost::asio::ip::tcp::resolver::results_type& endpoints);
+
+        /// @brief Drops the cached endpoints of a host and port, so the next request resolves them again
+        /// @param host The host
+        /// @param port The port
+        void InvalidateEndpoints(const std::string& host, const std::string& port);
+
+    private:
+        /// @brief An idle connection
+        struct IdleConnection
+        {
+            boost::asio::any_io_executor executor;
+            std::unique_ptr<IHttpSocket> socket;
+            std::chrono::steady_clock::time_point since;
+        };
+
+        /// @brief Resolved endpoints and their expiration
+        struct CachedEndpoints
+        {
+            boost::asio::ip::tcp::resolver::results_type endpoints;
+            std::chrono::steady_clock::time_point expiry;
+        };
+
+        /// @brief Time resolved endpoints are reused
+        std::chrono::steady_clock::duration m_dnsCacheTtl;
+
+        /// @brief Time an idle connection is kept
+        std::chrono::steady_clock::duration m_idleTimeout;
+
+        /// @brief Maximum number of idle connections kept per key
+        std::size_t m_maxIdlePerHost;
+
+        /// @brief Mutex protecting the idle connections and the cached endpoints
+        std::mutex m_mutex;
+
+        /// @brief Idle connections per key, most recently used last
+        std::map<std::string, std::vector<IdleConnection>> m_idle;
+
+        /// @brief Cached endpoints per host and port
+        std::map<std::string, CachedEndpoints> m_endpoints;
+    };
+} // namespace http_client
@@ -1,5 +1,7 @@
 #include <http_request_params.hpp>
 
+#include "http_body_compression.hpp"
+
 #include <boost/url.hpp>
 
 #include <logger.hpp>
@@ -51,11 +53,32 @@ namespace http_client
         Port = !url.port().empty() ? url.port() : (Use_Https ? "443" : "80");
     }
 
+    void HttpRequestParams::CompressBody()
+    {
+        if (CompressionLevel <= 0 || Body.empty())
+        {
+            return;
+        }
+
+        if (auto compressedBody = GzipCompress(Body, CompressionLevel))
+        {
+            Body = std::move(*compressedBody);
+            ContentEncoding = "gzip";
+        }
+        else
+        {
+            LogError("Failed to compress request body, sending it uncompressed.");
+        }
+
+        CompressionLevel = 0;
+    }
+
     bool HttpRequestParams::operator==(const HttpRequestParams& other) const
     {
         return Method == other.Method && Host == other.Host && Port == other.Port && Endpoint == other.Endpoint &&
                User_agent == other.User_agent && Verification_Mode == other.Verification_Mode && Token == other.Token &&
                User_pass == other.User_pass && Body == other.Body && Use_Https == other.Use_Https &&
-               RequestTimeout == other.RequestTimeout;
+               RequestTimeout == other.RequestTimeout && CompressionLevel == other.CompressionLevel &&
+               ContentEncoding == other.ContentEncoding;
     }
 } // namespace http_client
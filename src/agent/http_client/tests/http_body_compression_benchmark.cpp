@@ -0,0 +1,62 @@
+#include "http_body_compression.hpp"
+
+#include <ctime>
+#include <iostream>
+#include <string>
+
+namespace
+{
+    constexpr std::size_t DEFAULT_BATCH_SIZE = 1000000;
+    constexpr int ITERATIONS = 20;
+    constexpr int MAX_LEVEL = 9;
+    constexpr double BYTES_PER_MB = 1000000.0;
+
+    /// @brief Builds a batch shaped like the ones sent by the agent: a metadata line followed by NDJSON events.
+    std::string CreateBatch(std::size_t size)
+    {
+        std::string batch =
+            R"({"agent":{"id":"0194ad7b-4fc4-7c2b-a2a3-0a2d5a5d2c6e","name":"host","version":"6.0.0"}})";
+        batch += "\n";
+
+        for (int i = 0; batch.size() < size; ++i)
+        {
+            batch += R"({"module":"logcollector","type":"file","metadata":{"path":"/var/log/auth.log"}})";
+            batch += "\n";
+            batch += R"({"event":{"original":"Jan 01 00:00:)" + std::to_string(i % 60) + " host sshd[" +
+                     std::to_string(1000 + i) + R"(]: Accepted publickey for user from 10.0.0.)" +
+                     std::to_string(i % 256) + R"( port 22"}})";
+            batch += "\n";
+        }
+
+        return batch;
+    }
+} // namespace
+
+/// @brief Measures gzip request body size and CPU time per level. Usage: benchmark_HttpBodyCompression [batch bytes]
+int main(int argc, char** argv)
+{
+    const auto batch = CreateBatch(argc > 1 ? std::stoul(argv[1]) : DEFAULT_BATCH_SIZE);
+
+    std::cout << "Batch: " << batch.size() << " bytes\n";
+
+    for (int level = 1; level <= MAX_LEVEL; ++level)
+    {
+        std::size_t compressedSize = 0;
+
+        const auto start = std::clock();
+
+        for (int i = 0; i < ITERATIONS; ++i)
+        {
+            compressedSize = http_client::GzipCompress(batch, level).value_or("").size();
+        }
+
+        const auto cpuSeconds = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+        const auto megabytes = static_cast<double>(batch.size()) * ITERATIONS / BYTES_PER_MB;
+
+        std::cout << "Level " << level << ": " << compressedSize << " bytes on the wire ("
+                  << static_cast<double>(batch.size()) / static_cast<double>(compressedSize) << "x), "
+                  << cpuSeconds * 1000 / megabytes << " ms CPU per MB\n";
+    }
+
+    return 0;
+}
@@ -9,18 +9,73 @@
 #include "mocks/mock_http_socket.hpp"
 #include "mocks/mock_http_socket_factory.hpp"
 
+#include "http_body_compression.hpp"
+
 #include <boost/asio.hpp>
 #include <boost/beast/http.hpp>
 
+#include <zlib.h>
+
 #include <functional>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 // NOLINTBEGIN(cppcoreguidelines-avoid-capturing-lambda-coroutines,cppcoreguidelines-avoid-reference-coroutine-parameters)
 
 using namespace testing;
 
+namespace
+{
+    std::string GzipDecompress(const std::string& compressed)
+    {
+        constexpr int gzipWindowBits = 15 + 16;
+        constexpr size_t chunkSize = 1024;
+
+        z_stream stream {};
+        EXPECT_EQ(inflateInit2(&stream, gzipWindowBits), Z_OK);
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast,cppcoreguidelines-pro-type-reinterpret-cast)
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+        stream.avail_in = static_cast<uInt>(compressed.size());
+
+        std::string output;
+        int result = Z_OK;
+
+        while (result == Z_OK)
+        {
+            const auto written = output.size();
+            output.resize(written + chunkSize);
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            stream.next_out = reinterpret_cast<Bytef*>(output.data() + written);
+            stream.avail_out = static_cast<uInt>(chunkSize);
+            result = inflate(&stream, Z_NO_FLUSH);
+            output.resize(output.size() - stream.avail_out);
+        }
+
+        EXPECT_EQ(result, Z_STREAM_END);
+        inflateEnd(&stream);
+        return output;
+    }
+
+    boost::asio::awaitable<void> WriteDone()
+    {
+        co_return;
+    }
+
+    std::string RepeatedEvents(int count)
+    {
+        std::string events;
+        for (int i = 0; i < count; ++i)
+        {
+            events += R"({"event":{"original":"Jan 01 00:00:00 host sshd[)" + std::to_string(i) +
+                      R"(]: Accepted publickey"}})" + "\n";
+        }
+        return events;
+    }
+} // namespace
+
 class HttpClientTest : public TestWithParam<boost::beast::http::status>
 {
 protected:
@@ -330,6 +385,402 @@ TEST_F(HttpClientTest, Co_PerformHttpRequest_OnSuccessNotCalledIfAsyncReadFails)
     EXPECT_EQ(std::get<1>(res), "Internal server error: Error handling response: Bad address");
 }
 
+TEST_F(HttpClientTest, Co_PerformHttpRequest_ReusesKeepAliveConnection)
+{
+    SetupMockResolverFactory();
+    SetupMockSocketFactory();
+    SetupMockResolverExpectations();
+    SetupMockSocketConnectExpectations();
+    EXPECT_CALL(*mockSocket, SetVerificationMode("localhost", "full")).Times(1);
+    EXPECT_CALL(*mockSocket, AsyncWrite(_, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([](const boost::beast::http::request<boost::beast::http::string_body>&,
+                                  boost::system::error_code&) -> boost::asio::awaitable<void> { co_return; }));
+    EXPECT_CALL(*mockSocket, AsyncRead(_, _))
+        .Times(2)
+        .WillRepeatedly(Invoke(
+            [](auto& res, boost::system::error_code&) -> boost::asio::awaitable<void>
+            {
+                res.result(boost::beast::http::status::ok);
+                co_return;
+            }));
+    EXPECT_CALL(*mockSocket, Shutdown(_)).Times(0);
+
+    const http_client::HttpRequestParams params(
+        http_client::MethodType::GET, "https://localhost:8080", "/test", "Wazuh 6.0.0", "full");
+
+    std::vector<int> statusCodes;
+
+    boost::asio::io_context ioContext;
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            for (int i = 0; i < 2; ++i)
+            {
+                const auto value = co_await client->Co_PerformHttpRequest(params);
+                statusCodes.push_back(std::get<0>(value));
+            }
+        },
+        boost::asio::detached);
+
+    ioContext.run();
+
+    EXPECT_THAT(statusCodes, ElementsAre(http_client::HTTP_CODE_OK, http_client::HTTP_CODE_OK));
+}
+
+TEST_F(HttpClientTest, Co_PerformHttpRequest_RetriesOnNewConnectionIfReusedOneFails)
+{
+    auto newSocket = std::make_unique<MockHttpSocket>();
+    auto* newSocketPtr = newSocket.get();
+
+    SetupMockResolverFactory();
+    SetupMockResolverExpectations();
+    EXPECT_CALL(*mockSocketFactory, Create(_, _))
+        .WillOnce(Invoke([this](const auto&, const bool) -> std::unique_ptr<http_client::IHttpSocket>
+                         { return std::move(mockSocket); }))
+        .WillOnce(Invoke([&newSocket](const auto&, const bool) -> std::unique_ptr<http_client::IHttpSocket>
+                         { return std::move(newSocket); }));
+
+    SetupMockSocketConnectExpectations();
+    EXPECT_CALL(*mockSocket, AsyncWrite(_, _))
+        .WillOnce(Invoke([](const boost::beast::http::request<boost::beast::http::string_body>&,
+                            boost::system::error_code&) -> boost::asio::awaitable<void> { co_return; }))
+        .WillOnce(Invoke(
+            [](const boost::beast::http::request<boost::beast::http::string_body>&,
+               boost::system::error_code& ec) -> boost::asio::awaitable<void>
+            {
+                ec = boost::asio::error::broken_pipe;
+                co_return;
+            }));
+    SetupMockSocketReadExpectations(boost::beast::http::status::ok);
+
+    // the endpoints resolved for the first request are reused
+    EXPECT_CALL(*newSocketPtr, AsyncConnect(_, _))
+        .WillOnce(Invoke([](const boost::asio::ip::tcp::resolver::results_type&,
+                            boost::system::error_code&) -> boost::asio::awaitable<void> { co_return; }));
+    EXPECT_CALL(*newSocketPtr, AsyncWrite(_, _))
+        .WillOnce(Invoke([](const boost::beast::http::request<boost::beast::http::string_body>&,
+                            boost::system::error_code&) -> boost::asio::awaitable<void> { co_return; }));
+    EXPECT_CALL(*newSocketPtr, AsyncRead(_, _))
+        .WillOnce(Invoke(
+            [](auto& res, boost::system::error_code&) -> boost::asio::awaitable<void>
+            {
+                res.result(boost::beast::http::status::created);
+                co_return;
+            }));
+
+    const http_client::HttpRequestParams params(
+        http_client::MethodType::GET, "https://localhost:8080", "/test", "Wazuh 6.0.0", "full");
+
+    std::vector<int> statusCodes;
+
+    boost::asio::io_context ioContext;
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            for (int i = 0; i < 2; ++i)
+            {
+                const auto value = co_await client->Co_PerformHttpRequest(params);
+                statusCodes.push_back(std::get<0>(value));
+            }
+        },
+        boost::asio::detached);
+
+    ioContext.run();
+
+    EXPECT_THAT(statusCodes, ElementsAre(http_client::HTTP_CODE_OK, http_client::HTTP_CODE_CREATED));
+}
+
+TEST_F(HttpClientTest, Co_PerformHttpRequest_RetriesOnNewConnectionIfReusedOneWasClosedBeforeResponse)
+{
+    auto newSocket = std::make_unique<MockHttpSocket>();
+    auto* newSocketPtr = newSocket.get();
+
+    SetupMockResolverFactory();
+    SetupMockResolverExpectations();
+    EXPECT_CALL(*mockSocketFactory, Create(_, _))
+        .WillOnce(Invoke([this](const auto&, const bool) -> std::unique_ptr<http_client::IHttpSocket>
+                         { return std::move(mockSocket); }))
+        .WillOnce(Invoke([&newSocket](const auto&, const bool) -> std::unique_ptr<http_client::IHttpSocket>
+                         { return std::move(newSocket); }));
+
+    SetupMockSocketConnectExpectations();
+    EXPECT_CALL(*mockSocket, AsyncWrite(_, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([](const boost::beast::http::request<boost::beast::http::string_body>&,
+                                  boost::system::error_code&) -> boost::asio::awaitable<void> { co_return; }));
+    EXPECT_CALL(*mockSocket, AsyncRead(_, _))
+        .WillOnce(Invoke(
+            [](auto& res, boost::system::error_code&) -> boost::asio::awaitable<void>
+            {
+                res.result(boost::beast::http::status::ok);
+                co_return;
+            }))
+        .WillOnce(Invoke(
+            [](auto&, boost::system::error_code& ec) -> boost::asio::awaitable<void>
+            {
+                ec = boost::beast::http::error::end_of_stream;
+                co_return;
+            }));
+
+    EXPECT_CALL(*newSocketPtr, AsyncConnect(_, _))
+        .WillOnce(Invoke([](const boost::asio::ip::tcp::resolver::results_type&,
+                            boost::system::error_code&) -> boost::asio::awaitable<void> { co_return; }));
+    EXPECT_CALL(*newSocketPtr, AsyncWrite(_, _))
+        .WillOnce(Invoke([](const boost::beast::http::request<boost::beast::http::string_body>&,
+                            boost::system::error_code&) -> boost::asio::awaitable<void> { co_return; }));
+    EXPECT_CALL(*newSocketPtr, AsyncRead(_, _))
+        .WillOnce(Invoke(
+            [](auto& res, boost::system::error_code&) -> boost::asio::awaitable<void>
+            {
+                res.result(boost::beast::http::status::created);
+                co_return;
+            }));
+
+    const http_client::HttpRequestParams params(
+        http_client::MethodType::POST, "https://localhost:8080", "/test", "Wazuh 6.0.0", "full", "", "", "body");
+
+    std::vector<int> statusCodes;
+
+    boost::asio::io_context ioContext;
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            for (int i = 0; i < 2; ++i)
+            {
+                const auto value = co_await client->Co_PerformHttpRequest(params);
+                statusCodes.push_back(std::get<0>(value));
+            }
+        },
+        boost::asio::detached);
+
+    ioContext.run();
+
+    EXPECT_THAT(statusCodes, ElementsAre(http_client::HTTP_CODE_OK, http_client::HTTP_CODE_CREATED));
+}
+
+TEST_F(HttpClientTest, Co_PerformHttpRequest_DoesNotResendIfReusedConnectionFailsAfterWrite)
+{
+    SetupMockResolverFactory();
+    SetupMockSocketFactory();
+    SetupMockResolverExpectations();
+    SetupMockSocketConnectExpectations();
+    EXPECT_CALL(*mockSocket, AsyncWrite(_, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([](const boost::beast::http::request<boost::beast::http::string_body>&,
+                                  boost::system::error_code&) -> boost::asio::awaitable<void> { co_return; }));
+    EXPECT_CALL(*mockSocket, AsyncRead(_, _))
+        .WillOnce(Invoke(
+            [](auto& res, boost::system::error_code&) -> boost::asio::awaitable<void>
+            {
+                res.result(boost::beast::http::status::ok);
+                co_return;
+            }))
+        .WillOnce(Invoke(
+            [](auto&, boost::system::error_code& ec) -> boost::asio::awaitable<void>
+            {
+                ec = boost::asio::error::connection_reset;
+                co_return;
+            }));
+
+    // The server may have received the batch already, it is not sent again on a new connection
+    const http_client::HttpRequestParams params(
+        http_client::MethodType::POST, "https://localhost:8080", "/test", "Wazuh 6.0.0", "full", "", "", "body");
+
+    std::vector<int> statusCodes;
+
+    boost::asio::io_context ioContext;
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            for (int i = 0; i < 2; ++i)
+            {
+                const auto value = co_await client->Co_PerformHttpRequest(params);
+                statusCodes.push_back(std::get<0>(value));
+            }
+        },
+        boost::asio::detached);
+
+    ioContext.run();
+
+    EXPECT_THAT(statusCodes, ElementsAre(http_client::HTTP_CODE_OK, http_client::HTTP_CODE_INTERNAL_SERVER_ERROR));
+}
+
+TEST_F(HttpClientTest, Co_PerformHttpRequest_ClosesConnectionIfNotKeepAlive)
+{
+    SetupMockResolverFactory();
+    SetupMockSocketFactory();
+    SetupMockResolverExpectations();
+    SetupMockSocketConnectExpectations();
+    SetupMockSocketWriteExpectations();
+    EXPECT_CALL(*mockSocket, AsyncRead(_, _))
+        .WillOnce(Invoke(
+            [](auto& res, boost::system::error_code&) -> boost::asio::awaitable<void>
+            {
+                res.result(boost::beast::http::status::ok);
+                res.keep_alive(false);
+                co_return;
+            }));
+    EXPECT_CALL(*mockSocket, Shutdown(_)).Times(1);
+
+    const http_client::HttpRequestParams params(
+        http_client::MethodType::GET, "https://localhost:8080", "/test", "Wazuh 6.0.0", "full");
+
+    int statusCode = 0;
+
+    boost::asio::io_context ioContext;
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        { statusCode = std::get<0>(co_await client->Co_PerformHttpRequest(params)); },
+        boost::asio::detached);
+
+    ioContext.run();
+
+    EXPECT_EQ(statusCode, http_client::HTTP_CODE_OK);
+}
+
+TEST(GzipCompressTest, RoundTripsBody)
+{
+    const auto body = RepeatedEvents(10000);
+
+    const auto compressed = http_client::GzipCompress(body, Z_DEFAULT_COMPRESSION);
+
+    ASSERT_TRUE(compressed.has_value());
+    EXPECT_LT(compressed->size(), body.size() / 5);
+    EXPECT_EQ(GzipDecompress(*compressed), body);
+}
+
+TEST(GzipCompressTest, CompressesEmptyBody)
+{
+    const auto compressed = http_client::GzipCompress("", 1);
+
+    ASSERT_TRUE(compressed.has_value());
+    EXPECT_EQ(GzipDecompress(*compressed), "");
+}
+
+TEST(GzipCompressTest, FailsWithInvalidLevel)
+{
+    EXPECT_FALSE(http_client::GzipCompress("body", 42).has_value());
+}
+
+TEST_F(HttpClientTest, Co_PerformHttpRequest_SendsBodyUncompressedByDefault)
+{
+    SetupMockResolverFactory();
+    SetupMockSocketFactory();
+    SetupMockResolverExpectations();
+    SetupMockSocketConnectExpectations();
+    SetupMockSocketReadExpectations(boost::beast::http::status::ok);
+
+    boost::beast::http::request<boost::beast::http::string_body> sentRequest;
+    EXPECT_CALL(*mockSocket, AsyncWrite(_, _))
+        .WillOnce(Invoke(
+            [&sentRequest](const boost::beast::http::request<boost::beast::http::string_body>& req,
+                           boost::system::error_code&) -> boost::asio::awaitable<void>
+            {
+                sentRequest = req;
+                return WriteDone();
+            }));
+
+    const auto body = RepeatedEvents(100);
+    const http_client::HttpRequestParams params(
+        http_client::MethodType::POST, "http://localhost:8080", "/test", "Wazuh 6.0.0", "full", "", "", body);
+
+    boost::asio::io_context ioContext;
+    boost::asio::co_spawn(ioContext, client->Co_PerformHttpRequest(params), boost::asio::detached);
+    ioContext.run();
+
+    EXPECT_EQ(sentRequest.count(boost::beast::http::field::content_encoding), 0);
+    EXPECT_EQ(sentRequest[boost::beast::http::field::content_length], std::to_string(body.size()));
+    EXPECT_EQ(sentRequest.body(), body);
+}
+
+TEST_F(HttpClientTest, Co_PerformHttpRequest_LeavesCompressionToCompressBody)
+{
+    SetupMockResolverFactory();
+    SetupMockSocketFactory();
+    SetupMockResolverExpectations();
+    SetupMockSocketConnectExpectations();
+    SetupMockSocketReadExpectations(boost::beast::http::status::ok);
+
+    boost::beast::http::request<boost::beast::http::string_body> sentRequest;
+    EXPECT_CALL(*mockSocket, AsyncWrite(_, _))
+        .WillOnce(Invoke(
+            [&sentRequest](const boost::beast::http::request<boost::beast::http::string_body>& req,
+                           boost::system::error_code&) -> boost::asio::awaitable<void>
+            {
+                sentRequest = req;
+                return WriteDone();
+            }));
+
+    const auto body = RepeatedEvents(100);
+    http_client::HttpRequestParams params(
+        http_client::MethodType::POST, "http://localhost:8080", "/test", "Wazuh 6.0.0", "full", "", "", body);
+    params.CompressionLevel = 6;
+
+    boost::asio::io_context ioContext;
+    boost::asio::co_spawn(ioContext, client->Co_PerformHttpRequest(params), boost::asio::detached);
+    ioContext.run();
+
+    // The body is only compressed by CompressBody, the request sends what it is given
+    EXPECT_EQ(sentRequest.count(boost::beast::http::field::content_encoding), 0);
+    EXPECT_EQ(sentRequest.body(), body);
+}
+
+TEST_F(HttpClientTest, Co_PerformHttpRequest_SendsPrecompressedBodyAsIs)
+{
+    SetupMockResolverFactory();
+    SetupMockSocketFactory();
+    SetupMockResolverExpectations();
+    SetupMockSocketConnectExpectations();
+    SetupMockSocketReadExpectations(boost::beast::http::status::ok);
+
+    boost::beast::http::request<boost::beast::http::string_body> sentRequest;
+    EXPECT_CALL(*mockSocket, AsyncWrite(_, _))
+        .WillOnce(Invoke(
+            [&sentRequest](const boost::beast::http::request<boost::beast::http::string_body>& req,
+                           boost::system::error_code&) -> boost::asio::awaitable<void>
+            {
+                sentRequest = req;
+                return WriteDone();
+            }));
+
+    const auto body = RepeatedEvents(100);
+    http_client::HttpRequestParams params(
+        http_client::MethodType::POST, "http://localhost:8080", "/test", "Wazuh 6.0.0", "full", "", "", body);
+    params.CompressionLevel = 6;
+    params.CompressBody();
+
+    ASSERT_EQ(params.ContentEncoding, "gzip");
+    ASSERT_EQ(params.CompressionLevel, 0);
+    const auto compressedBody = params.Body;
+
+    boost::asio::io_context ioContext;
+    boost::asio::co_spawn(ioContext, client->Co_PerformHttpRequest(params), boost::asio::detached);
+    ioContext.run();
+
+    EXPECT_EQ(sentRequest[boost::beast::http::field::content_encoding], "gzip");
+    EXPECT_EQ(sentRequest[boost::beast::http::field::content_type], "application/json");
+    EXPECT_EQ(sentRequest[boost::beast::http::field::content_length], std::to_string(compressedBody.size()));
+    EXPECT_LT(compressedBody.size(), body.size());
+    EXPECT_EQ(sentRequest.body(), compressedBody);
+    EXPECT_EQ(GzipDecompress(sentRequest.body()), body);
+}
+
+TEST(HttpRequestParamsTest, CompressBodyKeepsBodyIfCompressionDisabled)
+{
+    http_client::HttpRequestParams params(
+        http_client::MethodType::POST, "http://localhost:8080", "/test", "Wazuh 6.0.0", "full", "", "", "body");
+    params.CompressBody();
+
+    EXPECT_EQ(params.Body, "body");
+    EXPECT_TRUE(params.ContentEncoding.empty());
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -9,7 +9,7 @@ class MockHttpClient : public http_client::IHttpClient
 public:
     MOCK_METHOD((boost::asio::awaitable<std::tuple<int, std::string>>),
                 Co_PerformHttpRequest,
-                (const http_client::HttpRequestParams params),
+                (http_client::HttpRequestParams params),
                 (override));
 
     MOCK_METHOD((std::tuple<int, std::string>),
@@ -4,6 +4,7 @@
 
 #include <boost/asio/awaitable.hpp>
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -41,27 +42,71 @@ public:
     /// @return Message The next message from the queue.
     virtual Message getNext(MessageType type, const std::string moduleName = "", const std::string moduleType = "") = 0;
 
+    /// @brief Waits until the queue holds the given bytes of messages, or the batch interval elapses.
+    /// @param type The type of the queue to wait on.
+    /// @param messageQuantity In bytes of messages.
+    /// @param skippedBytes If set, returns the bytes of stored messages that do not count towards the quantity,
+    /// such as those already sent and not yet acknowledged. It is checked again whenever the queue changes.
+    /// @return boost::asio::awaitable<bool> True if the queue holds the given bytes when resuming.
+    virtual boost::asio::awaitable<bool> waitForBytesAwaitable(MessageType type,
+                                                               const size_t messageQuantity,
+                                                               const std::function<size_t()>& skippedBytes) = 0;
+
     /// @brief Retrieves the next Bytes of messages from the queue asynchronously.
     /// @param type The type of the queue to use as the source.
     /// @param messageQuantity In bytes of messages.
     /// @param moduleName The name of the module requesting the message.
     /// @param moduleType The type of the module requesting the messages.
+    /// @param afterRowId Only messages stored with a greater row id are returned.
     /// @return boost::asio::awaitable<std::vector<Message>> Awaitable object representing the next N messages.
     virtual boost::asio::awaitable<std::vector<Message>> getNextBytesAwaitable(MessageType type,
                                                                                const size_t messageQuantity,
                                                                                const std::string moduleName = "",
-                                                                               const std::string moduleType = "") = 0;
+                                                                               const std::string moduleType = "",
+                                                                               const int64_t afterRowId = 0) = 0;
+
+    /// @brief Retrieves the next Bytes of messages from the queue asynchronously, serialized as a batch body.
+    /// @param type The type of the queue to use as the source.
+    /// @param messageQuantity In bytes of messages.
+    /// @param body Start of the batch body, the messages are appended to it.
+    /// @param moduleName The name of the module requesting the messages.
+    /// @param moduleType The type of the module requesting the messages.
+    /// @param afterRowId Only messages stored with a greater row id are returned.
+    /// @return boost::asio::awaitable<MessageBatch> Awaitable object representing the batch.
+    virtual boost::asio::awaitable<MessageBatch> getNextBatchAwaitable(MessageType type,
+                                                                       const size_t messageQuantity,
+                                                                       std::string body,
+                                                                       const std::string moduleName = "",
+                                                                       const std::string moduleType = "",
+                                                                       const int64_t afterRowId = 0) = 0;
+
+    /// @brief Retrieves the next Bytes of messages from the queue, serialized as a batch body.
+    /// @param type The type of the queue to use as the source.
+    /// @param messageQuantity The quantity of bytes of messages to return.
+    /// @param body Start of the batch body, the messages are appended to it.
+    /// @param moduleName The name of the module requesting the messages.
+    /// @param moduleType The type of the module requesting the messages.
+    /// @param afterRowId Only messages stored with a greater row id are returned.
+    /// @return MessageBatch The batch of messages fetched from the queue.
+    virtual MessageBatch getNextBatch(MessageType type,
+                                      const size_t messageQuantity,
+                                      std::string body,
+                                      const std::string moduleName = "",
+                                      const std::string moduleType = "",
+                                      const int64_t afterRowId = 0) = 0;
 
     /// @brief Retrieves the next N messages from the queue.
     /// @param type The type of the queue to use as the source.
     /// @param messageQuantity The quantity of bytes of messages to return.
     /// @param moduleName The name of the module requesting the messages.
     /// @param moduleType The type of the module requesting the messages.
+    /// @param afterRowId Only messages stored with a greater row id are returned.
     /// @return std::vector<Message> A vector of messages fetched from the queue.
     virtual std::vector<Message> getNextBytes(MessageType type,
                                               const size_t messageQuantity,
                                               const std::string moduleName = "",
-                                              const std::string moduleType = "") = 0;
+                                              const std::string moduleType = "",
+                                              const int64_t afterRowId = 0) = 0;
 
     /// @brief Deletes a message from the queue.
     /// @param type The type of the queue from which to pop the message.
@@ -82,6 +127,17 @@ public:
                      const std::string moduleName = "",
                      const std::string moduleType = "") = 0;
 
+    /// @brief Deletes the messages within a range of positions from the queue.
+    /// @param type The type of the queue from which to pop the messages.
+    /// @param range The range of positions, as reported by the retrieved messages.
+    /// @param moduleName The name of the module requesting the pop.
+    /// @param moduleType The type of the module requesting the pop.
+    /// @return int The number of messages deleted.
+    virtual int popRange(MessageType type,
+                         const MessageRange& range,
+                         const std::string moduleName = "",
+                         const std::string moduleType = "") = 0;
+
     /// @brief Checks if a queue is empty.
     /// @param type The type of the queue.
     /// @param moduleName The name of the module requesting the check.
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <message.hpp>
+
 #include <nlohmann/json.hpp>
 
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -42,6 +45,19 @@ public:
                                const std::string& moduleName = "",
                                const std::string& moduleType = "") = 0;
 
+    /// @brief Remove the messages stored within an inclusive range of row ids.
+    /// @param firstRowId The row id of the first message to remove.
+    /// @param lastRowId The row id of the last message to remove.
+    /// @param tableName The name of the table to remove the messages from.
+    /// @param moduleName The name of the module that created the message.
+    /// @param moduleType The module type that created the message.
+    /// @return The number of removed elements.
+    virtual int RemoveRange(int64_t firstRowId,
+                            int64_t lastRowId,
+                            const std::string& tableName,
+                            const std::string& moduleName = "",
+                            const std::string& moduleType = "") = 0;
+
     /// @brief Retrieve multiple JSON messages.
     /// @param n The number of messages to retrieve.
     /// @param tableName The name of the table to retrieve the message from.
@@ -58,11 +74,30 @@ public:
     /// @param tableName The name of the table to retrieve the message from.
     /// @param moduleName The name of the module.
     /// @param moduleType The type of the module.
+    /// @param afterRowId Only messages stored with a greater row id are retrieved.
     /// @return nlohmann::json The retrieved JSON messages.
     virtual nlohmann::json RetrieveBySize(size_t n,
                                           const std::string& tableName,
                                           const std::string& moduleName = "",
-                                          const std::string& moduleType = "") = 0;
+                                          const std::string& moduleType = "",
+                                          int64_t afterRowId = 0) = 0;
+
+    /// @brief Retrieve multiple messages based on size from the specified queue, serialized as a batch body.
+    /// @details The stored text of each message is appended as is, without parsing it: its metadata and its data
+    /// go on their own lines, empty metadata and empty objects as data are left out.
+    /// @param n size occupied by the messages to be retrieved.
+    /// @param body Start of the batch body, the messages are appended to it.
+    /// @param tableName The name of the table to retrieve the message from.
+    /// @param moduleName The name of the module.
+    /// @param moduleType The type of the module.
+    /// @param afterRowId Only messages stored with a greater row id are retrieved.
+    /// @return MessageBatch The batch body, the number of messages in it and their row ids.
+    virtual MessageBatch RetrieveBatchBySize(size_t n,
+                                             std::string body,
+                                             const std::string& tableName,
+                                             const std::string& moduleName = "",
+                                             const std::string& moduleType = "",
+                                             int64_t afterRowId = 0) = 0;
 
     /// @brief Get the number of elements in the table.
     /// @param tableName The name of the table to retrieve the message from.
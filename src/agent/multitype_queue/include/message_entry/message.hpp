@@ -2,7 +2,10 @@
 
 #include <nlohmann/json.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <utility>
 
 /// @brief Types of messages enum
 enum class MessageType
@@ -12,6 +15,34 @@ enum class MessageType
     COMMAND
 };
 
+/// @brief Inclusive range of stored row ids backing a batch of messages retrieved from a queue.
+///
+/// Used to acknowledge exactly the rows that were delivered, regardless of what was pushed afterwards.
+struct MessageRange
+{
+    /// @brief Row id of the first message of the batch
+    int64_t first = 0;
+
+    /// @brief Row id of the last message of the batch
+    int64_t last = 0;
+};
+
+/// @brief Messages retrieved from a queue already serialized as the body of a batch request.
+struct MessageBatch
+{
+    /// @brief The batch body, with the metadata and the data of each message on their own lines
+    std::string body;
+
+    /// @brief Number of messages in the body
+    int count = 0;
+
+    /// @brief Row ids backing the messages, only meaningful when count is not 0
+    MessageRange range;
+
+    /// @brief Bytes the messages account for in the queue size
+    size_t size = 0;
+};
+
 /// @brief Wrapper for Message, contains the message type, the json data, the
 /// module name, the module type and the metadata.
 class Message
@@ -23,6 +54,9 @@ public:
     std::string moduleType;
     std::string metaData;
 
+    /// @brief Row id of the message once stored in a queue, 0 if it has not been stored. Not part of equality.
+    int64_t rowId = 0;
+
     /// @brief Constructor
     /// @param t The type of the message
     /// @param d The json data
@@ -31,10 +65,10 @@ public:
     /// @param mD The metadata
     Message(MessageType t, nlohmann::json d, std::string mN = "", std::string mT = "", std::string mD = "")
         : type(t)
-        , data(d)
-        , moduleName(mN)
-        , moduleType(mT)
-        , metaData(mD)
+        , data(std::move(d))
+        , moduleName(std::move(mN))
+        , moduleType(std::move(mT))
+        , metaData(std::move(mD))
     {
     }
 
@@ -5,9 +5,12 @@
 #include <istorage.hpp>
 
 #include <boost/asio/awaitable.hpp>
+#include <boost/asio/steady_timer.hpp>
 
 #include <chrono>
 #include <condition_variable>
+#include <functional>
+#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -55,6 +58,42 @@ private:
     /// @brief Time between batch requests
     std::time_t m_batchInterval;
 
+    /// @brief A coroutine waiting for a queue to change
+    struct Waiter
+    {
+        /// @brief Timer the coroutine waits on, expiring at its deadline. Cancelling it wakes the coroutine up.
+        std::shared_ptr<boost::asio::steady_timer> timer;
+
+        /// @brief Condition the coroutine is waiting for
+        std::function<bool()> isReady;
+    };
+
+    /// @brief mutex protecting the waiters
+    std::mutex m_waitersMtx;
+
+    /// @brief coroutines waiting for changes on each queue
+    std::map<MessageType, std::list<std::shared_ptr<Waiter>>> m_waiters;
+
+    /// @brief Suspends the calling coroutine until a condition holds or a deadline expires.
+    /// @details The condition is checked again only when the queue is notified of a change.
+    /// @param type The type of the queue to wait on.
+    /// @param isReady The condition to wait for.
+    /// @param deadline The time point after which the coroutine resumes anyway.
+    /// @return boost::asio::awaitable<bool> True if the condition holds when resuming.
+    boost::asio::awaitable<bool> waitUntil(MessageType type,
+                                           const std::function<bool()>& isReady,
+                                           std::chrono::steady_clock::time_point deadline);
+
+    /// @brief Registers a waiter and waits on its timer. Runs on the strand of the waiter timer.
+    /// @param type The type of the queue to wait on.
+    /// @param waiter The waiter to register.
+    /// @return boost::asio::awaitable<bool> True if the waiter condition holds when resuming.
+    boost::asio::awaitable<bool> waitForNotification(MessageType type, std::shared_ptr<Waiter> waiter);
+
+    /// @brief Wakes up the coroutines waiting on a queue whose condition holds.
+    /// @param type The type of the queue that changed.
+    void notifyWaiters(MessageType type);
+
 public:
     /// @brief Constructor
     /// @param configurationParser Pointer to the configuration parser
@@ -89,17 +128,40 @@ public:
     /// @copydoc IMultiTypeQueue::getNext
     Message getNext(MessageType type, const std::string moduleName = "", const std::string moduleType = "") override;
 
+    /// @copydoc IMultiTypeQueue::waitForBytesAwaitable
+    boost::asio::awaitable<bool> waitForBytesAwaitable(MessageType type,
+                                                       const size_t messageQuantity,
+                                                       const std::function<size_t()>& skippedBytes) override;
+
     /// @copydoc IMultiTypeQueue::getNextBytesAwaitable
     boost::asio::awaitable<std::vector<Message>> getNextBytesAwaitable(MessageType type,
                                                                        const size_t messageQuantity,
                                                                        const std::string moduleName = "",
-                                                                       const std::string moduleType = "") override;
+                                                                       const std::string moduleType = "",
+                                                                       const int64_t afterRowId = 0) override;
 
     /// @copydoc IMultiTypeQueue::getNextBytes
     std::vector<Message> getNextBytes(MessageType type,
                                       const size_t messageQuantity,
                                       const std::string moduleName = "",
-                                      const std::string moduleType = "") override;
+                                      const std::string moduleType = "",
+                                      const int64_t afterRowId = 0) override;
+
+    /// @copydoc IMultiTypeQueue::getNextBatchAwaitable
+    boost::asio::awaitable<MessageBatch> getNextBatchAwaitable(MessageType type,
+                                                               const size_t messageQuantity,
+                                                               std::string body,
+                                                               const std::string moduleName = "",
+                                                               const std::string moduleType = "",
+                                                               const int64_t afterRowId = 0) override;
+
+    /// @copydoc IMultiTypeQueue::getNextBatch
+    MessageBatch getNextBatch(MessageType type,
+                              const size_t messageQuantity,
+                              std::string body,
+                              const std::string moduleName = "",
+                              const std::string moduleType = "",
+                              const int64_t afterRowId = 0) override;
 
     /// @copydoc IMultiTypeQueue::pop
     bool pop(MessageType type, const std::string moduleName = "", const std::string moduleType = "") override;
@@ -110,6 +172,12 @@ public:
              const std::string moduleName = "",
              const std::string moduleType = "") override;
 
+    /// @copydoc IMultiTypeQueue::popRange
+    int popRange(MessageType type,
+                 const MessageRange& range,
+                 const std::string moduleName = "",
+                 const std::string moduleType = "") override;
+
     /// @copydoc IMultiTypeQueue::isEmpty
     bool isEmpty(MessageType type, const std::string moduleName = "", const std::string moduleType = "") override;
 
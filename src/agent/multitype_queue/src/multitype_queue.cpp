@@ -4,6 +4,7 @@
 
 #include <boost/asio.hpp>
 #include <logger.hpp>
+#include <algorithm>
 #include <utility>
 
 namespace
@@ -12,6 +13,7 @@ namespace
     constexpr auto MAX_BATCH_INTERVAL = 60 * 60 * 1000;
     constexpr auto MIN_QUEUE_SIZE = 1000;
     constexpr auto MAX_QUEUE_SIZE = 60 * 60 * 1000;
+    constexpr auto MAX_COMMIT_INTERVAL = 60 * 1000;
 } // namespace
 
 MultiTypeQueue::MultiTypeQueue(std::shared_ptr<configuration::ConfigurationParser> configurationParser,
@@ -31,6 +33,12 @@ MultiTypeQueue::MultiTypeQueue(std::shared_ptr<configuration::ConfigurationParse
 
     const auto dbFolderPath = configurationParser->GetConfigOrDefault(config::DEFAULT_DATA_PATH, "agent", "path.data");
 
+    const auto commitInterval = configurationParser->GetTimeConfigInRangeOrDefault(
+        config::agent::QUEUE_DEFAULT_COMMIT_INTERVAL, 0, MAX_COMMIT_INTERVAL, "agent", "queue_commit_interval");
+
+    const auto commitSize = configurationParser->GetConfigInRangeOrDefault<size_t>(
+        config::agent::QUEUE_DEFAULT_COMMIT_SIZE, 1, m_maxItems, "agent", "queue_commit_size");
+
     try
     {
         if (persistenceDest)
@@ -39,7 +47,8 @@ MultiTypeQueue::MultiTypeQueue(std::shared_ptr<configuration::ConfigurationParse
         }
         else
         {
-            m_persistenceDest = std::make_unique<Storage>(dbFolderPath, m_vMessageTypeStrings);
+            m_persistenceDest = std::make_unique<Storage>(
+                dbFolderPath, m_vMessageTypeStrings, nullptr, std::chrono::milliseconds(commitInterval), commitSize);
         }
     }
     catch (const std::exception& e)
@@ -73,7 +82,7 @@ int MultiTypeQueue::push(Message message, bool shouldWait)
         const auto spaceAvailable = (m_maxItems > storedMessages) ? m_maxItems - storedMessages : 0;
         if (spaceAvailable)
         {
-            auto messageData = message.data;
+            const auto& messageData = message.data;
             if (messageData.is_array())
             {
                 if (messageData.size() <= spaceAvailable)
@@ -95,6 +104,8 @@ int MultiTypeQueue::push(Message message, bool shouldWait)
                                                   message.metaData);
                 m_cv.notify_all();
             }
+
+            notifyWaiters(message.type);
         }
     }
     else
@@ -107,23 +118,21 @@ int MultiTypeQueue::push(Message message, bool shouldWait)
 boost::asio::awaitable<int> MultiTypeQueue::pushAwaitable(Message message)
 {
     int result = 0;
-    boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor);
 
     if (m_mapMessageTypeName.contains(message.type))
     {
         auto sMessageType = m_mapMessageTypeName.at(message.type);
 
-        while (static_cast<size_t>(m_persistenceDest->GetElementCount(sMessageType)) >= m_maxItems)
-        {
-            timer.expires_after(std::chrono::milliseconds(m_timeout));
-            co_await timer.async_wait(boost::asio::use_awaitable);
-        }
+        // Wait until the queue is not full
+        const std::function<bool()> spaceAvailable = [this, &sMessageType]()
+        { return static_cast<size_t>(m_persistenceDest->GetElementCount(sMessageType)) < m_maxItems; };
+        co_await waitUntil(message.type, spaceAvailable, std::chrono::steady_clock::time_point::max());
 
         const auto storedItems = static_cast<size_t>(m_persistenceDest->GetElementCount(sMessageType));
         const auto availableItems = (m_maxItems > storedItems) ? m_maxItems - storedItems : 0;
         if (availableItems)
         {
-            auto messageData = message.data;
+            const auto& messageData = message.data;
             if (messageData.is_array())
             {
                 if (messageData.size() <= availableItems)
@@ -145,6 +154,8 @@ boost::asio::awaitable<int> MultiTypeQueue::pushAwaitable(Message message)
                                                   message.metaData);
                 m_cv.notify_all();
             }
+
+            notifyWaiters(message.type);
         }
     }
     else
@@ -185,36 +196,50 @@ Message MultiTypeQueue::getNext(MessageType type, const std::string moduleName,
     return result;
 }
 
+boost::asio::awaitable<bool> MultiTypeQueue::waitForBytesAwaitable(MessageType type,
+                                                                   const size_t messageQuantity,
+                                                                   const std::function<size_t()>& skippedBytes)
+{
+    if (!m_mapMessageTypeName.contains(type))
+    {
+        LogError("Error didn't find the queue.");
+        co_return false;
+    }
+
+    //  waits for specified size stored, not counting the skipped messages
+    const std::function<bool()> batchReady = [this, type, messageQuantity, skippedBytes]()
+    {
+        const auto stored = sizePerType(type);
+        const auto skipped = skippedBytes ? std::min(skippedBytes(), stored) : 0;
+        return stored - skipped >= messageQuantity;
+    };
+    const auto sizeReached = co_await waitUntil(
+        type, batchReady, std::chrono::steady_clock::now() + std::chrono::milliseconds(m_batchInterval));
+
+    if (sizeReached)
+    {
+        LogDebug("Required size achieved: {}B", messageQuantity);
+    }
+    else
+    {
+        LogDebug("Timeout reached after {}ms", m_batchInterval);
+    }
+
+    co_return sizeReached;
+}
+
 boost::asio::awaitable<std::vector<Message>> MultiTypeQueue::getNextBytesAwaitable(MessageType type,
                                                                                    const size_t messageQuantity,
                                                                                    const std::string moduleName,
-                                                                                   const std::string moduleType)
+                                                                                   const std::string moduleType,
+                                                                                   const int64_t afterRowId)
 {
-    boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor);
-
     std::vector<Message> result;
     if (m_mapMessageTypeName.contains(type))
     {
-        //  waits for specified size stored
-        boost::asio::steady_timer batchTimeoutTimer(co_await boost::asio::this_coro::executor);
-        batchTimeoutTimer.expires_after(std::chrono::milliseconds(m_batchInterval));
-
-        while ((sizePerType(type) < messageQuantity) && (batchTimeoutTimer.expiry() > std::chrono::steady_clock::now()))
-        {
-            timer.expires_after(std::chrono::milliseconds(m_timeout));
-            co_await timer.async_wait(boost::asio::use_awaitable);
-        }
-
-        if (sizePerType(type) >= messageQuantity)
-        {
-            LogDebug("Required size achieved: {}B", messageQuantity);
-        }
-        else
-        {
-            LogDebug("Timeout reached after {}ms", m_batchInterval);
-        }
+        co_await waitForBytesAwaitable(type, messageQuantity, nullptr);
 
-        result = getNextBytes(type, messageQuantity, moduleName, moduleType);
+        result = getNextBytes(type, messageQuantity, moduleName, moduleType, afterRowId);
     }
     else
     {
@@ -226,18 +251,20 @@ boost::asio::awaitable<std::vector<Message>> MultiTypeQueue::getNextBytesAwaitab
 std::vector<Message> MultiTypeQueue::getNextBytes(MessageType type,
                                                   const size_t messageQuantity,
                                                   const std::string moduleName,
-                                                  const std::string moduleType)
+                                                  const std::string moduleType,
+                                                  const int64_t afterRowId)
 {
     std::vector<Message> result;
     if (m_mapMessageTypeName.contains(type))
     {
-        auto arrayData =
-            m_persistenceDest->RetrieveBySize(messageQuantity, m_mapMessageTypeName.at(type), moduleName, moduleType);
+        auto arrayData = m_persistenceDest->RetrieveBySize(
+            messageQuantity, m_mapMessageTypeName.at(type), moduleName, moduleType, afterRowId);
 
         for (auto singleJson : arrayData)
         {
-            result.emplace_back(
+            auto& message = result.emplace_back(
                 type, singleJson["data"], singleJson["moduleName"], singleJson["moduleType"], singleJson["metadata"]);
+            message.rowId = singleJson.value("rowId", int64_t {0});
         }
     }
     else
@@ -247,12 +274,52 @@ std::vector<Message> MultiTypeQueue::getNextBytes(MessageType type,
     return result;
 }
 
+boost::asio::awaitable<MessageBatch> MultiTypeQueue::getNextBatchAwaitable(MessageType type,
+                                                                           const size_t messageQuantity,
+                                                                           std::string body,
+                                                                           const std::string moduleName,
+                                                                           const std::string moduleType,
+                                                                           const int64_t afterRowId)
+{
+    MessageBatch result;
+    if (m_mapMessageTypeName.contains(type))
+    {
+        co_await waitForBytesAwaitable(type, messageQuantity, nullptr);
+
+        result = getNextBatch(type, messageQuantity, std::move(body), moduleName, moduleType, afterRowId);
+    }
+    else
+    {
+        LogError("Error didn't find the queue.");
+    }
+    co_return result;
+}
+
+MessageBatch MultiTypeQueue::getNextBatch(MessageType type,
+                                          const size_t messageQuantity,
+                                          std::string body,
+                                          const std::string moduleName,
+                                          const std::string moduleType,
+                                          const int64_t afterRowId)
+{
+    if (m_mapMessageTypeName.contains(type))
+    {
+        return m_persistenceDest->RetrieveBatchBySize(
+            messageQuantity, std::move(body), m_mapMessageTypeName.at(type), moduleName, moduleType, afterRowId);
+    }
+
+    LogError("Error didn't find the queue.");
+    return {};
+}
+
 bool MultiTypeQueue::pop(MessageType type, const std::string moduleName, const std::string moduleType)
 {
     bool result = false;
     if (m_mapMessageTypeName.contains(type))
     {
         result = m_persistenceDest->RemoveMultiple(1, m_mapMessageTypeName.at(type), moduleName, moduleType);
+        m_cv.notify_all();
+        notifyWaiters(type);
     }
     else
     {
@@ -271,6 +338,28 @@ int MultiTypeQueue::popN(MessageType type,
     {
         result =
             m_persistenceDest->RemoveMultiple(messageQuantity, m_mapMessageTypeName.at(type), moduleName, moduleType);
+        m_cv.notify_all();
+        notifyWaiters(type);
+    }
+    else
+    {
+        LogError("Error didn't find the queue.");
+    }
+    return result;
+}
+
+int MultiTypeQueue::popRange(MessageType type,
+                             const MessageRange& range,
+                             const std::string moduleName,
+                             const std::string moduleType)
+{
+    int result = 0;
+    if (m_mapMessageTypeName.contains(type))
+    {
+        result = m_persistenceDest->RemoveRange(
+            range.first, range.last, m_mapMessageTypeName.at(type), moduleName, moduleType);
+        m_cv.notify_all();
+        notifyWaiters(type);
     }
     else
     {
@@ -331,3 +420,69 @@ size_t MultiTypeQueue::sizePerType(MessageType type)
     }
     return false;
 }
+
+boost::asio::awaitable<bool> MultiTypeQueue::waitUntil(MessageType type,
+                                                       const std::function<bool()>& isReady,
+                                                       std::chrono::steady_clock::time_point deadline)
+{
+    if (isReady())
+    {
+        co_return true;
+    }
+
+    // The waiter runs on its own strand, so a wake up posted by a notifier can't be lost between
+    // registering the waiter and starting to wait on its timer
+    const auto strand = boost::asio::make_strand(co_await boost::asio::this_coro::executor);
+    auto waiter = std::make_shared<Waiter>(
+        Waiter {std::make_shared<boost::asio::steady_timer>(strand, deadline), isReady});
+
+    co_return co_await boost::asio::co_spawn(
+        strand, waitForNotification(type, std::move(waiter)), boost::asio::use_awaitable);
+}
+
+boost::asio::awaitable<bool> MultiTypeQueue::waitForNotification(MessageType type, std::shared_ptr<Waiter> waiter)
+{
+    {
+        const std::lock_guard<std::mutex> lock(m_waitersMtx);
+
+        if (waiter->isReady())
+        {
+            co_return true;
+        }
+
+        m_waiters[type].push_back(waiter);
+    }
+
+    boost::system::error_code ec;
+    co_await waiter->timer->async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+    const std::lock_guard<std::mutex> lock(m_waitersMtx);
+    m_waiters[type].remove(waiter);
+    co_return waiter->isReady();
+}
+
+void MultiTypeQueue::notifyWaiters(MessageType type)
+{
+    const std::lock_guard<std::mutex> lock(m_waitersMtx);
+
+    const auto it = m_waiters.find(type);
+    if (it == m_waiters.end())
+    {
+        return;
+    }
+
+    auto& waiters = it->second;
+    for (auto waiterIt = waiters.begin(); waiterIt != waiters.end();)
+    {
+        if ((*waiterIt)->isReady())
+        {
+            boost::asio::post((*waiterIt)->timer->get_executor(),
+                              [timer = (*waiterIt)->timer]() { timer->cancel(); });
+            waiterIt = waiters.erase(waiterIt);
+        }
+        else
+        {
+            ++waiterIt;
+        }
+    }
+}
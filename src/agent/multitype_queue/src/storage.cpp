@@ -6,6 +6,9 @@
 #include <persistence.hpp>
 #include <persistence_factory.hpp>
 
+#include <algorithm>
+#include <optional>
+
 using namespace column;
 
 namespace
@@ -19,52 +22,70 @@ namespace
     const std::string MODULE_TYPE_COLUMN_NAME = "module_type";
     const std::string METADATA_COLUMN_NAME = "metadata";
     const std::string MESSAGE_COLUMN_NAME = "message";
+    const std::string SIZE_COLUMN_NAME = "size";
 
-    nlohmann::json ProcessRequest(const std::vector<Row>& rows, size_t maxSize = 0)
+    /// @brief Converts a queue row into its JSON representation.
+    nlohmann::json ProcessRow(const Row& row)
     {
-        nlohmann::json messages = nlohmann::json::array();
-        size_t sizeAccum = 0;
+        const std::string& moduleNameString = row[0].Value;
+        const std::string& moduleTypeString = row[1].Value;
+        const std::string& metadataString = row[2].Value;
+        const std::string& dataString = row[3].Value;
+
+        nlohmann::json outputJson = {{"moduleName", ""},
+                                     {"moduleType", ""},
+                                     {"metadata", ""},
+                                     {"data", {}},
+                                     {"rowId", std::stoll(row[4].Value)}};
+
+        if (!dataString.empty())
+        {
+            outputJson["data"] = nlohmann::json::parse(dataString);
+        }
 
-        for (const auto& row : rows)
+        if (!metadataString.empty())
         {
-            const std::string moduleNameString = row[0].Value;
-            const std::string moduleTypeString = row[1].Value;
-            const std::string metadataString = row[2].Value;
-            const std::string dataString = row[3].Value;
+            outputJson["metadata"] = metadataString;
+        }
 
-            nlohmann::json outputJson = {{"moduleName", ""}, {"moduleType", ""}, {"metadata", ""}, {"data", {}}};
+        if (!moduleNameString.empty())
+        {
+            outputJson["moduleName"] = moduleNameString;
+        }
 
-            if (!dataString.empty())
-            {
-                outputJson["data"] = nlohmann::json::parse(dataString);
-            }
+        if (!moduleTypeString.empty())
+        {
+            outputJson["moduleType"] = moduleTypeString;
+        }
 
-            if (!metadataString.empty())
-            {
-                outputJson["metadata"] = metadataString;
-            }
+        return outputJson;
+    }
 
-            if (!moduleNameString.empty())
-            {
-                outputJson["moduleName"] = moduleNameString;
-            }
+    /// @brief Returns the bytes accounted for a queue row.
+    /// @details Uses the stored size column when present. Rows stored before that column existed
+    /// fall back to the length of their text fields.
+    size_t RowSize(const Row& row)
+    {
+        if (row.size() > 5 && !row[5].Value.empty())
+        {
+            return std::stoull(row[5].Value);
+        }
+        return row[0].Value.size() + row[1].Value.size() + row[2].Value.size() + row[3].Value.size();
+    }
 
-            if (!moduleTypeString.empty())
-            {
-                outputJson["moduleType"] = moduleTypeString;
-            }
+    /// @brief Returns the value of the size column, 0 if it is not set.
+    size_t SizeValue(const ColumnValue& col)
+    {
+        return col.Value.empty() ? 0 : std::stoull(col.Value);
+    }
 
-            messages.push_back(outputJson);
-            if (maxSize)
-            {
-                const size_t messageSize = moduleNameString.size() + moduleTypeString.size() + metadataString.size() +
-                                           outputJson["data"].dump().size();
-                if (sizeAccum + messageSize >= maxSize)
-                {
-                    break;
-                }
-                sizeAccum += messageSize;
-            }
+    nlohmann::json ProcessRequest(const std::vector<Row>& rows)
+    {
+        nlohmann::json messages = nlohmann::json::array();
+
+        for (const auto& row : rows)
+        {
+            messages.push_back(ProcessRow(row));
         }
 
         return messages;
@@ -73,7 +94,11 @@ namespace
 
 Storage::Storage(const std::string& dbFolderPath,
                  const std::vector<std::string>& tableNames,
-                 std::unique_ptr<Persistence> persistence)
+                 std::unique_ptr<Persistence> persistence,
+                 std::chrono::milliseconds commitInterval,
+                 size_t commitSize)
+    : m_commitInterval(commitInterval)
+    , m_commitSize(std::max<size_t>(commitSize, 1))
 {
     const auto dbFilePath = dbFolderPath + "/" + QUEUE_DB_NAME;
 
@@ -94,15 +119,186 @@ Storage::Storage(const std::string& dbFolderPath,
             {
                 CreateTable(table);
             }
+            else if (!m_db->ColumnExists(table, SIZE_COLUMN_NAME))
+            {
+                m_db->AddColumn(table, ColumnKey(SIZE_COLUMN_NAME, ColumnType::INTEGER));
+                BackfillSizes(table);
+            }
+
+            LoadTotals(table);
         }
     }
     catch (const std::exception&)
     {
         throw std::runtime_error(std::string("Cannot open database: " + dbFilePath));
     }
+
+    if (m_commitInterval.count() > 0)
+    {
+        m_commitThread = std::thread([this]() { RunCommitLoop(); });
+    }
 }
 
-Storage::~Storage() = default;
+Storage::~Storage()
+{
+    if (m_commitThread.joinable())
+    {
+        {
+            const std::unique_lock<std::mutex> lock(m_mutex);
+            m_stopCommitLoop = true;
+        }
+        m_commitCv.notify_all();
+        m_commitThread.join();
+    }
+
+    const std::unique_lock<std::mutex> lock(m_mutex);
+    CommitStaged();
+}
+
+void Storage::RunCommitLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (!m_stopCommitLoop)
+    {
+        m_commitCv.wait_for(lock, m_commitInterval, [this]() { return m_stopCommitLoop; });
+        CommitStaged();
+    }
+}
+
+int Storage::Stage(const nlohmann::json& message,
+                   const std::string& tableName,
+                   const std::string& moduleName,
+                   const std::string& moduleType,
+                   const std::string& metadata)
+{
+    const auto baseSize = moduleName.size() + moduleType.size() + metadata.size();
+
+    std::vector<StagedRow> rows;
+    size_t stagedBytes = 0;
+
+    const auto stageMessage = [&](const nlohmann::json& singleMessageData)
+    {
+        try
+        {
+            auto dataString = singleMessageData.dump();
+            const auto messageSize = baseSize + dataString.size();
+
+            Row fields;
+            fields.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT, moduleName);
+            fields.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT, moduleType);
+            fields.emplace_back(METADATA_COLUMN_NAME, ColumnType::TEXT, metadata);
+            fields.emplace_back(MESSAGE_COLUMN_NAME, ColumnType::TEXT, std::move(dataString));
+            fields.emplace_back(SIZE_COLUMN_NAME, ColumnType::INTEGER, std::to_string(messageSize));
+
+            rows.push_back({tableName, std::move(fields), messageSize});
+            stagedBytes += messageSize;
+        }
+        catch (const std::exception& e)
+        {
+            LogError("Error during Store operation: {}.", e.what());
+        }
+    };
+
+    if (message.is_array())
+    {
+        for (const auto& singleMessageData : message)
+        {
+            stageMessage(singleMessageData);
+        }
+    }
+    else
+    {
+        stageMessage(message);
+    }
+
+    const std::unique_lock<std::mutex> lock(m_mutex);
+
+    // While commits fail, the staged messages are only kept up to a commit's worth, then messages are rejected
+    if (m_commitFailing && m_staged.size() >= m_commitSize)
+    {
+        LogWarn("Cannot store messages until the staged ones are committed.");
+        return 0;
+    }
+
+    const auto result = static_cast<int>(rows.size());
+
+    m_staged.insert(m_staged.end(), std::make_move_iterator(rows.begin()), std::make_move_iterator(rows.end()));
+    UpdateTotals(tableName, moduleName, moduleType, result, static_cast<int64_t>(stagedBytes));
+
+    // A failing commit is only retried every commit interval
+    if (m_staged.size() >= m_commitSize && !m_commitFailing)
+    {
+        CommitStaged();
+    }
+
+    return result;
+}
+
+void Storage::CommitStaged()
+{
+    if (m_staged.empty())
+    {
+        return;
+    }
+
+    auto staged = std::move(m_staged);
+    m_staged.clear();
+
+    // Rows that cannot be inserted are dropped, the rest stay staged if the transaction fails
+    std::vector<bool> discarded(staged.size(), false);
+    std::optional<TransactionId> transaction;
+
+    try
+    {
+        transaction = m_db->BeginTransaction();
+
+        for (size_t i = 0; i < staged.size(); ++i)
+        {
+            try
+            {
+                m_db->Insert(staged[i].tableName, staged[i].fields);
+            }
+            catch (const std::exception& e)
+            {
+                LogError("Error during Store operation: {}.", e.what());
+                const auto& row = staged[i];
+                UpdateTotals(
+                    row.tableName, row.fields[0].Value, row.fields[1].Value, -1, -static_cast<int64_t>(row.size));
+                discarded[i] = true;
+            }
+        }
+
+        m_db->CommitTransaction(*transaction);
+        m_commitFailing = false;
+    }
+    catch (const std::exception& e)
+    {
+        LogError("Error committing staged messages, retrying on the next commit: {}.", e.what());
+
+        if (transaction)
+        {
+            try
+            {
+                m_db->RollbackTransaction(*transaction);
+            }
+            catch (const std::exception& rollbackError)
+            {
+                LogError("Error rolling back staged messages: {}.", rollbackError.what());
+            }
+        }
+
+        for (size_t i = 0; i < staged.size(); ++i)
+        {
+            if (!discarded[i])
+            {
+                m_staged.push_back(std::move(staged[i]));
+            }
+        }
+
+        m_commitFailing = true;
+    }
+}
 
 void Storage::CreateTable(const std::string& tableName)
 {
@@ -113,6 +309,7 @@ void Storage::CreateTable(const std::string& tableName)
         columns.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT);
         columns.emplace_back(METADATA_COLUMN_NAME, ColumnType::TEXT);
         columns.emplace_back(MESSAGE_COLUMN_NAME, ColumnType::TEXT, NOT_NULL);
+        columns.emplace_back(SIZE_COLUMN_NAME, ColumnType::INTEGER);
 
         m_db->CreateTable(tableName, columns);
     }
@@ -123,13 +320,142 @@ void Storage::CreateTable(const std::string& tableName)
     }
 }
 
+void Storage::BackfillSizes(const std::string& tableName)
+{
+    Names columns;
+    columns.emplace_back(ROW_ID_COLUMN_NAME, ColumnType::INTEGER);
+    columns.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT);
+    columns.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT);
+    columns.emplace_back(METADATA_COLUMN_NAME, ColumnType::TEXT);
+    columns.emplace_back(MESSAGE_COLUMN_NAME, ColumnType::TEXT);
+
+    std::vector<std::pair<std::string, size_t>> sizes;
+
+    m_db->SelectWhile(tableName,
+                      columns,
+                      {},
+                      LogicalOperator::AND,
+                      {},
+                      OrderType::ASC,
+                      [&sizes](const Row& row)
+                      {
+                          sizes.emplace_back(row[0].Value,
+                                             row[1].Value.size() + row[2].Value.size() + row[3].Value.size() +
+                                                 row[4].Value.size());
+                          return true;
+                      });
+
+    if (sizes.empty())
+    {
+        return;
+    }
+
+    auto transaction = m_db->BeginTransaction();
+
+    for (const auto& [rowId, size] : sizes)
+    {
+        m_db->Update(tableName,
+                     {ColumnValue(SIZE_COLUMN_NAME, ColumnType::INTEGER, std::to_string(size))},
+                     {ColumnValue(ROW_ID_COLUMN_NAME, ColumnType::INTEGER, rowId)});
+    }
+
+    m_db->CommitTransaction(transaction);
+}
+
+void Storage::LoadTotals(const std::string& tableName)
+{
+    Names columns;
+    columns.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT);
+    columns.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT);
+    columns.emplace_back(SIZE_COLUMN_NAME, ColumnType::INTEGER);
+
+    m_totals[tableName] = {};
+
+    m_db->SelectWhile(tableName,
+                      columns,
+                      {},
+                      LogicalOperator::AND,
+                      {},
+                      OrderType::ASC,
+                      [this, &tableName](const Row& row)
+                      {
+                          UpdateTotals(
+                              tableName, row[0].Value, row[1].Value, 1, static_cast<int64_t>(SizeValue(row[2])));
+                          return true;
+                      });
+}
+
+void Storage::UpdateTotals(const std::string& tableName,
+                           const std::string& moduleName,
+                           const std::string& moduleType,
+                           int count,
+                           int64_t bytes)
+{
+    const auto apply = [count, bytes](StoredTotals& totals)
+    {
+        totals.count = std::max(0, totals.count + count);
+        totals.bytes = bytes < 0 ? totals.bytes - std::min(totals.bytes, static_cast<size_t>(-bytes))
+                                 : totals.bytes + static_cast<size_t>(bytes);
+    };
+
+    auto& tableTotals = m_totals[tableName];
+    apply(tableTotals.total);
+
+    const auto key = std::make_pair(moduleName, moduleType);
+    auto& moduleTotals = tableTotals.perModule[key];
+    apply(moduleTotals);
+
+    if (moduleTotals.count == 0)
+    {
+        tableTotals.perModule.erase(key);
+    }
+}
+
+Storage::StoredTotals
+Storage::GetTotals(const std::string& tableName, const std::string& moduleName, const std::string& moduleType) const
+{
+    const auto tableIt = m_totals.find(tableName);
+    if (tableIt == m_totals.end())
+    {
+        return {};
+    }
+
+    const auto& tableTotals = tableIt->second;
+
+    if (moduleName.empty() && moduleType.empty())
+    {
+        return tableTotals.total;
+    }
+
+    if (!moduleName.empty() && !moduleType.empty())
+    {
+        const auto moduleIt = tableTotals.perModule.find(std::make_pair(moduleName, moduleType));
+        return moduleIt != tableTotals.perModule.end() ? moduleIt->second : StoredTotals {};
+    }
+
+    StoredTotals totals;
+    for (const auto& [key, moduleTotals] : tableTotals.perModule)
+    {
+        if ((moduleName.empty() || key.first == moduleName) && (moduleType.empty() || key.second == moduleType))
+        {
+            totals.count += moduleTotals.count;
+            totals.bytes += moduleTotals.bytes;
+        }
+    }
+    return totals;
+}
+
 bool Storage::Clear(const std::vector<std::string>& tableNames)
 {
     try
     {
+        const std::unique_lock<std::mutex> lock(m_mutex);
+
         for (const auto& table : tableNames)
         {
+            std::erase_if(m_staged, [&table](const StagedRow& row) { return row.tableName == table; });
             m_db->Remove(table, {});
+            m_totals[table] = {};
         }
     }
     catch (const std::exception& e)
@@ -146,12 +472,40 @@ int Storage::Store(const nlohmann::json& message,
                    const std::string& moduleType,
                    const std::string& metadata)
 {
+    if (m_commitInterval.count() > 0)
+    {
+        return Stage(message, tableName, moduleName, moduleType, metadata);
+    }
+
     Row fields;
     fields.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT, moduleName);
     fields.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT, moduleType);
     fields.emplace_back(METADATA_COLUMN_NAME, ColumnType::TEXT, metadata);
 
+    const auto baseFieldsCount = fields.size();
+    const auto baseSize = moduleName.size() + moduleType.size() + metadata.size();
+
     int result = 0;
+    size_t storedBytes = 0;
+
+    const auto insertMessage = [&](const nlohmann::json& singleMessageData)
+    {
+        try
+        {
+            auto dataString = singleMessageData.dump();
+            const auto messageSize = baseSize + dataString.size();
+            fields.emplace_back(MESSAGE_COLUMN_NAME, ColumnType::TEXT, std::move(dataString));
+            fields.emplace_back(SIZE_COLUMN_NAME, ColumnType::INTEGER, std::to_string(messageSize));
+            m_db->Insert(tableName, fields);
+            result++;
+            storedBytes += messageSize;
+        }
+        catch (const std::exception& e)
+        {
+            LogError("Error during Store operation: {}.", e.what());
+        }
+        fields.erase(fields.begin() + static_cast<std::ptrdiff_t>(baseFieldsCount), fields.end());
+    };
 
     const std::unique_lock<std::mutex> lock(m_mutex);
 
@@ -161,35 +515,18 @@ int Storage::Store(const nlohmann::json& message,
     {
         for (const auto& singleMessageData : message)
         {
-            try
-            {
-                fields.emplace_back(MESSAGE_COLUMN_NAME, ColumnType::TEXT, singleMessageData.dump());
-                m_db->Insert(tableName, fields);
-                result++;
-            }
-            catch (const std::exception& e)
-            {
-                LogError("Error during Store operation: {}.", e.what());
-            }
-            fields.pop_back();
+            insertMessage(singleMessageData);
         }
     }
     else
     {
-        try
-        {
-            fields.emplace_back(MESSAGE_COLUMN_NAME, ColumnType::TEXT, message.dump());
-            m_db->Insert(tableName, fields);
-            result++;
-        }
-        catch (const std::exception& e)
-        {
-            LogError("Error during Store operation: {}.", e.what());
-        }
+        insertMessage(message);
     }
 
     m_db->CommitTransaction(transaction);
 
+    UpdateTotals(tableName, moduleName, moduleType, result, static_cast<int64_t>(storedBytes));
+
     return result;
 }
 
@@ -208,10 +545,18 @@ int Storage::RemoveMultiple(int n,
         filters.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT, moduleType);
     }
 
+    Names returnedColumns;
+    returnedColumns.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT);
+    returnedColumns.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT);
+    returnedColumns.emplace_back(SIZE_COLUMN_NAME, ColumnType::INTEGER);
+
     int result = 0;
+    std::vector<Row> removedRows;
 
     const std::unique_lock<std::mutex> lock(m_mutex);
 
+    CommitStaged();
+
     auto transaction = m_db->BeginTransaction();
 
     try
@@ -225,24 +570,15 @@ int Storage::RemoveMultiple(int n,
 
         if (!results.empty())
         {
-            filters.clear();
-
-            for (const auto& row : results)
-            {
-                filters.emplace_back(ROW_ID_COLUMN_NAME, ColumnType::INTEGER, row[0].Value);
-
-                try
-                {
-                    // Remove selected message
-                    m_db->Remove(tableName, filters, LogicalOperator::AND);
-                    result++;
-                }
-                catch (const std::exception& e)
-                {
-                    LogError("Error during Remove operation: {}.", e.what());
-                }
-                filters.pop_back();
-            }
+            // Remove them in a single statement, the selected rows are the only matching ones in that range
+            result = m_db->RemoveRange(tableName,
+                                       columns.front(),
+                                       std::stoll(results.front()[0].Value),
+                                       std::stoll(results.back()[0].Value),
+                                       filters,
+                                       LogicalOperator::AND,
+                                       returnedColumns,
+                                       [&removedRows](const Row& row) { removedRows.push_back(row); });
         }
     }
     catch (const std::exception& e)
@@ -252,20 +588,20 @@ int Storage::RemoveMultiple(int n,
 
     m_db->CommitTransaction(transaction);
 
+    for (const auto& row : removedRows)
+    {
+        UpdateTotals(tableName, row[0].Value, row[1].Value, -1, -static_cast<int64_t>(SizeValue(row[2])));
+    }
+
     return result;
 }
 
-nlohmann::json Storage::RetrieveMultiple(int n,
-                                         const std::string& tableName,
-                                         const std::string& moduleName,
-                                         const std::string& moduleType)
+int Storage::RemoveRange(int64_t firstRowId,
+                         int64_t lastRowId,
+                         const std::string& tableName,
+                         const std::string& moduleName,
+                         const std::string& moduleType)
 {
-    Names columns;
-    columns.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT);
-    columns.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT);
-    columns.emplace_back(METADATA_COLUMN_NAME, ColumnType::TEXT);
-    columns.emplace_back(MESSAGE_COLUMN_NAME, ColumnType::TEXT);
-
     Criteria filters;
     if (!moduleName.empty())
     {
@@ -276,33 +612,49 @@ nlohmann::json Storage::RetrieveMultiple(int n,
         filters.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT, moduleType);
     }
 
-    Names orderColumns;
-    orderColumns.emplace_back(ROW_ID_COLUMN_NAME, ColumnType::INTEGER);
+    Names returnedColumns;
+    returnedColumns.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT);
+    returnedColumns.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT);
+    returnedColumns.emplace_back(SIZE_COLUMN_NAME, ColumnType::INTEGER);
+
+    int result = 0;
+
+    const std::unique_lock<std::mutex> lock(m_mutex);
+
+    CommitStaged();
 
     try
     {
-        const auto results =
-            m_db->Select(tableName, columns, filters, LogicalOperator::AND, orderColumns, OrderType::ASC, n);
-
-        return ProcessRequest(results);
+        result = m_db->RemoveRange(
+            tableName,
+            ColumnName(ROW_ID_COLUMN_NAME, ColumnType::INTEGER),
+            firstRowId,
+            lastRowId,
+            filters,
+            LogicalOperator::AND,
+            returnedColumns,
+            [this, &tableName](const Row& row)
+            { UpdateTotals(tableName, row[0].Value, row[1].Value, -1, -static_cast<int64_t>(SizeValue(row[2]))); });
     }
     catch (const std::exception& e)
     {
-        LogError("Error during RetrieveMultiple operation: {}.", e.what());
-        return {};
+        LogError("Error during RemoveRange operation: {}.", e.what());
     }
+
+    return result;
 }
 
-nlohmann::json Storage::RetrieveBySize(size_t n,
-                                       const std::string& tableName,
-                                       const std::string& moduleName,
-                                       const std::string& moduleType)
+nlohmann::json Storage::RetrieveMultiple(int n,
+                                         const std::string& tableName,
+                                         const std::string& moduleName,
+                                         const std::string& moduleType)
 {
     Names columns;
     columns.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT);
     columns.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT);
     columns.emplace_back(METADATA_COLUMN_NAME, ColumnType::TEXT);
     columns.emplace_back(MESSAGE_COLUMN_NAME, ColumnType::TEXT);
+    columns.emplace_back(ROW_ID_COLUMN_NAME, ColumnType::INTEGER);
 
     Criteria filters;
     if (!moduleName.empty())
@@ -317,50 +669,129 @@ nlohmann::json Storage::RetrieveBySize(size_t n,
     Names orderColumns;
     orderColumns.emplace_back(ROW_ID_COLUMN_NAME, ColumnType::INTEGER);
 
+    {
+        const std::unique_lock<std::mutex> lock(m_mutex);
+        CommitStaged();
+    }
+
     try
     {
         const auto results =
-            m_db->Select(tableName, columns, filters, LogicalOperator::AND, orderColumns, OrderType::ASC);
+            m_db->Select(tableName, columns, filters, LogicalOperator::AND, orderColumns, OrderType::ASC, n);
 
-        return ProcessRequest(results, n);
+        return ProcessRequest(results);
     }
     catch (const std::exception& e)
     {
-        LogError("Error during RetrieveBySize operation: {}.", e.what());
+        LogError("Error during RetrieveMultiple operation: {}.", e.what());
         return {};
     }
 }
 
-int Storage::GetElementCount(const std::string& tableName, const std::string& moduleName, const std::string& moduleType)
+nlohmann::json Storage::RetrieveBySize(size_t n,
+                                       const std::string& tableName,
+                                       const std::string& moduleName,
+                                       const std::string& moduleType,
+                                       int64_t afterRowId)
 {
-    Criteria filters;
-    if (!moduleName.empty())
+    try
     {
-        filters.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT, moduleName);
+        nlohmann::json messages = nlohmann::json::array();
+
+        SelectBySize(n,
+                     tableName,
+                     moduleName,
+                     moduleType,
+                     afterRowId,
+                     [&messages](const Row& row) { messages.push_back(ProcessRow(row)); });
+
+        return messages;
     }
-    if (!moduleType.empty())
+    catch (const std::exception& e)
     {
-        filters.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT, moduleType);
+        LogError("Error during RetrieveBySize operation: {}.", e.what());
+        return {};
     }
+}
+
+MessageBatch Storage::RetrieveBatchBySize(size_t n,
+                                          std::string body,
+                                          const std::string& tableName,
+                                          const std::string& moduleName,
+                                          const std::string& moduleType,
+                                          int64_t afterRowId)
+{
+    MessageBatch batch;
+    batch.body = std::move(body);
+
+    const auto bodyStart = batch.body.size();
 
-    int count = 0;
+    // The stored bytes bound the body unless the budget is smaller, the last message may overshoot it.
+    batch.body.reserve(bodyStart + std::min(n, GetElementsStoredSize(tableName, moduleName, moduleType)));
 
     try
     {
-        count = m_db->GetCount(tableName, filters, LogicalOperator::AND);
+        SelectBySize(n,
+                     tableName,
+                     moduleName,
+                     moduleType,
+                     afterRowId,
+                     [&batch](const Row& row)
+                     {
+                         const std::string& metadataString = row[2].Value;
+                         const std::string& dataString = row[3].Value;
+
+                         if (!metadataString.empty())
+                         {
+                             batch.body += '\n';
+                             batch.body += metadataString;
+                         }
+
+                         if (!dataString.empty() && dataString != "{}")
+                         {
+                             batch.body += '\n';
+                             batch.body += dataString;
+                         }
+
+                         const auto rowId = std::stoll(row[4].Value);
+
+                         if (batch.count == 0)
+                         {
+                             batch.range.first = rowId;
+                         }
+
+                         batch.range.last = rowId;
+                         batch.size += RowSize(row);
+                         ++batch.count;
+                     });
     }
     catch (const std::exception& e)
     {
-        LogError("Error during GetElementCount operation: {}.", e.what());
+        LogError("Error during RetrieveBatchBySize operation: {}.", e.what());
+        batch.body.resize(bodyStart);
+        batch.count = 0;
+        batch.range = {};
+        batch.size = 0;
     }
 
-    return count;
+    return batch;
 }
 
-size_t Storage::GetElementsStoredSize(const std::string& tableName,
-                                      const std::string& moduleName,
-                                      const std::string& moduleType)
+void Storage::SelectBySize(size_t n,
+                           const std::string& tableName,
+                           const std::string& moduleName,
+                           const std::string& moduleType,
+                           int64_t afterRowId,
+                           const std::function<void(const column::Row&)>& onRow)
 {
+    Names columns;
+    columns.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT);
+    columns.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT);
+    columns.emplace_back(METADATA_COLUMN_NAME, ColumnType::TEXT);
+    columns.emplace_back(MESSAGE_COLUMN_NAME, ColumnType::TEXT);
+    columns.emplace_back(ROW_ID_COLUMN_NAME, ColumnType::INTEGER);
+    columns.emplace_back(SIZE_COLUMN_NAME, ColumnType::INTEGER);
+
     Criteria filters;
     if (!moduleName.empty())
     {
@@ -371,22 +802,44 @@ size_t Storage::GetElementsStoredSize(const std::string& tableName,
         filters.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT, moduleType);
     }
 
-    size_t count = 0;
-
-    try
-    {
-        Names columns;
-        columns.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT);
-        columns.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT);
-        columns.emplace_back(METADATA_COLUMN_NAME, ColumnType::TEXT);
-        columns.emplace_back(MESSAGE_COLUMN_NAME, ColumnType::TEXT);
+    Names orderColumns;
+    orderColumns.emplace_back(ROW_ID_COLUMN_NAME, ColumnType::INTEGER);
 
-        count = m_db->GetSize(tableName, columns, filters, LogicalOperator::AND);
-    }
-    catch (const std::exception& e)
     {
-        LogError("Error during GetElementsStoredSize operation: {}.", e.what());
+        const std::unique_lock<std::mutex> lock(m_mutex);
+        CommitStaged();
     }
 
-    return count;
+    size_t sizeAccum = 0;
+
+    // Rows are streamed in rowid order and the cursor is abandoned once the budget is reached.
+    // Rows up to afterRowId are excluded by the query itself, so they are never read.
+    m_db->SelectWhileAfter(tableName,
+                           columns,
+                           ColumnName(ROW_ID_COLUMN_NAME, ColumnType::INTEGER),
+                           afterRowId,
+                           filters,
+                           LogicalOperator::AND,
+                           orderColumns,
+                           OrderType::ASC,
+                           [&onRow, &sizeAccum, n](const Row& row)
+                           {
+                               onRow(row);
+                               sizeAccum += RowSize(row);
+                               return sizeAccum < n;
+                           });
+}
+
+int Storage::GetElementCount(const std::string& tableName, const std::string& moduleName, const std::string& moduleType)
+{
+    const std::unique_lock<std::mutex> lock(m_mutex);
+    return GetTotals(tableName, moduleName, moduleType).count;
+}
+
+size_t Storage::GetElementsStoredSize(const std::string& tableName,
+                                      const std::string& moduleName,
+                                      const std::string& moduleType)
+{
+    const std::unique_lock<std::mutex> lock(m_mutex);
+    return GetTotals(tableName, moduleName, moduleType).bytes;
 }
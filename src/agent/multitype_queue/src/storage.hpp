@@ -5,9 +5,17 @@
 
 #include <nlohmann/json.hpp>
 
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 /// @brief Storage class.
 ///
@@ -20,9 +28,14 @@ public:
     /// @param dbFolderPath The path to the database folder
     /// @param tableNames A vector of table names
     /// @param persistence Optional pointer to an existing persistence object.
+    /// @param commitInterval Maximum time stored messages are kept in memory before being committed to the
+    /// database. Zero commits every store right away.
+    /// @param commitSize Number of messages kept in memory that triggers a commit before the interval expires.
     Storage(const std::string& dbFolderPath,
             const std::vector<std::string>& tableNames,
-            std::unique_ptr<Persistence> persistence = nullptr);
+            std::unique_ptr<Persistence> persistence = nullptr,
+            std::chrono::milliseconds commitInterval = std::chrono::milliseconds(0),
+            size_t commitSize = 1);
 
     /// @brief Delete copy constructor
     Storage(const Storage&) = delete;
@@ -55,6 +68,13 @@ public:
                        const std::string& moduleName = "",
                        const std::string& moduleType = "") override;
 
+    /// @copydoc IStorage::RemoveRange
+    int RemoveRange(int64_t firstRowId,
+                    int64_t lastRowId,
+                    const std::string& tableName,
+                    const std::string& moduleName = "",
+                    const std::string& moduleType = "") override;
+
     /// @copydoc IStorage::RetrieveMultiple
     nlohmann::json RetrieveMultiple(int n,
                                     const std::string& tableName,
@@ -65,7 +85,16 @@ public:
     nlohmann::json RetrieveBySize(size_t n,
                                   const std::string& tableName,
                                   const std::string& moduleName = "",
-                                  const std::string& moduleType = "") override;
+                                  const std::string& moduleType = "",
+                                  int64_t afterRowId = 0) override;
+
+    /// @copydoc IStorage::RetrieveBatchBySize
+    MessageBatch RetrieveBatchBySize(size_t n,
+                                     std::string body,
+                                     const std::string& tableName,
+                                     const std::string& moduleName = "",
+                                     const std::string& moduleType = "",
+                                     int64_t afterRowId = 0) override;
 
     /// @copydoc IStorage::GetElementCount
     int GetElementCount(const std::string& tableName,
@@ -78,13 +107,123 @@ public:
                                  const std::string& moduleType = "") override;
 
 private:
+    /// @brief Number of elements and bytes stored.
+    struct StoredTotals
+    {
+        int count = 0;
+        size_t bytes = 0;
+    };
+
+    /// @brief Totals of a table, overall and per module name and type.
+    struct TableTotals
+    {
+        StoredTotals total;
+        std::map<std::pair<std::string, std::string>, StoredTotals> perModule;
+    };
+
+    /// @brief Message stored in memory, waiting to be committed to the database.
+    struct StagedRow
+    {
+        std::string tableName;
+        column::Row fields;
+        size_t size = 0;
+    };
+
+    /// @brief Keeps messages in memory until the next commit. They are accounted in the totals right away.
+    /// @param message The message to store.
+    /// @param tableName The name of the table to store the message in.
+    /// @param moduleName The name of the module that created the message.
+    /// @param moduleType The type of the module that created the message.
+    /// @param metadata The metadata message to store.
+    /// @return The number of messages staged.
+    int Stage(const nlohmann::json& message,
+              const std::string& tableName,
+              const std::string& moduleName,
+              const std::string& moduleType,
+              const std::string& metadata);
+
+    /// @brief Selects the messages of a table in row id order until their size reaches a budget.
+    /// @param n The size budget, the message that reaches it is included.
+    /// @param tableName The name of the table.
+    /// @param moduleName The module name, empty for any.
+    /// @param moduleType The module type, empty for any.
+    /// @param afterRowId Only messages stored with a greater row id are selected.
+    /// @param onRow Callback invoked for each selected row.
+    void SelectBySize(size_t n,
+                      const std::string& tableName,
+                      const std::string& moduleName,
+                      const std::string& moduleType,
+                      int64_t afterRowId,
+                      const std::function<void(const column::Row&)>& onRow);
+
+    /// @brief Inserts the staged messages in a single transaction. m_mutex must be held.
+    /// @details If the transaction fails, the messages stay staged and are committed again on the next commit
+    /// interval. Meanwhile, once a commit's worth of messages is staged, new messages are rejected.
+    void CommitStaged();
+
+    /// @brief Commits the staged messages every commit interval until the storage is destroyed.
+    void RunCommitLoop();
+
     /// @brief Create a table in the database.
     /// @param tableName The name of the table to create.
     void CreateTable(const std::string& tableName);
 
+    /// @brief Fills the size column of the rows stored before that column existed.
+    /// @param tableName The name of the table to update.
+    void BackfillSizes(const std::string& tableName);
+
+    /// @brief Loads the totals of a table from the database.
+    /// @param tableName The name of the table.
+    void LoadTotals(const std::string& tableName);
+
+    /// @brief Adds elements to the totals of a table, or subtracts them if negative. m_mutex must be held.
+    /// @param tableName The name of the table.
+    /// @param moduleName The module name of the elements.
+    /// @param moduleType The module type of the elements.
+    /// @param count The number of elements.
+    /// @param bytes The size of the elements.
+    void UpdateTotals(const std::string& tableName,
+                      const std::string& moduleName,
+                      const std::string& moduleType,
+                      int count,
+                      int64_t bytes);
+
+    /// @brief Returns the totals of a table, filtered by module name and type when given. m_mutex must be held.
+    /// @param tableName The name of the table.
+    /// @param moduleName The module name, empty for any.
+    /// @param moduleType The module type, empty for any.
+    /// @return The matching totals.
+    StoredTotals GetTotals(const std::string& tableName,
+                           const std::string& moduleName,
+                           const std::string& moduleType) const;
+
     /// @brief Pointer to the database connection.
     std::unique_ptr<Persistence> m_db;
 
     /// @brief Mutex to ensure thread-safe operations.
     std::mutex m_mutex;
+
+    /// @brief Stored totals per table, kept in sync with the database by store and remove operations.
+    std::map<std::string, TableTotals> m_totals;
+
+    /// @brief Maximum time a staged message waits to be committed. Zero disables staging.
+    std::chrono::milliseconds m_commitInterval;
+
+    /// @brief Number of staged messages that triggers a commit.
+    size_t m_commitSize;
+
+    /// @brief Messages waiting to be committed, in store order.
+    std::vector<StagedRow> m_staged;
+
+    /// @brief Whether the last commit of the staged messages failed.
+    bool m_commitFailing = false;
+
+    /// @brief Wakes up the commit loop when the storage is destroyed.
+    std::condition_variable m_commitCv;
+
+    /// @brief Whether the commit loop must exit.
+    bool m_stopCommitLoop = false;
+
+    /// @brief Thread committing the staged messages periodically.
+    std::thread m_commitThread;
 };
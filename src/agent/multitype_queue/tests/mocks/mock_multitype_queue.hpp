@@ -20,21 +20,58 @@ public:
                 getNext,
                 (MessageType type, const std::string moduleName, const std::string moduleType),
                 (override));
+    MOCK_METHOD(boost::asio::awaitable<bool>,
+                waitForBytesAwaitable,
+                (MessageType type, const size_t messageQuantity, const std::function<size_t()>& skippedBytes),
+                (override));
     MOCK_METHOD(
         boost::asio::awaitable<std::vector<Message>>,
         getNextBytesAwaitable,
-        (MessageType type, const size_t messageQuantity, const std::string moduleName, const std::string moduleType),
+        (MessageType type,
+         const size_t messageQuantity,
+         const std::string moduleName,
+         const std::string moduleType,
+         const int64_t afterRowId),
         (override));
     MOCK_METHOD(
         std::vector<Message>,
         getNextBytes,
-        (MessageType type, const size_t messageQuantity, const std::string moduleName, const std::string moduleType),
+        (MessageType type,
+         const size_t messageQuantity,
+         const std::string moduleName,
+         const std::string moduleType,
+         const int64_t afterRowId),
         (override));
+    MOCK_METHOD(boost::asio::awaitable<MessageBatch>,
+                getNextBatchAwaitable,
+                (MessageType type,
+                 const size_t messageQuantity,
+                 std::string body,
+                 const std::string moduleName,
+                 const std::string moduleType,
+                 const int64_t afterRowId),
+                (override));
+    MOCK_METHOD(MessageBatch,
+                getNextBatch,
+                (MessageType type,
+                 const size_t messageQuantity,
+                 std::string body,
+                 const std::string moduleName,
+                 const std::string moduleType,
+                 const int64_t afterRowId),
+                (override));
     MOCK_METHOD(bool, pop, (MessageType type, const std::string moduleName, const std::string moduleType), (override));
     MOCK_METHOD(int,
                 popN,
                 (MessageType type, int messageQuantity, const std::string moduleName, const std::string moduleType),
                 (override));
+    MOCK_METHOD(int,
+                popRange,
+                (MessageType type,
+                 const MessageRange& range,
+                 const std::string moduleName,
+                 const std::string moduleType),
+                (override));
     MOCK_METHOD(bool,
                 isEmpty,
                 (MessageType type, const std::string moduleName, const std::string moduleType),
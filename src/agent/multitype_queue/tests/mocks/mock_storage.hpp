@@ -28,6 +28,15 @@ public:
                 (int n, const std::string& tableName, const std::string& moduleName, const std::string& moduleType),
                 (override));
 
+    MOCK_METHOD(int,
+                RemoveRange,
+                (int64_t firstRowId,
+                 int64_t lastRowId,
+                 const std::string& tableName,
+                 const std::string& moduleName,
+                 const std::string& moduleType),
+                (override));
+
     MOCK_METHOD(nlohmann::json,
                 RetrieveMultiple,
                 (int n, const std::string& tableName, const std::string& moduleName, const std::string& moduleType),
@@ -35,7 +44,21 @@ public:
 
     MOCK_METHOD(nlohmann::json,
                 RetrieveBySize,
-                (size_t n, const std::string& tableName, const std::string& moduleName, const std::string& moduleType),
+                (size_t n,
+                 const std::string& tableName,
+                 const std::string& moduleName,
+                 const std::string& moduleType,
+                 int64_t afterRowId),
+                (override));
+
+    MOCK_METHOD(MessageBatch,
+                RetrieveBatchBySize,
+                (size_t n,
+                 std::string body,
+                 const std::string& tableName,
+                 const std::string& moduleName,
+                 const std::string& moduleType,
+                 int64_t afterRowId),
                 (override));
 
     MOCK_METHOD(int,
@@ -412,6 +412,56 @@ TEST_F(MultiTypeQueueTest, PushAwaitableStoreArrayNotSpaceAvailable)
     ioContext.run();
 }
 
+TEST_F(MultiTypeQueueTest, PushAwaitableWakesUpWhenSpaceIsFreed)
+{
+    boost::asio::io_context ioContext;
+    MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
+    const MessageType messageType {MessageType::STATELESS};
+    const nlohmann::json sigleData = R"({"data": "for STATELESS_0"})";
+    const Message messageToSend {messageType, sigleData};
+
+    int storedItems = DEFAULT_QUEUE_SIZE;
+
+    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_))
+        .WillRepeatedly(testing::Invoke([&storedItems]() { return storedItems; }));
+
+    EXPECT_CALL(*m_mockStorage, RemoveMultiple(1, testing::_, testing::_, testing::_))
+        .WillOnce(testing::Invoke(
+            [&storedItems]()
+            {
+                --storedItems;
+                return 1;
+            }));
+
+    EXPECT_CALL(*m_mockStorage, Store(testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(testing::Return(1));
+
+    testing::MockFunction<void(int)> checkResult;
+    EXPECT_CALL(checkResult, Call(1));
+
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            const int result = co_await multiTypeQueue.pushAwaitable(messageToSend);
+            checkResult.Call(result);
+        },
+        boost::asio::detached);
+
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor);
+            timer.expires_after(std::chrono::milliseconds(10));
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            multiTypeQueue.pop(messageType);
+        },
+        boost::asio::detached);
+
+    ioContext.run();
+}
+
 TEST_F(MultiTypeQueueTest, PushVector)
 {
     std::vector<Message> messages = {};
@@ -540,7 +590,7 @@ TEST_F(MultiTypeQueueTest, GetNextBytesAwaitableSuccess)
     EXPECT_CALL(*m_mockStorage, GetElementsStoredSize(testing::_, testing::_, testing::_))
         .WillRepeatedly(testing::Return(messageQuantity));
 
-    EXPECT_CALL(*m_mockStorage, RetrieveBySize(testing::_, testing::_, testing::_, testing::_))
+    EXPECT_CALL(*m_mockStorage, RetrieveBySize(testing::_, testing::_, testing::_, testing::_, testing::_))
         .WillOnce(testing::Return(retrievedMessages));
 
     testing::MockFunction<void(const std::vector<Message>&)> checkResult;
@@ -558,6 +608,135 @@ TEST_F(MultiTypeQueueTest, GetNextBytesAwaitableSuccess)
     ioContext.run();
 }
 
+TEST_F(MultiTypeQueueTest, GetNextBytesAwaitableWakesUpWhenSizeIsReached)
+{
+    boost::asio::io_context ioContext;
+    MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
+
+    const MessageType messageType {MessageType::STATELESS};
+    const size_t messageQuantity = 3;
+    const nlohmann::json sigleData = R"({"data": "for STATELESS_0"})";
+    const Message messageToSend {messageType, sigleData};
+
+    const nlohmann::json retrievedMessages = nlohmann::json::array(
+        {{{"data", "msg1"}, {"moduleName", "mod1"}, {"moduleType", "type1"}, {"metadata", "meta1"}}});
+
+    size_t storedSize = 0;
+
+    EXPECT_CALL(*m_mockStorage, GetElementsStoredSize(testing::_, testing::_, testing::_))
+        .WillRepeatedly(testing::Invoke([&storedSize]() { return storedSize; }));
+
+    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_))
+        .WillRepeatedly(testing::Return(0));
+
+    EXPECT_CALL(*m_mockStorage, Store(testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(testing::Invoke(
+            [&storedSize]()
+            {
+                storedSize = messageQuantity;
+                return 1;
+            }));
+
+    EXPECT_CALL(*m_mockStorage, RetrieveBySize(testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(testing::Return(retrievedMessages));
+
+    testing::MockFunction<void(size_t)> checkResult;
+    EXPECT_CALL(checkResult, Call(1));
+
+    const auto start = std::chrono::steady_clock::now();
+
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            auto result = co_await multiTypeQueue.getNextBytesAwaitable(messageType, messageQuantity);
+            checkResult.Call(result.size());
+        },
+        boost::asio::detached);
+
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor);
+            timer.expires_after(std::chrono::milliseconds(10));
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            multiTypeQueue.push(messageToSend);
+        },
+        boost::asio::detached);
+
+    ioContext.run();
+
+    // The batch is returned as soon as the size is reached, well before the batch interval expires
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
+TEST_F(MultiTypeQueueTest, WaitForBytesAwaitableDoesNotCountSkippedBytes)
+{
+    const auto configParser = std::make_shared<configuration::ConfigurationParser>(std::string(R"(
+        agent:
+          path.data: "."
+        events:
+          batch_interval: 1s
+    )"));
+
+    boost::asio::io_context ioContext;
+    MultiTypeQueue multiTypeQueue(configParser, std::move(m_mockStoragePtr));
+
+    const MessageType messageType {MessageType::STATELESS};
+    const size_t messageQuantity = 3;
+    const Message messageToSend {messageType, BASE_DATA_CONTENT};
+
+    // A full batch is stored, but it was already sent and is waiting for its response
+    size_t storedSize = messageQuantity;
+    const size_t inFlightSize = messageQuantity;
+
+    EXPECT_CALL(*m_mockStorage, GetElementsStoredSize(testing::_, testing::_, testing::_))
+        .WillRepeatedly(testing::Invoke([&storedSize]() { return storedSize; }));
+
+    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_))
+        .WillRepeatedly(testing::Return(0));
+
+    EXPECT_CALL(*m_mockStorage, Store(testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(testing::Invoke(
+            [&storedSize]()
+            {
+                ++storedSize;
+                return 1;
+            }));
+
+    testing::MockFunction<void(bool)> checkResult;
+    EXPECT_CALL(checkResult, Call(false));
+
+    const auto start = std::chrono::steady_clock::now();
+
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            auto result = co_await multiTypeQueue.waitForBytesAwaitable(
+                messageType, messageQuantity, [&inFlightSize]() { return inFlightSize; });
+            checkResult.Call(result);
+        },
+        boost::asio::detached);
+
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor);
+            timer.expires_after(std::chrono::milliseconds(10));
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            multiTypeQueue.push(messageToSend);
+        },
+        boost::asio::detached);
+
+    ioContext.run();
+
+    // The small push does not fill a batch on top of the one in flight, so the wait lasts the whole batch interval
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
 TEST_F(MultiTypeQueueTest, GetNextBytesBadQueue)
 {
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
@@ -575,7 +754,7 @@ TEST_F(MultiTypeQueueTest, GetNextBytesEmpty)
     const MessageType messageType {MessageType::STATELESS};
 
     const nlohmann::json retrieveResult = nlohmann::json::array();
-    EXPECT_CALL(*m_mockStorage, RetrieveBySize(testing::_, testing::_, testing::_, testing::_))
+    EXPECT_CALL(*m_mockStorage, RetrieveBySize(testing::_, testing::_, testing::_, testing::_, testing::_))
         .WillOnce(testing::Return(retrieveResult));
 
     const size_t contentSize = 1;
@@ -592,11 +771,23 @@ TEST_F(MultiTypeQueueTest, GetNextBytesMessage)
     const std::string moduleType = "TestType";
 
     const nlohmann::json retrievedMessages = nlohmann::json::array(
-        {{{"data", "msg1"}, {"moduleName", moduleName}, {"moduleType", moduleType}, {"metadata", "meta1"}},
-         {{"data", "msg2"}, {"moduleName", moduleName}, {"moduleType", moduleType}, {"metadata", "meta2"}},
-         {{"data", "msg3"}, {"moduleName", moduleName}, {"moduleType", moduleType}, {"metadata", "meta3"}}});
-
-    EXPECT_CALL(*m_mockStorage, RetrieveBySize(testing::_, testing::_, testing::_, testing::_))
+        {{{"data", "msg1"},
+          {"moduleName", moduleName},
+          {"moduleType", moduleType},
+          {"metadata", "meta1"},
+          {"rowId", 1}},
+         {{"data", "msg2"},
+          {"moduleName", moduleName},
+          {"moduleType", moduleType},
+          {"metadata", "meta2"},
+          {"rowId", 2}},
+         {{"data", "msg3"},
+          {"moduleName", moduleName},
+          {"moduleType", moduleType},
+          {"metadata", "meta3"},
+          {"rowId", 3}}});
+
+    EXPECT_CALL(*m_mockStorage, RetrieveBySize(testing::_, testing::_, testing::_, testing::_, testing::_))
         .WillOnce(testing::Return(retrievedMessages));
 
     const size_t contentSize = 3;
@@ -615,6 +806,52 @@ TEST_F(MultiTypeQueueTest, GetNextBytesMessage)
     EXPECT_EQ(messages[2].data, "msg3");
     EXPECT_EQ(messages[2].moduleName, moduleName);
     EXPECT_EQ(messages[2].moduleType, moduleType);
+    EXPECT_EQ(messages[0].rowId, 1);
+    EXPECT_EQ(messages[2].rowId, 3);
+}
+
+TEST_F(MultiTypeQueueTest, GetNextBatchAwaitableSuccess)
+{
+    boost::asio::io_context ioContext;
+    MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
+
+    const MessageType messageType {MessageType::STATEFUL};
+    const size_t messageQuantity = 3;
+
+    EXPECT_CALL(*m_mockStorage, GetElementsStoredSize(testing::_, testing::_, testing::_))
+        .WillRepeatedly(testing::Return(messageQuantity));
+
+    EXPECT_CALL(*m_mockStorage, RetrieveBatchBySize(messageQuantity, "meta", testing::_, "", "", 5))
+        .WillOnce(testing::Return(MessageBatch {"meta\nmsg6\nmsg7", 2, {6, 7}}));
+
+    testing::MockFunction<void(const std::string&, int, int64_t, int64_t)> checkResult;
+    EXPECT_CALL(checkResult, Call("meta\nmsg6\nmsg7", 2, 6, 7));
+
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            auto result =
+                co_await multiTypeQueue.getNextBatchAwaitable(messageType, messageQuantity, "meta", "", "", 5);
+            checkResult.Call(result.body, result.count, result.range.first, result.range.last);
+        },
+        boost::asio::detached);
+
+    ioContext.run();
+}
+
+TEST_F(MultiTypeQueueTest, GetNextBatchBadQueue)
+{
+    MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
+    const MessageType messageType {static_cast<MessageType>(10)};
+
+    EXPECT_CALL(*m_mockStorage,
+                RetrieveBatchBySize(testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .Times(0);
+
+    const auto batch = multiTypeQueue.getNextBatch(messageType, 1, "meta");
+
+    EXPECT_EQ(batch.count, 0);
 }
 
 TEST_F(MultiTypeQueueTest, PopBadQueue)
@@ -678,6 +915,25 @@ TEST_F(MultiTypeQueueTest, PopNSuccess)
     EXPECT_EQ(multiTypeQueue.popN(messageType, messageQuantity), messageQuantity);
 }
 
+TEST_F(MultiTypeQueueTest, PopRangeBadQueue)
+{
+    MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
+    const MessageType messageType {static_cast<MessageType>(10)};
+
+    EXPECT_EQ(multiTypeQueue.popRange(messageType, MessageRange {1, 3}), 0);
+}
+
+TEST_F(MultiTypeQueueTest, PopRangeSuccess)
+{
+    MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
+    const MessageType messageType {MessageType::STATELESS};
+
+    EXPECT_CALL(*m_mockStorage, RemoveRange(1, 3, testing::_, testing::_, testing::_)).WillOnce(testing::Return(3));
+    EXPECT_CALL(*m_mockStorage, RemoveMultiple(testing::_, testing::_, testing::_, testing::_)).Times(0);
+
+    EXPECT_EQ(multiTypeQueue.popRange(messageType, MessageRange {1, 3}), 3);
+}
+
 TEST_F(MultiTypeQueueTest, IsEmptyBadQueue)
 {
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
@@ -1,3 +1,5 @@
+#include <chrono>
+#include <future>
 #include <memory>
 #include <random>
 #include <thread>
@@ -12,10 +14,80 @@
 namespace
 {
     // column names
+    const std::string ROW_ID_COLUMN_NAME = "rowid";
     const std::string MODULE_NAME_COLUMN_NAME = "module_name";
     const std::string MODULE_TYPE_COLUMN_NAME = "module_type";
     const std::string METADATA_COLUMN_NAME = "metadata";
     const std::string MESSAGE_COLUMN_NAME = "message";
+    const std::string SIZE_COLUMN_NAME = "size";
+
+    /// @brief Builds an action that feeds the given rows to a SelectWhile callback
+    auto FeedRows(const std::vector<column::Row>& rows, size_t* visitedRows = nullptr)
+    {
+        return [rows, visitedRows](const std::string&,
+                                   const column::Names&,
+                                   const column::Criteria&,
+                                   column::LogicalOperator,
+                                   const column::Names&,
+                                   column::OrderType,
+                                   const std::function<bool(const column::Row&)>& onRow)
+        {
+            for (const auto& row : rows)
+            {
+                if (visitedRows)
+                {
+                    ++(*visitedRows);
+                }
+                if (!onRow(row))
+                {
+                    break;
+                }
+            }
+        };
+    }
+
+    /// @brief Builds an action that feeds the given rows to a SelectWhileAfter callback
+    auto FeedRowsAfter(const std::vector<column::Row>& rows, size_t* visitedRows = nullptr)
+    {
+        return [feed = FeedRows(rows, visitedRows)](const std::string& tableName,
+                                                    const column::Names& fields,
+                                                    const column::ColumnName&,
+                                                    int64_t,
+                                                    const column::Criteria& selCriteria,
+                                                    column::LogicalOperator logOp,
+                                                    const column::Names& orderBy,
+                                                    column::OrderType orderType,
+                                                    const std::function<bool(const column::Row&)>& onRow)
+        { feed(tableName, fields, selCriteria, logOp, orderBy, orderType, onRow); };
+    }
+
+    /// @brief Builds an action that reports the given rows as removed by RemoveRange
+    auto ReportRemoved(const std::vector<column::Row>& rows)
+    {
+        return [rows](const std::string&,
+                      const column::ColumnName&,
+                      int64_t,
+                      int64_t,
+                      const column::Criteria&,
+                      column::LogicalOperator,
+                      const column::Names&,
+                      const std::function<void(const column::Row&)>& onRemoved)
+        {
+            for (const auto& row : rows)
+            {
+                onRemoved(row);
+            }
+            return static_cast<int>(rows.size());
+        };
+    }
+
+    /// @brief Builds a row with the columns the stored totals are computed from
+    column::Row TotalsRow(const std::string& moduleName, const std::string& moduleType, const std::string& size)
+    {
+        return {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
+                column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, moduleType),
+                column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, size)};
+    }
 } // namespace
 
 class StorageConstructorTest : public ::testing::Test
@@ -30,10 +102,81 @@ TEST_F(StorageConstructorTest, TableExists)
     auto mockPersistencePtr = std::make_unique<MockPersistence>();
     auto mockPersistence = mockPersistencePtr.get();
     EXPECT_CALL(*mockPersistence, TableExists("test_table.db")).WillOnce(testing::Return(true));
+    EXPECT_CALL(*mockPersistence, ColumnExists("test_table.db", SIZE_COLUMN_NAME)).WillOnce(testing::Return(true));
+    EXPECT_CALL(*mockPersistence, AddColumn(testing::_, testing::_)).Times(0);
+    EXPECT_CALL(*mockPersistence,
+                SelectWhile("test_table.db", testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .Times(1);
 
     ASSERT_NO_THROW(std::make_unique<Storage>(".", tableName, std::move(mockPersistencePtr)));
 }
 
+TEST_F(StorageConstructorTest, TableExistsLoadsTotals)
+{
+    const std::vector<std::string> tableName {"test_table.db"};
+    auto mockPersistencePtr = std::make_unique<MockPersistence>();
+    auto mockPersistence = mockPersistencePtr.get();
+    EXPECT_CALL(*mockPersistence, TableExists("test_table.db")).WillOnce(testing::Return(true));
+    EXPECT_CALL(*mockPersistence, ColumnExists("test_table.db", SIZE_COLUMN_NAME)).WillOnce(testing::Return(true));
+
+    const std::vector<column::Row> mockRows = {
+        TotalsRow("module1", "type1", "10"), TotalsRow("module1", "type2", "20"), TotalsRow("module2", "type1", "30")};
+    EXPECT_CALL(
+        *mockPersistence,
+        SelectWhile("test_table.db", testing::SizeIs(3), testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(testing::Invoke(FeedRows(mockRows)));
+
+    const auto storage = std::make_unique<Storage>(".", tableName, std::move(mockPersistencePtr));
+
+    EXPECT_EQ(storage->GetElementCount("test_table.db"), 3);
+    EXPECT_EQ(storage->GetElementsStoredSize("test_table.db"), 60);
+    EXPECT_EQ(storage->GetElementCount("test_table.db", "module1"), 2);
+    EXPECT_EQ(storage->GetElementsStoredSize("test_table.db", "module1"), 30);
+    EXPECT_EQ(storage->GetElementCount("test_table.db", "", "type1"), 2);
+    EXPECT_EQ(storage->GetElementsStoredSize("test_table.db", "module2", "type1"), 30);
+    EXPECT_EQ(storage->GetElementCount("test_table.db", "module2", "type2"), 0);
+    EXPECT_EQ(storage->GetElementCount("other_table.db"), 0);
+}
+
+TEST_F(StorageConstructorTest, TableExistsWithoutSizeColumn)
+{
+    const std::vector<std::string> tableName {"test_table.db"};
+    auto mockPersistencePtr = std::make_unique<MockPersistence>();
+    auto mockPersistence = mockPersistencePtr.get();
+    EXPECT_CALL(*mockPersistence, TableExists("test_table.db")).WillOnce(testing::Return(true));
+    EXPECT_CALL(*mockPersistence, ColumnExists("test_table.db", SIZE_COLUMN_NAME)).WillOnce(testing::Return(false));
+    EXPECT_CALL(*mockPersistence,
+                AddColumn("test_table.db", testing::Field(&column::ColumnKey::Name, testing::Eq(SIZE_COLUMN_NAME))))
+        .Times(1);
+
+    // rows stored before the size column existed get their size filled in
+    const std::vector<column::Row> legacyRows = {
+        {column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1"),
+         column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "module1"),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, ""),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})")}};
+    const std::vector<column::Row> loadedRows = {TotalsRow("module1", "type1", "28")};
+
+    EXPECT_CALL(*mockPersistence,
+                SelectWhile("test_table.db", testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(testing::Invoke(FeedRows(legacyRows)))
+        .WillOnce(testing::Invoke(FeedRows(loadedRows)));
+    EXPECT_CALL(*mockPersistence, BeginTransaction()).Times(1);
+    EXPECT_CALL(*mockPersistence,
+                Update("test_table.db",
+                       testing::ElementsAre(testing::AllOf(
+                           testing::Field(&column::ColumnValue::Name, testing::Eq(SIZE_COLUMN_NAME)),
+                           testing::Field(&column::ColumnValue::Value, testing::Eq("28")))),
+                       testing::ElementsAre(testing::Field(&column::ColumnValue::Value, testing::Eq("1"))),
+                       testing::_))
+        .Times(1);
+    EXPECT_CALL(*mockPersistence, CommitTransaction(testing::_)).Times(1);
+
+    const auto storage = std::make_unique<Storage>(".", tableName, std::move(mockPersistencePtr));
+    EXPECT_EQ(storage->GetElementsStoredSize("test_table.db"), 28);
+}
+
 TEST_F(StorageConstructorTest, TableExistsException)
 {
     const std::vector<std::string> tableName {"test_table.db"};
@@ -98,6 +241,12 @@ protected:
 
         EXPECT_CALL(*m_mockPersistence, TableExists("test_table")).WillOnce(testing::Return(true));
         EXPECT_CALL(*m_mockPersistence, TableExists("test_table2")).WillOnce(testing::Return(true));
+        EXPECT_CALL(*m_mockPersistence, ColumnExists(testing::_, SIZE_COLUMN_NAME))
+            .Times(2)
+            .WillRepeatedly(testing::Return(true));
+        EXPECT_CALL(*m_mockPersistence,
+                    SelectWhile(testing::_, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+            .Times(2);
 
         m_storage = std::make_unique<Storage>(".", m_vMessageTypeStrings, std::move(mockPersistencePtr));
     }
@@ -162,7 +311,7 @@ TEST_F(StorageTest, StoreSingleMessageWithModule)
     EXPECT_CALL(
         *m_mockPersistence,
         Insert(testing::Eq(tableName),
-               testing::AllOf(testing::SizeIs(4),
+               testing::AllOf(testing::SizeIs(5),
                               testing::Contains(testing::AllOf(
                                   testing::Field(&column::ColumnValue::Name, testing::Eq(MODULE_NAME_COLUMN_NAME)),
                                   testing::Field(&column::ColumnValue::Value, testing::Eq(moduleName)))),
@@ -174,7 +323,10 @@ TEST_F(StorageTest, StoreSingleMessageWithModule)
                                   testing::Field(&column::ColumnValue::Value, testing::Eq("")))),
                               testing::Contains(testing::AllOf(
                                   testing::Field(&column::ColumnValue::Name, testing::Eq(MESSAGE_COLUMN_NAME)),
-                                  testing::Field(&column::ColumnValue::Value, testing::Eq("{\"key\":\"value\"}")))))))
+                                  testing::Field(&column::ColumnValue::Value, testing::Eq("{\"key\":\"value\"}")))),
+                              testing::Contains(testing::AllOf(
+                                  testing::Field(&column::ColumnValue::Name, testing::Eq(SIZE_COLUMN_NAME)),
+                                  testing::Field(&column::ColumnValue::Value, testing::Eq("22")))))))
         .Times(1);
     EXPECT_CALL(*m_mockPersistence, CommitTransaction(testing::_)).Times(1);
 
@@ -319,11 +471,13 @@ TEST_F(StorageTest, RetrieveMultipleMessages)
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "module1"),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata1"),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})")},
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1")},
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "module2"),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type2"),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})")}};
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2")}};
 
     EXPECT_CALL(*m_mockPersistence,
                 Select(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
@@ -331,6 +485,8 @@ TEST_F(StorageTest, RetrieveMultipleMessages)
 
     const auto retrievedMessages = m_storage->RetrieveMultiple(2, tableName);
     EXPECT_EQ(retrievedMessages.size(), 2);
+    EXPECT_EQ(retrievedMessages[0]["rowId"], 1);
+    EXPECT_EQ(retrievedMessages[1]["rowId"], 2);
 }
 
 TEST_F(StorageTest, RetrieveMultipleMessagesLessThanRequested)
@@ -339,11 +495,13 @@ TEST_F(StorageTest, RetrieveMultipleMessagesLessThanRequested)
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "module1"),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata1"),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})")},
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1")},
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "module2"),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type2"),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})")}};
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2")}};
 
     EXPECT_CALL(*m_mockPersistence,
                 Select(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
@@ -359,11 +517,13 @@ TEST_F(StorageTest, RetrieveMultipleMessagesWithModule)
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata1"),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})")},
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1")},
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type2"),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})")}};
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2")}};
 
     EXPECT_CALL(
         *m_mockPersistence,
@@ -404,15 +564,25 @@ TEST_F(StorageTest, RetrieveBySizeMessage1)
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, moduleTypeString),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, metadataString),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, dataString)},
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, dataString),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1")},
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type2"),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})")}};
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2")}};
 
     EXPECT_CALL(*m_mockPersistence,
-                Select(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
-        .WillOnce(testing::Return(mockRows));
+                SelectWhileAfter(tableName,
+                                 testing::_,
+                                 testing::_,
+                                 0,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_))
+        .WillOnce(testing::Invoke(FeedRowsAfter(mockRows)));
 
     const size_t sizeMessage1 =
         moduleNameString.size() + moduleTypeString.size() + metadataString.size() + dataString.size();
@@ -432,15 +602,25 @@ TEST_F(StorageTest, RetrieveBySizeHalfMessage1)
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, moduleTypeString),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, metadataString),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, dataString)},
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, dataString),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1")},
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type2"),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})")}};
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2")}};
 
     EXPECT_CALL(*m_mockPersistence,
-                Select(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
-        .WillOnce(testing::Return(mockRows));
+                SelectWhileAfter(tableName,
+                                 testing::_,
+                                 testing::_,
+                                 0,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_))
+        .WillOnce(testing::Invoke(FeedRowsAfter(mockRows)));
 
     const size_t sizeHalfMessage1 = moduleNameString.size() + moduleTypeString.size();
 
@@ -459,15 +639,25 @@ TEST_F(StorageTest, RetrieveBySizeMessage1HalfMessage2)
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, moduleTypeString),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, metadataString),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, dataString)},
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, dataString),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1")},
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type2"),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})")}};
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2")}};
 
     EXPECT_CALL(*m_mockPersistence,
-                Select(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
-        .WillOnce(testing::Return(mockRows));
+                SelectWhileAfter(tableName,
+                                 testing::_,
+                                 testing::_,
+                                 0,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_))
+        .WillOnce(testing::Invoke(FeedRowsAfter(mockRows)));
 
     const size_t sizeMessage = moduleNameString.size() + moduleTypeString.size() + metadataString.size() +
                                dataString.size() + moduleNameString.size();
@@ -476,43 +666,556 @@ TEST_F(StorageTest, RetrieveBySizeMessage1HalfMessage2)
     EXPECT_EQ(retrievedMessages.size(), 2);
 }
 
+TEST_F(StorageTest, RetrieveBySizeUsesStoredSize)
+{
+    const std::vector<column::Row> mockRows = {
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata1"),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "10")},
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type2"),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "10")},
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type3"),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata3"),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value3"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "3"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "10")}};
+
+    EXPECT_CALL(*m_mockPersistence,
+                SelectWhileAfter(tableName,
+                                 testing::_,
+                                 testing::_,
+                                 0,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_))
+        .WillOnce(testing::Invoke(FeedRowsAfter(mockRows)));
+
+    const auto retrievedMessages = m_storage->RetrieveBySize(15, tableName);
+    ASSERT_EQ(retrievedMessages.size(), 2);
+    EXPECT_EQ(retrievedMessages[1]["data"]["key"], "value2");
+}
+
+TEST_F(StorageTest, RetrieveBySizeStopsReadingOnceBudgetIsReached)
+{
+    std::vector<column::Row> mockRows;
+    for (int i = 0; i < 100; ++i)
+    {
+        mockRows.push_back({column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
+                            column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, ""),
+                            column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, ""),
+                            column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value"})"),
+                            column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, std::to_string(i + 1)),
+                            column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "100")});
+    }
+
+    size_t visitedRows = 0;
+    EXPECT_CALL(*m_mockPersistence,
+                SelectWhileAfter(tableName,
+                                 testing::_,
+                                 testing::_,
+                                 0,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_))
+        .WillOnce(testing::Invoke(FeedRowsAfter(mockRows, &visitedRows)));
+
+    const auto retrievedMessages = m_storage->RetrieveBySize(250, tableName);
+    EXPECT_EQ(retrievedMessages.size(), 3);
+    EXPECT_EQ(visitedRows, 3);
+}
+
+TEST_F(StorageTest, RetrieveBySizeSelectsRowsAfterRowId)
+{
+    std::vector<column::Row> mockRows;
+    for (int i = 4; i < 10; ++i)
+    {
+        mockRows.push_back({column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
+                            column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, ""),
+                            column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, ""),
+                            column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value"})"),
+                            column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, std::to_string(i + 1)),
+                            column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "100")});
+    }
+
+    EXPECT_CALL(*m_mockPersistence,
+                SelectWhileAfter(tableName,
+                                 testing::_,
+                                 testing::Field(&column::ColumnName::Name, testing::Eq(ROW_ID_COLUMN_NAME)),
+                                 4,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_))
+        .WillOnce(testing::Invoke(FeedRowsAfter(mockRows)));
+
+    const auto retrievedMessages = m_storage->RetrieveBySize(250, tableName, "", "", 4);
+    ASSERT_EQ(retrievedMessages.size(), 3);
+    EXPECT_EQ(retrievedMessages[0]["rowId"], 5);
+    EXPECT_EQ(retrievedMessages[2]["rowId"], 7);
+}
+
 TEST_F(StorageTest, RetrieveBySizeSelectFail)
 {
     EXPECT_CALL(*m_mockPersistence,
-                Select(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+                SelectWhileAfter(tableName,
+                                 testing::_,
+                                 testing::_,
+                                 0,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_))
         .WillOnce(testing::Throw(std::runtime_error("Error Select")));
 
     const auto retrievedMessages = m_storage->RetrieveBySize(2, tableName, moduleName);
     EXPECT_EQ(retrievedMessages.size(), 0);
 }
 
+TEST_F(StorageTest, RetrieveBatchBySizeAppendsStoredTextToBody)
+{
+    const std::vector<column::Row> mockRows = {
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, ""),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, R"({"module":"logcollector"})"),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"b":2,"a":1})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "3"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "100")},
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, ""),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, R"({"operation":"delete"})"),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, "{}"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "4"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "100")},
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, ""),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, ""),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "8"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "100")}};
+
+    EXPECT_CALL(*m_mockPersistence,
+                SelectWhileAfter(tableName,
+                                 testing::_,
+                                 testing::_,
+                                 0,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_))
+        .WillOnce(testing::Invoke(FeedRowsAfter(mockRows)));
+
+    const auto batch = m_storage->RetrieveBatchBySize(1000, R"({"agent":"test"})", tableName);
+
+    // The stored text is kept as is, keys are not reordered
+    EXPECT_EQ(batch.body,
+              R"({"agent":"test"})"
+              "\n"
+              R"({"module":"logcollector"})"
+              "\n"
+              R"({"b":2,"a":1})"
+              "\n"
+              R"({"operation":"delete"})"
+              "\n"
+              R"({"key":"value"})");
+    EXPECT_EQ(batch.count, 3);
+    EXPECT_EQ(batch.range.first, 3);
+    EXPECT_EQ(batch.range.last, 8);
+}
+
+TEST_F(StorageTest, RetrieveBatchBySizeStopsOnceBudgetIsReached)
+{
+    std::vector<column::Row> mockRows;
+    for (int i = 4; i < 10; ++i)
+    {
+        mockRows.push_back({column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
+                            column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, ""),
+                            column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, ""),
+                            column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, std::to_string(i)),
+                            column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, std::to_string(i + 1)),
+                            column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "100")});
+    }
+
+    EXPECT_CALL(*m_mockPersistence,
+                SelectWhileAfter(tableName,
+                                 testing::_,
+                                 testing::Field(&column::ColumnName::Name, testing::Eq(ROW_ID_COLUMN_NAME)),
+                                 4,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_))
+        .WillOnce(testing::Invoke(FeedRowsAfter(mockRows)));
+
+    const auto batch = m_storage->RetrieveBatchBySize(250, "", tableName, "", "", 4);
+    EXPECT_EQ(batch.body, "\n4\n5\n6");
+    EXPECT_EQ(batch.count, 3);
+    EXPECT_EQ(batch.range.first, 5);
+    EXPECT_EQ(batch.range.last, 7);
+    EXPECT_EQ(batch.size, 300);
+}
+
+TEST_F(StorageTest, RetrieveBatchBySizeSelectFail)
+{
+    EXPECT_CALL(*m_mockPersistence,
+                SelectWhileAfter(tableName,
+                                 testing::_,
+                                 testing::_,
+                                 0,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_))
+        .WillOnce(testing::Throw(std::runtime_error("Error Select")));
+
+    const auto batch = m_storage->RetrieveBatchBySize(2, "metadata", tableName, moduleName);
+    EXPECT_EQ(batch.body, "metadata");
+    EXPECT_EQ(batch.count, 0);
+}
+
+TEST_F(StorageTest, RemoveMultipleRemovesSelectedRange)
+{
+    const std::vector<column::Row> mockRows = {
+        {column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "4")},
+        {column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "5")},
+        {column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "9")}};
+
+    EXPECT_CALL(*m_mockPersistence,
+                Select(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, 3))
+        .WillOnce(testing::Return(mockRows));
+    EXPECT_CALL(*m_mockPersistence,
+                RemoveRange(tableName,
+                            testing::Field(&column::ColumnName::Name, testing::Eq(ROW_ID_COLUMN_NAME)),
+                            4,
+                            9,
+                            testing::SizeIs(1),
+                            column::LogicalOperator::AND,
+                            testing::SizeIs(3),
+                            testing::_))
+        .WillOnce(testing::Return(3));
+    EXPECT_CALL(*m_mockPersistence, Remove(testing::_, testing::_, testing::_)).Times(0);
+
+    EXPECT_EQ(m_storage->RemoveMultiple(3, tableName, moduleName), 3);
+}
+
+TEST_F(StorageTest, RemoveMultipleEmptyTable)
+{
+    EXPECT_CALL(*m_mockPersistence,
+                Select(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(testing::Return(std::vector<column::Row> {}));
+    EXPECT_CALL(
+        *m_mockPersistence,
+        RemoveRange(testing::_, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .Times(0);
+
+    EXPECT_EQ(m_storage->RemoveMultiple(3, tableName), 0);
+}
+
+TEST_F(StorageTest, RemoveRange)
+{
+    EXPECT_CALL(*m_mockPersistence,
+                RemoveRange(tableName,
+                            testing::Field(&column::ColumnName::Name, testing::Eq(ROW_ID_COLUMN_NAME)),
+                            10,
+                            20,
+                            testing::IsEmpty(),
+                            column::LogicalOperator::AND,
+                            testing::SizeIs(3),
+                            testing::_))
+        .WillOnce(testing::Return(11));
+
+    EXPECT_EQ(m_storage->RemoveRange(10, 20, tableName), 11);
+}
+
+TEST_F(StorageTest, RemoveRangeFail)
+{
+    EXPECT_CALL(*m_mockPersistence,
+                RemoveRange(
+                    tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(testing::Throw(std::runtime_error("Error RemoveRange")));
+
+    EXPECT_EQ(m_storage->RemoveRange(10, 20, tableName), 0);
+}
+
 TEST_F(StorageTest, GetElementCount)
 {
-    EXPECT_CALL(*m_mockPersistence, GetCount(tableName, testing::_, testing::_)).WillOnce(testing::Return(1));
-    EXPECT_EQ(m_storage->GetElementCount(tableName), 1);
+    auto messages = nlohmann::json::array();
+    messages.push_back({{"key", "value1"}});
+    messages.push_back({{"key", "value2"}});
+
+    EXPECT_CALL(*m_mockPersistence, Insert(tableName, testing::_)).Times(2);
+    EXPECT_CALL(*m_mockPersistence, GetCount(testing::_, testing::_, testing::_)).Times(0);
+
+    EXPECT_EQ(m_storage->Store(messages, tableName, moduleName, "type1"), 2);
+    EXPECT_EQ(m_storage->GetElementCount(tableName), 2);
+    EXPECT_EQ(m_storage->GetElementCount(tableName, moduleName), 2);
+    EXPECT_EQ(m_storage->GetElementCount(tableName, moduleName, "type2"), 0);
+    EXPECT_EQ(m_storage->GetElementCount("test_table2"), 0);
 }
 
-TEST_F(StorageTest, GetElementCountGetCountFail)
+TEST_F(StorageTest, GetElementCountSkipsFailedInserts)
 {
-    EXPECT_CALL(*m_mockPersistence, GetCount(tableName, testing::_, testing::_))
-        .WillOnce(testing::Throw(std::runtime_error("Error GetCount")));
-    EXPECT_EQ(m_storage->GetElementCount(tableName), 0);
+    auto messages = nlohmann::json::array();
+    messages.push_back({{"key", "value1"}});
+    messages.push_back({{"key", "value2"}});
+
+    EXPECT_CALL(*m_mockPersistence, Insert(tableName, testing::_))
+        .WillOnce(testing::Throw(std::runtime_error("Error Insert")))
+        .WillOnce(testing::Return());
+
+    EXPECT_EQ(m_storage->Store(messages, tableName), 1);
+    EXPECT_EQ(m_storage->GetElementCount(tableName), 1);
+    EXPECT_EQ(m_storage->GetElementsStoredSize(tableName), 16);
 }
 
 TEST_F(StorageTest, GetElementsStoredSize)
 {
-    EXPECT_CALL(*m_mockPersistence, GetSize(tableName, testing::_, testing::_, testing::_))
-        .WillOnce(testing::Return(1));
-    EXPECT_EQ(m_storage->GetElementsStoredSize(tableName), 1);
+    const nlohmann::json message = {{"key", "value"}};
+
+    EXPECT_CALL(*m_mockPersistence, Insert(tableName, testing::_)).Times(1);
+    EXPECT_CALL(*m_mockPersistence, GetSize(testing::_, testing::_, testing::_, testing::_)).Times(0);
+
+    EXPECT_EQ(m_storage->Store(message, tableName, moduleName), 1);
+    EXPECT_EQ(m_storage->GetElementsStoredSize(tableName), 22);
+    EXPECT_EQ(m_storage->GetElementsStoredSize(tableName, moduleName), 22);
+    EXPECT_EQ(m_storage->GetElementsStoredSize(tableName, "otherModule"), 0);
+}
+
+TEST_F(StorageTest, RemoveRangeUpdatesTotals)
+{
+    auto messages = nlohmann::json::array();
+    messages.push_back({{"key", "value1"}});
+    messages.push_back({{"key", "value2"}});
+
+    EXPECT_CALL(*m_mockPersistence, Insert(tableName, testing::_)).Times(2);
+    EXPECT_EQ(m_storage->Store(messages, tableName, moduleName, "type1"), 2);
+    EXPECT_EQ(m_storage->GetElementsStoredSize(tableName), 2 * (moduleName.size() + 5 + 16));
+
+    EXPECT_CALL(*m_mockPersistence,
+                RemoveRange(
+                    tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(testing::Invoke(ReportRemoved({TotalsRow(moduleName, "type1", "28")})));
+
+    EXPECT_EQ(m_storage->RemoveRange(1, 1, tableName), 1);
+    EXPECT_EQ(m_storage->GetElementCount(tableName), 1);
+    EXPECT_EQ(m_storage->GetElementCount(tableName, moduleName, "type1"), 1);
+    EXPECT_EQ(m_storage->GetElementsStoredSize(tableName), 28);
 }
 
-TEST_F(StorageTest, GetElementsStoredSizeGetSizeFail)
+TEST_F(StorageTest, RemoveMultipleUpdatesTotals)
 {
-    EXPECT_CALL(*m_mockPersistence, GetSize(tableName, testing::_, testing::_, testing::_))
-        .WillOnce(testing::Throw(std::runtime_error("Error GetSize")));
+    const nlohmann::json message = {{"key", "value"}};
+
+    EXPECT_CALL(*m_mockPersistence, Insert(tableName, testing::_)).Times(1);
+    EXPECT_EQ(m_storage->Store(message, tableName, moduleName), 1);
+
+    EXPECT_CALL(*m_mockPersistence,
+                Select(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(testing::Return(
+            std::vector<column::Row> {{column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1")}}));
+    EXPECT_CALL(*m_mockPersistence,
+                RemoveRange(
+                    tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(testing::Invoke(ReportRemoved({TotalsRow(moduleName, "", "22")})));
+
+    EXPECT_EQ(m_storage->RemoveMultiple(1, tableName), 1);
+    EXPECT_EQ(m_storage->GetElementCount(tableName), 0);
+    EXPECT_EQ(m_storage->GetElementsStoredSize(tableName), 0);
+}
+
+TEST_F(StorageTest, ClearResetsTotals)
+{
+    const nlohmann::json message = {{"key", "value"}};
+
+    EXPECT_CALL(*m_mockPersistence, Insert(tableName, testing::_)).Times(1);
+    EXPECT_EQ(m_storage->Store(message, tableName), 1);
+
+    EXPECT_CALL(*m_mockPersistence, Remove(tableName, testing::_, testing::_)).Times(1);
+    ASSERT_TRUE(m_storage->Clear({tableName}));
+    EXPECT_EQ(m_storage->GetElementCount(tableName), 0);
     EXPECT_EQ(m_storage->GetElementsStoredSize(tableName), 0);
 }
 
+class StagedStorageTest : public ::testing::Test
+{
+protected:
+    const std::string tableName = "test_table";
+    const std::vector<std::string> m_vMessageTypeStrings {"test_table"};
+    std::unique_ptr<Storage> m_storage;
+    MockPersistence* m_mockPersistence = nullptr;
+
+    void CreateStorage(std::chrono::milliseconds commitInterval, size_t commitSize)
+    {
+        auto mockPersistencePtr = std::make_unique<MockPersistence>();
+        m_mockPersistence = mockPersistencePtr.get();
+
+        EXPECT_CALL(*m_mockPersistence, TableExists("test_table")).WillOnce(testing::Return(true));
+        EXPECT_CALL(*m_mockPersistence, ColumnExists(testing::_, SIZE_COLUMN_NAME)).WillOnce(testing::Return(true));
+        EXPECT_CALL(*m_mockPersistence,
+                    SelectWhile(testing::_, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+            .Times(1);
+
+        m_storage = std::make_unique<Storage>(
+            ".", m_vMessageTypeStrings, std::move(mockPersistencePtr), commitInterval, commitSize);
+    }
+};
+
+TEST_F(StagedStorageTest, StoreCommitsOnceCommitSizeIsReached)
+{
+    CreateStorage(std::chrono::hours(1), 3);
+
+    const nlohmann::json message = {{"key", "value"}};
+
+    EXPECT_CALL(*m_mockPersistence, BeginTransaction()).Times(0);
+    EXPECT_CALL(*m_mockPersistence, Insert(testing::_, testing::_)).Times(0);
+
+    EXPECT_EQ(m_storage->Store(message, tableName), 1);
+    EXPECT_EQ(m_storage->Store(message, tableName), 1);
+
+    // staged messages are accounted before being committed
+    EXPECT_EQ(m_storage->GetElementCount(tableName), 2);
+    EXPECT_EQ(m_storage->GetElementsStoredSize(tableName), 30);
+
+    testing::Mock::VerifyAndClearExpectations(m_mockPersistence);
+
+    EXPECT_CALL(*m_mockPersistence, BeginTransaction()).Times(1);
+    EXPECT_CALL(*m_mockPersistence, Insert(tableName, testing::SizeIs(5))).Times(3);
+    EXPECT_CALL(*m_mockPersistence, CommitTransaction(testing::_)).Times(1);
+
+    EXPECT_EQ(m_storage->Store(message, tableName), 1);
+    EXPECT_EQ(m_storage->GetElementCount(tableName), 3);
+}
+
+TEST_F(StagedStorageTest, StoreCommitsOnceCommitIntervalExpires)
+{
+    CreateStorage(std::chrono::milliseconds(10), 1000);
+
+    const nlohmann::json message = {{"key", "value"}};
+
+    std::promise<void> committed;
+    EXPECT_CALL(*m_mockPersistence, BeginTransaction()).Times(testing::AtLeast(1));
+    EXPECT_CALL(*m_mockPersistence, Insert(tableName, testing::_)).Times(1);
+    EXPECT_CALL(*m_mockPersistence, CommitTransaction(testing::_))
+        .WillOnce(testing::Invoke([&committed](TransactionId) { committed.set_value(); }));
+
+    EXPECT_EQ(m_storage->Store(message, tableName), 1);
+    EXPECT_EQ(committed.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+}
+
+TEST_F(StagedStorageTest, RetrieveCommitsStagedMessagesFirst)
+{
+    CreateStorage(std::chrono::hours(1), 1000);
+
+    const nlohmann::json message = {{"key", "value"}};
+    EXPECT_EQ(m_storage->Store(message, tableName), 1);
+
+    const testing::InSequence seq;
+    EXPECT_CALL(*m_mockPersistence, BeginTransaction());
+    EXPECT_CALL(*m_mockPersistence, Insert(tableName, testing::_));
+    EXPECT_CALL(*m_mockPersistence, CommitTransaction(testing::_));
+    EXPECT_CALL(*m_mockPersistence,
+                SelectWhileAfter(tableName,
+                                 testing::_,
+                                 testing::_,
+                                 0,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_,
+                                 testing::_));
+
+    m_storage->RetrieveBySize(100, tableName);
+}
+
+TEST_F(StagedStorageTest, FailedCommitIsDiscountedFromTotals)
+{
+    CreateStorage(std::chrono::hours(1), 2);
+
+    const nlohmann::json message = {{"key", "value"}};
+
+    EXPECT_CALL(*m_mockPersistence, Insert(tableName, testing::_))
+        .WillOnce(testing::Throw(std::runtime_error("Error Insert")))
+        .WillOnce(testing::Return());
+
+    EXPECT_EQ(m_storage->Store(message, tableName), 1);
+    EXPECT_EQ(m_storage->Store(message, tableName), 1);
+    EXPECT_EQ(m_storage->GetElementCount(tableName), 1);
+    EXPECT_EQ(m_storage->GetElementsStoredSize(tableName), 15);
+}
+
+TEST_F(StagedStorageTest, FailedTransactionKeepsMessagesStaged)
+{
+    CreateStorage(std::chrono::hours(1), 2);
+
+    const nlohmann::json message = {{"key", "value"}};
+
+    EXPECT_CALL(*m_mockPersistence, BeginTransaction()).Times(2);
+    EXPECT_CALL(*m_mockPersistence, Insert(tableName, testing::_)).Times(4);
+    EXPECT_CALL(*m_mockPersistence, CommitTransaction(testing::_))
+        .WillOnce(testing::Throw(std::runtime_error("database is locked")))
+        .WillOnce(testing::Return());
+    EXPECT_CALL(*m_mockPersistence, RollbackTransaction(testing::_)).Times(1);
+
+    EXPECT_EQ(m_storage->Store(message, tableName), 1);
+    EXPECT_EQ(m_storage->Store(message, tableName), 1);
+
+    // The messages are still accounted, as they are committed again later
+    EXPECT_EQ(m_storage->GetElementCount(tableName), 2);
+    EXPECT_EQ(m_storage->GetElementsStoredSize(tableName), 30);
+
+    // Until a commit succeeds, no more than a commit's worth of messages is staged
+    EXPECT_EQ(m_storage->Store(message, tableName), 0);
+    EXPECT_EQ(m_storage->GetElementCount(tableName), 2);
+
+    m_storage.reset();
+}
+
+TEST_F(StagedStorageTest, ClearDropsStagedMessages)
+{
+    CreateStorage(std::chrono::hours(1), 1000);
+
+    const nlohmann::json message = {{"key", "value"}};
+    EXPECT_EQ(m_storage->Store(message, tableName), 1);
+
+    EXPECT_CALL(*m_mockPersistence, Insert(testing::_, testing::_)).Times(0);
+    EXPECT_CALL(*m_mockPersistence, Remove(tableName, testing::_, testing::_)).Times(1);
+
+    ASSERT_TRUE(m_storage->Clear({tableName}));
+    EXPECT_EQ(m_storage->GetElementCount(tableName), 0);
+
+    m_storage.reset();
+}
+
+TEST_F(StagedStorageTest, DestructorCommitsStagedMessages)
+{
+    CreateStorage(std::chrono::hours(1), 1000);
+
+    const nlohmann::json message = {{"key", "value"}};
+    EXPECT_EQ(m_storage->Store(message, tableName), 1);
+
+    EXPECT_CALL(*m_mockPersistence, BeginTransaction()).Times(1);
+    EXPECT_CALL(*m_mockPersistence, Insert(tableName, testing::_)).Times(1);
+    EXPECT_CALL(*m_mockPersistence, CommitTransaction(testing::_)).Times(1);
+
+    m_storage.reset();
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -2,6 +2,8 @@
 
 #include "column.hpp"
 
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -24,6 +26,17 @@ public:
     /// @param cols Keys specifying the table schema.
     virtual void CreateTable(const std::string& tableName, const column::Keys& cols) = 0;
 
+    /// @brief Checks if a specified column exists in a table.
+    /// @param tableName The name of the table to check.
+    /// @param columnName The name of the column to look for.
+    /// @return True if the column exists, false otherwise.
+    virtual bool ColumnExists(const std::string& tableName, const std::string& columnName) = 0;
+
+    /// @brief Adds a new column to an existing table.
+    /// @param tableName The name of the table to alter.
+    /// @param col Key specifying the new column.
+    virtual void AddColumn(const std::string& tableName, const column::ColumnKey& col) = 0;
+
     /// @brief Inserts data into a specified table.
     /// @param tableName The name of the table where data is inserted.
     /// @param cols Row with values to insert.
@@ -47,6 +60,25 @@ public:
                         const column::Criteria& selCriteria = {},
                         column::LogicalOperator logOp = column::LogicalOperator::AND) = 0;
 
+    /// @brief Removes the rows whose integer column lies within an inclusive range, with optional criteria.
+    /// @param tableName The name of the table to delete from.
+    /// @param rangeColumn The integer column the range applies to.
+    /// @param from The lower bound of the range.
+    /// @param to The upper bound of the range.
+    /// @param selCriteria Optional criteria to further filter rows to delete.
+    /// @param logOp Logical operator to combine selection criteria.
+    /// @param returnedFields Fields of the removed rows to report, none if empty.
+    /// @param onRemoved Called with the returned fields of each removed row.
+    /// @return The number of removed rows.
+    virtual int RemoveRange(const std::string& tableName,
+                            const column::ColumnName& rangeColumn,
+                            int64_t from,
+                            int64_t to,
+                            const column::Criteria& selCriteria = {},
+                            column::LogicalOperator logOp = column::LogicalOperator::AND,
+                            const column::Names& returnedFields = {},
+                            const std::function<void(const column::Row&)>& onRemoved = nullptr) = 0;
+
     /// @brief Drops a specified table from the database.
     /// @param tableName The name of the table to drop.
     virtual void DropTable(const std::string& tableName) = 0;
@@ -68,6 +100,46 @@ public:
                                             column::OrderType orderType = column::OrderType::ASC,
                                             int limit = 0) = 0;
 
+    /// @brief Selects rows from a specified table one at a time, until the callback asks to stop.
+    /// @details Rows are stepped directly from the database cursor, so no more rows than the ones
+    /// handed to the callback are read.
+    /// @param tableName The name of the table to select from.
+    /// @param fields Names to retrieve.
+    /// @param selCriteria Selection criteria to filter rows.
+    /// @param logOp Logical operator to combine selection criteria (AND/OR).
+    /// @param orderBy Names to order the results by.
+    /// @param orderType The order type (ASC or DESC).
+    /// @param onRow Callback invoked for each row. Returning false stops the selection.
+    virtual void SelectWhile(const std::string& tableName,
+                             const column::Names& fields,
+                             const column::Criteria& selCriteria,
+                             column::LogicalOperator logOp,
+                             const column::Names& orderBy,
+                             column::OrderType orderType,
+                             const std::function<bool(const column::Row&)>& onRow) = 0;
+
+    /// @brief Selects the rows whose integer column is greater than a bound one at a time, until the callback
+    /// asks to stop.
+    /// @details The bound is part of the query, so rows up to it are not read at all.
+    /// @param tableName The name of the table to select from.
+    /// @param fields Names to retrieve.
+    /// @param afterColumn The integer column the bound applies to.
+    /// @param after Only rows with a greater value in afterColumn are selected.
+    /// @param selCriteria Selection criteria to further filter rows.
+    /// @param logOp Logical operator to combine selection criteria (AND/OR).
+    /// @param orderBy Names to order the results by.
+    /// @param orderType The order type (ASC or DESC).
+    /// @param onRow Callback invoked for each row. Returning false stops the selection.
+    virtual void SelectWhileAfter(const std::string& tableName,
+                                  const column::Names& fields,
+                                  const column::ColumnName& afterColumn,
+                                  int64_t after,
+                                  const column::Criteria& selCriteria,
+                                  column::LogicalOperator logOp,
+                                  const column::Names& orderBy,
+                                  column::OrderType orderType,
+                                  const std::function<bool(const column::Row&)>& onRow) = 0;
+
     /// @brief Retrieves the number of rows in a specified table.
     /// @param tableName The name of the table to count rows in.
     /// @param selCriteria Optional selection criteria to filter rows.
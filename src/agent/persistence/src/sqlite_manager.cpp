@@ -5,7 +5,6 @@
 #include <SQLiteCpp/SQLiteCpp.h>
 #include <fmt/format.h>
 #include <map>
-#include <regex>
 
 using namespace column;
 
@@ -19,14 +18,80 @@ SQLiteManager::~SQLiteManager() = default;
 
 namespace
 {
-    const std::string& TO_SEARCH = "'";
-    const std::string& TO_REPLACE = "''";
+    /// @brief Builds a list of "column = ?" placeholders joined by a separator.
+    std::string BuildPlaceholders(const std::vector<ColumnValue>& cols, const std::string& separator)
+    {
+        std::vector<std::string> placeholders;
+        placeholders.reserve(cols.size());
+
+        for (const auto& col : cols)
+        {
+            placeholders.push_back(fmt::format("{} = ?", col.Name));
+        }
+
+        return fmt::format("{}", fmt::join(placeholders, separator));
+    }
+
+    /// @brief Builds a WHERE clause with a placeholder for each criterion.
+    std::string BuildWhereClause(const Criteria& selCriteria, LogicalOperator logOp)
+    {
+        if (selCriteria.empty())
+        {
+            return "";
+        }
+
+        return fmt::format(" WHERE {}",
+                           BuildPlaceholders(selCriteria, fmt::format(" {} ", MAP_LOGOP_STRING.at(logOp))));
+    }
+
+    /// @brief Binds a column value to the given statement parameter according to its type.
+    void BindValue(SQLite::Statement& query, int index, const ColumnValue& col)
+    {
+        if (col.Type == ColumnType::INTEGER)
+        {
+            query.bind(index, static_cast<int64_t>(std::stoll(col.Value)));
+        }
+        else if (col.Type == ColumnType::REAL)
+        {
+            query.bind(index, std::stod(col.Value));
+        }
+        else
+        {
+            query.bind(index, col.Value);
+        }
+    }
 
-    /// @brief Escapes single quotes in a string.
-    std::string EscapeSingleQuotes(const std::string& str)
+    /// @brief Binds a list of column values to consecutive statement parameters.
+    /// @return The index of the next parameter to bind.
+    int BindValues(SQLite::Statement& query, int index, const std::vector<ColumnValue>& cols)
     {
-        return std::regex_replace(str, std::regex(TO_SEARCH), TO_REPLACE);
+        for (const auto& col : cols)
+        {
+            BindValue(query, index++, col);
+        }
+        return index;
     }
+
+    /// @brief Resets a cached statement when going out of scope, so it can be bound and stepped again.
+    class StatementReset
+    {
+    public:
+        explicit StatementReset(SQLite::Statement& query)
+            : m_query(query)
+        {
+        }
+
+        StatementReset(const StatementReset&) = delete;
+        StatementReset& operator=(const StatementReset&) = delete;
+
+        ~StatementReset()
+        {
+            m_query.tryReset();
+        }
+
+    private:
+        SQLite::Statement& m_query;
+    };
 } // namespace
 
 ColumnType SQLiteManager::ColumnTypeFromSQLiteType(const int type) const
@@ -44,6 +109,20 @@ ColumnType SQLiteManager::ColumnTypeFromSQLiteType(const int type) const
     return ColumnType::TEXT;
 }
 
+void SQLiteManager::ReadRow(const SQLite::Statement& query, Row& row) const
+{
+    const int nColumns = query.getColumnCount();
+
+    row.clear();
+    row.reserve(static_cast<size_t>(nColumns));
+
+    for (int i = 0; i < nColumns; i++)
+    {
+        const auto column = query.getColumn(i);
+        row.emplace_back(column.getName(), ColumnTypeFromSQLiteType(column.getType()), column.getString());
+    }
+}
+
 SQLiteManager::SQLiteManager(const std::string& dbName)
     : m_dbName(dbName)
     , m_db(std::make_unique<SQLite::Database>(dbName, SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE))
@@ -56,7 +135,9 @@ bool SQLiteManager::TableExists(const std::string& table)
     try
     {
         const std::lock_guard<std::mutex> lock(m_mutex);
-        SQLite::Statement query(*m_db, "SELECT name FROM sqlite_master WHERE type='table' AND name='" + table + "';");
+        auto& query = GetStatement("SELECT name FROM sqlite_master WHERE type='table' AND name = ?");
+        const StatementReset reset(query);
+        query.bind(1, table);
         return query.executeStep();
     }
     catch (const std::exception& e)
@@ -88,29 +169,56 @@ void SQLiteManager::CreateTable(const std::string& tableName, const Keys& cols)
     Execute(queryString);
 }
 
+bool SQLiteManager::ColumnExists(const std::string& tableName, const std::string& columnName)
+{
+    try
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        SQLite::Statement query(*m_db, "PRAGMA table_info(" + tableName + ");");
+
+        while (query.executeStep())
+        {
+            if (query.getColumn("name").getString() == columnName)
+            {
+                return true;
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        LogError("Failed to check if column exists: {}.", e.what());
+    }
+    return false;
+}
+
+void SQLiteManager::AddColumn(const std::string& tableName, const ColumnKey& col)
+{
+    const std::string queryString = fmt::format("ALTER TABLE {} ADD COLUMN {} {}{}",
+                                                tableName,
+                                                col.Name,
+                                                MAP_COL_TYPE_STRING.at(col.Type),
+                                                (col.Attributes & NOT_NULL) ? " NOT NULL" : "");
+
+    Execute(queryString);
+    ClearStatements();
+}
+
 void SQLiteManager::Insert(const std::string& tableName, const Row& cols)
 {
     std::vector<std::string> names;
-    std::vector<std::string> values;
+    names.reserve(cols.size());
 
     for (const auto& col : cols)
     {
         names.push_back(col.Name);
-        if (col.Type == ColumnType::TEXT)
-        {
-            auto escapedValue = EscapeSingleQuotes(col.Value);
-            values.push_back(fmt::format("'{}'", escapedValue));
-        }
-        else
-        {
-            values.push_back(col.Value);
-        }
     }
 
-    const std::string queryString =
-        fmt::format("INSERT INTO {} ({}) VALUES ({})", tableName, fmt::join(names, ", "), fmt::join(values, ", "));
+    const std::string queryString = fmt::format("INSERT INTO {} ({}) VALUES ({})",
+                                                tableName,
+                                                fmt::join(names, ", "),
+                                                fmt::join(std::vector<std::string>(cols.size(), "?"), ", "));
 
-    Execute(queryString);
+    Execute(queryString, cols);
 }
 
 void SQLiteManager::Update(const std::string& tableName,
@@ -124,84 +232,102 @@ void SQLiteManager::Update(const std::string& tableName,
         throw;
     }
 
-    std::vector<std::string> setFields;
-    for (const auto& col : fields)
+    const std::string queryString = fmt::format(
+        "UPDATE {} SET {}{}", tableName, BuildPlaceholders(fields, ", "), BuildWhereClause(selCriteria, logOp));
+
+    Row params(fields);
+    params.insert(params.end(), selCriteria.begin(), selCriteria.end());
+
+    Execute(queryString, params);
+}
+
+void SQLiteManager::Remove(const std::string& tableName, const Criteria& selCriteria, LogicalOperator logOp)
+{
+    const std::string queryString = fmt::format("DELETE FROM {}{}", tableName, BuildWhereClause(selCriteria, logOp));
+
+    Execute(queryString, selCriteria);
+}
+
+int SQLiteManager::RemoveRange(const std::string& tableName,
+                               const ColumnName& rangeColumn,
+                               int64_t from,
+                               int64_t to,
+                               const Criteria& selCriteria,
+                               LogicalOperator logOp,
+                               const Names& returnedFields,
+                               const std::function<void(const Row&)>& onRemoved)
+{
+    std::string whereClause = fmt::format(" WHERE {} BETWEEN ? AND ?", rangeColumn.Name);
+    if (!selCriteria.empty())
     {
-        if (col.Type == ColumnType::TEXT)
-        {
-            auto escapedValue = EscapeSingleQuotes(col.Value);
-            setFields.push_back(fmt::format("{}='{}'", col.Name, escapedValue));
-        }
-        else
-        {
-            setFields.push_back(fmt::format("{}={}", col.Name, col.Value));
-        }
+        whereClause +=
+            fmt::format(" AND ({})", BuildPlaceholders(selCriteria, fmt::format(" {} ", MAP_LOGOP_STRING.at(logOp))));
     }
-    std::string updateValues = fmt::format("{}", fmt::join(setFields, ", "));
 
-    std::string whereClause;
-    if (!selCriteria.empty())
+    const std::string queryString = fmt::format("DELETE FROM {}{}", tableName, whereClause);
+
+    Row params;
+    params.reserve(selCriteria.size() + 2);
+    params.emplace_back(rangeColumn.Name, ColumnType::INTEGER, std::to_string(from));
+    params.emplace_back(rangeColumn.Name, ColumnType::INTEGER, std::to_string(to));
+    params.insert(params.end(), selCriteria.begin(), selCriteria.end());
+
+    if (returnedFields.empty())
     {
-        std::vector<std::string> conditions;
-        for (const auto& col : selCriteria)
-        {
-            if (col.Type == ColumnType::TEXT)
-            {
-                auto escapedValue = EscapeSingleQuotes(col.Value);
-                conditions.push_back(fmt::format("{}='{}'", col.Name, escapedValue));
-            }
-            else
-            {
-                conditions.push_back(fmt::format("{}={}", col.Name, col.Value));
-            }
-        }
-        whereClause = fmt::format(" WHERE {}", fmt::join(conditions, fmt::format(" {} ", MAP_LOGOP_STRING.at(logOp))));
+        return Execute(queryString, params);
     }
 
-    const std::string queryString = fmt::format("UPDATE {} SET {}{}", tableName, updateValues, whereClause);
+    std::vector<std::string> returnedNames;
+    returnedNames.reserve(returnedFields.size());
+    for (const auto& col : returnedFields)
+    {
+        returnedNames.push_back(col.Name);
+    }
 
-    Execute(queryString);
-}
+    const std::string returningQuery = fmt::format("{} RETURNING {}", queryString, fmt::join(returnedNames, ", "));
 
-void SQLiteManager::Remove(const std::string& tableName, const Criteria& selCriteria, LogicalOperator logOp)
-{
-    std::string whereClause;
-    if (!selCriteria.empty())
+    int removed = 0;
+    try
     {
-        std::vector<std::string> critFields;
-        for (const auto& col : selCriteria)
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        auto& query = GetStatement(returningQuery);
+        const StatementReset reset(query);
+
+        BindValues(query, 1, params);
+
+        Row removedFields;
+        while (query.executeStep())
         {
-            if (col.Type == ColumnType::TEXT)
+            ++removed;
+            if (onRemoved)
             {
-                auto escapedValue = EscapeSingleQuotes(col.Value);
-                critFields.push_back(fmt::format("{}='{}'", col.Name, escapedValue));
-            }
-            else
-            {
-                critFields.push_back(fmt::format("{}={}", col.Name, col.Value));
+                ReadRow(query, removedFields);
+                onRemoved(removedFields);
             }
         }
-        whereClause = fmt::format(" WHERE {}", fmt::join(critFields, fmt::format(" {} ", MAP_LOGOP_STRING.at(logOp))));
     }
-
-    const std::string queryString = fmt::format("DELETE FROM {}{}", tableName, whereClause);
-
-    Execute(queryString);
+    catch (const std::exception& e)
+    {
+        LogError("Error during RemoveRange operation: {}.", e.what());
+        throw;
+    }
+    return removed;
 }
 
 void SQLiteManager::DropTable(const std::string& tableName)
 {
     const std::string queryString = fmt::format("DROP TABLE {}", tableName);
 
+    ClearStatements();
     Execute(queryString);
 }
 
-void SQLiteManager::Execute(const std::string& query)
+int SQLiteManager::Execute(const std::string& query)
 {
     try
     {
         const std::lock_guard<std::mutex> lock(m_mutex);
-        m_db->exec(query);
+        return m_db->exec(query);
     }
     catch (const std::exception& e)
     {
@@ -210,13 +336,45 @@ void SQLiteManager::Execute(const std::string& query)
     }
 }
 
-std::vector<Row> SQLiteManager::Select(const std::string& tableName,
-                                       const Names& fields,
-                                       const Criteria& selCriteria,
-                                       LogicalOperator logOp,
-                                       const Names& orderBy,
-                                       OrderType orderType,
-                                       int limit)
+int SQLiteManager::Execute(const std::string& query, const std::vector<ColumnValue>& params)
+{
+    try
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        auto& statement = GetStatement(query);
+        const StatementReset reset(statement);
+        BindValues(statement, 1, params);
+        return statement.exec();
+    }
+    catch (const std::exception& e)
+    {
+        LogError("Error during database operation: {}.", e.what());
+        throw;
+    }
+}
+
+SQLite::Statement& SQLiteManager::GetStatement(const std::string& query)
+{
+    auto it = m_statements.find(query);
+    if (it == m_statements.end())
+    {
+        it = m_statements.emplace(query, std::make_unique<SQLite::Statement>(*m_db, query)).first;
+    }
+    return *it->second;
+}
+
+void SQLiteManager::ClearStatements()
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_statements.clear();
+}
+
+std::string SQLiteManager::BuildSelectQuery(const std::string& tableName,
+                                            const Names& fields,
+                                            const std::string& whereClause,
+                                            const Names& orderBy,
+                                            OrderType orderType,
+                                            int limit) const
 {
     std::string selectedFields;
     if (fields.empty())
@@ -235,24 +393,7 @@ std::vector<Row> SQLiteManager::Select(const std::string& tableName,
         selectedFields = fmt::format("{}", fmt::join(fieldNames, ", "));
     }
 
-    std::string condition;
-    if (!selCriteria.empty())
-    {
-        std::vector<std::string> conditions;
-        for (const auto& col : selCriteria)
-        {
-            if (col.Type == ColumnType::TEXT)
-            {
-                auto escapedValue = EscapeSingleQuotes(col.Value);
-                conditions.push_back(fmt::format("{}='{}'", col.Name, escapedValue));
-            }
-            else
-            {
-                conditions.push_back(fmt::format("{}={}", col.Name, col.Value));
-            }
-        }
-        condition = fmt::format("WHERE {}", fmt::join(conditions, fmt::format(" {} ", MAP_LOGOP_STRING.at(logOp))));
-    }
+    std::string condition = whereClause;
 
     if (!orderBy.empty())
     {
@@ -268,29 +409,39 @@ std::vector<Row> SQLiteManager::Select(const std::string& tableName,
 
     if (limit > 0)
     {
-        condition += fmt::format(" LIMIT {}", limit);
+        condition += " LIMIT ?";
     }
 
-    const std::string queryString = fmt::format("SELECT {} FROM {} {}", selectedFields, tableName, condition);
+    return fmt::format("SELECT {} FROM {}{}", selectedFields, tableName, condition);
+}
+
+std::vector<Row> SQLiteManager::Select(const std::string& tableName,
+                                       const Names& fields,
+                                       const Criteria& selCriteria,
+                                       LogicalOperator logOp,
+                                       const Names& orderBy,
+                                       OrderType orderType,
+                                       int limit)
+{
+    const std::string queryString =
+        BuildSelectQuery(tableName, fields, BuildWhereClause(selCriteria, logOp), orderBy, orderType, limit);
 
     std::vector<Row> results;
     try
     {
         const std::lock_guard<std::mutex> lock(m_mutex);
-        SQLite::Statement query(*m_db, queryString);
+        auto& query = GetStatement(queryString);
+        const StatementReset reset(query);
+
+        const int index = BindValues(query, 1, selCriteria);
+        if (limit > 0)
+        {
+            query.bind(index, limit);
+        }
 
         while (query.executeStep())
         {
-            const int nColumns = query.getColumnCount();
-            Row queryFields;
-            queryFields.reserve(static_cast<size_t>(nColumns));
-            for (int i = 0; i < nColumns; i++)
-            {
-                queryFields.emplace_back(query.getColumn(i).getName(),
-                                         ColumnTypeFromSQLiteType(query.getColumn(i).getType()),
-                                         query.getColumn(i).getString());
-            }
-            results.push_back(queryFields);
+            ReadRow(query, results.emplace_back());
         }
     }
     catch (const std::exception& e)
@@ -301,34 +452,99 @@ std::vector<Row> SQLiteManager::Select(const std::string& tableName,
     return results;
 }
 
-int SQLiteManager::GetCount(const std::string& tableName, const Criteria& selCriteria, LogicalOperator logOp)
+void SQLiteManager::SelectWhile(const std::string& tableName,
+                                const Names& fields,
+                                const Criteria& selCriteria,
+                                LogicalOperator logOp,
+                                const Names& orderBy,
+                                OrderType orderType,
+                                const std::function<bool(const Row&)>& onRow)
+{
+    const std::string queryString =
+        BuildSelectQuery(tableName, fields, BuildWhereClause(selCriteria, logOp), orderBy, orderType, 0);
+
+    try
+    {
+        StepSelect(queryString, selCriteria, onRow);
+    }
+    catch (const std::exception& e)
+    {
+        LogError("Error during SelectWhile operation: {}.", e.what());
+        throw;
+    }
+}
+
+void SQLiteManager::SelectWhileAfter(const std::string& tableName,
+                                     const Names& fields,
+                                     const ColumnName& afterColumn,
+                                     int64_t after,
+                                     const Criteria& selCriteria,
+                                     LogicalOperator logOp,
+                                     const Names& orderBy,
+                                     OrderType orderType,
+                                     const std::function<bool(const Row&)>& onRow)
 {
-    std::string condition;
+    std::string whereClause = fmt::format(" WHERE {} > ?", afterColumn.Name);
     if (!selCriteria.empty())
     {
-        std::vector<std::string> conditions;
-        for (const auto& col : selCriteria)
+        whereClause +=
+            fmt::format(" AND ({})", BuildPlaceholders(selCriteria, fmt::format(" {} ", MAP_LOGOP_STRING.at(logOp))));
+    }
+
+    const std::string queryString = BuildSelectQuery(tableName, fields, whereClause, orderBy, orderType, 0);
+
+    Row params;
+    params.reserve(selCriteria.size() + 1);
+    params.emplace_back(afterColumn.Name, ColumnType::INTEGER, std::to_string(after));
+    params.insert(params.end(), selCriteria.begin(), selCriteria.end());
+
+    try
+    {
+        StepSelect(queryString, params, onRow);
+    }
+    catch (const std::exception& e)
+    {
+        LogError("Error during SelectWhileAfter operation: {}.", e.what());
+        throw;
+    }
+}
+
+void SQLiteManager::StepSelect(const std::string& queryString,
+                               const std::vector<ColumnValue>& params,
+                               const std::function<bool(const Row&)>& onRow)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    auto& query = GetStatement(queryString);
+    const StatementReset reset(query);
+
+    BindValues(query, 1, params);
+
+    Row queryFields;
+
+    while (query.executeStep())
+    {
+        ReadRow(query, queryFields);
+
+        if (!onRow(queryFields))
         {
-            if (col.Type == ColumnType::TEXT)
-            {
-                auto escapedValue = EscapeSingleQuotes(col.Value);
-                conditions.push_back(fmt::format("{}='{}'", col.Name, escapedValue));
-            }
-            else
-            {
-                conditions.push_back(fmt::format("{}={}", col.Name, col.Value));
-            }
+            break;
         }
-        condition = fmt::format("WHERE {}", fmt::join(conditions, fmt::format(" {} ", MAP_LOGOP_STRING.at(logOp))));
     }
+}
 
-    const std::string queryString = fmt::format("SELECT COUNT(*) FROM {} {}", tableName, condition);
+int SQLiteManager::GetCount(const std::string& tableName, const Criteria& selCriteria, LogicalOperator logOp)
+{
+    const std::string queryString =
+        fmt::format("SELECT COUNT(*) FROM {}{}", tableName, BuildWhereClause(selCriteria, logOp));
 
     int count = 0;
     try
     {
         const std::lock_guard<std::mutex> lock(m_mutex);
-        SQLite::Statement query(*m_db, queryString);
+        auto& query = GetStatement(queryString);
+        const StatementReset reset(query);
+
+        BindValues(query, 1, selCriteria);
 
         if (query.executeStep())
         {
@@ -368,33 +584,17 @@ size_t SQLiteManager::GetSize(const std::string& tableName,
     }
     selectedFields = fmt::format("{}", fmt::join(fieldNames, " + "));
 
-    std::string condition;
-    if (!selCriteria.empty())
-    {
-        std::vector<std::string> conditions;
-        for (const auto& col : selCriteria)
-        {
-            if (col.Type == ColumnType::TEXT)
-            {
-                auto escapedValue = EscapeSingleQuotes(col.Value);
-                conditions.push_back(fmt::format("{}='{}'", col.Name, escapedValue));
-            }
-            else
-            {
-                conditions.push_back(fmt::format("{}={}", col.Name, col.Value));
-            }
-        }
-        condition = fmt::format("WHERE {}", fmt::join(conditions, fmt::format(" {} ", MAP_LOGOP_STRING.at(logOp))));
-    }
-
-    const std::string queryString =
-        fmt::format("SELECT SUM({}) AS total_bytes FROM {} {}", selectedFields, tableName, condition);
+    const std::string queryString = fmt::format(
+        "SELECT SUM({}) AS total_bytes FROM {}{}", selectedFields, tableName, BuildWhereClause(selCriteria, logOp));
 
     size_t count = 0;
     try
     {
         const std::lock_guard<std::mutex> lock(m_mutex);
-        SQLite::Statement query(*m_db, queryString);
+        auto& query = GetStatement(queryString);
+        const StatementReset reset(query);
+
+        BindValues(query, 1, selCriteria);
 
         if (query.executeStep())
         {
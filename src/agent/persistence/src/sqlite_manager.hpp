@@ -8,11 +8,13 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace SQLite
 {
     class Database;
+    class Statement;
     class Transaction;
 } // namespace SQLite
 
@@ -45,6 +47,12 @@ public:
     /// @copydoc Persistence::CreateTable
     void CreateTable(const std::string& tableName, const column::Keys& cols) override;
 
+    /// @copydoc Persistence::ColumnExists
+    bool ColumnExists(const std::string& tableName, const std::string& columnName) override;
+
+    /// @copydoc Persistence::AddColumn
+    void AddColumn(const std::string& tableName, const column::ColumnKey& col) override;
+
     /// @copydoc Persistence::Insert
     void Insert(const std::string& tableName, const column::Row& cols) override;
 
@@ -59,6 +67,16 @@ public:
                 const column::Criteria& selCriteria = {},
                 column::LogicalOperator logOp = column::LogicalOperator::AND) override;
 
+    /// @copydoc Persistence::RemoveRange
+    int RemoveRange(const std::string& tableName,
+                    const column::ColumnName& rangeColumn,
+                    int64_t from,
+                    int64_t to,
+                    const column::Criteria& selCriteria = {},
+                    column::LogicalOperator logOp = column::LogicalOperator::AND,
+                    const column::Names& returnedFields = {},
+                    const std::function<void(const column::Row&)>& onRemoved = nullptr) override;
+
     /// @copydoc Persistence::DropTable
     void DropTable(const std::string& tableName) override;
 
@@ -71,6 +89,26 @@ public:
                                     column::OrderType orderType = column::OrderType::ASC,
                                     int limit = 0) override;
 
+    /// @copydoc Persistence::SelectWhile
+    void SelectWhile(const std::string& tableName,
+                     const column::Names& fields,
+                     const column::Criteria& selCriteria,
+                     column::LogicalOperator logOp,
+                     const column::Names& orderBy,
+                     column::OrderType orderType,
+                     const std::function<bool(const column::Row&)>& onRow) override;
+
+    /// @copydoc Persistence::SelectWhileAfter
+    void SelectWhileAfter(const std::string& tableName,
+                          const column::Names& fields,
+                          const column::ColumnName& afterColumn,
+                          int64_t after,
+                          const column::Criteria& selCriteria,
+                          column::LogicalOperator logOp,
+                          const column::Names& orderBy,
+                          column::OrderType orderType,
+                          const std::function<bool(const column::Row&)>& onRow) override;
+
     /// @copydoc Persistence::GetCount
     int GetCount(const std::string& tableName,
                  const column::Criteria& selCriteria = {},
@@ -97,9 +135,54 @@ private:
     /// @return Corresponding ColumnType enum.
     column::ColumnType ColumnTypeFromSQLiteType(const int type) const;
 
+    /// @brief Reads the current row of a statement.
+    /// @param query The statement positioned on a row.
+    /// @param row The row to fill, cleared first.
+    void ReadRow(const SQLite::Statement& query, column::Row& row) const;
+
+    /// @brief Builds a SELECT query string.
+    /// @param tableName The name of the table to select from.
+    /// @param fields Names to retrieve.
+    /// @param whereClause The WHERE clause, with its parameter placeholders, or empty for none.
+    /// @param orderBy Names to order the results by.
+    /// @param orderType The order type (ASC or DESC).
+    /// @param limit The maximum number of rows to retrieve, 0 for no limit. A positive limit is left as the last
+    /// parameter of the query, after the ones of the WHERE clause.
+    /// @return The SELECT query string.
+    std::string BuildSelectQuery(const std::string& tableName,
+                                 const column::Names& fields,
+                                 const std::string& whereClause,
+                                 const column::Names& orderBy,
+                                 column::OrderType orderType,
+                                 int limit) const;
+
+    /// @brief Steps a cached SELECT statement, handing each row to a callback until it asks to stop.
+    /// @param queryString The SELECT query string, with a placeholder for each parameter.
+    /// @param params The values to bind, in order.
+    /// @param onRow Callback invoked for each row. Returning false stops the selection.
+    void StepSelect(const std::string& queryString,
+                    const std::vector<column::ColumnValue>& params,
+                    const std::function<bool(const column::Row&)>& onRow);
+
     /// @brief Executes a raw SQL query on the database.
     /// @param query The SQL query string to execute.
-    void Execute(const std::string& query);
+    /// @return The number of rows modified by the query.
+    int Execute(const std::string& query);
+
+    /// @brief Executes a cached statement binding the given values to its parameters.
+    /// @param query The SQL query string, with a placeholder for each value.
+    /// @param params The values to bind, in order.
+    /// @return The number of rows modified by the query.
+    int Execute(const std::string& query, const std::vector<column::ColumnValue>& params);
+
+    /// @brief Returns the cached prepared statement for a query, preparing it on first use.
+    /// @details The caller must hold m_mutex and reset the statement once done with it.
+    /// @param query The SQL query string.
+    /// @return The prepared statement.
+    SQLite::Statement& GetStatement(const std::string& query);
+
+    /// @brief Finalizes all cached statements, used when the schema changes.
+    void ClearStatements();
 
     /// @brief Mutex for thread-safe operations.
     std::mutex m_mutex;
@@ -110,6 +193,9 @@ private:
     /// @brief Pointer to the SQLite database connection.
     std::unique_ptr<SQLite::Database> m_db;
 
+    /// @brief Prepared statements keyed by their SQL query string.
+    std::unordered_map<std::string, std::unique_ptr<SQLite::Statement>> m_statements;
+
     /// @brief Map of open transactions.
     std::map<TransactionId, std::unique_ptr<SQLite::Transaction>> m_transactions;
 
@@ -2,6 +2,7 @@
 
 #include <persistence.hpp>
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -10,6 +11,8 @@ class MockPersistence : public Persistence
 public:
     MOCK_METHOD(bool, TableExists, (const std::string& tableName), (override));
     MOCK_METHOD(void, CreateTable, (const std::string& tableName, const column::Keys& cols), (override));
+    MOCK_METHOD(bool, ColumnExists, (const std::string& tableName, const std::string& columnName), (override));
+    MOCK_METHOD(void, AddColumn, (const std::string& tableName, const column::ColumnKey& col), (override));
     MOCK_METHOD(void, Insert, (const std::string& tableName, const column::Row& cols), (override));
     MOCK_METHOD(void,
                 Update,
@@ -22,6 +25,17 @@ public:
                 Remove,
                 (const std::string& tableName, const column::Criteria& selCriteria, column::LogicalOperator logOp),
                 (override));
+    MOCK_METHOD(int,
+                RemoveRange,
+                (const std::string& tableName,
+                 const column::ColumnName& rangeColumn,
+                 int64_t from,
+                 int64_t to,
+                 const column::Criteria& selCriteria,
+                 column::LogicalOperator logOp,
+                 const column::Names& returnedFields,
+                 const std::function<void(const column::Row&)>& onRemoved),
+                (override));
     MOCK_METHOD(void, DropTable, (const std::string& tableName), (override));
     MOCK_METHOD(std::vector<column::Row>,
                 Select,
@@ -33,6 +47,28 @@ public:
                  column::OrderType orderType,
                  int limit),
                 (override));
+    MOCK_METHOD(void,
+                SelectWhile,
+                (const std::string& tableName,
+                 const column::Names& fields,
+                 const column::Criteria& selCriteria,
+                 column::LogicalOperator logOp,
+                 const column::Names& orderBy,
+                 column::OrderType orderType,
+                 const std::function<bool(const column::Row&)>& onRow),
+                (override));
+    MOCK_METHOD(void,
+                SelectWhileAfter,
+                (const std::string& tableName,
+                 const column::Names& fields,
+                 const column::ColumnName& afterColumn,
+                 int64_t after,
+                 const column::Criteria& selCriteria,
+                 column::LogicalOperator logOp,
+                 const column::Names& orderBy,
+                 column::OrderType orderType,
+                 const std::function<bool(const column::Row&)>& onRow),
+                (override));
     MOCK_METHOD(int,
                 GetCount,
                 (const std::string& tableName, const column::Criteria& selCriteria, column::LogicalOperator logOp),
@@ -0,0 +1,73 @@
+#include <sqlite_manager.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+using namespace column;
+
+namespace
+{
+    const std::string BENCHMARK_DB_NAME = "benchmark_sqlite_manager.db";
+    const std::string BENCHMARK_TABLE_NAME = "benchmark";
+    constexpr int DEFAULT_INSERTS = 100000;
+    constexpr int INSERTS_PER_TRANSACTION = 1000;
+
+    /// @brief Inserts rows shaped like the ones stored by the message queue and returns the elapsed seconds.
+    double RunInserts(SQLiteManager& db, int inserts)
+    {
+        const std::string message =
+            R"({"event":{"original":"Jan 01 00:00:00 host sshd[1234]: Accepted publickey for user's key"}})";
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < inserts; i += INSERTS_PER_TRANSACTION)
+        {
+            const auto transaction = db.BeginTransaction();
+
+            for (int j = i; j < i + INSERTS_PER_TRANSACTION && j < inserts; ++j)
+            {
+                db.Insert(BENCHMARK_TABLE_NAME,
+                          {ColumnValue("module_name", ColumnType::TEXT, "logcollector"),
+                           ColumnValue("module_type", ColumnType::TEXT, "file"),
+                           ColumnValue("metadata", ColumnType::TEXT, R"({"module":"logcollector","type":"file"})"),
+                           ColumnValue("message", ColumnType::TEXT, message),
+                           ColumnValue("size", ColumnType::INTEGER, std::to_string(message.size()))});
+            }
+
+            db.CommitTransaction(transaction);
+        }
+
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+} // namespace
+
+/// @brief Measures SQLiteManager::Insert throughput. Usage: benchmark_SQLiteManager [inserts]
+int main(int argc, char** argv)
+{
+    const int inserts = argc > 1 ? std::stoi(argv[1]) : DEFAULT_INSERTS;
+
+    std::filesystem::remove(BENCHMARK_DB_NAME);
+
+    {
+        SQLiteManager db(BENCHMARK_DB_NAME);
+        db.CreateTable(BENCHMARK_TABLE_NAME,
+                       {ColumnKey("module_name", ColumnType::TEXT),
+                        ColumnKey("module_type", ColumnType::TEXT),
+                        ColumnKey("metadata", ColumnType::TEXT),
+                        ColumnKey("message", ColumnType::TEXT, NOT_NULL),
+                        ColumnKey("size", ColumnType::INTEGER)});
+
+        const auto seconds = RunInserts(db, inserts);
+
+        std::cout << "Insert: " << inserts << " rows in " << seconds << " s ("
+                  << static_cast<long long>(inserts / seconds) << " inserts/s)\n";
+    }
+
+    std::filesystem::remove(BENCHMARK_DB_NAME);
+    std::filesystem::remove(BENCHMARK_DB_NAME + "-wal");
+    std::filesystem::remove(BENCHMARK_DB_NAME + "-shm");
+
+    return 0;
+}
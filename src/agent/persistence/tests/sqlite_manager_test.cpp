@@ -280,6 +280,154 @@ TEST_F(SQLiteManagerTest, SelectTest)
     EXPECT_EQ(ret[0][1].Value, "3.5");
 }
 
+TEST_F(SQLiteManagerTest, SelectWhileTest)
+{
+    AddTestData();
+
+    const Names cols {ColumnName("Name", ColumnType::TEXT)};
+
+    // all rows are visited when the callback never stops
+    std::vector<std::string> names;
+    m_db->SelectWhile(m_tableName,
+                      cols,
+                      {},
+                      LogicalOperator::AND,
+                      {ColumnName("Name", ColumnType::TEXT)},
+                      OrderType::DESC,
+                      [&names](const Row& row)
+                      {
+                          names.push_back(row[0].Value);
+                          return true;
+                      });
+
+    EXPECT_EQ(names.size(), 6);
+    EXPECT_EQ(names[0], "MyTestName");
+    EXPECT_EQ(names[5], "ItemName");
+
+    // selection stops as soon as the callback returns false
+    names.clear();
+    m_db->SelectWhile(m_tableName,
+                      cols,
+                      {},
+                      LogicalOperator::AND,
+                      {ColumnName("rowid", ColumnType::INTEGER)},
+                      OrderType::ASC,
+                      [&names](const Row& row)
+                      {
+                          names.push_back(row[0].Value);
+                          return names.size() < 2;
+                      });
+
+    EXPECT_EQ(names.size(), 2);
+    EXPECT_EQ(names[0], "ItemName");
+    EXPECT_EQ(names[1], "MyTestName");
+
+    // selection criteria are applied
+    names.clear();
+    m_db->SelectWhile(m_tableName,
+                      cols,
+                      {ColumnValue("Amount", ColumnType::REAL, "3.5")},
+                      LogicalOperator::AND,
+                      {},
+                      OrderType::ASC,
+                      [&names](const Row& row)
+                      {
+                          names.push_back(row[0].Value);
+                          return true;
+                      });
+
+    EXPECT_EQ(names.size(), 1);
+    EXPECT_EQ(names[0], "ItemName5");
+}
+
+TEST_F(SQLiteManagerTest, SelectWhileAfterTest)
+{
+    AddTestData();
+
+    const Names cols {ColumnName("Name", ColumnType::TEXT)};
+    const ColumnName orden("Orden", ColumnType::INTEGER);
+
+    // only rows past the bound are visited
+    std::vector<std::string> names;
+    m_db->SelectWhileAfter(m_tableName,
+                           cols,
+                           orden,
+                           0,
+                           {},
+                           LogicalOperator::AND,
+                           {orden},
+                           OrderType::ASC,
+                           [&names](const Row& row)
+                           {
+                               names.push_back(row[0].Value);
+                               return true;
+                           });
+
+    ASSERT_EQ(names.size(), 2);
+    EXPECT_EQ(names[0], "ItemName4");
+    EXPECT_EQ(names[1], "ItemName5");
+
+    names.clear();
+    m_db->SelectWhileAfter(m_tableName,
+                           cols,
+                           orden,
+                           19,
+                           {},
+                           LogicalOperator::AND,
+                           {orden},
+                           OrderType::ASC,
+                           [&names](const Row& row)
+                           {
+                               names.push_back(row[0].Value);
+                               return true;
+                           });
+
+    ASSERT_EQ(names.size(), 1);
+    EXPECT_EQ(names[0], "ItemName5");
+
+    // selection criteria are combined with the bound
+    names.clear();
+    m_db->SelectWhileAfter(m_tableName,
+                           cols,
+                           orden,
+                           0,
+                           {ColumnValue("Module", ColumnType::TEXT, "ItemModule4"),
+                            ColumnValue("Module", ColumnType::TEXT, "ItemModule3")},
+                           LogicalOperator::OR,
+                           {},
+                           OrderType::ASC,
+                           [&names](const Row& row)
+                           {
+                               names.push_back(row[0].Value);
+                               return true;
+                           });
+
+    ASSERT_EQ(names.size(), 1);
+    EXPECT_EQ(names[0], "ItemName4");
+}
+
+TEST_F(SQLiteManagerTest, AddColumnTest)
+{
+    const ColumnKey col1 {"Id", ColumnType::INTEGER, NOT_NULL | PRIMARY_KEY | AUTO_INCREMENT};
+    const ColumnKey col2 {"Name", ColumnType::TEXT, NOT_NULL};
+    EXPECT_NO_THROW(m_db->CreateTable("AlterMe", {col1, col2}));
+    m_db->Insert("AlterMe", {ColumnValue("Name", ColumnType::TEXT, "ItemName")});
+
+    EXPECT_TRUE(m_db->ColumnExists("AlterMe", "Name"));
+    EXPECT_FALSE(m_db->ColumnExists("AlterMe", "Size"));
+
+    EXPECT_NO_THROW(m_db->AddColumn("AlterMe", ColumnKey("Size", ColumnType::INTEGER)));
+    EXPECT_TRUE(m_db->ColumnExists("AlterMe", "Size"));
+
+    // existing rows get NULL in the new column
+    const auto ret =
+        m_db->Select("AlterMe", {ColumnName("Name", ColumnType::TEXT), ColumnName("Size", ColumnType::INTEGER)});
+    ASSERT_EQ(ret.size(), 1);
+    EXPECT_EQ(ret[0][1].Value, "");
+
+    EXPECT_NO_THROW(m_db->DropTable("AlterMe"));
+}
+
 TEST_F(SQLiteManagerTest, RemoveTest)
 {
     AddTestData();
@@ -299,6 +447,45 @@ TEST_F(SQLiteManagerTest, RemoveTest)
     EXPECT_EQ(count, 0);
 }
 
+TEST_F(SQLiteManagerTest, RemoveRangeTest)
+{
+    AddTestData();
+
+    const auto rows = m_db->Select(m_tableName,
+                                   {ColumnName("rowid", ColumnType::INTEGER)},
+                                   {},
+                                   LogicalOperator::AND,
+                                   {ColumnName("rowid", ColumnType::INTEGER)},
+                                   OrderType::ASC);
+    ASSERT_EQ(rows.size(), 6);
+
+    const auto first = std::stoll(rows[1][0].Value);
+    const auto last = std::stoll(rows[4][0].Value);
+
+    // criteria narrow the range
+    EXPECT_EQ(m_db->RemoveRange(m_tableName,
+                                ColumnName("rowid", ColumnType::INTEGER),
+                                first,
+                                last,
+                                {ColumnValue("Module", ColumnType::TEXT, "ItemModule3"),
+                                 ColumnValue("Module", ColumnType::TEXT, "ItemModule4")},
+                                LogicalOperator::OR),
+              2);
+    EXPECT_EQ(m_db->GetCount(m_tableName), 4);
+
+    // only rows within the range are removed
+    EXPECT_EQ(m_db->RemoveRange(m_tableName, ColumnName("rowid", ColumnType::INTEGER), first, last), 2);
+    EXPECT_EQ(m_db->GetCount(m_tableName), 2);
+
+    const auto remaining = m_db->Select(m_tableName, {ColumnName("Name", ColumnType::TEXT)});
+    ASSERT_EQ(remaining.size(), 2);
+    EXPECT_EQ(remaining[0][0].Value, "ItemName");
+    EXPECT_EQ(remaining[1][0].Value, "ItemName5");
+
+    // empty ranges remove nothing
+    EXPECT_EQ(m_db->RemoveRange(m_tableName, ColumnName("rowid", ColumnType::INTEGER), first, last), 0);
+}
+
 TEST_F(SQLiteManagerTest, UpdateTest)
 {
     AddTestData();
@@ -340,6 +527,39 @@ TEST_F(SQLiteManagerTest, UpdateTest)
     ret = m_db->Select(m_tableName, {}, {});
 }
 
+TEST_F(SQLiteManagerTest, RemoveRangeReturningTest)
+{
+    AddTestData();
+
+    const auto rows = m_db->Select(m_tableName,
+                                   {ColumnName("rowid", ColumnType::INTEGER)},
+                                   {},
+                                   LogicalOperator::AND,
+                                   {ColumnName("rowid", ColumnType::INTEGER)},
+                                   OrderType::ASC);
+    ASSERT_EQ(rows.size(), 6);
+
+    std::vector<std::string> removedNames;
+    EXPECT_EQ(m_db->RemoveRange(m_tableName,
+                                ColumnName("rowid", ColumnType::INTEGER),
+                                std::stoll(rows[3][0].Value),
+                                std::stoll(rows[5][0].Value),
+                                {},
+                                LogicalOperator::AND,
+                                {ColumnName("Name", ColumnType::TEXT), ColumnName("Orden", ColumnType::INTEGER)},
+                                [&removedNames](const Row& row)
+                                {
+                                    ASSERT_EQ(row.size(), 2);
+                                    removedNames.push_back(row[0].Value);
+                                }),
+              3);
+
+    ASSERT_EQ(removedNames.size(), 3);
+    EXPECT_EQ(removedNames[0], "ItemName3");
+    EXPECT_EQ(removedNames[2], "ItemName5");
+    EXPECT_EQ(m_db->GetCount(m_tableName), 3);
+}
+
 TEST_F(SQLiteManagerTest, TransactionTest)
 {
     {
@@ -394,3 +614,59 @@ TEST_F(SQLiteManagerTest, DropTableTest)
 
     EXPECT_ANY_THROW(auto ret = m_db->Select("DropMe", {}, {}));
 }
+
+TEST_F(SQLiteManagerTest, BoundValuesAreNotInterpretedTest)
+{
+    AddTestData();
+
+    const std::string quotedName = "It's a name'; DROP TABLE TestTable; --";
+    m_db->Insert(m_tableName,
+                 {ColumnValue("Name", ColumnType::TEXT, quotedName),
+                  ColumnValue("Status", ColumnType::TEXT, "Quoted")});
+
+    auto ret = m_db->Select(
+        m_tableName, {ColumnName("Status", ColumnType::TEXT)}, {ColumnValue("Name", ColumnType::TEXT, quotedName)});
+    ASSERT_EQ(ret.size(), 1);
+    EXPECT_EQ(ret[0][0].Value, "Quoted");
+
+    m_db->Update(m_tableName,
+                 {ColumnValue("Status", ColumnType::TEXT, "Can't")},
+                 {ColumnValue("Name", ColumnType::TEXT, quotedName)});
+    EXPECT_EQ(m_db->GetCount(m_tableName, {ColumnValue("Status", ColumnType::TEXT, "Can't")}), 1);
+    EXPECT_EQ(m_db->GetCount(m_tableName), 7);
+}
+
+TEST_F(SQLiteManagerTest, CachedStatementsAreReusedTest)
+{
+    AddTestData();
+
+    // the same statement is bound and stepped again with different values and limits
+    for (int limit = 1; limit <= 3; ++limit)
+    {
+        const auto ret = m_db->Select(m_tableName,
+                                      {ColumnName("Name", ColumnType::TEXT)},
+                                      {ColumnValue("Status", ColumnType::TEXT, "ItemStatus")},
+                                      LogicalOperator::OR,
+                                      {},
+                                      OrderType::ASC,
+                                      limit);
+        EXPECT_EQ(ret.size(), 1);
+    }
+
+    const auto ret = m_db->Select(
+        m_tableName, {ColumnName("Name", ColumnType::TEXT)}, {}, LogicalOperator::AND, {}, OrderType::ASC, 4);
+    EXPECT_EQ(ret.size(), 4);
+
+    // statements survive the table being dropped and created again
+    const ColumnKey col1 {"Name", ColumnType::TEXT, NOT_NULL};
+    EXPECT_NO_THROW(m_db->CreateTable("Recreated", {col1}));
+    m_db->Insert("Recreated", {ColumnValue("Name", ColumnType::TEXT, "First")});
+    EXPECT_EQ(m_db->GetCount("Recreated"), 1);
+    EXPECT_NO_THROW(m_db->DropTable("Recreated"));
+    EXPECT_FALSE(m_db->TableExists("Recreated"));
+    EXPECT_NO_THROW(m_db->CreateTable("Recreated", {col1}));
+    EXPECT_TRUE(m_db->TableExists("Recreated"));
+    m_db->Insert("Recreated", {ColumnValue("Name", ColumnType::TEXT, "Second")});
+    EXPECT_EQ(m_db->GetCount("Recreated"), 1);
+    EXPECT_NO_THROW(m_db->DropTable("Recreated"));
+}
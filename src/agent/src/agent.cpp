@@ -144,29 +144,39 @@ void Agent::Run()
                                                                     { PushCommandsToQueue(m_messageQueue, response); }),
                               "FetchCommands");
 
-    m_taskManager.EnqueueTask(m_communicator.StatefulMessageProcessingTask(
-                                  [this](const size_t numMessages)
-                                  {
-                                      return GetMessagesFromQueue(m_messageQueue,
-                                                                  MessageType::STATEFUL,
-                                                                  numMessages,
-                                                                  [this]() { return m_agentInfo->GetMetadataInfo(); });
-                                  },
-                                  [this]([[maybe_unused]] const int messageCount, const std::string&)
-                                  { PopMessagesFromQueue(m_messageQueue, MessageType::STATEFUL, messageCount); }),
-                              "Stateful");
-
-    m_taskManager.EnqueueTask(m_communicator.StatelessMessageProcessingTask(
-                                  [this](const size_t numMessages)
-                                  {
-                                      return GetMessagesFromQueue(m_messageQueue,
-                                                                  MessageType::STATELESS,
-                                                                  numMessages,
-                                                                  [this]() { return m_agentInfo->GetMetadataInfo(); });
-                                  },
-                                  [this]([[maybe_unused]] const int messageCount, const std::string&)
-                                  { PopMessagesFromQueue(m_messageQueue, MessageType::STATELESS, messageCount); }),
-                              "Stateless");
+    // Each channel may have several batches in flight, every one of them acknowledged by its own id
+    auto statefulBatches = std::make_shared<InFlightBatches>();
+    m_taskManager.EnqueueTask(
+        m_communicator.StatefulMessageProcessingTask(
+            [this, statefulBatches](const size_t numMessages, const uint64_t batchId)
+            {
+                return GetMessagesFromQueue(m_messageQueue,
+                                            MessageType::STATEFUL,
+                                            numMessages,
+                                            [this]() { return m_agentInfo->GetMetadataInfo(); },
+                                            statefulBatches,
+                                            batchId);
+            },
+            [this, statefulBatches](const uint64_t batchId, [[maybe_unused]] const int messageCount, const std::string&)
+            { PopMessagesFromQueue(m_messageQueue, MessageType::STATEFUL, *statefulBatches, batchId); }),
+        "Stateful");
+
+    auto statelessBatches = std::make_shared<InFlightBatches>();
+    m_taskManager.EnqueueTask(
+        m_communicator.StatelessMessageProcessingTask(
+            [this, statelessBatches](const size_t numMessages, const uint64_t batchId)
+            {
+                return GetMessagesFromQueue(m_messageQueue,
+                                            MessageType::STATELESS,
+                                            numMessages,
+                                            [this]() { return m_agentInfo->GetMetadataInfo(); },
+                                            statelessBatches,
+                                            batchId);
+            },
+            [this, statelessBatches](
+                const uint64_t batchId, [[maybe_unused]] const int messageCount, const std::string&)
+            { PopMessagesFromQueue(m_messageQueue, MessageType::STATELESS, *statelessBatches, batchId); }),
+        "Stateless");
 
     m_moduleManager->AddModules();
     m_moduleManager->Start();
@@ -1,13 +1,82 @@
 #include <imultitype_queue.hpp>
 #include <message_queue_utils.hpp>
 
+#include <algorithm>
+#include <utility>
 #include <vector>
 
+void InFlightBatches::Add(uint64_t batchId, const MessageRange& range, size_t size)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_batches[batchId] = {range, size};
+}
+
+std::optional<MessageRange> InFlightBatches::Remove(uint64_t batchId)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto it = m_batches.find(batchId);
+    if (it == m_batches.end())
+    {
+        return std::nullopt;
+    }
+
+    const auto range = it->second.range;
+    m_batches.erase(it);
+    return range;
+}
+
+int64_t InFlightBatches::LastRowId() const
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    return LastRowIdLocked();
+}
+
+size_t InFlightBatches::Size() const
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    size_t size = 0;
+    for (const auto& [batchId, batch] : m_batches)
+    {
+        size += batch.size;
+    }
+    return size;
+}
+
+MessageBatch InFlightBatches::Fetch(uint64_t batchId, const std::function<MessageBatch(int64_t)>& fetch)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto batch = fetch(LastRowIdLocked());
+
+    if (batch.count > 0)
+    {
+        m_batches[batchId] = {batch.range, batch.size};
+    }
+
+    return batch;
+}
+
+int64_t InFlightBatches::LastRowIdLocked() const
+{
+    // New rows are always stored past the rows still in the queue, so once the batch holding the last row is
+    // acknowledged, rows stored afterwards may reuse its ids and must be reachable again
+    int64_t lastRowId = 0;
+    for (const auto& [batchId, batch] : m_batches)
+    {
+        lastRowId = std::max(lastRowId, batch.range.last);
+    }
+    return lastRowId;
+}
+
 boost::asio::awaitable<std::tuple<int, std::string>>
 GetMessagesFromQueue(std::shared_ptr<IMultiTypeQueue> multiTypeQueue,
                      MessageType messageType,
                      const size_t messagesSize,
-                     std::function<std::string()> getMetadataInfo)
+                     std::function<std::string()> getMetadataInfo,
+                     std::shared_ptr<InFlightBatches> batches,
+                     const uint64_t batchId)
 {
     std::string output;
 
@@ -16,19 +85,31 @@ GetMessagesFromQueue(std::shared_ptr<IMultiTypeQueue> multiTypeQueue,
         output = getMetadataInfo();
     }
 
-    const auto messages = co_await multiTypeQueue->getNextBytesAwaitable(messageType, messagesSize, "", "");
-    for (const auto& message : messages)
-    {
-        output += (message.metaData.empty() ? "" : "\n" + message.metaData) +
-                  (message.data.dump() == "{}" ? "" : "\n" + message.data.dump());
-    }
+    // The messages in flight are still stored but are not sent again, so they do not fill the next batch
+    const auto inFlightSize =
+        batches != nullptr ? std::function<size_t()>([batches]() { return batches->Size(); }) : nullptr;
 
-    co_return std::tuple<int, std::string> {static_cast<int>(messages.size()), output};
+    co_await multiTypeQueue->waitForBytesAwaitable(messageType, messagesSize, inFlightSize);
+
+    // The stored messages are appended to the metadata as they are, without being parsed again.
+    // The rows in flight are only looked up once the wait is over, as acknowledgements may arrive during it.
+    const auto fetch = [&](int64_t afterRowId)
+    { return multiTypeQueue->getNextBatch(messageType, messagesSize, std::move(output), "", "", afterRowId); };
+
+    auto batch = batches != nullptr ? batches->Fetch(batchId, fetch) : fetch(0);
+
+    co_return std::tuple<int, std::string> {batch.count, std::move(batch.body)};
 }
 
-void PopMessagesFromQueue(std::shared_ptr<IMultiTypeQueue> multiTypeQueue, MessageType messageType, int numMessages)
+void PopMessagesFromQueue(std::shared_ptr<IMultiTypeQueue> multiTypeQueue,
+                          MessageType messageType,
+                          InFlightBatches& batches,
+                          const uint64_t batchId)
 {
-    multiTypeQueue->popN(messageType, numMessages);
+    if (const auto range = batches.Remove(batchId))
+    {
+        multiTypeQueue->popRange(messageType, *range);
+    }
 }
 
 void PushCommandsToQueue(std::shared_ptr<IMultiTypeQueue> multiTypeQueue, const std::string& commands)
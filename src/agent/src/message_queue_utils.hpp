@@ -6,30 +6,101 @@
 #include <boost/asio/awaitable.hpp>
 #include <nlohmann/json.hpp>
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <tuple>
 
 class IMultiTypeQueue;
 
+/// @brief Keeps the range of queue rows of each batch sent to the server and not yet acknowledged
+///
+/// Batches are read from the queue past the last row already in flight, so several of them can be
+/// in flight at once, and each one is acknowledged by its id in whatever order responses arrive.
+class InFlightBatches
+{
+public:
+    /// @brief Registers a batch as in flight
+    /// @param batchId The id of the batch
+    /// @param range The range of queue rows the batch carries
+    /// @param size The bytes the batch accounts for in the queue size
+    void Add(uint64_t batchId, const MessageRange& range, size_t size = 0);
+
+    /// @brief Takes a batch out of flight
+    /// @param batchId The id of the batch
+    /// @return The range of queue rows the batch carries, if it was in flight
+    std::optional<MessageRange> Remove(uint64_t batchId);
+
+    /// @brief Gets the last queue row carried by the batches in flight
+    /// @return The row id, 0 if there are no batches in flight
+    int64_t LastRowId() const;
+
+    /// @brief Gets the bytes the batches in flight account for in the queue size
+    /// @return The bytes, 0 if there are no batches in flight
+    size_t Size() const;
+
+    /// @brief Fetches a batch past the last row in flight and registers it as in flight
+    ///
+    /// The bound is read and the batch fetched under the lock, so no batch in flight is acknowledged
+    /// meanwhile, and new rows cannot reuse its row ids while they are still skipped.
+    /// @param batchId The id of the batch
+    /// @param fetch Fetches the batch past the given row id
+    /// @return The fetched batch
+    MessageBatch Fetch(uint64_t batchId, const std::function<MessageBatch(int64_t)>& fetch);
+
+private:
+    /// @brief Gets the last queue row carried by the batches in flight. m_mutex must be held
+    /// @return The row id, 0 if there are no batches in flight
+    int64_t LastRowIdLocked() const;
+
+    /// @brief Batch sent to the server and not yet acknowledged
+    struct Batch
+    {
+        /// @brief Range of queue rows the batch carries
+        MessageRange range;
+
+        /// @brief Bytes the batch accounts for in the queue size
+        size_t size = 0;
+    };
+
+    /// @brief Mutex protecting the batches
+    mutable std::mutex m_mutex;
+
+    /// @brief Each batch in flight by its id
+    std::map<uint64_t, Batch> m_batches;
+};
+
 /// @brief Gets messages from a queue and returns them as a JSON string
 /// @param multiTypeQueue The queue to get messages from
 /// @param messageType The type of messages to get from the queue
 /// @param messagesSize Minimum size of messages in bytes to get from the queue
 /// @param getMetadataInfo Function to get the agent metadata
+/// @param batches If not null, only messages past the batches in flight are retrieved, and they are
+/// registered in it as a new batch. The messages in flight do not count towards the size waited for
+/// @param batchId The id under which the retrieved messages are registered
 /// @return A string containing the messages from the queue
 boost::asio::awaitable<std::tuple<int, std::string>>
 GetMessagesFromQueue(std::shared_ptr<IMultiTypeQueue> multiTypeQueue,
                      MessageType messageType,
                      const size_t messagesSize,
-                     std::function<std::string()> getMetadataInfo);
+                     std::function<std::string()> getMetadataInfo,
+                     std::shared_ptr<InFlightBatches> batches = nullptr,
+                     const uint64_t batchId = 0);
 
-/// @brief Removes a fixed number of messages from the specified queue
+/// @brief Removes the messages of an acknowledged batch from the specified queue
 /// @param multiTypeQueue The queue from which to remove messages
 /// @param messageType The type of messages to remove
-/// @param numMessages The number of messages to remove from the queue
-void PopMessagesFromQueue(std::shared_ptr<IMultiTypeQueue> multiTypeQueue, MessageType messageType, int numMessages);
+/// @param batches The batches in flight, as registered by GetMessagesFromQueue
+/// @param batchId The id of the acknowledged batch
+void PopMessagesFromQueue(std::shared_ptr<IMultiTypeQueue> multiTypeQueue,
+                          MessageType messageType,
+                          InFlightBatches& batches,
+                          const uint64_t batchId);
 
 /// @brief Pushes a batch of commands to the specified queue
 /// @param multiTypeQueue The queue to push commands to
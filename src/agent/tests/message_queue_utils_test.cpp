@@ -28,15 +28,15 @@ protected:
 
 TEST_F(MessageQueueUtilsTest, GetMessagesFromQueueTestBySize)
 {
-    const std::vector<std::string> data {R"({"event":{"original":"Testing message!"}})"};
-    const std::string metadata {R"({"module":"logcollector","type":"file"})"};
-    std::vector<Message> testMessages;
-    testMessages.emplace_back(MessageType::STATELESS, data, "", "", metadata);
+    const std::string body = std::string("\n") + R"({"module":"logcollector","type":"file"})" + std::string("\n") +
+                             R"({"event":{"original":"Testing message!"}})";
 
     // NOLINTBEGIN(cppcoreguidelines-avoid-capturing-lambda-coroutines)
-    EXPECT_CALL(*mockQueue, getNextBytesAwaitable(MessageType::STATELESS, MIN_SIZE_OF_MESSAGES, "", ""))
-        .WillOnce([&testMessages]() -> boost::asio::awaitable<std::vector<Message>> { co_return testMessages; });
+    EXPECT_CALL(*mockQueue, waitForBytesAwaitable(MessageType::STATELESS, MIN_SIZE_OF_MESSAGES, ::testing::_))
+        .WillOnce([]() -> boost::asio::awaitable<bool> { co_return true; });
     // NOLINTEND(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    EXPECT_CALL(*mockQueue, getNextBatch(MessageType::STATELESS, MIN_SIZE_OF_MESSAGES, "", "", "", 0))
+        .WillOnce(::testing::Return(MessageBatch {body, 1, {1, 1}}));
 
     auto awaitableResult =
         boost::asio::co_spawn(io_context,
@@ -49,28 +49,26 @@ TEST_F(MessageQueueUtilsTest, GetMessagesFromQueueTestBySize)
     ASSERT_TRUE(awaitableResult.wait_for(std::chrono::milliseconds(1)) == std::future_status::ready);
 
     const auto result = awaitableResult.get();
-    const auto jsonResult = std::get<1>(result);
 
-    const std::string expectedString = std::string("\n") + R"({"module":"logcollector","type":"file"})" +
-                                       std::string("\n") + R"(["{\"event\":{\"original\":\"Testing message!\"}}"])";
-
-    ASSERT_EQ(jsonResult, expectedString);
+    ASSERT_EQ(std::get<0>(result), 1);
+    ASSERT_EQ(std::get<1>(result), body);
 }
 
 TEST_F(MessageQueueUtilsTest, GetMessagesFromQueueMetadataTest)
 {
-    const std::vector<std::string> data {R"({"event":{"original":"Testing message!"}})"};
-    const std::string moduleMetadata {R"({"module":"logcollector","type":"file"})"};
-    std::vector<Message> testMessages;
-    testMessages.emplace_back(MessageType::STATELESS, data, "", "", moduleMetadata);
-
     nlohmann::json metadata;
     metadata["agent"] = "test";
 
+    const std::string messages = std::string("\n") + R"({"module":"logcollector","type":"file"})" +
+                                 std::string("\n") + R"({"event":{"original":"Testing message!"}})";
+
+    // The metadata is handed to the queue as the start of the body, the messages are appended to it
     // NOLINTBEGIN(cppcoreguidelines-avoid-capturing-lambda-coroutines)
-    EXPECT_CALL(*mockQueue, getNextBytesAwaitable(MessageType::STATELESS, MIN_SIZE_OF_MESSAGES, "", ""))
-        .WillOnce([&testMessages]() -> boost::asio::awaitable<std::vector<Message>> { co_return testMessages; });
+    EXPECT_CALL(*mockQueue, waitForBytesAwaitable(MessageType::STATELESS, MIN_SIZE_OF_MESSAGES, ::testing::_))
+        .WillOnce([]() -> boost::asio::awaitable<bool> { co_return true; });
     // NOLINTEND(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    EXPECT_CALL(*mockQueue, getNextBatch(MessageType::STATELESS, MIN_SIZE_OF_MESSAGES, metadata.dump(), "", "", 0))
+        .WillOnce(::testing::Return(MessageBatch {metadata.dump() + messages, 1, {1, 1}}));
 
     io_context.restart();
 
@@ -86,29 +84,22 @@ TEST_F(MessageQueueUtilsTest, GetMessagesFromQueueMetadataTest)
     ASSERT_TRUE(awaitableResult.wait_for(std::chrono::milliseconds(1)) == std::future_status::ready);
 
     const auto result = awaitableResult.get();
-    const auto jsonResult = std::get<1>(result);
 
-    const std::string expectedString = R"({"agent":"test"})" + std::string("\n") +
-                                       R"({"module":"logcollector","type":"file"})" + std::string("\n") +
-                                       R"(["{\"event\":{\"original\":\"Testing message!\"}}"])";
-
-    ASSERT_EQ(jsonResult, expectedString);
+    ASSERT_EQ(std::get<0>(result), 1);
+    ASSERT_EQ(std::get<1>(result), R"({"agent":"test"})" + messages);
 }
 
 TEST_F(MessageQueueUtilsTest, GetEmptyMessagesFromQueueTest)
 {
-    const nlohmann::json data = nlohmann::json::object();
-    const std::string moduleMetadata {R"({"operation":"delete"})"};
-    std::vector<Message> testMessages;
-    testMessages.emplace_back(MessageType::STATEFUL, data, "", "", moduleMetadata);
-
     nlohmann::json metadata;
     metadata["agent"] = "test";
 
     // NOLINTBEGIN(cppcoreguidelines-avoid-capturing-lambda-coroutines)
-    EXPECT_CALL(*mockQueue, getNextBytesAwaitable(MessageType::STATEFUL, MIN_SIZE_OF_MESSAGES, "", ""))
-        .WillOnce([&testMessages]() -> boost::asio::awaitable<std::vector<Message>> { co_return testMessages; });
+    EXPECT_CALL(*mockQueue, waitForBytesAwaitable(MessageType::STATEFUL, MIN_SIZE_OF_MESSAGES, ::testing::_))
+        .WillOnce([]() -> boost::asio::awaitable<bool> { co_return true; });
     // NOLINTEND(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    EXPECT_CALL(*mockQueue, getNextBatch(MessageType::STATEFUL, MIN_SIZE_OF_MESSAGES, metadata.dump(), "", "", 0))
+        .WillOnce(::testing::Return(MessageBatch {metadata.dump(), 0, {}}));
 
     io_context.restart();
 
@@ -124,17 +115,159 @@ TEST_F(MessageQueueUtilsTest, GetEmptyMessagesFromQueueTest)
     ASSERT_TRUE(awaitableResult.wait_for(std::chrono::milliseconds(1)) == std::future_status::ready);
 
     const auto result = awaitableResult.get();
-    const auto jsonResult = std::get<1>(result);
 
-    const std::string expectedString = R"({"agent":"test"})" + std::string("\n") + R"({"operation":"delete"})";
+    ASSERT_EQ(std::get<0>(result), 0);
+    ASSERT_EQ(std::get<1>(result), R"({"agent":"test"})");
+}
+
+TEST_F(MessageQueueUtilsTest, GetMessagesFromQueueRegistersBatchTest)
+{
+    // NOLINTBEGIN(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    EXPECT_CALL(*mockQueue, waitForBytesAwaitable(MessageType::STATELESS, MIN_SIZE_OF_MESSAGES, ::testing::_))
+        .WillOnce([]() -> boost::asio::awaitable<bool> { co_return true; });
+    // NOLINTEND(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    EXPECT_CALL(*mockQueue, getNextBatch(MessageType::STATELESS, MIN_SIZE_OF_MESSAGES, "", "", "", 0))
+        .WillOnce(::testing::Return(MessageBatch {"\n{}\n{}", 2, {3, 7}}));
+
+    io_context.restart();
+
+    auto batches = std::make_shared<InFlightBatches>();
+    auto awaitableResult = boost::asio::co_spawn(
+        io_context,
+        GetMessagesFromQueue(mockQueue, MessageType::STATELESS, MIN_SIZE_OF_MESSAGES, nullptr, batches, 1),
+        boost::asio::use_future);
+
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(1);
+    io_context.run_until(timeout);
+
+    ASSERT_TRUE(awaitableResult.wait_for(std::chrono::milliseconds(1)) == std::future_status::ready);
+    ASSERT_EQ(std::get<0>(awaitableResult.get()), 2);
+    ASSERT_EQ(batches->LastRowId(), 7);
+
+    const auto range = batches->Remove(1);
+    ASSERT_TRUE(range.has_value());
+    ASSERT_EQ(range->first, 3);
+    ASSERT_EQ(range->last, 7);
+}
+
+TEST_F(MessageQueueUtilsTest, GetMessagesFromQueueSkipsBatchesInFlightTest)
+{
+    auto batches = std::make_shared<InFlightBatches>();
+    batches->Add(1, MessageRange {1, 5});
+    batches->Add(2, MessageRange {6, 9});
+
+    // NOLINTBEGIN(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    EXPECT_CALL(*mockQueue, waitForBytesAwaitable(MessageType::STATEFUL, MIN_SIZE_OF_MESSAGES, ::testing::_))
+        .WillOnce([]() -> boost::asio::awaitable<bool> { co_return true; });
+    // NOLINTEND(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    EXPECT_CALL(*mockQueue, getNextBatch(MessageType::STATEFUL, MIN_SIZE_OF_MESSAGES, "", "", "", 9))
+        .WillOnce(::testing::Return(MessageBatch {}));
+
+    io_context.restart();
+
+    auto awaitableResult = boost::asio::co_spawn(
+        io_context,
+        GetMessagesFromQueue(mockQueue, MessageType::STATEFUL, MIN_SIZE_OF_MESSAGES, nullptr, batches, 3),
+        boost::asio::use_future);
+
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(1);
+    io_context.run_until(timeout);
+
+    ASSERT_TRUE(awaitableResult.wait_for(std::chrono::milliseconds(1)) == std::future_status::ready);
+    ASSERT_EQ(std::get<0>(awaitableResult.get()), 0);
+    ASSERT_FALSE(batches->Remove(3).has_value());
+}
+
+TEST_F(MessageQueueUtilsTest, GetMessagesFromQueueLooksUpBatchesInFlightAfterWaitingTest)
+{
+    auto batches = std::make_shared<InFlightBatches>();
+    batches->Add(1, MessageRange {1, 5});
+    batches->Add(2, MessageRange {6, 9});
+
+    // The last batch is acknowledged while waiting, so its row ids may be reused by new messages
+    // NOLINTBEGIN(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    EXPECT_CALL(*mockQueue, waitForBytesAwaitable(MessageType::STATEFUL, MIN_SIZE_OF_MESSAGES, ::testing::_))
+        .WillOnce(
+            [batches]() -> boost::asio::awaitable<bool>
+            {
+                batches->Remove(2);
+                co_return true;
+            });
+    // NOLINTEND(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    EXPECT_CALL(*mockQueue, getNextBatch(MessageType::STATEFUL, MIN_SIZE_OF_MESSAGES, "", "", "", 5))
+        .WillOnce(::testing::Return(MessageBatch {"\n{}", 1, {6, 6}}));
+
+    io_context.restart();
+
+    auto awaitableResult = boost::asio::co_spawn(
+        io_context,
+        GetMessagesFromQueue(mockQueue, MessageType::STATEFUL, MIN_SIZE_OF_MESSAGES, nullptr, batches, 3),
+        boost::asio::use_future);
+
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(1);
+    io_context.run_until(timeout);
+
+    ASSERT_TRUE(awaitableResult.wait_for(std::chrono::milliseconds(1)) == std::future_status::ready);
+    ASSERT_EQ(std::get<0>(awaitableResult.get()), 1);
+    ASSERT_EQ(batches->LastRowId(), 6);
+}
+
+TEST_F(MessageQueueUtilsTest, GetMessagesFromQueueDoesNotWaitForBatchesInFlightTest)
+{
+    auto batches = std::make_shared<InFlightBatches>();
+    batches->Add(1, MessageRange {1, 5}, MIN_SIZE_OF_MESSAGES);
+
+    // NOLINTBEGIN(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    EXPECT_CALL(*mockQueue, waitForBytesAwaitable(MessageType::STATEFUL, MIN_SIZE_OF_MESSAGES, ::testing::_))
+        .WillOnce(
+            [batches](MessageType, size_t, const std::function<size_t()>& skippedBytes) -> boost::asio::awaitable<bool>
+            {
+                EXPECT_EQ(skippedBytes(), MIN_SIZE_OF_MESSAGES);
+
+                // Once the batch is acknowledged, its messages no longer count as skipped
+                batches->Remove(1);
+                EXPECT_EQ(skippedBytes(), 0);
+                co_return true;
+            });
+    // NOLINTEND(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    EXPECT_CALL(*mockQueue, getNextBatch(MessageType::STATEFUL, MIN_SIZE_OF_MESSAGES, "", "", "", 0))
+        .WillOnce(::testing::Return(MessageBatch {"\n{}", 1, {6, 6}, 4}));
+
+    io_context.restart();
+
+    auto awaitableResult = boost::asio::co_spawn(
+        io_context,
+        GetMessagesFromQueue(mockQueue, MessageType::STATEFUL, MIN_SIZE_OF_MESSAGES, nullptr, batches, 2),
+        boost::asio::use_future);
 
-    ASSERT_EQ(jsonResult, expectedString);
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(1);
+    io_context.run_until(timeout);
+
+    ASSERT_TRUE(awaitableResult.wait_for(std::chrono::milliseconds(1)) == std::future_status::ready);
+    ASSERT_EQ(std::get<0>(awaitableResult.get()), 1);
+    ASSERT_EQ(batches->Size(), 4);
 }
 
 TEST_F(MessageQueueUtilsTest, PopMessagesFromQueueTest)
 {
-    EXPECT_CALL(*mockQueue, popN(MessageType::STATEFUL, 1, "", "")).Times(1);
-    PopMessagesFromQueue(mockQueue, MessageType::STATEFUL, 1);
+    InFlightBatches batches;
+    batches.Add(1, MessageRange {1, 2});
+    batches.Add(2, MessageRange {3, 7});
+
+    EXPECT_CALL(*mockQueue,
+                popRange(MessageType::STATEFUL,
+                         ::testing::AllOf(::testing::Field(&MessageRange::first, 3),
+                                          ::testing::Field(&MessageRange::last, 7)),
+                         "",
+                         ""))
+        .WillOnce(::testing::Return(2));
+
+    // Acknowledged out of order, the later batch is popped and the earlier one stays in flight
+    PopMessagesFromQueue(mockQueue, MessageType::STATEFUL, batches, 2);
+    ASSERT_EQ(batches.LastRowId(), 2);
+
+    // A batch is popped only once
+    PopMessagesFromQueue(mockQueue, MessageType::STATEFUL, batches, 2);
 }
 
 TEST_F(MessageQueueUtilsTest, PushCommandsToQueueTest)
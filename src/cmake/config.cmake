@@ -39,16 +39,26 @@ set(DEFAULT_BATCH_INTERVAL "\"10000ms\"" CACHE STRING "Default Agent batch inter
 
 set(DEFAULT_BATCH_SIZE "\"1000000B\"" CACHE STRING "Default Agent batch size limit (1MB)")
 
+set(DEFAULT_MAX_BATCHES_IN_FLIGHT 1 CACHE STRING "Default Agent maximum number of batches waiting for a response per channel")
+
+set(DEFAULT_COMPRESSION_LEVEL 0 CACHE STRING "Default Agent event batch gzip level (0 disables compression)")
+
 set(DEFAULT_VERIFICATION_MODE "none" CACHE STRING "Default Agent verification mode")
 
 set(DEFAULT_LOGCOLLECTOR_ENABLED true CACHE BOOL "Default Logcollector enabled")
 
-set(BUFFER_SIZE 4096 CACHE STRING "Default Logcollector reading buffer size")
+set(BUFFER_SIZE 65536 CACHE STRING "Default Logcollector reading buffer size, longer lines are split")
 
 set(DEFAULT_FILE_WAIT "\"500ms\"" CACHE STRING "Default Logcollector file reading interval (500ms)")
 
 set(DEFAULT_RELOAD_INTERVAL "\"60000ms\"" CACHE STRING "Default Logcollector reload interval (1m)")
 
+set(DEFAULT_MULTILINE_TIMEOUT "\"1000ms\"" CACHE STRING "Default Logcollector multiline record timeout (1s)")
+
+set(MULTILINE_MAX_SIZE 1048576 CACHE STRING "Logcollector multiline record size limit, longer records are split")
+
+set(DEFAULT_MAX_EPS 0 CACHE STRING "Default Logcollector events per second limit of each source (0 disables it)")
+
 set(DEFAULT_INVENTORY_ENABLED true CACHE BOOL "Default inventory enabled")
 
 set(DEFAULT_INTERVAL "\"3600000ms\"" CACHE STRING "Default inventory interval (1h)")
@@ -79,6 +89,10 @@ set(QUEUE_STATUS_REFRESH_TIMER 100 CACHE STRING "Default Agent's queue refresh t
 
 set(QUEUE_DEFAULT_SIZE "\"10000B\"" CACHE STRING "Default Agent's queue size (10000)")
 
+set(QUEUE_DEFAULT_COMMIT_INTERVAL "\"0ms\"" CACHE STRING "Default Agent's queue commit interval (0ms, commit every message)")
+
+set(QUEUE_DEFAULT_COMMIT_SIZE 1000 CACHE STRING "Default Agent's queue commit size (1000)")
+
 set(DEFAULT_COMMANDS_REQUEST_TIMEOUT "\"11m\"" CACHE STRING "Default Agent's command request timeout (11m)")
 
 set(DEFAULT_SCA_ENABLED true CACHE BOOL "Default SCA enabled")
@@ -86,3 +100,5 @@ set(DEFAULT_SCA_ENABLED true CACHE BOOL "Default SCA enabled")
 set(DEFAULT_SCA_INTERVAL "\"1h\"" CACHE STRING "Default SCA interval (1h)")
 
 set(DEFAULT_SCA_SCAN_ON_START true CACHE BOOL "Default SCA scan on start")
+
+set(DEFAULT_SCA_COMMAND_CACHE_SIZE "\"10MB\"" CACHE STRING "Default SCA command cache size (10MB, 0 disables it)")
@@ -40,6 +40,9 @@ public:
     /// @brief Fills the processes information using a callback
     void processes(std::function<void(nlohmann::json&)>) override;
 
+    /// @copydoc ISysInfo::packagesFingerprint
+    std::string packagesFingerprint() override;
+
 private:
     /// @brief Returns the hardware information
     /// @return Hardware information
@@ -74,4 +77,8 @@ private:
 
     /// @brief Fills the processes information using a callback
     virtual void getProcessesInfo(const std::function<void(nlohmann::json&)>&) const;
+
+    /// @brief Returns a fingerprint of the sources the installed packages are read from
+    /// @return Fingerprint of the package sources, empty if it can't be computed
+    virtual std::string getPackagesFingerprint() const;
 };
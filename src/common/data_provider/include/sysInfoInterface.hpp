@@ -1,6 +1,7 @@
 #pragma once
 
 #include <nlohmann/json.hpp>
+#include <string>
 
 class ISysInfo
 {
@@ -44,4 +45,8 @@ public:
 
     /// @brief Fills the processes information using a callback
     virtual void processes(std::function<void(nlohmann::json&)>) = 0;
+
+    /// @brief Returns a fingerprint of the sources the installed packages are read from
+    /// @return Fingerprint that changes whenever a package source changes, empty if it can't be computed
+    virtual std::string packagesFingerprint() = 0;
 };
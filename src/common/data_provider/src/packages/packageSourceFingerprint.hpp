@@ -0,0 +1,108 @@
+#pragma once
+
+#include "filesystem_utils.hpp"
+
+#include <sys/stat.h>
+
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+/// @brief Fingerprint of the places installed packages are read from
+///
+/// The fingerprint is built from the inode, size and modification time of the package databases and of the
+/// directories language packages are installed in, so it changes whenever a package is installed, upgraded or
+/// removed, without reading any of them.
+class PackageSourceFingerprint final
+{
+public:
+    /// @brief PackageSourceFingerprint constructor
+    /// @param fsUtils File system utils used to expand the paths with wildcards
+    explicit PackageSourceFingerprint(std::unique_ptr<IFileSystemUtils> fsUtils = nullptr)
+        : m_fsUtils(fsUtils ? std::move(fsUtils) : std::make_unique<file_system::FileSystemUtils>())
+    {
+    }
+
+    /// @brief Adds the status of a file or directory
+    /// @param path Path to add, a missing path is part of the fingerprint too
+    void addPath(const std::string& path)
+    {
+        struct stat status {};
+
+        m_state << path;
+
+        if (stat(path.c_str(), &status) == 0)
+        {
+            m_state << ':' << status.st_ino << ':' << status.st_size << ':' << status.st_mtim.tv_sec << '.'
+                    << status.st_mtim.tv_nsec;
+        }
+
+        m_state << '\n';
+    }
+
+    /// @brief Adds the status of a directory and of each of its entries
+    /// @param path Path of the directory
+    void addDirectory(const std::string& path)
+    {
+        addPath(path);
+
+        try
+        {
+            std::error_code ec;
+
+            for (const auto& entry : std::filesystem::directory_iterator(path, ec))
+            {
+                addPath(entry.path().string());
+            }
+        }
+        catch (const std::exception&)
+        {
+            m_state << "unreadable\n";
+        }
+    }
+
+    /// @brief Adds the directories that match some patterns, as addDirectory does
+    /// @param patterns Paths to the directories, they may contain wildcards
+    /// @param subdirectory Subdirectory of each matching directory to add instead of the directory itself
+    void addDirectories(const std::set<std::string>& patterns, const std::string& subdirectory = "")
+    {
+        for (const auto& pattern : patterns)
+        {
+            std::deque<std::string> expandedPaths;
+
+            try
+            {
+                m_fsUtils->expand_absolute_path(pattern, expandedPaths);
+            }
+            catch (const std::exception&)
+            {
+                // Do nothing, continue with the next pattern
+            }
+
+            for (const auto& expandedPath : expandedPaths)
+            {
+                addDirectory(subdirectory.empty() ? expandedPath
+                                                  : (std::filesystem::path(expandedPath) / subdirectory).string());
+            }
+        }
+    }
+
+    /// @brief Returns the fingerprint of the paths added so far
+    /// @return Fingerprint
+    std::string value() const
+    {
+        return std::to_string(std::hash<std::string> {}(m_state.str()));
+    }
+
+private:
+    /// @brief Pointer to the file system utils
+    std::unique_ptr<IFileSystemUtils> m_fsUtils;
+
+    /// @brief Status of the added paths
+    std::ostringstream m_state;
+};
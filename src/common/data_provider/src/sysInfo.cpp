@@ -47,6 +47,11 @@ nlohmann::json SysInfo::hotfixes()
     return getHotfixes();
 }
 
+std::string SysInfo::packagesFingerprint()
+{
+    return getPackagesFingerprint();
+}
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -7,6 +7,7 @@
 #include "packages/berkeleyRpmDbHelper.h"
 #include "packages/modernPackageDataRetriever.hpp"
 #include "packages/packageLinuxDataRetriever.h"
+#include "packages/packageSourceFingerprint.hpp"
 #include "ports/portImpl.h"
 #include "ports/portLinuxWrapper.h"
 #include "sharedDefs.h"
@@ -610,6 +611,19 @@ void SysInfo::getPackages(const std::function<void(nlohmann::json&)>& callback)
     ModernFactoryPackagesCreator::getPackages(searchPaths, callback);
 }
 
+std::string SysInfo::getPackagesFingerprint() const
+{
+    PackageSourceFingerprint fingerprint;
+
+    fingerprint.addPath(DPKG_STATUS_PATH);
+    fingerprint.addDirectory(RPM_PATH);
+    fingerprint.addPath(SNAP_STATE_PATH);
+    fingerprint.addDirectories(UNIX_PYPI_DEFAULT_BASE_DIRS);
+    fingerprint.addDirectories(UNIX_NPM_DEFAULT_BASE_DIRS, "node_modules");
+
+    return fingerprint.value();
+}
+
 nlohmann::json SysInfo::getHotfixes() const
 {
     // Currently not supported for this OS.
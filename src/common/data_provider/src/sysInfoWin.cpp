@@ -904,6 +904,12 @@ void SysInfo::getPackages(const std::function<void(nlohmann::json&)>& callback)
     ModernFactoryPackagesCreator::getPackages(searchPaths, callback);
 }
 
+std::string SysInfo::getPackagesFingerprint() const
+{
+    // Currently not supported for this OS, packages are always collected.
+    return {};
+}
+
 nlohmann::json SysInfo::getHotfixes() const
 {
     std::set<std::string> hotfixes;
@@ -14,4 +14,5 @@ public:
     MOCK_METHOD(nlohmann::json, networks, (), (override));
     MOCK_METHOD(nlohmann::json, ports, (), (override));
     MOCK_METHOD(nlohmann::json, hotfixes, (), (override));
+    MOCK_METHOD(std::string, packagesFingerprint, (), (override));
 };
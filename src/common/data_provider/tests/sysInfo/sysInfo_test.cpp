@@ -63,6 +63,11 @@ void SysInfo::getProcessesInfo(const std::function<void(nlohmann::json&)>& callb
     std::invoke(callback, PROCESSES_EXPECTED);
 }
 
+std::string SysInfo::getPackagesFingerprint() const
+{
+    return {};
+}
+
 class CallbackMock
 {
 public:
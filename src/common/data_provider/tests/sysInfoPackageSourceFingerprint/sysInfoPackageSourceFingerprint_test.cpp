@@ -0,0 +1,73 @@
+#include "sysInfoPackageSourceFingerprint_test.hpp"
+#include "packageSourceFingerprint.hpp"
+
+#include <fstream>
+
+void PackageSourceFingerprintTest::SetUp()
+{
+    m_root = std::filesystem::temp_directory_path() / "package_source_fingerprint_test";
+    std::filesystem::remove_all(m_root);
+    std::filesystem::create_directories(m_root / "lib" / "python3" / "site-packages");
+    std::filesystem::create_directories(m_root / "lib" / "node_modules" / "express");
+    std::ofstream {m_root / "status"} << "Package: bash\n";
+};
+
+void PackageSourceFingerprintTest::TearDown()
+{
+    std::filesystem::remove_all(m_root);
+};
+
+namespace
+{
+    std::string Fingerprint(const std::filesystem::path& root)
+    {
+        PackageSourceFingerprint fingerprint;
+
+        fingerprint.addPath((root / "status").string());
+        fingerprint.addDirectories({(root / "lib" / "python*" / "site-packages").string()});
+        fingerprint.addDirectories({(root / "lib").string()}, "node_modules");
+
+        return fingerprint.value();
+    }
+} // namespace
+
+TEST_F(PackageSourceFingerprintTest, unchangedSources)
+{
+    EXPECT_EQ(Fingerprint(m_root), Fingerprint(m_root));
+}
+
+TEST_F(PackageSourceFingerprintTest, changedStatusFile)
+{
+    const auto before {Fingerprint(m_root)};
+
+    std::ofstream {m_root / "status", std::ios::app} << "Package: curl\n";
+
+    EXPECT_NE(before, Fingerprint(m_root));
+}
+
+TEST_F(PackageSourceFingerprintTest, missingStatusFile)
+{
+    const auto before {Fingerprint(m_root)};
+
+    std::filesystem::remove(m_root / "status");
+
+    EXPECT_NE(before, Fingerprint(m_root));
+}
+
+TEST_F(PackageSourceFingerprintTest, installedPythonPackage)
+{
+    const auto before {Fingerprint(m_root)};
+
+    std::filesystem::create_directories(m_root / "lib" / "python3" / "site-packages" / "requests-2.32.3.dist-info");
+
+    EXPECT_NE(before, Fingerprint(m_root));
+}
+
+TEST_F(PackageSourceFingerprintTest, upgradedNodePackage)
+{
+    const auto before {Fingerprint(m_root)};
+
+    std::ofstream {m_root / "lib" / "node_modules" / "express" / "package.json"} << R"({"version":"4.21.2"})";
+
+    EXPECT_NE(before, Fingerprint(m_root));
+}
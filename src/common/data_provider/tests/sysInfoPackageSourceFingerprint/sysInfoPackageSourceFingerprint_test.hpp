@@ -0,0 +1,18 @@
+#pragma once
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <filesystem>
+
+class PackageSourceFingerprintTest : public ::testing::Test
+{
+protected:
+    PackageSourceFingerprintTest() = default;
+    virtual ~PackageSourceFingerprintTest() = default;
+
+    void SetUp() override;
+    void TearDown() override;
+
+    std::filesystem::path m_root;
+};
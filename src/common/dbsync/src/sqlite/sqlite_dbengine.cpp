@@ -6,6 +6,7 @@
 #include "stringHelper.hpp"
 #include <fstream>
 #include <iostream>
+#include <optional>
 #include <sqlite3.h>
 #include <thread>
 
@@ -13,19 +14,150 @@ using namespace std::chrono_literals;
 auto constexpr MAX_TRIES = 5;
 auto constexpr COND_AND_SIZE = 5;
 
+namespace
+{
+    constexpr auto DIGEST_KIND_BITS {2};
+
+    /// @brief Digest of a column value
+    size_t columnDigest(const nlohmann::json& value)
+    {
+        // The lowest bits tell the kind of value apart, so "1" and 1 don't share a digest. Strings are hashed as
+        // they are, text that isn't valid UTF-8 can't be dumped.
+        if (value.is_string())
+        {
+            return (std::hash<std::string> {}(value.get_ref<const std::string&>()) << DIGEST_KIND_BITS) | 1;
+        }
+
+        if (value.is_number_unsigned() || (value.is_number_integer() && value.get<int64_t>() >= 0))
+        {
+            return (std::hash<uint64_t> {}(value.get<uint64_t>()) << DIGEST_KIND_BITS) | 2;
+        }
+
+        if (value.is_number_integer())
+        {
+            return (std::hash<int64_t> {}(value.get<int64_t>()) << DIGEST_KIND_BITS) | 3;
+        }
+
+        return std::hash<std::string> {}(value.dump()) << DIGEST_KIND_BITS;
+    }
+
+    /// @brief Reads a column value the way getTableData and getFieldValueFromTuple do
+    nlohmann::json columnValue(const std::unique_ptr<SQLiteLegacy::IColumn>& column, const ColumnType type)
+    {
+        if (!column->hasValue())
+        {
+            return nullptr;
+        }
+
+        switch (type)
+        {
+            case ColumnType::BigInt: return column->value(int64_t {});
+            case ColumnType::UnsignedBigInt: return column->value(uint64_t {});
+            case ColumnType::Integer: return column->value(int32_t {});
+            case ColumnType::Text: return column->value(std::string {});
+            case ColumnType::Double: return column->value(double_t {});
+            default: throw dbengine_error {INVALID_COLUMN_TYPE};
+        }
+    }
+
+    /// @brief Builds the key of a row in the row digests from its primary key values
+    /// @return row key, or nullopt if a primary key value is missing
+    std::optional<std::string> rowDigestKey(const std::vector<std::string>& primaryKeyList, const nlohmann::json& data)
+    {
+        std::string key;
+
+        for (const auto& pkValue : primaryKeyList)
+        {
+            const auto it {data.find(pkValue)};
+
+            if (data.end() == it || it->is_null())
+            {
+                return std::nullopt;
+            }
+
+            // Strings are prefixed with their length, other values are dumped, so the key can be read back.
+            if (it->is_string())
+            {
+                const auto& value {it->get_ref<const std::string&>()};
+                key.append("s" + std::to_string(value.size()) + ":").append(value);
+            }
+            else
+            {
+                key.append("n" + it->dump() + ";");
+            }
+        }
+
+        return key;
+    }
+
+    /// @brief Reads the primary key values back from the key of a row in the row digests
+    nlohmann::json rowDigestKeyValues(const std::string& key, const std::vector<std::string>& primaryKeyList)
+    {
+        nlohmann::json data;
+        size_t position {0};
+
+        for (const auto& pkValue : primaryKeyList)
+        {
+            if ('s' == key.at(position))
+            {
+                const auto separator {key.find(':', position)};
+                const auto size {std::stoull(key.substr(position + 1, separator - position - 1))};
+                data[pkValue] = key.substr(separator + 1, size);
+                position = separator + 1 + size;
+            }
+            else
+            {
+                const auto separator {key.find(';', position)};
+                data[pkValue] = nlohmann::json::parse(key.substr(position + 1, separator - position - 1));
+                position = separator + 1;
+            }
+        }
+
+        return data;
+    }
+
+    /// @brief Number of statements cached by an engine, some of them for each of the tables it creates
+    size_t statementCacheCapacity(const std::string& tableStmtCreation)
+    {
+        const auto statements {Utils::toUpperCase(tableStmtCreation)};
+        size_t tables {0};
+
+        for (auto position = statements.find("CREATE TABLE"); std::string::npos != position;
+             position = statements.find("CREATE TABLE", position + 1))
+        {
+            ++tables;
+        }
+
+        return std::max<size_t>(CACHE_STMT_LIMIT, tables * CACHE_STMT_PER_TABLE);
+    }
+
+    /// @brief Joins the names of the members of a JSON object
+    std::string joinKeys(const nlohmann::json& data)
+    {
+        std::string keys;
+
+        for (auto it = data.begin(); it != data.end(); ++it)
+        {
+            keys.append(it.key()).append(1, ',');
+        }
+
+        return keys;
+    }
+} // namespace
+
 SQLiteDBEngine::SQLiteDBEngine(const std::shared_ptr<SQLiteLegacy::ISQLiteFactory>& sqliteFactory,
                                const std::string& path,
                                const std::string& tableStmtCreation,
                                const DbManagement dbManagement,
                                const std::vector<std::string>& upgradeStatements)
-    : m_sqliteFactory(sqliteFactory)
+    : m_statementsCache(statementCacheCapacity(tableStmtCreation))
+    , m_sqliteFactory(sqliteFactory)
 {
     initialize(path, tableStmtCreation, dbManagement, upgradeStatements);
 }
 
 SQLiteDBEngine::~SQLiteDBEngine()
 {
-    const std::lock_guard<std::mutex> lock(m_stmtMutex);
     m_statementsCache.clear();
 
     if (m_transaction)
@@ -72,6 +204,8 @@ void SQLiteDBEngine::setMaxRows(const std::string& table, const int64_t maxRows)
 
 void SQLiteDBEngine::bulkInsert(const std::string& table, const nlohmann::json& data)
 {
+    applyAllRowDigestMarks();
+
     if (0 != loadTableData(table))
     {
         const auto& tableFieldsMetaData {m_tableFields[table]};
@@ -92,6 +226,7 @@ void SQLiteDBEngine::refreshTableData(const nlohmann::json& data,
                                       std::unique_lock<std::shared_timed_mutex>& lock)
 {
     const std::string table {data.at("table").is_string() ? data.at("table").get_ref<const std::string&>() : ""};
+    applyAllRowDigestMarks();
 
     if (createCopyTempTable(table))
     {
@@ -198,8 +333,19 @@ void SQLiteDBEngine::syncTableRowData(const nlohmann::json& jsInput,
     {
         if (getPrimaryKeysFromTable(table, primaryKeyList))
         {
+            if (!inTransaction)
+            {
+                applyAllRowDigestMarks();
+            }
+
             for (const auto& entry : data)
             {
+                // Rows stored with the same values only need their status field set, that's done in bulk later.
+                if (inTransaction && isRowUnchanged(table, primaryKeyList, entry))
+                {
+                    continue;
+                }
+
                 nlohmann::json updated;
                 nlohmann::json oldData;
                 const bool diffExist {getRowDiff(primaryKeyList, ignoredColumns, table, entry, updated, oldData)};
@@ -289,6 +435,9 @@ void SQLiteDBEngine::initializeStatusField(const nlohmann::json& tableNames)
             {
                 throw dbengine_error {STEP_ERROR_ADD_STATUS_FIELD};
             }
+
+            const std::lock_guard<std::mutex> lock(m_rowDigestsMutex);
+            m_rowDigests.erase(table);
         }
         else
         {
@@ -299,6 +448,9 @@ void SQLiteDBEngine::initializeStatusField(const nlohmann::json& tableNames)
 
 void SQLiteDBEngine::deleteRowsByStatusField(const nlohmann::json& tableNames)
 {
+    // The transaction is closing, the marks of every table it synced are applied before its pending rows are deleted.
+    applyAllRowDigestMarks();
+
     for (const auto& tableValue : tableNames)
     {
         const auto table {tableValue.get<std::string>()};
@@ -325,6 +477,11 @@ void SQLiteDBEngine::returnRowsMarkedForDelete(const nlohmann::json& tableNames,
                                                const DbSync::ResultCallback& callback,
                                                std::unique_lock<std::shared_timed_mutex>& lock)
 {
+    for (const auto& tableValue : tableNames)
+    {
+        applyRowDigestMarks(tableValue.get<std::string>());
+    }
+
     if (m_transaction)
     {
         m_transaction->commit();
@@ -427,6 +584,8 @@ void SQLiteDBEngine::selectData(const std::string& table,
 
 void SQLiteDBEngine::deleteTableRowsData(const std::string& table, const nlohmann::json& jsDeletionData)
 {
+    applyAllRowDigestMarks();
+
     if (0 != loadTableData(table))
     {
         const auto& itData {jsDeletionData.find("data")};
@@ -456,6 +615,8 @@ void SQLiteDBEngine::deleteTableRowsData(const std::string& table, const nlohman
 
 void SQLiteDBEngine::addTableRelationship(const nlohmann::json& data)
 {
+    applyAllRowDigestMarks();
+
     const auto baseTable {data.at("base_table").get<std::string>()};
 
     if (0 != loadTableData(baseTable))
@@ -602,7 +763,8 @@ void SQLiteDBEngine::InsertElement(const std::string& table,
                                    const nlohmann::json& element,
                                    const std::function<void()>& callback)
 {
-    const auto stmt {getStatement(buildInsertDataSqlQuery(table, element))};
+    const auto stmt {
+        getStatement(table, "insert", joinKeys(element), [&]() { return buildInsertDataSqlQuery(table, element); })};
     int32_t index {1l};
 
     for (const auto& field : tableColumns)
@@ -711,6 +873,8 @@ bool SQLiteDBEngine::loadFieldData(const std::string& table)
         }
 
         m_tableFields.insert(table, fieldList);
+        // The statements cached by shape were built from the previous fields of the table.
+        m_statementsCache.eraseShapes(table);
     }
 
     return ret;
@@ -1114,7 +1278,8 @@ void SQLiteDBEngine::deleteRowsbyPK(const std::string& table, const nlohmann::js
     if (getPrimaryKeysFromTable(table, primaryKeyList))
     {
         const auto& tableFields {m_tableFields[table]};
-        const auto stmt {getStatement(buildDeleteBulkDataSqlQuery(table, primaryKeyList))};
+        const auto stmt {getStatement(
+            table, "delete_pk", "", [&]() { return buildDeleteBulkDataSqlQuery(table, primaryKeyList); })};
 
         for (const auto& jsRow : data)
         {
@@ -1313,7 +1478,8 @@ bool SQLiteDBEngine::getRowDiff(const std::vector<std::string>& primaryKeyList,
 {
     bool diffExist {false};
     bool isModified {false};
-    const auto stmt {getStatement(buildSelectMatchingPKsSqlQuery(table, primaryKeyList))};
+    const auto stmt {getStatement(
+        table, "select_pk", "", [&]() { return buildSelectMatchingPKsSqlQuery(table, primaryKeyList); })};
 
     const auto& tableFields {m_tableFields[table]};
     int32_t index {1l};
@@ -1453,7 +1619,7 @@ bool SQLiteDBEngine::insertNewRows(const std::string& table,
 
 void SQLiteDBEngine::bulkInsert(const std::string& table, const std::vector<Row>& data)
 {
-    const auto stmt {getStatement(buildInsertDataSqlQuery(table))};
+    const auto stmt {getStatement(table, "insert", "", [&]() { return buildInsertDataSqlQuery(table); })};
 
     for (const auto& row : data)
     {
@@ -1766,7 +1932,10 @@ void SQLiteDBEngine::updateSingleRow(const std::string& table, const nlohmann::j
     if (getPrimaryKeysFromTable(table, primaryKeyList))
     {
         const auto& tableFields {m_tableFields[table]};
-        const auto stmt {getStatement(buildUpdatePartialDataSqlQuery(table, jsData, primaryKeyList))};
+        const auto stmt {getStatement(table,
+                                      "update",
+                                      joinKeys(jsData),
+                                      [&]() { return buildUpdatePartialDataSqlQuery(table, jsData, primaryKeyList); })};
         int32_t index {1l};
 
         for (auto it = jsData.begin(); it != jsData.end(); ++it)
@@ -1922,28 +2091,21 @@ void SQLiteDBEngine::getFieldValueFromTuple(const Field& value, std::string& res
 
 std::shared_ptr<SQLiteLegacy::IStatement> SQLiteDBEngine::getStatement(const std::string& sql)
 {
-    const std::lock_guard<std::mutex> lock(m_stmtMutex);
-    const auto it {std::find_if(m_statementsCache.begin(),
-                                m_statementsCache.end(),
-                                [sql](const std::pair<std::string, std::shared_ptr<SQLiteLegacy::IStatement>>& pair)
-                                { return 0 == pair.first.compare(sql); })};
-
-    if (m_statementsCache.end() != it)
-    {
-        it->second->reset();
-        return it->second;
-    }
-    else
-    {
-        m_statementsCache.emplace_back(sql, m_sqliteFactory->createStatement(m_sqliteConnection, sql));
+    return m_statementsCache.get(sql, [&]() { return m_sqliteFactory->createStatement(m_sqliteConnection, sql); });
+}
 
-        if (CACHE_STMT_LIMIT <= m_statementsCache.size())
-        {
-            m_statementsCache.pop_front();
-        }
+std::shared_ptr<SQLiteLegacy::IStatement> SQLiteDBEngine::getStatement(const std::string& table,
+                                                                       const std::string& operation,
+                                                                       const std::string& columns,
+                                                                       const std::function<std::string()>& buildSql)
+{
+    return m_statementsCache.get(StatementCache::shapeKey(table, operation, columns),
+                                 [&]() { return m_sqliteFactory->createStatement(m_sqliteConnection, buildSql()); });
+}
 
-        return m_statementsCache.back().second;
-    }
+StatementCacheStats SQLiteDBEngine::statementCacheStats()
+{
+    return m_statementsCache.stats();
 }
 
 std::string SQLiteDBEngine::getSelectAllQuery(const std::string& table, const TableColumns& tableFields) const
@@ -2074,3 +2236,229 @@ void SQLiteDBEngine::updateTableRowCounter(const std::string& table, const long
         }
     }
 }
+
+RowDigests SQLiteDBEngine::loadRowDigests(const std::string& table, const std::vector<std::string>& primaryKeyList)
+{
+    RowDigests rowDigests {};
+    const auto stmtTriggers {getStatement("SELECT COUNT(*) FROM sqlite_master WHERE type='trigger';")};
+
+    // Triggers may change rows of other tables, the digests of those rows would be outdated.
+    rowDigests.enabled = SQLITE_ROW == stmtTriggers->step() && 0 == stmtTriggers->column(0)->value(int64_t {});
+
+    if (!rowDigests.enabled)
+    {
+        return rowDigests;
+    }
+
+    std::vector<ColumnType> types;
+    std::vector<bool> primaryKeys;
+
+    for (const auto& field : m_tableFields[table])
+    {
+        if (!std::get<TableHeader::TXNStatusField>(field))
+        {
+            rowDigests.columns.push_back(std::get<TableHeader::Name>(field));
+            types.push_back(std::get<TableHeader::Type>(field));
+            primaryKeys.push_back(std::get<TableHeader::PK>(field));
+        }
+    }
+
+    // Only the rows still pending (status field 0) are loaded. Rows this transaction already synced are left out even
+    // if the digests are reloaded halfway through it, so they are never unmarked and reported as deleted.
+    const auto stmt {getStatement(getSelectAllQuery(table, m_tableFields[table]))};
+
+    while (SQLITE_ROW == stmt->step())
+    {
+        std::vector<size_t> digests;
+        nlohmann::json pkValues;
+        digests.reserve(rowDigests.columns.size());
+
+        for (size_t i = 0; i < rowDigests.columns.size(); ++i)
+        {
+            const auto value = columnValue(stmt->column(static_cast<int32_t>(i)), types[i]);
+            digests.push_back(columnDigest(value));
+
+            if (primaryKeys[i])
+            {
+                pkValues[rowDigests.columns[i]] = value;
+            }
+        }
+
+        const auto key {rowDigestKey(primaryKeyList, pkValues)};
+
+        // A pending row without a key couldn't be unmarked when the whole table is marked at once.
+        if (!key.has_value())
+        {
+            return RowDigests {};
+        }
+
+        rowDigests.rows.emplace(key.value(), std::move(digests));
+    }
+
+    return rowDigests;
+}
+
+bool SQLiteDBEngine::isRowUnchanged(const std::string& table,
+                                    const std::vector<std::string>& primaryKeyList,
+                                    const nlohmann::json& data)
+{
+    const auto key {rowDigestKey(primaryKeyList, data)};
+
+    if (!key.has_value())
+    {
+        return false;
+    }
+
+    const std::lock_guard<std::mutex> lock(m_rowDigestsMutex);
+    auto it {m_rowDigests.find(table)};
+
+    if (m_rowDigests.end() == it)
+    {
+        it = m_rowDigests.emplace(table, loadRowDigests(table, primaryKeyList)).first;
+    }
+
+    auto& rowDigests {it->second};
+    const auto itRow {rowDigests.enabled ? rowDigests.rows.find(key.value()) : rowDigests.rows.end()};
+
+    if (rowDigests.rows.end() == itRow)
+    {
+        return false;
+    }
+
+    // Only the columns present in the data are compared, as getRowDiff does. A digest mismatch isn't necessarily a
+    // change (e.g. 1 and 1.0), the row is then compared by getRowDiff.
+    auto unchanged {true};
+
+    for (size_t i = 0; unchanged && i < rowDigests.columns.size(); ++i)
+    {
+        const auto itValue {data.find(rowDigests.columns[i])};
+        unchanged = data.end() == itValue || columnDigest(*itValue) == itRow->second[i];
+    }
+
+    if (unchanged)
+    {
+        rowDigests.unchangedRows.push_back(key.value());
+    }
+
+    // Either way the row is synced now, it's no longer a candidate for deletion.
+    rowDigests.rows.erase(itRow);
+
+    return unchanged;
+}
+
+void SQLiteDBEngine::applyRowDigestMarks(const std::string& table)
+{
+    RowDigests rowDigests {};
+
+    {
+        const std::lock_guard<std::mutex> lock(m_rowDigestsMutex);
+        const auto it {m_rowDigests.find(table)};
+
+        if (m_rowDigests.end() == it)
+        {
+            return;
+        }
+
+        rowDigests = std::move(it->second);
+        m_rowDigests.erase(it);
+    }
+
+    if (rowDigests.unchangedRows.empty())
+    {
+        return;
+    }
+
+    // When most rows are unchanged the whole table is marked at once, and the rows the transaction didn't sync are
+    // unmarked, otherwise the unchanged rows are marked one by one.
+    const auto markAll {rowDigests.unchangedRows.size() > rowDigests.rows.size()};
+
+    if (markAll)
+    {
+        const auto stmtMarkAll {
+            getStatement("UPDATE " + table + " SET " + STATUS_FIELD_NAME + "=1 WHERE " + STATUS_FIELD_NAME + "=0;")};
+
+        if (SQLITE_ERROR == stmtMarkAll->step())
+        {
+            throw dbengine_error {STEP_ERROR_UPDATE_STATUS_FIELD};
+        }
+    }
+
+    std::vector<std::string> primaryKeyList;
+
+    if (!getPrimaryKeysFromTable(table, primaryKeyList))
+    {
+        throw dbengine_error {EMPTY_TABLE_METADATA};
+    }
+
+    const auto tableFields {m_tableFields[table]};
+    std::string sql {"UPDATE " + table + " SET " + STATUS_FIELD_NAME + "=" + (markAll ? "0" : "1") + " WHERE "};
+
+    for (const auto& pkValue : primaryKeyList)
+    {
+        sql.append(pkValue + "=? AND ");
+    }
+
+    sql = sql.substr(0, sql.size() - COND_AND_SIZE) + ";";
+    const auto stmt {getStatement(sql)};
+
+    const auto markRow {[&](const std::string& key)
+                        {
+                            const auto data = rowDigestKeyValues(key, primaryKeyList);
+                            int32_t index {1l};
+
+                            for (const auto& pkValue : primaryKeyList)
+                            {
+                                const auto it {std::find_if(tableFields.begin(),
+                                                            tableFields.end(),
+                                                            [&pkValue](const ColumnData& column)
+                                                            { return 0 == std::get<Name>(column).compare(pkValue); })};
+
+                                if (tableFields.end() != it)
+                                {
+                                    bindJsonData(stmt, *it, data, index);
+                                    ++index;
+                                }
+                            }
+
+                            if (SQLITE_ERROR == stmt->step())
+                            {
+                                throw dbengine_error {STEP_ERROR_UPDATE_STATUS_FIELD};
+                            }
+
+                            stmt->reset();
+                        }};
+
+    if (markAll)
+    {
+        for (const auto& row : rowDigests.rows)
+        {
+            markRow(row.first);
+        }
+    }
+    else
+    {
+        for (const auto& key : rowDigests.unchangedRows)
+        {
+            markRow(key);
+        }
+    }
+}
+
+void SQLiteDBEngine::applyAllRowDigestMarks()
+{
+    std::vector<std::string> tables;
+
+    {
+        const std::lock_guard<std::mutex> lock(m_rowDigestsMutex);
+
+        for (const auto& rowDigests : m_rowDigests)
+        {
+            tables.push_back(rowDigests.first);
+        }
+    }
+
+    for (const auto& table : tables)
+    {
+        applyRowDigestMarks(table);
+    }
+}
@@ -5,9 +5,11 @@
 #include "isqliteWrapper.hpp"
 #include "mapWrapperSafe.hpp"
 #include "sqliteWrapperFactory.hpp"
+#include "statement_cache.h"
 #include <mutex>
 #include <queue>
 #include <tuple>
+#include <unordered_map>
 
 constexpr auto TEMP_TABLE_SUBFIX {"_TEMP"};
 
@@ -15,6 +17,7 @@ constexpr auto STATUS_FIELD_NAME {"db_status_field_dm"};
 constexpr auto STATUS_FIELD_TYPE {"INTEGER"};
 
 constexpr auto CACHE_STMT_LIMIT {30ull};
+constexpr auto CACHE_STMT_PER_TABLE {12ull};
 
 const std::vector<std::string> InternalColumnNames = {{STATUS_FIELD_NAME}};
 
@@ -102,6 +105,19 @@ struct MaxRows final
     int64_t currentRows;
 };
 
+/// @brief Content digests of the rows of a table that the current transaction didn't sync yet
+struct RowDigests final
+{
+    /// @brief Whether the digests can be used, they can't when triggers may change the rows behind them
+    bool enabled {false};
+    /// @brief Names of the columns the digests are computed from
+    std::vector<std::string> columns;
+    /// @brief Digest of each column of each row, keyed by the primary key values of the row
+    std::unordered_map<std::string, std::vector<size_t>> rows;
+    /// @brief Primary key values of the rows found unchanged, whose status field is still to be set
+    std::vector<std::string> unchangedRows;
+};
+
 /// @brief SQLiteDBEngine
 class SQLiteDBEngine final : public DbSync::IDbEngine
 {
@@ -184,6 +200,10 @@ public:
     /// @param data JSON data
     void addTableRelationship(const nlohmann::json& data) override;
 
+    /// @brief Gets the prepared statement cache counters
+    /// @return Statement cache counters
+    StatementCacheStats statementCacheStats();
+
 private:
     /// @brief Delete copy constructor
     SQLiteDBEngine(const SQLiteDBEngine&) = delete;
@@ -477,10 +497,21 @@ private:
     /// @return statement
     std::shared_ptr<SQLiteLegacy::IStatement> getStatement(const std::string& sql);
 
+    /// @brief Get a statement by its shape, its SQL sentence is only built when it isn't cached
+    /// @param table table name
+    /// @param operation operation done by the statement
+    /// @param columns columns the statement binds
+    /// @param buildSql builds the SQL sentence
+    /// @return statement
+    std::shared_ptr<SQLiteLegacy::IStatement> getStatement(const std::string& table,
+                                                           const std::string& operation,
+                                                           const std::string& columns,
+                                                           const std::function<std::string()>& buildSql);
+
     /// @brief Gets the select all query
     /// @param table table name
     /// @param tableFields table fields
-    /// @return select all query
+    /// @return query selecting the columns of the rows whose status field is 0
     std::string getSelectAllQuery(const std::string& table, const TableColumns& tableFields) const;
 
     /// @brief Builds the delete relation trigger
@@ -513,12 +544,35 @@ private:
                        const nlohmann::json& element,
                        const std::function<void()>& callback = {});
 
+    /// @brief Checks whether a row synced in a transaction is stored with the same values, using the row digests
+    /// @param table table name
+    /// @param primaryKeyList primary key list
+    /// @param data row data
+    /// @return true if the row is unchanged, its status field is then set by applyRowDigestMarks
+    bool isRowUnchanged(const std::string& table,
+                        const std::vector<std::string>& primaryKeyList,
+                        const nlohmann::json& data);
+
+    /// @brief Loads the digests of the rows of a table that the current transaction didn't sync yet
+    /// @param table table name
+    /// @param primaryKeyList primary key list
+    /// @return row digests
+    RowDigests loadRowDigests(const std::string& table, const std::vector<std::string>& primaryKeyList);
+
+    /// @brief Sets the status field of the rows found unchanged and drops the row digests of a table
+    /// @param table table name
+    void applyRowDigestMarks(const std::string& table);
+
+    /// @brief Applies the row digest marks of every table
+    void applyAllRowDigestMarks();
+
     Utils::MapWrapperSafe<std::string, TableColumns> m_tableFields;
-    std::deque<std::pair<std::string, std::shared_ptr<SQLiteLegacy::IStatement>>> m_statementsCache;
+    StatementCache m_statementsCache;
     const std::shared_ptr<SQLiteLegacy::ISQLiteFactory> m_sqliteFactory;
     std::shared_ptr<SQLiteLegacy::IConnection> m_sqliteConnection;
-    std::mutex m_stmtMutex;
     std::unique_ptr<SQLiteLegacy::ITransaction> m_transaction;
     std::mutex m_maxRowsMutex;
     std::map<std::string, MaxRows> m_maxRows;
+    std::mutex m_rowDigestsMutex;
+    std::map<std::string, RowDigests> m_rowDigests;
 };
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "isqliteWrapper.hpp"
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+/// @brief Statement cache counters
+struct StatementCacheStats final
+{
+    uint64_t hits;
+    uint64_t misses;
+    size_t size;
+    size_t capacity;
+};
+
+/// @brief Least recently used cache of prepared statements
+///
+/// Statements are looked up by a key, either their SQL sentence or a key built by shapeKey, so the SQL sentence of a
+/// cached statement doesn't need to be built again.
+class StatementCache final
+{
+public:
+    using Statement = std::shared_ptr<SQLiteLegacy::IStatement>;
+
+    /// @brief Constructor
+    /// @param capacity Number of statements kept in the cache
+    explicit StatementCache(const size_t capacity)
+        : m_capacity {capacity}
+    {
+    }
+
+    /// @brief Builds the key of a statement from its shape
+    /// @param table Table name
+    /// @param operation Operation done by the statement
+    /// @param columns Columns the statement binds
+    /// @return Key of the statement, it never matches an SQL sentence
+    static std::string shapeKey(const std::string& table, const std::string& operation, const std::string& columns)
+    {
+        std::string key {table};
+        key.append(1, '\0').append(operation).append(1, '\0').append(columns);
+        return key;
+    }
+
+    /// @brief Gets a cached statement, reset so it can be used again, or prepares it and caches it
+    /// @param key Key of the statement
+    /// @param prepare Prepares the statement when it isn't cached
+    /// @return Statement
+    Statement get(const std::string& key, const std::function<Statement()>& prepare)
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        const auto it {m_index.find(key)};
+
+        if (m_index.end() != it)
+        {
+            ++m_hits;
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            it->second->second->reset();
+            return it->second->second;
+        }
+
+        ++m_misses;
+        auto statement {prepare()};
+        m_entries.emplace_front(key, statement);
+        m_index.emplace(key, m_entries.begin());
+
+        if (m_entries.size() > m_capacity)
+        {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+
+        return statement;
+    }
+
+    /// @brief Removes the statements cached by shape for a table, their SQL sentences may no longer match it
+    /// @param table Table name
+    void eraseShapes(const std::string& table)
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        const auto prefix {table + '\0'};
+
+        for (auto it = m_entries.begin(); it != m_entries.end();)
+        {
+            if (0 == it->first.compare(0, prefix.size(), prefix))
+            {
+                m_index.erase(it->first);
+                it = m_entries.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    /// @brief Removes every cached statement
+    void clear()
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_index.clear();
+        m_entries.clear();
+    }
+
+    /// @brief Gets the cache counters
+    /// @return Statement cache counters
+    StatementCacheStats stats()
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        return {m_hits, m_misses, m_entries.size(), m_capacity};
+    }
+
+private:
+    /// @brief Cached statements, the most recently used first
+    std::list<std::pair<std::string, Statement>> m_entries;
+
+    /// @brief Position of each cached statement in m_entries, by key
+    std::unordered_map<std::string, std::list<std::pair<std::string, Statement>>::iterator> m_index;
+
+    const size_t m_capacity;
+    uint64_t m_hits {0};
+    uint64_t m_misses {0};
+    std::mutex m_mutex;
+};
@@ -0,0 +1,148 @@
+#include "dbsync.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+namespace
+{
+    const std::string BENCHMARK_DB_NAME = "benchmark_dbsync.db";
+    constexpr std::size_t DEFAULT_ROWS = 100000;
+    constexpr std::size_t CHANGED_ROWS_RATIO = 100; // 1% of the rows change between scans
+    constexpr std::size_t VERSIONS = 10;
+    constexpr auto QUEUE_SIZE {4096};
+
+    constexpr auto CREATE_STATEMENT {
+        R"(CREATE TABLE packages (
+        name TEXT,
+        version TEXT,
+        vendor TEXT,
+        install_time TEXT,
+        location TEXT,
+        architecture TEXT,
+        groups TEXT,
+        description TEXT,
+        size BIGINT,
+        priority TEXT,
+        multiarch TEXT,
+        source TEXT,
+        format TEXT,
+        PRIMARY KEY (name,version,architecture,format,location)) WITHOUT ROWID;)"};
+
+    constexpr auto FILES_CREATE_STATEMENT {
+        R"(CREATE TABLE package_files (path TEXT, name TEXT, PRIMARY KEY (path)) WITHOUT ROWID;)"};
+
+    /// @brief The relationship adds triggers, they disable the row digests so each row is compared with a query.
+    constexpr auto RELATIONSHIP {
+        R"({"base_table":"packages","relationed_tables":[{"table":"package_files","field_match":{"name":"name"}}]})"};
+
+    /// @brief Builds the packages of a scan, the packages with an index multiple of CHANGED_ROWS_RATIO have a
+    /// different version in each generation.
+    nlohmann::json CreatePackages(std::size_t count, std::size_t generation)
+    {
+        nlohmann::json packages = nlohmann::json::array();
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto changed {i % CHANGED_ROWS_RATIO == 0};
+
+            packages.push_back({{"name", "package" + std::to_string(i)},
+                                {"version", "1." + std::to_string(i % VERSIONS)},
+                                {"vendor", "Debian"},
+                                {"install_time", "2025/01/01 00:00:00"},
+                                {"location", " "},
+                                {"architecture", "amd64"},
+                                {"groups", "libs"},
+                                {"description", "Package number " + std::to_string(i) + " of the benchmark"},
+                                {"size", changed ? generation : i},
+                                {"priority", "optional"},
+                                {"multiarch", "same"},
+                                {"source", changed ? "source" + std::to_string(generation) : "source"},
+                                {"format", "deb"}});
+        }
+
+        return packages;
+    }
+
+    /// @brief Counts of the changes reported by a sync
+    struct Changes
+    {
+        std::size_t inserted {0};
+        std::size_t modified {0};
+        std::size_t deleted {0};
+    };
+
+    /// @brief Syncs a scan in a transaction the way Inventory::UpdateChanges does and returns the elapsed seconds.
+    double SyncScan(DBSync& dbSync, const nlohmann::json& packages, Changes& changes)
+    {
+        ResultCallbackData callback {[&changes](ReturnTypeCallback result, const nlohmann::json&)
+                                     {
+                                         changes.inserted += result == INSERTED ? 1 : 0;
+                                         changes.modified += result == MODIFIED ? 1 : 0;
+                                         changes.deleted += result == DELETED ? 1 : 0;
+                                     }};
+        nlohmann::json input;
+        input["table"] = "packages";
+        input["data"] = packages;
+        input["options"]["return_old_data"] = true;
+
+        const auto start = std::chrono::steady_clock::now();
+
+        {
+            DBSyncTxn txn {dbSync.handle(), nlohmann::json {"packages"}, 0, QUEUE_SIZE, callback};
+            txn.syncTxnRow(input);
+            txn.getDeletedRows(callback);
+        }
+
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /// @brief Syncs a first scan and a second one where 1% of the rows changed, and prints the second one.
+    /// @return true if the expected changes were reported
+    bool Measure(const std::string& name, bool withRelationship, std::size_t rows)
+    {
+        std::remove(BENCHMARK_DB_NAME.c_str());
+
+        DBSync dbSync {HostType::AGENT,
+                       DbEngineType::SQLITE3,
+                       BENCHMARK_DB_NAME,
+                       std::string {CREATE_STATEMENT} + FILES_CREATE_STATEMENT};
+
+        if (withRelationship)
+        {
+            dbSync.addTableRelationship(nlohmann::json::parse(RELATIONSHIP));
+        }
+
+        Changes firstChanges;
+        Changes secondChanges;
+        const auto firstScan = CreatePackages(rows, 1);
+        const auto secondScan = CreatePackages(rows, 2);
+
+        SyncScan(dbSync, firstScan, firstChanges);
+        const auto seconds = SyncScan(dbSync, secondScan, secondChanges);
+
+        std::cout << name << ": " << rows << " rows synced in " << seconds * 1000 << " ms ("
+                  << secondChanges.inserted << " inserted, " << secondChanges.modified << " modified, "
+                  << secondChanges.deleted << " deleted)\n";
+
+        const auto expectedModified {(rows + CHANGED_ROWS_RATIO - 1) / CHANGED_ROWS_RATIO};
+        return firstChanges.inserted == rows && secondChanges.inserted == 0 &&
+               secondChanges.modified == expectedModified && secondChanges.deleted == 0;
+    }
+} // namespace
+
+/// @brief Measures a transaction over a table where few rows changed. Usage: benchmark_DBSync [number of rows]
+int main(int argc, char** argv)
+{
+    const std::size_t rows = argc > 1 ? std::stoul(argv[1]) : DEFAULT_ROWS;
+
+    const auto rowByRow = Measure("Row by row", true, rows);
+    const auto digests = Measure("Row digests", false, rows);
+
+    std::remove(BENCHMARK_DB_NAME.c_str());
+
+    std::cout << "Results " << (rowByRow && digests ? "match" : "differ") << '\n';
+    return rowByRow && digests ? 0 : 1;
+}
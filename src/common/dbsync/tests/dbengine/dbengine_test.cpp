@@ -685,3 +685,96 @@ TEST_F(DBEngineTest, AddTableRelationshipNoMetadata)
 
     EXPECT_THROW(spEngine->addTableRelationship(relationshipJSON), dbengine_error);
 }
+
+TEST_F(DBEngineTest, StatementCacheReusesStatements)
+{
+    const auto& mockFactory {std::make_shared<MockSQLiteFactory>()};
+    const auto& mockConnection {std::make_shared<MockConnection>()};
+
+    auto mockTransaction {std::make_unique<MockTransaction>()};
+
+    EXPECT_CALL(*mockFactory, createConnection(_)).WillOnce(Return(mockConnection));
+    EXPECT_CALL(*mockFactory, createTransaction(_)).WillOnce(Return(ByMove(std::move(mockTransaction))));
+
+    auto mockStatement_1 {std::make_unique<MockStatement>()};
+    EXPECT_CALL(*mockStatement_1, step()).WillOnce(Return(SQLITE_DONE));
+    EXPECT_CALL(*mockFactory, createStatement(_, "NNN")).WillOnce(Return(ByMove(std::move(mockStatement_1))));
+
+    EXPECT_CALL(*mockConnection, execute("PRAGMA temp_store = memory;")).Times(1);
+    EXPECT_CALL(*mockConnection, execute("PRAGMA journal_mode = truncate;")).Times(1);
+    EXPECT_CALL(*mockConnection, execute("PRAGMA synchronous = OFF;")).Times(1);
+    EXPECT_CALL(*mockConnection, execute("PRAGMA user_version = 1;")).Times(1);
+
+    EXPECT_CALL(*mockConnection, changes()).Times(2).WillRepeatedly(Return(1));
+
+    std::unique_ptr<SQLiteDBEngine> spEngine;
+    EXPECT_NO_THROW(spEngine = std::make_unique<SQLiteDBEngine>(mockFactory, "1", "NNN"));
+
+    auto mockColumn_1 {std::make_unique<MockColumn>()};
+    EXPECT_CALL(*mockColumn_1, value(An<const int32_t&>())).WillOnce(Return(0));
+    auto mockColumn_2 {std::make_unique<MockColumn>()};
+    EXPECT_CALL(*mockColumn_2, value(An<const std::string&>())).WillOnce(Return(STATUS_FIELD_NAME));
+    auto mockColumn_3 {std::make_unique<MockColumn>()};
+    EXPECT_CALL(*mockColumn_3, value(An<const std::string&>())).WillOnce(Return(STATUS_FIELD_TYPE));
+    auto mockColumn_4 {std::make_unique<MockColumn>()};
+    EXPECT_CALL(*mockColumn_4, value(An<const int32_t&>())).WillOnce(Return(0));
+
+    auto mockStatement_2 {std::make_unique<MockStatement>()};
+    EXPECT_CALL(*mockStatement_2, step()).WillOnce(Return(SQLITE_ROW)).WillOnce(Return(SQLITE_DONE));
+    EXPECT_CALL(*mockStatement_2, column(0)).WillOnce(Return(ByMove(std::move(mockColumn_1))));
+    EXPECT_CALL(*mockStatement_2, column(1)).WillOnce(Return(ByMove(std::move(mockColumn_2))));
+    EXPECT_CALL(*mockStatement_2, column(2)).WillOnce(Return(ByMove(std::move(mockColumn_3))));
+    EXPECT_CALL(*mockStatement_2, column(5)).WillOnce(Return(ByMove(std::move(mockColumn_4))));
+    EXPECT_CALL(*mockFactory, createStatement(_, "PRAGMA table_info(dummy);"))
+        .WillOnce(Return(ByMove(std::move(mockStatement_2))));
+
+    // The second deletion reuses the statement prepared by the first one.
+    auto mockStatement_3 {std::make_unique<MockStatement>()};
+    EXPECT_CALL(*mockStatement_3, step()).Times(2).WillRepeatedly(Return(SQLITE_DONE));
+    EXPECT_CALL(*mockStatement_3, reset()).Times(1);
+    EXPECT_CALL(*mockFactory, createStatement(_, "DELETE FROM dummy WHERE db_status_field_dm=0;"))
+        .WillOnce(Return(ByMove(std::move(mockStatement_3))));
+
+    EXPECT_NO_THROW(spEngine->deleteRowsByStatusField(std::vector<std::string> {"dummy"}));
+    EXPECT_NO_THROW(spEngine->deleteRowsByStatusField(std::vector<std::string> {"dummy"}));
+
+    const auto stats {spEngine->statementCacheStats()};
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(2u, stats.misses);
+    EXPECT_EQ(2u, stats.size);
+    EXPECT_EQ(CACHE_STMT_LIMIT, stats.capacity);
+}
+
+TEST_F(DBEngineTest, StatementCacheCapacityGrowsWithTables)
+{
+    const auto& mockFactory {std::make_shared<MockSQLiteFactory>()};
+    const auto& mockConnection {std::make_shared<MockConnection>()};
+    auto mockTransaction {std::make_unique<MockTransaction>()};
+
+    EXPECT_CALL(*mockFactory, createTransaction(_)).WillOnce(Return(ByMove(std::move(mockTransaction))));
+    EXPECT_CALL(*mockFactory, createConnection(_)).WillOnce(Return(mockConnection));
+    EXPECT_CALL(*mockFactory, createStatement(_, _))
+        .Times(3)
+        .WillRepeatedly(
+            []()
+            {
+                auto mockStatement {std::make_unique<MockStatement>()};
+                EXPECT_CALL(*mockStatement, step()).WillOnce(Return(SQLITE_DONE));
+                return std::unique_ptr<SQLiteLegacy::IStatement> {std::move(mockStatement)};
+            });
+    EXPECT_CALL(*mockConnection, execute("PRAGMA temp_store = memory;")).Times(1);
+    EXPECT_CALL(*mockConnection, execute("PRAGMA journal_mode = truncate;")).Times(1);
+    EXPECT_CALL(*mockConnection, execute("PRAGMA synchronous = OFF;")).Times(1);
+    EXPECT_CALL(*mockConnection, execute("PRAGMA user_version = 1;")).Times(1);
+
+    std::unique_ptr<SQLiteDBEngine> spEngine;
+    EXPECT_NO_THROW(spEngine = std::make_unique<SQLiteDBEngine>(mockFactory,
+                                                                "1",
+                                                                "CREATE TABLE t1 (f1 TEXT);CREATE TABLE t2 (f1 TEXT);"
+                                                                "create table t3 (f1 TEXT)"));
+
+    const auto stats {spEngine->statementCacheStats()};
+    EXPECT_EQ(0u, stats.hits);
+    EXPECT_EQ(3u, stats.misses);
+    EXPECT_EQ(3 * CACHE_STMT_PER_TABLE, stats.capacity);
+}
@@ -2329,6 +2329,160 @@ TEST_F(DBSyncTest, createTxnAtomicOperation)
     EXPECT_NO_THROW(dbSync->selectRows(nlohmann::json::parse(selectData), callbackData));
 }
 
+TEST_F(DBSyncTest, createTxnUnchangedRowsCPP)
+{
+    const auto sql {
+        "CREATE TABLE processes(`pid` BIGINT, `name` TEXT, `time` BIGINT, PRIMARY KEY (`pid`)) WITHOUT ROWID;"};
+    const auto tables {R"({"table": "processes"})"};
+    std::unique_ptr<DBSync> dbSync;
+
+    EXPECT_NO_THROW(dbSync = std::make_unique<DBSync>(HostType::AGENT, DbEngineType::SQLITE3, DATABASE_TEMP, sql));
+
+    const auto initialData = nlohmann::json::parse(R"([{"pid":1,"name":"System","time":100},
+                                                      {"pid":2,"name":"Guake","time":200},
+                                                      {"pid":3,"name":"Bash","time":300},
+                                                      {"pid":4,"name":"Vim","time":400}])");
+
+    CallbackMock wrapper;
+
+    for (const auto& entry : initialData)
+    {
+        EXPECT_CALL(wrapper, callbackMock(INSERTED, entry)).Times(1);
+    }
+
+    EXPECT_CALL(wrapper, callbackMock(MODIFIED, nlohmann::json::parse(R"({"pid":2,"name":"Terminal","time":200})")))
+        .Times(1);
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"pid":5,"name":"Top","time":500})")))
+        .Times(1);
+    EXPECT_CALL(wrapper, callbackMock(DELETED, nlohmann::json::parse(R"({"pid":4,"name":"Vim","time":400})")))
+        .Times(1);
+
+    ResultCallbackData callbackData {[&wrapper](ReturnTypeCallback type, const nlohmann::json& jsonResult)
+                                     {
+                                         wrapper.callbackMock(type, jsonResult);
+                                     }};
+
+    nlohmann::json initialSync;
+    initialSync["table"] = "processes";
+    initialSync["data"] = initialData;
+    EXPECT_NO_THROW(dbSync->syncRow(initialSync, callbackData));
+
+    std::unique_ptr<DBSyncTxn> dbSyncTxn;
+    EXPECT_NO_THROW(
+        dbSyncTxn = std::make_unique<DBSyncTxn>(dbSync->handle(), nlohmann::json::parse(tables), 0, 100, callbackData));
+
+    // Unchanged, modified, unchanged with a missing column, new and unchanged again.
+    const auto txnData = nlohmann::json::parse(R"([{"pid":1,"name":"System","time":100},
+                                                  {"pid":2,"name":"Terminal","time":200},
+                                                  {"pid":3,"name":"Bash"},
+                                                  {"pid":5,"name":"Top","time":500},
+                                                  {"pid":1,"name":"System","time":100}])");
+
+    for (const auto& entry : txnData)
+    {
+        nlohmann::json txnSync;
+        txnSync["table"] = "processes";
+        txnSync["data"] = nlohmann::json::array({entry});
+        EXPECT_NO_THROW(dbSyncTxn->syncTxnRow(txnSync));
+    }
+
+    EXPECT_NO_THROW(dbSyncTxn->getDeletedRows(callbackData));
+
+    dbSyncTxn.reset();
+
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, nlohmann::json::parse(R"({"count":4})"))).Times(1);
+
+    const auto selectData {
+        R"({"table":"processes",
+           "query":{"column_list":["count(*) AS count"],
+           "row_filter":"",
+           "distinct_opt":false,
+           "order_by_opt":"",
+           "count_opt":100}})"};
+
+    EXPECT_NO_THROW(dbSync->selectRows(nlohmann::json::parse(selectData), callbackData));
+}
+
+TEST_F(DBSyncTest, createTxnUnchangedRowsWriteOutsideTxnCPP)
+{
+    const auto sql {
+        "CREATE TABLE processes(`pid` BIGINT, `name` TEXT, `time` BIGINT, PRIMARY KEY (`pid`)) WITHOUT ROWID;"};
+    const auto tables {R"({"table": "processes"})"};
+    std::unique_ptr<DBSync> dbSync;
+
+    EXPECT_NO_THROW(dbSync = std::make_unique<DBSync>(HostType::AGENT, DbEngineType::SQLITE3, DATABASE_TEMP, sql));
+
+    const auto initialData = nlohmann::json::parse(R"([{"pid":1,"name":"System","time":100},
+                                                      {"pid":2,"name":"Guake","time":200},
+                                                      {"pid":3,"name":"Bash","time":300},
+                                                      {"pid":4,"name":"Vim","time":400}])");
+    const auto outsideData = nlohmann::json::parse(R"({"pid":6,"name":"Cron","time":600})");
+
+    CallbackMock wrapper;
+
+    for (const auto& entry : initialData)
+    {
+        EXPECT_CALL(wrapper, callbackMock(INSERTED, entry)).Times(1);
+    }
+
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, outsideData)).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(DELETED, nlohmann::json::parse(R"({"pid":4,"name":"Vim","time":400})")))
+        .Times(1);
+
+    ResultCallbackData callbackData {[&wrapper](ReturnTypeCallback type, const nlohmann::json& jsonResult)
+                                     {
+                                         wrapper.callbackMock(type, jsonResult);
+                                     }};
+
+    nlohmann::json initialSync;
+    initialSync["table"] = "processes";
+    initialSync["data"] = initialData;
+    EXPECT_NO_THROW(dbSync->syncRow(initialSync, callbackData));
+
+    std::unique_ptr<DBSyncTxn> dbSyncTxn;
+    EXPECT_NO_THROW(
+        dbSyncTxn = std::make_unique<DBSyncTxn>(dbSync->handle(), nlohmann::json::parse(tables), 0, 100, callbackData));
+
+    const auto syncTxnRow {[&dbSyncTxn](const nlohmann::json& entry)
+                           {
+                               nlohmann::json txnSync;
+                               txnSync["table"] = "processes";
+                               txnSync["data"] = nlohmann::json::array({entry});
+                               EXPECT_NO_THROW(dbSyncTxn->syncTxnRow(txnSync));
+                           }};
+
+    // Most rows are unchanged, so the whole table gets marked when the write below applies the pending marks.
+    for (size_t i = 0; i < 3; ++i)
+    {
+        syncTxnRow(initialData[i]);
+    }
+
+    nlohmann::json outsideSync;
+    outsideSync["table"] = "processes";
+    outsideSync["data"] = nlohmann::json::array({outsideData});
+    EXPECT_NO_THROW(dbSync->syncRow(outsideSync, callbackData));
+
+    // The digests are reloaded, the rows already synced must not be reloaded and unmarked.
+    syncTxnRow(outsideData);
+    syncTxnRow(initialData[0]);
+
+    EXPECT_NO_THROW(dbSyncTxn->getDeletedRows(callbackData));
+
+    dbSyncTxn.reset();
+
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, nlohmann::json::parse(R"({"count":4})"))).Times(1);
+
+    const auto selectData {
+        R"({"table":"processes",
+           "query":{"column_list":["count(*) AS count"],
+           "row_filter":"",
+           "distinct_opt":false,
+           "order_by_opt":"",
+           "count_opt":100}})"};
+
+    EXPECT_NO_THROW(dbSync->selectRows(nlohmann::json::parse(selectData), callbackData));
+}
+
 TEST_F(DBSyncTest, InitializationCPP)
 {
     const auto sql {
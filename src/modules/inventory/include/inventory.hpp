@@ -3,6 +3,7 @@
 #include <chrono>
 #include <condition_variable>
 #include <ctime>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <stack>
@@ -61,6 +62,10 @@ public:
 
     void SetAgentUUID(const std::string& agentUUID);
 
+    /// @brief Returns how long each collector took in the last scan
+    /// @return Elapsed time of each collector, keyed by the name of its table
+    std::map<std::string, std::chrono::milliseconds> CollectorTimings() const;
+
 private:
     std::string GetCreateStatement() const;
     nlohmann::json EcsProcessesData(const nlohmann::json& originalData, bool createFields = true);
@@ -90,6 +95,8 @@ private:
                      const bool isFirstScan);
 
     void TryCatchTask(const std::function<void()>& task) const;
+    void SetFirstScanDone(const std::string& table, bool& firstScan);
+    void RunCollector(const std::string& table, const std::function<void()>& collector);
     void ScanHardware();
     void ScanSystem();
     void ScanNetwork();
@@ -147,6 +154,8 @@ private:
     std::unique_ptr<DBSync> m_spDBSync;
     std::condition_variable m_cv;
     std::mutex m_mutex;
+    mutable std::mutex m_timingsMutex;
+    std::map<std::string, std::chrono::milliseconds> m_collectorTimings; // Elapsed time of each collector
     std::unique_ptr<InvNormalizer> m_spNormalizer;
     std::string m_scanTime;
     std::function<int(Message)> m_pushMessage;
@@ -157,4 +166,5 @@ private:
     bool m_portsFirstScan;     // Opened ports first scan flag
     bool m_processesFirstScan; // Running processes first scan flag
     bool m_hotfixesFirstScan;  // Windows hotfixes installed first scan flag
+    std::string m_packagesFingerprint; // Fingerprint of the package sources at the last packages scan
 };
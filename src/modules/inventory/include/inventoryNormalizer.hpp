@@ -1,7 +1,14 @@
 #pragma once
+#include <cstddef>
 #include <map>
+#include <memory>
 #include <nlohmann/json.hpp>
+#include <optional>
 #include <string>
+#include <vector>
+
+/// @brief Pattern of a normalization rule, compiled once when the configuration is loaded
+class NormalizerPattern;
 
 class InvNormalizer
 {
@@ -12,8 +19,36 @@ public:
     void RemoveExcluded(const std::string& type, nlohmann::json& data) const;
 
 private:
-    static std::map<std::string, nlohmann::json>
-    GetTypeValues(const std::string& configFile, const std::string& target, const std::string& type);
-    const std::map<std::string, nlohmann::json> m_typeExclusions;
-    const std::map<std::string, nlohmann::json> m_typeDictionary;
+    /// @brief Item is excluded if its field matches the pattern
+    struct ExclusionRule
+    {
+        std::size_t field;
+        std::shared_ptr<const NormalizerPattern> pattern;
+    };
+
+    /// @brief Entry of the dictionary, fields are indexes in the fields of its rule program
+    struct DictionaryRule
+    {
+        std::optional<std::size_t> findField;
+        std::shared_ptr<const NormalizerPattern> findPattern;
+        std::optional<std::size_t> replaceField;
+        std::shared_ptr<const NormalizerPattern> replacePattern;
+        std::string replaceValue;
+        std::optional<std::size_t> addField;
+        std::string addValue;
+    };
+
+    /// @brief Compiled rules of a data type
+    struct RuleProgram
+    {
+        /// @brief Names of the fields the rules read or write, each one is looked up once per item
+        std::vector<std::string> fields;
+        std::vector<ExclusionRule> exclusions;
+        std::vector<DictionaryRule> dictionary;
+    };
+
+    static std::map<std::string, RuleProgram> Compile(const std::string& configFile, const std::string& target);
+    static bool IsExcluded(const RuleProgram& program, const nlohmann::json& item);
+    static void NormalizeItem(const RuleProgram& program, nlohmann::json& item);
+    const std::map<std::string, RuleProgram> m_typePrograms;
 };
@@ -8,6 +8,11 @@
 #include <nlohmann/json.hpp>
 #include <stringHelper.hpp>
 #include <timeHelper.hpp>
+#include <tuple>
+#include <vector>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 
 constexpr auto EMPTY_VALUE {""};
 
@@ -16,6 +21,9 @@ constexpr size_t MAX_ID_SIZE = 512;
 
 constexpr auto QUEUE_SIZE {4096};
 
+/// @brief Number of collectors that run at the same time during a scan
+constexpr std::size_t SCAN_WORKERS {4};
+
 static const std::map<ReturnTypeCallback, std::string> OPERATION_MAP {
     {MODIFIED, "update"},
     {DELETED, "delete"},
@@ -376,6 +384,16 @@ void Inventory::UpdateChanges(const std::string& table, const nlohmann::json& va
     txn.getDeletedRows(callback);
 }
 
+void Inventory::SetFirstScanDone(const std::string& table, bool& firstScan)
+{
+    if (!firstScan && !m_stopping)
+    {
+        const std::unique_lock<std::mutex> lock {m_mutex};
+        WriteMetadata(TABLE_TO_KEY_MAP.at(table), Utils::getCurrentISO8601());
+        firstScan = true;
+    }
+}
+
 void Inventory::TryCatchTask(const std::function<void()>& task) const
 {
     try
@@ -643,11 +661,7 @@ void Inventory::ScanHardware()
         UpdateChanges(HARDWARE_TABLE, hwData, !m_hardwareFirstScan);
         LogTrace("Ending hardware scan");
 
-        if (!m_hardwareFirstScan && !m_stopping)
-        {
-            WriteMetadata(TABLE_TO_KEY_MAP.at(HARDWARE_TABLE), Utils::getCurrentISO8601());
-            m_hardwareFirstScan = true;
-        }
+        SetFirstScanDone(HARDWARE_TABLE, m_hardwareFirstScan);
     }
 }
 
@@ -661,11 +675,7 @@ void Inventory::ScanSystem()
         UpdateChanges(SYSTEM_TABLE, SystemData, !m_systemFirstScan);
         LogTrace("Ending os scan");
 
-        if (!m_systemFirstScan && !m_stopping)
-        {
-            WriteMetadata(TABLE_TO_KEY_MAP.at(SYSTEM_TABLE), Utils::getCurrentISO8601());
-            m_systemFirstScan = true;
-        }
+        SetFirstScanDone(SYSTEM_TABLE, m_systemFirstScan);
     }
 }
 
@@ -761,11 +771,7 @@ void Inventory::ScanNetwork()
             }
         }
 
-        if (!m_networksFirstScan && !m_stopping)
-        {
-            WriteMetadata(TABLE_TO_KEY_MAP.at(NETWORKS_TABLE), Utils::getCurrentISO8601());
-            m_networksFirstScan = true;
-        }
+        SetFirstScanDone(NETWORKS_TABLE, m_networksFirstScan);
 
         LogTrace("Ending network scan");
     }
@@ -775,46 +781,44 @@ void Inventory::ScanPackages()
 {
     if (m_packages)
     {
+        const auto fingerprint {m_spInfo->packagesFingerprint()};
+
+        // Nothing was installed, upgraded or removed since the last scan, so the table is up to date
+        if (!fingerprint.empty() && fingerprint == m_packagesFingerprint)
+        {
+            LogDebug("Package sources unchanged, skipping packages scan.");
+            return;
+        }
+
         LogTrace("Starting packages scan");
-        const auto callback {[this](ReturnTypeCallback result, const nlohmann::json& data)
-                             {
-                                 NotifyChange(result, data, PACKAGES_TABLE, !m_packagesFirstScan);
-                             }};
+        auto packages = nlohmann::json::array();
 
-        const std::unique_lock<std::mutex> lock {m_mutex};
-        DBSyncTxn txn {m_spDBSync->handle(), nlohmann::json {PACKAGES_TABLE}, 0, QUEUE_SIZE, callback};
+        // Packages are collected without holding the database lock, so other collectors can sync meanwhile
         m_spInfo->packages(
-            [this, &txn](nlohmann::json& rawData)
+            [this, &packages](nlohmann::json& rawData)
             {
                 if (m_stopping)
                 {
                     return;
                 }
 
-                nlohmann::json input;
-
-                input["table"] = PACKAGES_TABLE;
                 m_spNormalizer->Normalize("packages", rawData);
                 m_spNormalizer->RemoveExcluded("packages", rawData);
 
                 if (!rawData.empty())
                 {
-                    input["data"] = nlohmann::json::array({rawData});
-                    if (m_packagesFirstScan)
-                    {
-                        input["options"]["return_old_data"] = true;
-                    }
-                    txn.syncTxnRow(input);
+                    packages.push_back(std::move(rawData));
                 }
             });
-        txn.getDeletedRows(callback);
 
-        if (!m_packagesFirstScan && !m_stopping)
+        if (!m_stopping)
         {
-            WriteMetadata(TABLE_TO_KEY_MAP.at(PACKAGES_TABLE), Utils::getCurrentISO8601());
-            m_packagesFirstScan = true;
+            UpdateChanges(PACKAGES_TABLE, packages, !m_packagesFirstScan);
+            m_packagesFingerprint = fingerprint;
         }
 
+        SetFirstScanDone(PACKAGES_TABLE, m_packagesFirstScan);
+
         LogTrace("Ending packages scan");
     }
 }
@@ -831,11 +835,7 @@ void Inventory::ScanHotfixes()
             UpdateChanges(HOTFIXES_TABLE, hotfixes, !m_hotfixesFirstScan);
         }
 
-        if (!m_hotfixesFirstScan && !m_stopping)
-        {
-            WriteMetadata(TABLE_TO_KEY_MAP.at(HOTFIXES_TABLE), Utils::getCurrentISO8601());
-            m_hotfixesFirstScan = true;
-        }
+        SetFirstScanDone(HOTFIXES_TABLE, m_hotfixesFirstScan);
 
         LogTrace("Ending hotfixes scan");
     }
@@ -910,11 +910,7 @@ void Inventory::ScanPorts()
         UpdateChanges(PORTS_TABLE, portsData, !m_portsFirstScan);
         LogTrace("Ending ports scan");
 
-        if (!m_portsFirstScan && !m_stopping)
-        {
-            WriteMetadata(TABLE_TO_KEY_MAP.at(PORTS_TABLE), Utils::getCurrentISO8601());
-            m_portsFirstScan = true;
-        }
+        SetFirstScanDone(PORTS_TABLE, m_portsFirstScan);
     }
 }
 
@@ -923,39 +919,26 @@ void Inventory::ScanProcesses()
     if (m_processes)
     {
         LogTrace("Starting processes scan");
-        const auto callback {[this](ReturnTypeCallback result, const nlohmann::json& data)
-                             {
-                                 NotifyChange(result, data, PROCESSES_TABLE, !m_processesFirstScan);
-                             }};
-        const std::unique_lock<std::mutex> lock {m_mutex};
-        DBSyncTxn txn {m_spDBSync->handle(), nlohmann::json {PROCESSES_TABLE}, 0, QUEUE_SIZE, callback};
+        auto processes = nlohmann::json::array();
+
         m_spInfo->processes(std::function<void(nlohmann::json&)>(
-            [this, &txn](nlohmann::json& rawData)
+            [this, &processes](nlohmann::json& rawData)
             {
                 if (m_stopping)
                 {
                     return;
                 }
 
-                nlohmann::json input;
-                input["table"] = PROCESSES_TABLE;
-                input["data"] = nlohmann::json::array({rawData});
-
-                if (m_processesFirstScan)
-                {
-                    input["options"]["return_old_data"] = true;
-                }
-
-                txn.syncTxnRow(input);
+                processes.push_back(std::move(rawData));
             }));
-        txn.getDeletedRows(callback);
 
-        if (!m_processesFirstScan && !m_stopping)
+        if (!m_stopping)
         {
-            WriteMetadata(TABLE_TO_KEY_MAP.at(PROCESSES_TABLE), Utils::getCurrentISO8601());
-            m_processesFirstScan = true;
+            UpdateChanges(PROCESSES_TABLE, processes, !m_processesFirstScan);
         }
 
+        SetFirstScanDone(PROCESSES_TABLE, m_processesFirstScan);
+
         LogTrace("Ending processes scan");
     }
 }
@@ -965,18 +948,58 @@ void Inventory::Scan()
     LogInfo("Starting evaluation.");
     m_scanTime = Utils::getCurrentISO8601();
 
-    TryCatchTask([&]() { ScanHardware(); });
-    TryCatchTask([&]() { ScanSystem(); });
-    TryCatchTask([&]() { ScanPackages(); });
-    TryCatchTask([&]() { ScanProcesses(); });
-    TryCatchTask([&]() { ScanHotfixes(); });
-    TryCatchTask([&]() { ScanPorts(); });
-    TryCatchTask([&]() { ScanNetwork(); });
+    // Collectors run concurrently, each one syncing its own table once its data is ready. The slowest ones are
+    // posted first so they don't wait for a free worker.
+    const std::vector<std::tuple<bool, std::string, std::function<void()>>> collectors {
+        {m_packages, PACKAGES_TABLE, [this]() { ScanPackages(); }},
+        {m_processes, PROCESSES_TABLE, [this]() { ScanProcesses(); }},
+        {m_hotfixes, HOTFIXES_TABLE, [this]() { ScanHotfixes(); }},
+        {m_ports, PORTS_TABLE, [this]() { ScanPorts(); }},
+        {m_networks, NETWORKS_TABLE, [this]() { ScanNetwork(); }},
+        {m_hardware, HARDWARE_TABLE, [this]() { ScanHardware(); }},
+        {m_system, SYSTEM_TABLE, [this]() { ScanSystem(); }}};
+
+    {
+        const std::lock_guard<std::mutex> lock {m_timingsMutex};
+        m_collectorTimings.clear();
+    }
+
+    boost::asio::thread_pool pool {SCAN_WORKERS};
+
+    for (const auto& [enabled, table, collector] : collectors)
+    {
+        if (enabled)
+        {
+            boost::asio::post(pool, [this, &table, &collector]() { RunCollector(table, collector); });
+        }
+    }
+
+    pool.join();
 
     m_notify = true;
     LogInfo("Evaluation finished.");
 }
 
+void Inventory::RunCollector(const std::string& table, const std::function<void()>& collector)
+{
+    const auto start {std::chrono::steady_clock::now()};
+
+    TryCatchTask(collector);
+
+    const auto elapsed {
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start)};
+    LogDebug("Collector {} finished in {} ms.", table, elapsed.count());
+
+    const std::lock_guard<std::mutex> lock {m_timingsMutex};
+    m_collectorTimings[table] = elapsed;
+}
+
+std::map<std::string, std::chrono::milliseconds> Inventory::CollectorTimings() const
+{
+    const std::lock_guard<std::mutex> lock {m_timingsMutex};
+    return m_collectorTimings;
+}
+
 void Inventory::SyncLoop()
 {
     LogInfo("Module started.");
@@ -1,135 +1,393 @@
+#include <algorithm>
 #include <fstream>
 #include <inventoryNormalizer.hpp>
 #include <iostream>
-#include <regex>
+#include <pcre2.h>
+#include <stdexcept>
+#include <string_view>
 
-InvNormalizer::InvNormalizer(const std::string& configFile, const std::string& target)
-    : m_typeExclusions {GetTypeValues(configFile, target, "exclusions")}
-    , m_typeDictionary {GetTypeValues(configFile, target, "dictionary")}
+namespace
 {
-}
+    /// @brief Literals that every match of a pattern contains
+    struct RequiredLiterals
+    {
+        /// @brief Text every match starts with
+        std::string prefix;
 
-void InvNormalizer::RemoveExcluded(const std::string& type, nlohmann::json& data) const
-{
-    const auto exclusionsIt {m_typeExclusions.find(type)};
+        /// @brief Longest text every match contains
+        std::string longest;
+    };
 
-    if (exclusionsIt != m_typeExclusions.cend())
+    /// @brief Finds literals that a subject must contain to match a pattern
+    ///
+    /// Only simple patterns are analyzed: nothing is required from patterns with
+    /// alternatives, escapes, classes, special groups or optional groups.
+    RequiredLiterals GetRequiredLiterals(std::string_view pattern)
     {
-        for (const auto& exclusionItem : exclusionsIt->second)
+        if (pattern.find_first_of("|\\[") != std::string_view::npos || pattern.find("(?") != std::string_view::npos)
         {
-            try
+            return {};
+        }
+
+        std::vector<std::string> runs;
+        std::string run;
+        bool runStartsMatch = true;
+        bool atStart = true;
+        std::optional<std::string> prefix;
+
+        const auto endRun = [&]()
+        {
+            if (runStartsMatch && !prefix)
+            {
+                prefix = run;
+            }
+
+            if (!run.empty())
+            {
+                runs.push_back(std::move(run));
+            }
+
+            run.clear();
+            runStartsMatch = false;
+        };
+
+        for (std::size_t i = 0; i < pattern.size(); ++i)
+        {
+            const auto c = pattern[i];
+
+            if (c == '(')
+            {
+                if (!run.empty())
+                {
+                    endRun();
+                }
+
+                runStartsMatch = atStart;
+            }
+            else if (c == ')')
             {
-                const std::regex pattern {exclusionItem["pattern"].get_ref<const std::string&>()};
-                const auto& fieldName {exclusionItem["field_name"].get_ref<const std::string&>()};
+                endRun();
 
-                if (data.is_array())
+                if (i + 1 < pattern.size() && std::string_view("?*{").find(pattern[i + 1]) != std::string_view::npos)
                 {
-                    for (auto item {data.begin()}; item != data.end(); ++item)
-                    {
-                        const auto fieldIt {item->find(fieldName)};
-
-                        if (fieldIt != item->end() && std::regex_match(fieldIt->get_ref<const std::string&>(), pattern))
-                        {
-                            data.erase(item);
-                        }
-                    }
+                    return {};
                 }
-                else
+            }
+            else if (c == '?' || c == '*' || c == '{')
+            {
+                // The quantified character is optional
+                if (!run.empty())
                 {
-                    const auto fieldIt {data.find(fieldName)};
+                    run.pop_back();
+                }
 
-                    if (fieldIt != data.end() && std::regex_match(fieldIt->get_ref<const std::string&>(), pattern))
-                    {
-                        data.clear();
-                    }
+                endRun();
+
+                if (c == '{')
+                {
+                    i = std::min(pattern.find('}', i), pattern.size());
                 }
             }
-            catch (const std::exception& ex)
+            else if (c == '+')
+            {
+                endRun();
+            }
+            else if (c == '.' || c == '^' || c == '$')
             {
-                std::cout << "Exception caught in RemoveExcluded: " << ex.what() << '\n';
+                endRun();
             }
-            catch (...)
+            else
+            {
+                run += c;
+                atStart = false;
+                continue;
+            }
+
+            if (c != '(')
+            {
+                atStart = false;
+            }
+        }
+
+        endRun();
+
+        RequiredLiterals literals {prefix.value_or(""), ""};
+
+        for (auto& candidate : runs)
+        {
+            if (candidate.size() > literals.longest.size())
             {
-                std::cout << "Unknown exception caught in RemoveExcluded." << '\n';
+                literals.longest = std::move(candidate);
             }
         }
+
+        return literals;
     }
-}
+} // namespace
 
-static void NormalizeItem(const nlohmann::json& dictionary, nlohmann::json& item)
+class NormalizerPattern
 {
-    for (const auto& dictItem : dictionary)
+public:
+    /// @brief Compiles a pattern
+    /// @param pattern Pattern, in the syntax of the normalizer configuration
+    /// @param wholeSubject Whether the pattern has to match the whole subject or any part of it
+    /// @throws std::runtime_error if the pattern is not valid
+    NormalizerPattern(const std::string& pattern, bool wholeSubject)
+    {
+        int errorCode = 0;
+        PCRE2_SIZE errorOffset = 0;
+        const auto options = wholeSubject ? PCRE2_ANCHORED | PCRE2_ENDANCHORED : 0;
+
+        m_code = pcre2_compile(reinterpret_cast<PCRE2_SPTR>(pattern.c_str()),
+                               pattern.size(),
+                               options,
+                               &errorCode,
+                               &errorOffset,
+                               nullptr);
+
+        if (m_code == nullptr)
+        {
+            std::vector<PCRE2_UCHAR> message(256); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+            pcre2_get_error_message(errorCode, message.data(), message.size());
+            throw std::runtime_error("Invalid pattern '" + pattern + "' at offset " + std::to_string(errorOffset) +
+                                     ": " + reinterpret_cast<const char*>(message.data()));
+        }
+
+        // Without JIT support the interpreter is used
+        pcre2_jit_compile(m_code, PCRE2_JIT_COMPLETE);
+
+        auto literals = GetRequiredLiterals(pattern);
+        m_prefix = wholeSubject ? std::move(literals.prefix) : "";
+        m_literal = std::move(literals.longest);
+    }
+
+    ~NormalizerPattern()
+    {
+        pcre2_code_free(m_code);
+    }
+
+    NormalizerPattern(const NormalizerPattern&) = delete;
+    NormalizerPattern& operator=(const NormalizerPattern&) = delete;
+
+    /// @brief Checks if a subject matches the pattern
+    bool Matches(const std::string& subject) const
+    {
+        if (!MayMatch(subject))
+        {
+            return false;
+        }
+
+        const std::unique_ptr<pcre2_match_data, decltype(&pcre2_match_data_free)> matchData {
+            pcre2_match_data_create_from_pattern(m_code, nullptr), pcre2_match_data_free};
+
+        return matchData && pcre2_match(m_code,
+                                        reinterpret_cast<PCRE2_SPTR>(subject.data()),
+                                        subject.size(),
+                                        0,
+                                        0,
+                                        matchData.get(),
+                                        nullptr) >= 0;
+    }
+
+    /// @brief Replaces every match of the pattern in a subject
+    /// @return True if the subject changed
+    bool Replace(std::string& subject, const std::string& replacement) const
     {
-        const auto itFindPattern {dictItem.find("find_pattern")};
-        const auto itFindField {dictItem.find("find_field")};
+        if (!MayMatch(subject))
+        {
+            return false;
+        }
+
+        std::vector<PCRE2_UCHAR> output(subject.size() + replacement.size() + 1);
 
-        if (itFindPattern != dictItem.end() && itFindField != dictItem.end())
+        for (;;)
         {
-            const auto fieldIt {item.find(itFindField->get_ref<const std::string&>())};
-            const std::regex pattern {itFindPattern->get_ref<const std::string&>()};
+            auto outputSize = static_cast<PCRE2_SIZE>(output.size());
+            const auto rc = pcre2_substitute(m_code,
+                                             reinterpret_cast<PCRE2_SPTR>(subject.data()),
+                                             subject.size(),
+                                             0,
+                                             PCRE2_SUBSTITUTE_GLOBAL | PCRE2_SUBSTITUTE_OVERFLOW_LENGTH,
+                                             nullptr,
+                                             nullptr,
+                                             reinterpret_cast<PCRE2_SPTR>(replacement.data()),
+                                             replacement.size(),
+                                             output.data(),
+                                             &outputSize);
 
-            if (fieldIt == item.end() || !std::regex_match(fieldIt->get_ref<const std::string&>(), pattern))
+            if (rc == PCRE2_ERROR_NOMEMORY)
             {
-                // no field in the item or no matching, we continue
+                output.resize(outputSize);
                 continue;
             }
+
+            if (rc <= 0)
+            {
+                return false;
+            }
+
+            subject.assign(reinterpret_cast<const char*>(output.data()), outputSize);
+            return true;
         }
-        else if (itFindPattern != dictItem.end() || itFindField != dictItem.end())
+    }
+
+private:
+    /// @brief Rejects subjects that lack the literals every match contains
+    bool MayMatch(const std::string& subject) const
+    {
+        return subject.starts_with(m_prefix) && subject.find(m_literal) != std::string::npos;
+    }
+
+    pcre2_code* m_code = nullptr;
+    std::string m_prefix;
+    std::string m_literal;
+};
+
+namespace
+{
+    std::size_t FieldIndex(std::vector<std::string>& fields, const std::string& name)
+    {
+        const auto it {std::find(fields.begin(), fields.end(), name)};
+
+        if (it != fields.end())
         {
-            // we won't evaluate an incomplete item.
-            continue;
+            return static_cast<std::size_t>(it - fields.begin());
         }
 
-        const auto itReplacePattern {dictItem.find("replace_pattern")};
-        const auto itReplaceField {dictItem.find("replace_field")};
-        const auto itReplaceValue {dictItem.find("replace_value")};
+        fields.push_back(name);
+        return fields.size() - 1;
+    }
 
-        if (itReplacePattern != dictItem.end() && itReplaceField != dictItem.end() && itReplaceValue != dictItem.end())
+    /// @brief Looks up the fields of a rule program in an item
+    /// @return The string fields, by index, or nullptr if an item lacks them
+    template<typename Json>
+    std::vector<Json*> FindFields(const std::vector<std::string>& fields, Json& item)
+    {
+        std::vector<Json*> found(fields.size(), nullptr);
+
+        for (std::size_t i = 0; i < fields.size(); ++i)
         {
-            const std::regex pattern {itReplacePattern->get_ref<const std::string&>()};
-            const auto fieldIt {item.find(itReplaceField->get_ref<const std::string&>())};
+            const auto fieldIt {item.find(fields[i])};
 
-            if (fieldIt != item.end())
+            if (fieldIt != item.end() && fieldIt->is_string())
             {
-                *fieldIt = std::regex_replace(
-                    fieldIt->get_ref<const std::string&>(), pattern, itReplaceValue->get_ref<const std::string&>());
+                found[i] = &*fieldIt;
             }
         }
 
-        const auto itAddField {dictItem.find("add_field")};
-        const auto itAddValue {dictItem.find("add_value")};
+        return found;
+    }
+} // namespace
+
+InvNormalizer::InvNormalizer(const std::string& configFile, const std::string& target)
+    : m_typePrograms {Compile(configFile, target)}
+{
+}
+
+bool InvNormalizer::IsExcluded(const RuleProgram& program, const nlohmann::json& item)
+{
+    if (program.exclusions.empty() || !item.is_object())
+    {
+        return false;
+    }
+
+    const auto fields {FindFields(program.fields, item)};
 
-        if (itAddField != dictItem.end() && itAddValue != dictItem.end())
+    return std::any_of(program.exclusions.cbegin(),
+                       program.exclusions.cend(),
+                       [&fields](const ExclusionRule& rule)
+                       {
+                           const auto* field {fields[rule.field]};
+                           return field != nullptr && rule.pattern->Matches(field->get_ref<const std::string&>());
+                       });
+}
+
+void InvNormalizer::RemoveExcluded(const std::string& type, nlohmann::json& data) const
+{
+    const auto programIt {m_typePrograms.find(type)};
+
+    if (programIt != m_typePrograms.cend())
+    {
+        const auto& program {programIt->second};
+
+        if (data.is_array())
+        {
+            data.erase(std::remove_if(data.begin(),
+                                      data.end(),
+                                      [&program](const nlohmann::json& item) { return IsExcluded(program, item); }),
+                       data.end());
+        }
+        else if (IsExcluded(program, data))
         {
-            item[itAddField->get_ref<const std::string&>()] = itAddValue->get_ref<const std::string&>();
+            data.clear();
+        }
+    }
+}
+
+void InvNormalizer::NormalizeItem(const RuleProgram& program, nlohmann::json& item)
+{
+    if (program.dictionary.empty() || !item.is_object())
+    {
+        return;
+    }
+
+    auto fields {FindFields(program.fields, item)};
+
+    for (const auto& rule : program.dictionary)
+    {
+        if (rule.findPattern)
+        {
+            const auto* field {fields[*rule.findField]};
+
+            if (field == nullptr || !rule.findPattern->Matches(field->get_ref<const std::string&>()))
+            {
+                // no field in the item or no matching, we continue
+                continue;
+            }
+        }
+
+        if (rule.replacePattern)
+        {
+            if (auto* field {fields[*rule.replaceField]}; field != nullptr)
+            {
+                rule.replacePattern->Replace(field->get_ref<std::string&>(), rule.replaceValue);
+            }
+        }
+
+        if (rule.addField)
+        {
+            auto& field {item[program.fields[*rule.addField]]};
+            field = rule.addValue;
+            fields[*rule.addField] = &field;
         }
     }
 }
 
 void InvNormalizer::Normalize(const std::string& type, nlohmann::json& data) const
 {
-    const auto dictionaryIt {m_typeDictionary.find(type)};
+    const auto programIt {m_typePrograms.find(type)};
 
-    if (dictionaryIt != m_typeDictionary.cend())
+    if (programIt != m_typePrograms.cend())
     {
         if (data.is_array())
         {
             for (auto& item : data)
             {
-                NormalizeItem(dictionaryIt->second, item);
+                NormalizeItem(programIt->second, item);
             }
         }
         else
         {
-            NormalizeItem(dictionaryIt->second, data);
+            NormalizeItem(programIt->second, data);
         }
     }
 }
 
-std::map<std::string, nlohmann::json>
-InvNormalizer::GetTypeValues(const std::string& configFile, const std::string& target, const std::string& type)
+std::map<std::string, InvNormalizer::RuleProgram> InvNormalizer::Compile(const std::string& configFile,
+                                                                         const std::string& target)
 {
-    std::map<std::string, nlohmann::json> ret;
+    std::map<std::string, RuleProgram> ret;
+    nlohmann::json jsonConfigFile;
 
     try
     {
@@ -137,29 +395,89 @@ InvNormalizer::GetTypeValues(const std::string& configFile, const std::string& t
 
         if (config.is_open())
         {
-            const nlohmann::json& jsonConfigFile {nlohmann::json::parse(config)};
-            const auto it {jsonConfigFile.find(type)};
-
-            if (it != jsonConfigFile.end())
-            {
-                for (const auto& item : *it)
-                {
-                    if (item["target"] == target)
-                    {
-                        ret[item["data_type"]].push_back(item);
-                    }
-                }
-            }
+            jsonConfigFile = nlohmann::json::parse(config);
         }
     }
     catch (const std::exception& ex)
     {
-        std::cout << "Exception caught in GetTypeValues: " << ex.what() << '\n';
+        std::cout << "Exception caught in Compile: " << ex.what() << '\n';
     }
-    catch (...)
+
+    const auto forEachTargetItem = [&](const std::string& section, const auto& compileItem)
     {
-        std::cout << "Unknown exception caught in GetTypeValues." << '\n';
-    }
+        const auto it {jsonConfigFile.find(section)};
+
+        if (it == jsonConfigFile.end())
+        {
+            return;
+        }
+
+        for (const auto& item : *it)
+        {
+            try
+            {
+                if (item["target"] == target)
+                {
+                    compileItem(ret[item["data_type"].get<std::string>()], item);
+                }
+            }
+            catch (const std::exception& ex)
+            {
+                std::cout << "Exception caught compiling " << section << " entry: " << ex.what() << '\n';
+            }
+        }
+    };
+
+    forEachTargetItem("exclusions",
+                      [](RuleProgram& program, const nlohmann::json& item)
+                      {
+                          auto pattern {
+                              std::make_shared<NormalizerPattern>(item.at("pattern").get<std::string>(), true)};
+                          const auto field {FieldIndex(program.fields, item.at("field_name").get<std::string>())};
+                          program.exclusions.push_back({field, std::move(pattern)});
+                      });
+
+    forEachTargetItem(
+        "dictionary",
+        [](RuleProgram& program, const nlohmann::json& item)
+        {
+            DictionaryRule rule;
+            const auto itFindPattern {item.find("find_pattern")};
+            const auto itFindField {item.find("find_field")};
+
+            if (itFindPattern != item.end() && itFindField != item.end())
+            {
+                rule.findPattern = std::make_shared<NormalizerPattern>(itFindPattern->get<std::string>(), true);
+                rule.findField = FieldIndex(program.fields, itFindField->get<std::string>());
+            }
+            else if (itFindPattern != item.end() || itFindField != item.end())
+            {
+                // we won't evaluate an incomplete item.
+                return;
+            }
+
+            const auto itReplacePattern {item.find("replace_pattern")};
+            const auto itReplaceField {item.find("replace_field")};
+            const auto itReplaceValue {item.find("replace_value")};
+
+            if (itReplacePattern != item.end() && itReplaceField != item.end() && itReplaceValue != item.end())
+            {
+                rule.replacePattern = std::make_shared<NormalizerPattern>(itReplacePattern->get<std::string>(), false);
+                rule.replaceField = FieldIndex(program.fields, itReplaceField->get<std::string>());
+                rule.replaceValue = itReplaceValue->get<std::string>();
+            }
+
+            const auto itAddField {item.find("add_field")};
+            const auto itAddValue {item.find("add_value")};
+
+            if (itAddField != item.end() && itAddValue != item.end())
+            {
+                rule.addField = FieldIndex(program.fields, itAddField->get<std::string>());
+                rule.addValue = itAddValue->get<std::string>();
+            }
+
+            program.dictionary.push_back(std::move(rule));
+        });
 
     return ret;
 }
@@ -0,0 +1,205 @@
+#include "inventoryNormalizer.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr std::size_t DEFAULT_PACKAGES = 4000;
+    constexpr auto TARGET {"macos"};
+
+    /// @brief Typical names of packages, to build dpkg and rpm package lists from.
+    constexpr std::array STEMS {"ssl",      "curl",    "xml2",   "systemd", "glib",     "python3",    "perl",
+                                "gtk",      "krb5",    "pam",    "sqlite",  "zlib",     "yaml",       "openssh",
+                                "bash",     "nss",     "dbus",   "pcre2",   "audit",    "selinux",    "gnutls",
+                                "expat",    "ncurses", "lz4",    "zstd",    "mesa",     "fontconfig", "cups",
+                                "readline", "avahi",   "x11",    "acl",     "coreutils", "e2fsprogs"};
+
+    /// @brief Names of third-party products, some of them matched by the normalization rules.
+    constexpr std::array PRODUCTS {"microsoft-edge-stable", "VMware Tools", "code", "google-chrome-stable",
+                                   "McAfee Endpoint Security For Mac", "teams", "zoom.us", "docker-ce",
+                                   "Kaspersky Endpoint Security For Mac", "AVGAntivirus"};
+
+    /// @brief Builds a package list of a host, half of it in dpkg style and half of it in rpm style.
+    nlohmann::json CreatePackages(std::size_t count)
+    {
+        nlohmann::json packages = nlohmann::json::array();
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const std::string stem {STEMS[i % STEMS.size()]};
+            const auto variant {i / STEMS.size()};
+            const bool dpkg {i % 2 == 0};
+            std::string name;
+
+            if (i % 50 == 0) // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+            {
+                name = PRODUCTS[(i / 50) % PRODUCTS.size()]; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+            }
+            else if (dpkg)
+            {
+                name = variant % 3 == 0 ? "lib" + stem + std::to_string(variant)
+                                        : (variant % 3 == 1 ? "python3-" + stem : stem + "-common");
+            }
+            else
+            {
+                name = variant % 3 == 0 ? stem + "-libs" : (variant % 3 == 1 ? "perl-" + stem : stem + "-devel");
+            }
+
+            packages.push_back({{"name", name},
+                                {"version", dpkg ? "1." + std::to_string(variant) + "-1+deb12u1"
+                                                 : "1." + std::to_string(variant) + "-3.el9"},
+                                {"architecture", dpkg ? "amd64" : "x86_64"},
+                                {"format", dpkg ? "deb" : "rpm"},
+                                {"vendor", dpkg ? "Debian" : "Red Hat, Inc."},
+                                {"description", "Package " + name + " of the " + stem + " project"},
+                                {"size", 1024 * variant}}); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+        }
+
+        return packages;
+    }
+
+    /// @brief Normalizes an item the way InvNormalizer used to: the regexes of each entry are built for each item.
+    void NormalizeLegacy(const nlohmann::json& dictionary, nlohmann::json& item)
+    {
+        for (const auto& dictItem : dictionary)
+        {
+            const auto itFindPattern {dictItem.find("find_pattern")};
+            const auto itFindField {dictItem.find("find_field")};
+
+            if (itFindPattern != dictItem.end() && itFindField != dictItem.end())
+            {
+                const auto fieldIt {item.find(itFindField->get_ref<const std::string&>())};
+                const std::regex pattern {itFindPattern->get_ref<const std::string&>()};
+
+                if (fieldIt == item.end() || !std::regex_match(fieldIt->get_ref<const std::string&>(), pattern))
+                {
+                    continue;
+                }
+            }
+            else if (itFindPattern != dictItem.end() || itFindField != dictItem.end())
+            {
+                continue;
+            }
+
+            const auto itReplacePattern {dictItem.find("replace_pattern")};
+            const auto itReplaceField {dictItem.find("replace_field")};
+            const auto itReplaceValue {dictItem.find("replace_value")};
+
+            if (itReplacePattern != dictItem.end() && itReplaceField != dictItem.end() &&
+                itReplaceValue != dictItem.end())
+            {
+                const std::regex pattern {itReplacePattern->get_ref<const std::string&>()};
+                const auto fieldIt {item.find(itReplaceField->get_ref<const std::string&>())};
+
+                if (fieldIt != item.end())
+                {
+                    *fieldIt = std::regex_replace(
+                        fieldIt->get_ref<const std::string&>(), pattern, itReplaceValue->get_ref<const std::string&>());
+                }
+            }
+
+            const auto itAddField {dictItem.find("add_field")};
+            const auto itAddValue {dictItem.find("add_value")};
+
+            if (itAddField != dictItem.end() && itAddValue != dictItem.end())
+            {
+                item[itAddField->get_ref<const std::string&>()] = itAddValue->get_ref<const std::string&>();
+            }
+        }
+    }
+
+    /// @brief Removes an excluded item the way InvNormalizer used to.
+    void RemoveExcludedLegacy(const nlohmann::json& exclusions, nlohmann::json& item)
+    {
+        for (const auto& exclusionItem : exclusions)
+        {
+            const std::regex pattern {exclusionItem["pattern"].get_ref<const std::string&>()};
+            const auto fieldIt {item.find(exclusionItem["field_name"].get_ref<const std::string&>())};
+
+            if (fieldIt != item.end() && std::regex_match(fieldIt->get_ref<const std::string&>(), pattern))
+            {
+                item.clear();
+            }
+        }
+    }
+
+    /// @brief Reads the entries of a configuration section for the packages of the target.
+    nlohmann::json GetPackageEntries(const nlohmann::json& config, const std::string& section)
+    {
+        nlohmann::json entries = nlohmann::json::array();
+
+        for (const auto& entry : config[section])
+        {
+            if (entry["target"] == TARGET && entry["data_type"] == "packages")
+            {
+                entries.push_back(entry);
+            }
+        }
+
+        return entries;
+    }
+
+    /// @brief Runs a normalizer over a copy of the packages, one package at a time as Inventory::ScanPackages does.
+    /// @return The normalized packages
+    template<typename Func>
+    nlohmann::json Measure(const std::string& name, const nlohmann::json& packages, const Func& normalize)
+    {
+        auto items = packages;
+        std::size_t kept = 0;
+        const auto start = std::chrono::steady_clock::now();
+
+        for (auto& item : items)
+        {
+            normalize(item);
+            kept += item.empty() ? 0 : 1;
+        }
+
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << name << ": " << kept << " packages kept in " << seconds * 1000 << " ms\n";
+        return items;
+    }
+} // namespace
+
+/// @brief Measures package normalization with the bundled rules. Usage: benchmark_InvNormalizer [number of packages]
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::stoul(argv[1]) : DEFAULT_PACKAGES;
+    const auto packages = CreatePackages(count);
+
+    std::ifstream configFile {NORM_CONFIG_FILE};
+    const auto config = nlohmann::json::parse(configFile);
+    const auto dictionary = GetPackageEntries(config, "dictionary");
+    const auto exclusions = GetPackageEntries(config, "exclusions");
+
+    const auto legacyResult = Measure("std::regex per item",
+            packages,
+            [&](nlohmann::json& item)
+            {
+                NormalizeLegacy(dictionary, item);
+                RemoveExcludedLegacy(exclusions, item);
+            });
+
+    const auto start = std::chrono::steady_clock::now();
+    const InvNormalizer normalizer {NORM_CONFIG_FILE, TARGET};
+    std::cout << "Rules compiled in "
+              << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1000 << " ms\n";
+
+    const auto compiledResult = Measure("Compiled rules",
+            packages,
+            [&](nlohmann::json& item)
+            {
+                normalizer.Normalize("packages", item);
+                normalizer.RemoveExcluded("packages", item);
+            });
+
+    std::cout << "Results " << (legacyResult == compiledResult ? "match" : "differ") << '\n';
+    return legacyResult == compiledResult ? 0 : 1;
+}
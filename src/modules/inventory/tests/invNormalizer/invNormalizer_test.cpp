@@ -235,6 +235,54 @@ TEST_F(InvNormalizerTest, normalizeItemMatch)
     EXPECT_NE(inputJson, origJson);
 }
 
+TEST_F(InvNormalizerTest, excludeConsecutiveItems)
+{
+    auto inputJson(nlohmann::json::parse(R"([
+        {"name": "Siri", "version": "1.0"},
+        {"name": "iCloud", "version": "1.0"},
+        {"name": "Safari", "version": "1.0"}
+    ])"));
+    const InvNormalizer normalizer {TEST_CONFIG_FILE_NAME, "macos"};
+    normalizer.RemoveExcluded("packages", inputJson);
+    ASSERT_EQ(inputJson.size(), 1);
+    EXPECT_EQ(inputJson[0]["name"], "Safari");
+}
+
+TEST_F(InvNormalizerTest, normalizeMatchesWholeField)
+{
+    auto inputJson(nlohmann::json::parse(R"(
+        {
+            "name": "Uninstaller for Kaspersky For Mac",
+            "version": "1.0"
+        })"));
+    const auto origJson(inputJson);
+    const InvNormalizer normalizer {TEST_CONFIG_FILE_NAME, "macos"};
+    normalizer.Normalize("packages", inputJson);
+    EXPECT_EQ(inputJson, origJson);
+}
+
+TEST_F(InvNormalizerTest, invalidPatternIsSkipped)
+{
+    constexpr auto INVALID_PATTERN_FILE {"invalid_pattern.json"};
+    std::ofstream testConfigFile {INVALID_PATTERN_FILE};
+
+    if (testConfigFile.is_open())
+    {
+        testConfigFile << R"({"dictionary":[
+            {"target": "linux", "data_type": "packages", "find_field": "name", "find_pattern": "(unclosed",
+             "add_field": "vendor", "add_value": "Invalid"},
+            {"target": "linux", "data_type": "packages", "find_field": "name", "find_pattern": "lib.*",
+             "add_field": "vendor", "add_value": "Library"}]})";
+        testConfigFile.close();
+    }
+
+    auto inputJson(nlohmann::json::parse(R"({"name": "libssl3", "version": "3.0.15"})"));
+    const InvNormalizer normalizer {INVALID_PATTERN_FILE, "linux"};
+    normalizer.Normalize("packages", inputJson);
+    EXPECT_EQ(inputJson["vendor"], "Library");
+    std::remove(INVALID_PATTERN_FILE);
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
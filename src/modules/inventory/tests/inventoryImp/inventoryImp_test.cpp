@@ -37,6 +37,7 @@ public:
     MOCK_METHOD(void, processes, (std::function<void(nlohmann::json&)>), (override));
     MOCK_METHOD(nlohmann::json, ports, (), (override));
     MOCK_METHOD(nlohmann::json, hotfixes, (), (override));
+    MOCK_METHOD(std::string, packagesFingerprint, (), (override));
 };
 
 class CallbackMock
@@ -1431,6 +1432,152 @@ TEST_F(InventoryImpTest, statelessMessage)
     }
 }
 
+TEST_F(InventoryImpTest, collectorTimings)
+{
+    const auto spInfoWrapper {std::make_shared<SysInfoWrapper>()};
+
+    EXPECT_CALL(*spInfoWrapper, os())
+        .WillRepeatedly(Return(nlohmann::json::parse(
+            R"({"architecture":"x86_64","scan_time":"2020/12/28 21:49:50", "hostname":"UBUNTU","os_build":"7601","os_major":"6","os_minor":"1","os_name":"Microsoft Windows 7","os_release":"sp1","os_version":"6.1.7601"})")));
+    EXPECT_CALL(*spInfoWrapper, packages(testing::_))
+        .Times(::testing::AtLeast(1))
+        .WillOnce(::testing::InvokeArgument<0>(
+            R"({"architecture":"amd64","scan_time":"2020/12/28 21:49:50", "group":"x11","name":"xserver-xorg","priority":"optional","size":4111222333,"source":"xorg","version":"1:7.7+19ubuntu14","format":"deb","location":" "})"_json));
+    EXPECT_CALL(*spInfoWrapper, hotfixes())
+        .WillRepeatedly(Return(nlohmann::json::parse(R"([{"hotfix":"KB12345678"}])")));
+
+    EXPECT_CALL(*spInfoWrapper, hardware()).Times(0);
+    EXPECT_CALL(*spInfoWrapper, networks()).Times(0);
+    EXPECT_CALL(*spInfoWrapper, ports()).Times(0);
+    EXPECT_CALL(*spInfoWrapper, processes(testing::_)).Times(0);
+
+    std::function<void(const std::string&)> callbackDataDelta {[](const std::string&) {}};
+
+    std::string inventoryConfig = R"(
+        inventory:
+            enabled: true
+            interval: 3600
+            scan_on_start: true
+            hardware: false
+            system: true
+            networks: false
+            packages: true
+            ports: false
+            ports_all: false
+            processes: false
+            hotfixes: true
+    )";
+    auto configParser = std::make_shared<configuration::ConfigurationParser>(inventoryConfig);
+    m_inventory.Setup(configParser);
+
+    std::thread t {[&spInfoWrapper, &callbackDataDelta, this]()
+                   {
+                       m_inventory.Init(spInfoWrapper, callbackDataDelta, INVENTORY_DB_PATH, "", "");
+                       m_inventory.SetAgentUUID("1234");
+                   }};
+
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    m_inventory.Stop();
+
+    if (t.joinable())
+    {
+        t.join();
+    }
+
+    const auto timings {m_inventory.CollectorTimings()};
+
+    EXPECT_EQ(timings.size(), 3);
+    EXPECT_TRUE(timings.contains("system"));
+    EXPECT_TRUE(timings.contains("packages"));
+    EXPECT_TRUE(timings.contains("hotfixes"));
+}
+
+TEST_F(InventoryImpTest, packagesFingerprintUnchanged)
+{
+    const auto spInfoWrapper {std::make_shared<SysInfoWrapper>()};
+
+    EXPECT_CALL(*spInfoWrapper, packagesFingerprint()).WillRepeatedly(Return("1234"));
+    EXPECT_CALL(*spInfoWrapper, packages(testing::_))
+        .Times(1)
+        .WillOnce(::testing::InvokeArgument<0>(
+            R"({"architecture":"amd64","scan_time":"2020/12/28 21:49:50", "group":"x11","name":"xserver-xorg","priority":"optional","size":4111222333,"source":"xorg","version":"1:7.7+19ubuntu14","format":"deb","location":" "})"_json));
+
+    std::string inventoryConfig = R"(
+        inventory:
+            enabled: true
+            interval: 1
+            scan_on_start: true
+            hardware: false
+            system: false
+            networks: false
+            packages: true
+            ports: false
+            ports_all: false
+            processes: false
+            hotfixes: false
+    )";
+    auto configParser = std::make_shared<configuration::ConfigurationParser>(inventoryConfig);
+    m_inventory.Setup(configParser);
+
+    std::thread t {[&spInfoWrapper, this]()
+                   {
+                       m_inventory.Init(spInfoWrapper, ReportFunction, INVENTORY_DB_PATH, "", "");
+                       m_inventory.SetAgentUUID("1234");
+                   }};
+
+    std::this_thread::sleep_for(std::chrono::seconds {SLEEP_DURATION_SECONDS});
+    m_inventory.Stop();
+
+    if (t.joinable())
+    {
+        t.join();
+    }
+}
+
+TEST_F(InventoryImpTest, packagesFingerprintChanged)
+{
+    const auto spInfoWrapper {std::make_shared<SysInfoWrapper>()};
+
+    EXPECT_CALL(*spInfoWrapper, packagesFingerprint())
+        .WillOnce(Return("1234"))
+        .WillRepeatedly(Return("5678"));
+    EXPECT_CALL(*spInfoWrapper, packages(testing::_))
+        .Times(2)
+        .WillRepeatedly(::testing::InvokeArgument<0>(
+            R"({"architecture":"amd64","scan_time":"2020/12/28 21:49:50", "group":"x11","name":"xserver-xorg","priority":"optional","size":4111222333,"source":"xorg","version":"1:7.7+19ubuntu14","format":"deb","location":" "})"_json));
+
+    std::string inventoryConfig = R"(
+        inventory:
+            enabled: true
+            interval: 1
+            scan_on_start: true
+            hardware: false
+            system: false
+            networks: false
+            packages: true
+            ports: false
+            ports_all: false
+            processes: false
+            hotfixes: false
+    )";
+    auto configParser = std::make_shared<configuration::ConfigurationParser>(inventoryConfig);
+    m_inventory.Setup(configParser);
+
+    std::thread t {[&spInfoWrapper, this]()
+                   {
+                       m_inventory.Init(spInfoWrapper, ReportFunction, INVENTORY_DB_PATH, "", "");
+                       m_inventory.SetAgentUUID("1234");
+                   }};
+
+    std::this_thread::sleep_for(std::chrono::seconds {SLEEP_DURATION_SECONDS});
+    m_inventory.Stop();
+
+    if (t.joinable())
+    {
+        t.join();
+    }
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -8,14 +8,36 @@
 #include <boost/asio/awaitable.hpp>
 #include <boost/asio/steady_timer.hpp>
 
+#include <cstdint>
 #include <list>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 namespace logcollector
 {
     /// @brief Interface for log readers
     class IReader;
 
+    /// @brief Store of the reading positions
+    class BookmarkStore;
+
+    /// @brief Per-source event rate limiter
+    class RateLimiter;
+
+    /// @brief Counters of the logs that could not be queued when they were read
+    struct LogcollectorStatistics
+    {
+        /// @brief Logs held back because their source exceeded its rate limit
+        std::uint64_t throttled = 0;
+
+        /// @brief Logs held back because the queue was full
+        std::uint64_t blocked = 0;
+
+        /// @brief Logs lost because their reader cannot retry them
+        std::uint64_t dropped = 0;
+    };
+
     /// @brief Logcollector module class
     ///
     /// This module is responsible for collecting logs from various sources and processing them.
@@ -53,11 +75,28 @@ namespace logcollector
         void SetPushMessageFunction(const std::function<int(Message)>& pushMessage) override;
 
         /// @brief Pushes a message to que queue
+        /// @param location Location of the message, the source the rate limit applies to
+        /// @param log Message to send
+        /// @param collectorType type of logcollector
+        /// @return True if the message was queued, false if the source exceeds its rate or the queue is full
+        /// @pre The message queue must be set with SetMessageQueue
+        virtual bool PushMessage(const std::string& location, const std::string& log, const std::string& collectorType);
+
+        /// @brief Pushes a message to que queue, rate limited as part of a given source
         /// @param location Location of the message
         /// @param log Message to send
         /// @param collectorType type of logcollector
+        /// @param source Source the rate limit applies to
+        /// @return True if the message was queued, false if the source exceeds its rate or the queue is full
         /// @pre The message queue must be set with SetMessageQueue
-        virtual void PushMessage(const std::string& location, const std::string& log, const std::string& collectorType);
+        bool PushMessage(const std::string& location,
+                         const std::string& log,
+                         const std::string& collectorType,
+                         const std::string& source);
+
+        /// @brief Gets the counters of the logs that could not be queued when they were read
+        /// @return Statistics since the module was created
+        LogcollectorStatistics GetStatistics() const;
 
         /// @brief Enqueues an ASIO task (coroutine)
         /// @param task Task to enqueue
@@ -84,6 +123,18 @@ namespace logcollector
         /// @brief Clean all readers
         void CleanAllReaders();
 
+        /// @brief Pushes a message of a reader that cannot hold logs back
+        ///
+        /// The message is not rate limited, as throttling it would lose it. If the
+        /// queue is full, it is lost and counted as dropped.
+        ///
+        /// @param location Location of the message
+        /// @param log Message to send
+        /// @param collectorType type of logcollector
+        /// @return True if the message was queued, false if it was dropped
+        /// @pre The message queue must be set with SetMessageQueue
+        bool PushMessageOrDrop(const std::string& location, const std::string& log, const std::string& collectorType);
+
     private:
         /// @brief Wraps a task with a counter
         /// @param task Task to wrap
@@ -91,6 +142,19 @@ namespace logcollector
         /// @details This function is used to keep track of the number of tasks that are currently running.
         boost::asio::awaitable<void> WrapWithCounter(boost::asio::awaitable<void> task);
 
+        /// @brief Builds a message and pushes it to the queue
+        /// @param location Location of the message
+        /// @param log Message to send
+        /// @param collectorType type of logcollector
+        /// @return True if the message was queued, false if the queue is full
+        /// @pre The message queue must be set with SetMessageQueue
+        bool QueueMessage(const std::string& location, const std::string& log, const std::string& collectorType);
+
+        /// @brief Gets the metadata of the messages of a collector
+        /// @param collectorType Type of collector
+        /// @return Serialized metadata, built on the first call for each collector type
+        const std::string& GetMetadata(const std::string& collectorType);
+
         /// @brief Module name
         const std::string m_moduleName = "logcollector";
 
@@ -106,6 +170,9 @@ namespace logcollector
         /// @brief List of readers
         std::list<std::shared_ptr<IReader>> m_readers;
 
+        /// @brief Reading positions shared by the readers
+        std::shared_ptr<BookmarkStore> m_bookmarks;
+
         /// @brief Indicates if number of logs being monitorized
         std::atomic<int> m_activeReaders = 0;
 
@@ -114,6 +181,24 @@ namespace logcollector
 
         /// @brief List of steady timers
         std::list<boost::asio::steady_timer*> m_timers;
+
+        /// @brief Rate limit of the sources, if max_eps is set
+        std::shared_ptr<RateLimiter> m_rateLimiter;
+
+        /// @brief Logs held back by the rate limit
+        std::atomic<std::uint64_t> m_throttled = 0;
+
+        /// @brief Logs held back by a full queue
+        std::atomic<std::uint64_t> m_blocked = 0;
+
+        /// @brief Logs lost by readers that cannot retry
+        std::atomic<std::uint64_t> m_dropped = 0;
+
+        /// @brief Mutex to access the metadata of the collectors
+        std::mutex m_metadataMutex;
+
+        /// @brief Serialized metadata of the messages, by collector type
+        std::unordered_map<std::string, std::string> m_metadata;
     };
 
 } // namespace logcollector
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+
+namespace logcollector
+{
+
+    /// @brief File identity, stable across renames
+    struct FileId
+    {
+        /// @brief Device (volume) holding the file
+        std::uint64_t device = 0;
+
+        /// @brief Inode (file index) within the device
+        std::uint64_t inode = 0;
+
+        /// @brief Equality operator
+        bool operator==(const FileId& other) const = default;
+
+        /// @brief Ordering operator
+        auto operator<=>(const FileId& other) const = default;
+    };
+
+    /// @brief Read position of a file
+    struct Bookmark
+    {
+        /// @brief Identity of the file the position belongs to
+        FileId id;
+
+        /// @brief Offset after the last line read
+        std::int64_t offset = 0;
+
+        /// @brief Hash of the first bytes of the file, to tell it apart from a new file that reuses the inode
+        std::uint64_t fingerprint = 0;
+
+        /// @brief Number of bytes hashed into the fingerprint
+        std::int64_t fingerprintSize = 0;
+
+        /// @brief Equality operator
+        bool operator==(const Bookmark& other) const = default;
+    };
+
+    /// @brief Bookmark store class
+    ///
+    /// This class keeps the read position of each local file, and the cursor of
+    /// each journal reader, so that reading resumes where it stopped after a
+    /// restart. Positions are updated in memory and written to disk at most once
+    /// per flush interval.
+    ///
+    /// When the bookmarks are written, those of files that no longer exist, or
+    /// that no reader asked for since they were loaded because the files no
+    /// longer match any pattern, are dropped.
+    class BookmarkStore
+    {
+    public:
+        /// @brief Constructor. Loads the bookmarks stored in the file, if any
+        /// @param filePath File to keep the bookmarks in
+        /// @param flushInterval Minimum time between writes
+        BookmarkStore(std::string filePath, std::chrono::milliseconds flushInterval);
+
+        /// @brief Gets the bookmark of a file, and keeps it when the bookmarks are written
+        /// @param filename File name
+        /// @return The bookmark, or nothing if the file has none
+        std::optional<Bookmark> Get(const std::string& filename);
+
+        /// @brief Finds the bookmark of a file by its identity, for files that were renamed
+        /// @param id File identity
+        /// @return The bookmark, or nothing if no file has that identity
+        std::optional<Bookmark> Find(const FileId& id) const;
+
+        /// @brief Sets the bookmark of a file
+        /// @param filename File name
+        /// @param bookmark Bookmark
+        void Set(const std::string& filename, const Bookmark& bookmark);
+
+        /// @brief Gets the journal cursor of a reader
+        /// @param source Reader identifier
+        /// @return The cursor of the last entry processed, or nothing if the reader has none
+        std::optional<std::string> GetCursor(const std::string& source) const;
+
+        /// @brief Sets the journal cursor of a reader
+        /// @param source Reader identifier
+        /// @param cursor Cursor of the last entry processed
+        void SetCursor(const std::string& source, const std::string& cursor);
+
+        /// @brief Writes the bookmarks if they changed and the flush interval has elapsed since the last write
+        void FlushIfDue();
+
+        /// @brief Writes the bookmarks if they changed
+        void Flush();
+
+    private:
+        /// @brief Loads the bookmarks from the file
+        void Load();
+
+        /// @brief Writes the bookmarks to the file. m_mutex must be held
+        void Write();
+
+        /// @brief Drops the bookmarks of files that are gone or not read anymore. m_mutex must be held
+        void Prune();
+
+        /// @brief File to keep the bookmarks in
+        std::string m_filePath;
+
+        /// @brief Minimum time between writes
+        std::chrono::milliseconds m_flushInterval;
+
+        /// @brief Time of the last write
+        std::chrono::steady_clock::time_point m_lastFlush;
+
+        /// @brief Bookmarks by file name
+        std::map<std::string, Bookmark> m_bookmarks;
+
+        /// @brief File names by the identity in their bookmark
+        std::map<FileId, std::string> m_filenames;
+
+        /// @brief Files whose bookmark was asked for or set since the bookmarks were loaded
+        std::set<std::string> m_inUse;
+
+        /// @brief Journal cursors by reader
+        std::map<std::string, std::string> m_cursors;
+
+        /// @brief Whether the bookmarks changed since the last write
+        bool m_dirty = false;
+
+        /// @brief Mutex to access the bookmarks
+        mutable std::mutex m_mutex;
+    };
+
+    /// @brief Computes a fingerprint of some bytes
+    /// @param data Bytes to hash
+    /// @return FNV-1a hash of the bytes
+    std::uint64_t Fingerprint(std::string_view data);
+
+} // namespace logcollector
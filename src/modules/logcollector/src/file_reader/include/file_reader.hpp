@@ -4,8 +4,16 @@
 #include <exception>
 #include <fstream>
 #include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string_view>
 
+#include <bookmark_store.hpp>
+#include <file_watcher.hpp>
+#include <line_reader.hpp>
 #include <reader.hpp>
+#include <record_assembler.hpp>
 
 const std::string FILE_READER_TYPE = "file";
 
@@ -28,17 +36,67 @@ namespace logcollector
         Localfile(std::shared_ptr<std::istream> stream);
 
         /// @brief Gets the next log from the file
-        /// @return A log, or an empty string if the end of the file has been reached
-        std::string NextLog();
+        ///
+        /// Empty lines are skipped, and a carriage return before the line feed is removed.
+        ///
+        /// @return A log, valid until the next call, or an empty string if the end of the file has been reached
+        std::string_view NextLog();
+
+        /// @brief Joins the lines of the file into multiline records
+        /// @param config Multiline record settings
+        void SetMultiline(const MultilineConfig& config);
+
+        /// @brief Gets the next complete record from the file
+        ///
+        /// Without multiline settings, each log is a record. A record handed
+        /// back with Retry is returned first.
+        ///
+        /// @return A record, or nothing if no complete record is available
+        std::optional<std::string> NextRecord();
+
+        /// @brief Takes the multiline record still waiting for more lines
+        /// @param force Whether to take it even if its timeout has not expired
+        /// @return The record, or nothing if there is none or it may still grow
+        std::optional<std::string> FlushRecord(bool force);
+
+        /// @brief Hands back the last record taken, because it could not be pushed
+        ///
+        /// The reading position stays at the first line of the record until it
+        /// is taken again.
+        ///
+        /// @param record Record
+        void Retry(std::string record);
+
+        /// @brief Checks if a multiline record is waiting for more lines
+        /// @return True if there is a pending record, false otherwise
+        bool HasPendingRecord() const;
+
+        /// @brief Checks if a record was handed back with Retry
+        /// @return True if a record is waiting to be pushed again, false otherwise
+        bool HasUnsentRecord() const;
 
         /// @brief Seeks to the end of the file
         void SeekEnd();
 
+        /// @brief Gets the bookmark of the current reading position
+        /// @return Bookmark after the last log handed out, or at the first line of the unsent or pending record
+        Bookmark GetBookmark();
+
+        /// @brief Resumes reading at a bookmark
+        ///
+        /// The position is restored only if the bookmark belongs to this file:
+        /// same identity, same leading bytes, and an offset within the file size.
+        ///
+        /// @param bookmark Bookmark
+        /// @return True if the position was restored, false if the file was left untouched
+        bool Restore(const Bookmark& bookmark);
+
         /// @brief Checks if the file has been rotated
         ///
-        /// This method checks if the file has been rotated by comparing the current
-        /// size of the file with the reading position. If the file size is lower
-        /// than the reading position, the file has been rotated.
+        /// This method checks if the file has been rotated by comparing the identity
+        /// of the file at the path with the open file, and the current size of the
+        /// file with the reading position. If another file has taken the path, or
+        /// the file size is lower than the reading position, the file has been rotated.
         ///
         /// @return True if the file has been rotated, false otherwise
         bool Rotated();
@@ -53,15 +111,57 @@ namespace logcollector
             return m_filename;
         }
 
+        /// @brief Gets the identity of the open file
+        /// @return File identity
+        inline const FileId& Id() const
+        {
+            return m_id;
+        }
+
     private:
+        /// @brief Opens the file at the path and takes its identity
+        ///
+        /// The path may be rotated between opening it and taking the identity, so
+        /// the identity is taken before and after opening, and the file is opened
+        /// again until both match.
+        ///
+        /// @throw OpenError if the file cannot be opened
+        void Open();
+
+        /// @brief Reads the first bytes of the file, keeping the reading position
+        /// @param length Maximum number of bytes to read
+        /// @return The bytes read
+        std::string ReadHead(std::streamsize length);
+
         /// @brief File name
         std::string m_filename;
 
         /// @brief Shared pointer to the input stream
         std::shared_ptr<std::istream> m_stream;
 
-        /// @brief Current position in the file
-        std::streampos m_pos;
+        /// @brief Line reader, keeps the data read from the stream that has not been handed out yet
+        LineReader m_reader;
+
+        /// @brief Joins the lines into records, if the file has multiline settings
+        std::optional<RecordAssembler> m_assembler;
+
+        /// @brief Offset of the first line of the last record taken
+        std::int64_t m_recordOffset = 0;
+
+        /// @brief Record handed back because it could not be pushed, if any
+        std::optional<std::string> m_unsent;
+
+        /// @brief Offset of the first line of the unsent record
+        std::int64_t m_unsentOffset = 0;
+
+        /// @brief Identity of the open file
+        FileId m_id;
+
+        /// @brief Fingerprint of the first bytes of the file
+        std::uint64_t m_fingerprint = 0;
+
+        /// @brief Number of bytes hashed into the fingerprint
+        std::int64_t m_fingerprintSize = 0;
     };
 
     /// @brief File reader class
@@ -69,6 +169,15 @@ namespace logcollector
     /// This class represents each file block in the module. There may exist
     /// multiple file readers of each type. The File reader expands wildcards so
     /// that one file reader can read multiple files (Localfile).
+    ///
+    /// Where the platform notifies file changes, files are read when they change
+    /// and new files are found when they appear in the directory. Otherwise, each
+    /// file is polled every file wait interval and the wildcards are expanded
+    /// again every reload interval.
+    ///
+    /// When a log cannot be pushed, because the queue is full or the file exceeds
+    /// its rate limit, the file stops being read at that log and is retried every
+    /// file wait interval.
     class FileReader : public IReader
     {
     public:
@@ -78,16 +187,20 @@ namespace logcollector
         /// @param waitFunc Wait function
         /// @param enqueueTaskFunc Enqueue task function
         /// @param pattern File pattern
-        /// @param fileWait File wait time in milliseconds
-        /// @param reloadInterval Reload interval in milliseconds
+        /// @param fileWait File wait time in milliseconds, when polling
+        /// @param reloadInterval Reload interval in milliseconds, when polling
+        /// @param bookmarks Store to resume files from, or nullptr to always start at the end of the files
+        /// @param multiline Settings to join lines into records, or nothing to push each line as a log
         FileReader(
-            std::function<void(const std::string& location, const std::string& log, const std::string& collectorType)>
+            std::function<bool(const std::string& location, const std::string& log, const std::string& collectorType)>
                 pushMessageFunc,
             std::function<Awaitable(std::chrono::milliseconds)> waitFunc,
             std::function<void(boost::asio::awaitable<void>)> enqueueTaskFunc,
             std::string pattern,
             std::time_t fileWait,
-            std::time_t reloadInterval);
+            std::time_t reloadInterval,
+            std::shared_ptr<BookmarkStore> bookmarks = nullptr,
+            std::optional<MultilineConfig> multiline = std::nullopt);
 
         /// @copydoc IReader::Run
         Awaitable Run() override;
@@ -123,6 +236,66 @@ namespace logcollector
         /// @post The file is destroyed and may not be used anymore
         void RemoveLocalfile(const std::string& filename);
 
+        /// @brief Sets the starting position of a new local file
+        ///
+        /// Resumes from the stored bookmark if it still matches the file, and
+        /// reads the file from the beginning if it does not. A file without a
+        /// bookmark is read from the beginning if it was just created, and from
+        /// its end otherwise.
+        ///
+        /// @param lf Localfile
+        /// @param created Whether the file was created while the reader was running
+        void SetStartPosition(Localfile& lf, bool created);
+
+        /// @brief Reads the local files as the file watcher notifies changes
+        ///
+        /// Returns when the reader is stopped, or when the watcher fails, after
+        /// handing the files it was watching over to polling tasks.
+        ///
+        /// @param watcher File watcher, already watching the directory
+        /// @param directory Directory of the file pattern
+        /// @return Awaitable result
+        Awaitable WatchLocalfiles(std::shared_ptr<IFileWatcher> watcher, std::string directory);
+
+        /// @brief Starts reading a local file on notifications
+        ///
+        /// If the file cannot be watched, it is polled instead.
+        ///
+        /// @param watcher File watcher
+        /// @param lf Localfile
+        /// @param created Whether the file was created while the reader was running
+        void AddWatchedLocalfile(IFileWatcher& watcher, Localfile& lf, bool created);
+
+        /// @brief Reads the changes of a watched local file, and follows its rotation
+        /// @param watcher File watcher
+        /// @param lf Localfile
+        /// @post The file may be destroyed if it is no longer accessible
+        void ReadWatchedLocalfile(IFileWatcher& watcher, Localfile& lf);
+
+        /// @brief Pushes all the complete logs available in a local file
+        /// @param lf Localfile
+        /// @return True if all the logs were pushed, false if the file is blocked at a log that could not be pushed
+        bool ReadAvailableLogs(Localfile& lf);
+
+        /// @brief Pushes the pending multiline record of a local file
+        /// @param lf Localfile
+        /// @param force Whether to push it even if its timeout has not expired
+        /// @return True if there was nothing to push or it was pushed, false if the file is blocked
+        bool FlushRecord(Localfile& lf, bool force);
+
+        /// @brief Retries the watched local files that are blocked or have pending multiline records
+        ///
+        /// Without notifications nothing else wakes the reader for them. The
+        /// task ends when no file is blocked or has a pending record.
+        ///
+        /// @param watcher File watcher
+        /// @return Awaitable result
+        Awaitable ResumeLocalfiles(std::shared_ptr<IFileWatcher> watcher);
+
+        /// @brief Stores the reading position of a local file
+        /// @param lf Localfile
+        void SaveBookmark(Localfile& lf);
+
         /// @brief Enqueue task function
         std::function<void(boost::asio::awaitable<void>)> m_enqueueTask;
 
@@ -138,10 +311,34 @@ namespace logcollector
         /// @brief Reload (wildcard expand) interval in milliseconds
         std::time_t m_reloadInterval;
 
+        /// @brief Reading positions of the files
+        std::shared_ptr<BookmarkStore> m_bookmarks;
+
+        /// @brief Settings to join lines into records, if any
+        std::optional<MultilineConfig> m_multiline;
+
+        /// @brief Whether a task is retrying the blocked files and pushing the expired multiline records
+        bool m_resumeScheduled = false;
+
+        /// @brief Files polled by their own task, because they could not be watched or the watcher failed
+        std::set<std::string> m_polledFiles;
+
+        /// @brief File watcher, if the files are read on notifications
+        std::shared_ptr<IFileWatcher> m_watcher;
+
+        /// @brief Mutex to access the file watcher
+        std::mutex m_watcherMutex;
+
         /// @brief File pattern
         const std::string m_collectorType = FILE_READER_TYPE;
     };
 
+    /// @brief Gets the identity of a file
+    /// @param filename File name
+    /// @return File identity
+    /// @throw OpenError if the file cannot be accessed
+    FileId GetFileId(const std::string& filename);
+
     /// @brief Open error class
     ///
     /// This class represents an error that occurs when opening a file.
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/awaitable.hpp>
+
+#include <memory>
+#include <set>
+#include <string>
+
+namespace logcollector
+{
+
+    /// @brief Interface for file change notifiers
+    class IFileWatcher
+    {
+    public:
+        /// @brief Destructor
+        virtual ~IFileWatcher() = default;
+
+        /// @brief Starts watching a file for new data, moves and deletion
+        /// @param filename File name
+        /// @return True if the file is being watched, false otherwise
+        virtual bool AddFile(const std::string& filename) = 0;
+
+        /// @brief Stops watching a file
+        /// @param filename File name
+        virtual void RemoveFile(const std::string& filename) = 0;
+
+        /// @brief Starts watching a directory for files created or moved into it
+        /// @param path Directory path
+        /// @return True if the directory is being watched, false otherwise
+        virtual bool AddDirectory(const std::string& path) = 0;
+
+        /// @brief Waits until some watched file or directory changes
+        /// @return Names of the files and directories that changed, or an empty set if the wait was canceled
+        /// @throw std::system_error if notifications can no longer be waited for
+        virtual boost::asio::awaitable<std::set<std::string>> Wait() = 0;
+
+        /// @brief Cancels the pending wait and any later one. May be called from any thread
+        virtual void Cancel() = 0;
+    };
+
+    /// @brief Creates the file watcher of the platform
+    /// @param executor Executor to wait for notifications on
+    /// @return The file watcher, or nullptr if the platform does not notify file changes
+    std::shared_ptr<IFileWatcher> CreateFileWatcher(const boost::asio::any_io_executor& executor);
+
+} // namespace logcollector
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <file_watcher.hpp>
+
+#include <boost/asio/posix/stream_descriptor.hpp>
+
+#include <sys/inotify.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+
+namespace logcollector
+{
+    /// @brief Size of the buffer to read inotify events into
+    constexpr std::size_t INOTIFY_BUFFER_SIZE = 4096;
+
+    /// @brief Inotify file watcher class
+    ///
+    /// This class notifies changes of files and directories on Linux. Each file
+    /// is watched by inode, so after a rename the notifications keep coming
+    /// from the renamed file until it is removed from the watcher.
+    class InotifyWatcher
+        : public IFileWatcher
+        , public std::enable_shared_from_this<InotifyWatcher>
+    {
+    public:
+        /// @brief Constructor
+        /// @param executor Executor to wait for notifications on
+        /// @throw std::system_error if the inotify instance cannot be created
+        InotifyWatcher(const boost::asio::any_io_executor& executor);
+
+        /// @copydoc IFileWatcher::AddFile
+        bool AddFile(const std::string& filename) override;
+
+        /// @copydoc IFileWatcher::RemoveFile
+        void RemoveFile(const std::string& filename) override;
+
+        /// @copydoc IFileWatcher::AddDirectory
+        bool AddDirectory(const std::string& path) override;
+
+        /// @copydoc IFileWatcher::Wait
+        boost::asio::awaitable<std::set<std::string>> Wait() override;
+
+        /// @copydoc IFileWatcher::Cancel
+        void Cancel() override;
+
+    private:
+        /// @brief Adds a watch
+        /// @param path File or directory path
+        /// @param mask Events to watch
+        /// @return True if the watch was added, false otherwise
+        bool AddWatch(const std::string& path, std::uint32_t mask);
+
+        /// @brief Reads the pending events
+        /// @return Names of the files and directories that changed
+        std::set<std::string> ReadEvents();
+
+        /// @brief Inotify instance
+        boost::asio::posix::stream_descriptor m_descriptor;
+
+        /// @brief Watched paths by watch descriptor
+        std::map<int, std::string> m_paths;
+
+        /// @brief Watch descriptors by watched path
+        std::map<std::string, int> m_watches;
+
+        /// @brief Whether the waits are canceled
+        std::atomic<bool> m_canceled = false;
+
+        /// @brief Buffer for the events
+        alignas(inotify_event) std::array<char, INOTIFY_BUFFER_SIZE> m_buffer {};
+    };
+
+} // namespace logcollector
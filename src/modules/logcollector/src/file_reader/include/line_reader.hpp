@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace logcollector
+{
+
+    /// @brief Line reader class
+    ///
+    /// This class splits a stream into lines. The stream is read in blocks into
+    /// a buffer that is reused for the whole life of the reader, and lines are
+    /// handed out as views into that buffer. A line that is not terminated yet
+    /// is kept in the buffer until the rest of it is read.
+    class LineReader
+    {
+    public:
+        /// @brief Constructor
+        /// @param blockSize Buffer size. Lines longer than this are split
+        LineReader(std::size_t blockSize);
+
+        /// @brief Gets the next complete line, reading from the stream if needed
+        ///
+        /// The line terminator is not included. If the stream has no more data,
+        /// the stream state is cleared so that it can be read again later.
+        ///
+        /// @param stream Stream to read from
+        /// @return The line, valid until the next call to the reader, or nothing if there is no complete line
+        std::optional<std::string_view> NextLine(std::istream& stream);
+
+        /// @brief Discards the buffered data
+        /// @param offset Current position of the stream
+        void Reset(std::streamoff offset);
+
+        /// @brief Gets the position of the stream after the data read so far
+        /// @return Offset in bytes
+        inline std::streamoff Offset() const
+        {
+            return m_offset;
+        }
+
+        /// @brief Gets the position of the stream after the lines handed out so far
+        /// @return Offset in bytes
+        inline std::streamoff Position() const
+        {
+            return m_offset - static_cast<std::streamoff>(m_end - m_begin);
+        }
+
+    private:
+        /// @brief Reads data from the stream after the buffered data
+        /// @param stream Stream to read from
+        /// @return True if some data was read, false otherwise
+        bool Fill(std::istream& stream);
+
+        /// @brief Buffer
+        std::vector<char> m_buffer;
+
+        /// @brief Start of the unread data in the buffer
+        std::size_t m_begin = 0;
+
+        /// @brief End of the data in the buffer
+        std::size_t m_end = 0;
+
+        /// @brief Position of the stream after the data read so far
+        std::streamoff m_offset = 0;
+    };
+
+} // namespace logcollector
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+
+namespace logcollector
+{
+
+    /// @brief Ways to tell the lines of a multiline record apart
+    enum class MultilineMode
+    {
+        /// @brief Records start at lines that match a pattern
+        Regex,
+
+        /// @brief Lines that start with a space or a tab continue the previous record
+        Indent,
+
+        /// @brief Records span from an opening brace to the matching closing brace
+        Json
+    };
+
+    /// @brief Multiline record settings
+    struct MultilineConfig
+    {
+        /// @brief How the lines of a record are told apart
+        MultilineMode mode = MultilineMode::Regex;
+
+        /// @brief Pattern of the first line of a record, in regex mode
+        std::shared_ptr<const std::regex> startPattern;
+
+        /// @brief Time without new lines after which a pending record is complete
+        std::chrono::milliseconds timeout {0};
+
+        /// @brief Maximum size of a record, longer records are split
+        std::size_t maxSize = 0;
+    };
+
+    /// @brief Record assembler class
+    ///
+    /// This class joins consecutive lines of a file into records, such as stack
+    /// traces or pretty-printed JSON documents. The lines of a record are joined
+    /// with line feeds. A record is complete when the next record starts, when
+    /// its JSON document is closed, or when no line is added to it for the
+    /// timeout.
+    class RecordAssembler
+    {
+    public:
+        /// @brief Constructor
+        /// @param config Multiline record settings
+        RecordAssembler(MultilineConfig config);
+
+        /// @brief Adds a line
+        /// @param line Line, without the line feed
+        /// @param offset Offset of the line in the file
+        /// @return The record completed by the line, if any
+        std::optional<std::string> Add(std::string_view line, std::int64_t offset);
+
+        /// @brief Takes the pending record if no line was added to it for the timeout
+        /// @param now Current time
+        /// @return The pending record, if it is complete
+        std::optional<std::string> FlushIfExpired(std::chrono::steady_clock::time_point now);
+
+        /// @brief Takes the pending record
+        /// @return The pending record, if any
+        std::optional<std::string> Flush();
+
+        /// @brief Gets the offset of the first line of the pending record
+        /// @return The offset, or nothing if there is no pending record
+        std::optional<std::int64_t> PendingOffset() const;
+
+    private:
+        /// @brief Checks if a line starts a new record, in regex and indent modes
+        /// @param line Line
+        /// @return True if the line starts a record, false if it continues the pending one
+        bool StartsRecord(std::string_view line) const;
+
+        /// @brief Updates the brace depth with the characters of a line, in JSON mode
+        /// @param line Line
+        void TrackBraces(std::string_view line);
+
+        /// @brief Appends a line to the pending record, starting one if there is none
+        /// @param line Line
+        /// @param offset Offset of the line in the file
+        void Append(std::string_view line, std::int64_t offset);
+
+        /// @brief Takes the pending record and resets the state
+        /// @return The pending record
+        std::string Take();
+
+        /// @brief Multiline record settings
+        MultilineConfig m_config;
+
+        /// @brief Lines of the pending record
+        std::string m_record;
+
+        /// @brief Whether there is a pending record
+        bool m_pending = false;
+
+        /// @brief Offset of the first line of the pending record
+        std::int64_t m_offset = 0;
+
+        /// @brief Time the last line was added
+        std::chrono::steady_clock::time_point m_lastLine;
+
+        /// @brief Number of braces open, in JSON mode
+        std::size_t m_depth = 0;
+
+        /// @brief Whether the last line ended within a JSON string
+        bool m_inString = false;
+
+        /// @brief Whether the last character was an escape within a JSON string
+        bool m_escaped = false;
+    };
+
+} // namespace logcollector
@@ -0,0 +1,236 @@
+#include "bookmark_store.hpp"
+
+#include <logger.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+using namespace logcollector;
+
+namespace
+{
+    constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+    constexpr std::uint64_t FNV_PRIME = 1099511628211ULL;
+} // namespace
+
+BookmarkStore::BookmarkStore(std::string filePath, std::chrono::milliseconds flushInterval)
+    : m_filePath(std::move(filePath))
+    , m_flushInterval(flushInterval)
+    , m_lastFlush(std::chrono::steady_clock::now())
+{
+    Load();
+}
+
+std::optional<Bookmark> BookmarkStore::Get(const std::string& filename)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_inUse.insert(filename);
+    const auto it = m_bookmarks.find(filename);
+
+    if (it == m_bookmarks.end())
+    {
+        return std::nullopt;
+    }
+
+    return it->second;
+}
+
+std::optional<Bookmark> BookmarkStore::Find(const FileId& id) const
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto it = m_filenames.find(id);
+
+    if (it == m_filenames.end())
+    {
+        return std::nullopt;
+    }
+
+    return m_bookmarks.at(it->second);
+}
+
+void BookmarkStore::Set(const std::string& filename, const Bookmark& bookmark)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_inUse.insert(filename);
+    auto& current = m_bookmarks[filename];
+
+    if (current != bookmark)
+    {
+        if (const auto it = m_filenames.find(current.id); it != m_filenames.end() && it->second == filename)
+        {
+            m_filenames.erase(it);
+        }
+
+        current = bookmark;
+        m_filenames[bookmark.id] = filename;
+        m_dirty = true;
+    }
+}
+
+std::optional<std::string> BookmarkStore::GetCursor(const std::string& source) const
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto it = m_cursors.find(source);
+
+    if (it == m_cursors.end())
+    {
+        return std::nullopt;
+    }
+
+    return it->second;
+}
+
+void BookmarkStore::SetCursor(const std::string& source, const std::string& cursor)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto& current = m_cursors[source];
+
+    if (current != cursor)
+    {
+        current = cursor;
+        m_dirty = true;
+    }
+}
+
+void BookmarkStore::FlushIfDue()
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_dirty && std::chrono::steady_clock::now() - m_lastFlush >= m_flushInterval)
+    {
+        Write();
+    }
+}
+
+void BookmarkStore::Flush()
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_dirty)
+    {
+        Write();
+    }
+}
+
+void BookmarkStore::Load()
+{
+    std::ifstream file(m_filePath);
+
+    if (!file.is_open())
+    {
+        return;
+    }
+
+    try
+    {
+        const auto json = nlohmann::json::parse(file);
+
+        for (const auto& [filename, value] : json.at("files").items())
+        {
+            Bookmark bookmark;
+            bookmark.id.device = value.at("device").get<std::uint64_t>();
+            bookmark.id.inode = value.at("inode").get<std::uint64_t>();
+            bookmark.offset = value.at("offset").get<std::int64_t>();
+            bookmark.fingerprint = value.at("fingerprint").get<std::uint64_t>();
+            bookmark.fingerprintSize = value.at("fingerprint_size").get<std::int64_t>();
+            m_bookmarks[filename] = bookmark;
+            m_filenames[bookmark.id] = filename;
+        }
+
+        // Stores written before journal cursors were kept have no cursors
+        if (json.contains("journald"))
+        {
+            m_cursors = json.at("journald").get<std::map<std::string, std::string>>();
+        }
+    }
+    catch (const std::exception& e)
+    {
+        LogWarn("Cannot load logcollector bookmarks from '{}': {}", m_filePath, e.what());
+        m_bookmarks.clear();
+        m_filenames.clear();
+        m_cursors.clear();
+    }
+}
+
+void BookmarkStore::Write()
+{
+    Prune();
+
+    auto files = nlohmann::json::object();
+
+    for (const auto& [filename, bookmark] : m_bookmarks)
+    {
+        files[filename] = {{"device", bookmark.id.device},
+                           {"inode", bookmark.id.inode},
+                           {"offset", bookmark.offset},
+                           {"fingerprint", bookmark.fingerprint},
+                           {"fingerprint_size", bookmark.fingerprintSize}};
+    }
+
+    // Write to a temporary file and rename it, so that a crash never leaves a truncated file behind
+    const auto tmpPath = m_filePath + ".tmp";
+
+    {
+        std::ofstream file(tmpPath, std::ios::trunc);
+        file << nlohmann::json {{"files", files}, {"journald", m_cursors}}.dump();
+
+        if (!file.good())
+        {
+            LogWarn("Cannot write logcollector bookmarks to '{}'", tmpPath);
+            return;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, m_filePath, ec);
+
+    if (ec)
+    {
+        LogWarn("Cannot write logcollector bookmarks to '{}': {}", m_filePath, ec.message());
+        return;
+    }
+
+    m_dirty = false;
+    m_lastFlush = std::chrono::steady_clock::now();
+}
+
+void BookmarkStore::Prune()
+{
+    std::erase_if(m_bookmarks,
+                  [this](const auto& entry)
+                  {
+                      // Keep the bookmark if the file cannot be checked, as it may come back
+                      std::error_code ec;
+                      const auto gone = !std::filesystem::exists(entry.first, ec) && !ec;
+                      return gone || !m_inUse.contains(entry.first);
+                  });
+
+    std::erase_if(m_inUse, [this](const auto& filename) { return !m_bookmarks.contains(filename); });
+
+    m_filenames.clear();
+
+    for (const auto& [filename, bookmark] : m_bookmarks)
+    {
+        m_filenames[bookmark.id] = filename;
+    }
+}
+
+std::uint64_t logcollector::Fingerprint(std::string_view data)
+{
+    std::uint64_t hash = FNV_OFFSET_BASIS;
+
+    for (const auto c : data)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
@@ -3,37 +3,71 @@
 #include <config.h>
 #include <logger.hpp>
 
+#include <boost/asio/this_coro.hpp>
+
 #include <algorithm>
 #include <filesystem>
+#include <set>
 #include <string>
+#include <system_error>
+#include <utility>
 
 using namespace logcollector;
 
+namespace
+{
+    /// @brief Number of leading bytes that identify the content of a file
+    constexpr std::int64_t FINGERPRINT_SIZE = 256;
+
+    /// @brief Number of times to open a file that keeps being rotated while it is opened
+    constexpr int MAX_OPEN_ATTEMPTS = 3;
+} // namespace
+
 FileReader::FileReader(
-    std::function<void(const std::string& location, const std::string& log, const std::string& collectorType)>
+    std::function<bool(const std::string& location, const std::string& log, const std::string& collectorType)>
         pushMessageFunc,
     std::function<Awaitable(std::chrono::milliseconds)> waitFunc,
     std::function<void(boost::asio::awaitable<void>)> enqueueTaskFunc,
     std::string pattern,
     std::time_t fileWait,
-    std::time_t reloadInterval)
+    std::time_t reloadInterval,
+    std::shared_ptr<BookmarkStore> bookmarks,
+    std::optional<MultilineConfig> multiline)
     : IReader(std::move(pushMessageFunc), std::move(waitFunc))
     , m_enqueueTask(std::move(enqueueTaskFunc))
     , m_filePattern(std::move(pattern))
     , m_localfiles()
     , m_fileWait(fileWait)
     , m_reloadInterval(reloadInterval)
+    , m_bookmarks(std::move(bookmarks))
+    , m_multiline(std::move(multiline))
 {
 }
 
 Awaitable FileReader::Run()
 {
+    const auto directory = std::filesystem::path(m_filePattern).parent_path().string();
+
+    // Only a fixed directory can be watched for new files
+    if (!directory.empty() && directory.find_first_of("*?[") == std::string::npos)
+    {
+        const auto executor = co_await boost::asio::this_coro::executor;
+        auto watcher = CreateFileWatcher(executor);
+
+        // The files are polled once the watcher stops working, unless the reader was stopped
+        if (watcher && watcher->AddDirectory(directory))
+        {
+            co_await WatchLocalfiles(std::move(watcher), directory);
+        }
+    }
+
     while (m_keepRunning.load())
     {
         Reload(
             [&](Localfile& lf)
             {
-                lf.SeekEnd();
+                SetStartPosition(lf, false);
+                m_polledFiles.insert(lf.Filename());
                 m_enqueueTask(ReadLocalfile(&lf));
             });
 
@@ -43,39 +77,300 @@ Awaitable FileReader::Run()
 
 void FileReader::Stop()
 {
-    m_keepRunning.store(false);
+    {
+        const std::lock_guard<std::mutex> lock(m_watcherMutex);
+        m_keepRunning.store(false);
+
+        if (m_watcher)
+        {
+            m_watcher->Cancel();
+        }
+    }
+
+    if (m_bookmarks)
+    {
+        m_bookmarks->Flush();
+    }
 }
 
 Awaitable FileReader::ReadLocalfile(Localfile* lf)
 {
     while (m_keepRunning.load())
     {
-        auto log = lf->NextLog();
+        // A blocked file is retried after the wait, and its rotation is followed once the old file is done
+        if (ReadAvailableLogs(*lf))
+        {
+            try
+            {
+                // Logs written to the old file right before the rotation are still readable through the open stream
+                if (lf->Rotated() && ReadAvailableLogs(*lf) && FlushRecord(*lf, true))
+                {
+                    LogInfo("File '{}' rotated, reloading", lf->Filename());
+                    lf->Reopen();
+                }
+            }
+            catch (OpenError&)
+            {
+                LogInfo("File inaccesible: {}", lf->Filename());
+
+                if (!FlushRecord(*lf, true))
+                {
+                    LogWarn("The last logs of '{}' could not be queued", lf->Filename());
+                }
+
+                SaveBookmark(*lf);
+                break;
+            }
+
+            FlushRecord(*lf, false);
+        }
+
+        SaveBookmark(*lf);
+        co_await m_wait(std::chrono::milliseconds(m_fileWait));
+    }
+
+    if (m_bookmarks)
+    {
+        m_bookmarks->Flush();
+    }
+
+    RemoveLocalfile(lf->Filename());
+}
+
+Awaitable FileReader::WatchLocalfiles(std::shared_ptr<IFileWatcher> watcher, std::string directory)
+{
+    {
+        const std::lock_guard<std::mutex> lock(m_watcherMutex);
+        m_watcher = watcher;
+    }
+
+    LogDebug("Watching files matching '{}' for changes", m_filePattern);
+    Reload([&](Localfile& lf) { AddWatchedLocalfile(*watcher, lf, false); });
+
+    while (m_keepRunning.load())
+    {
+        std::set<std::string> paths;
+
+        try
+        {
+            paths = co_await watcher->Wait();
+        }
+        catch (const std::system_error& e)
+        {
+            LogWarn("{}. Polling files matching '{}' instead", e.what(), m_filePattern);
+
+            for (auto& lf : m_localfiles)
+            {
+                if (m_polledFiles.insert(lf.Filename()).second)
+                {
+                    m_enqueueTask(ReadLocalfile(&lf));
+                }
+            }
+
+            break;
+        }
+
+        for (const auto& path : paths)
+        {
+            if (path == directory)
+            {
+                Reload([&](Localfile& lf) { AddWatchedLocalfile(*watcher, lf, true); });
+                continue;
+            }
+
+            const auto it = std::find_if(m_localfiles.begin(),
+                                         m_localfiles.end(),
+                                         [&path](const Localfile& lf) { return lf.Filename() == path; });
 
-        while (!log.empty())
+            if (it != m_localfiles.end())
+            {
+                ReadWatchedLocalfile(*watcher, *it);
+            }
+        }
+
+        if (!m_resumeScheduled && std::any_of(m_localfiles.begin(),
+                                              m_localfiles.end(),
+                                              [](const Localfile& lf)
+                                              { return lf.HasPendingRecord() || lf.HasUnsentRecord(); }))
         {
-            m_pushMessage(lf->Filename(), log, m_collectorType);
-            log = lf->NextLog();
+            m_resumeScheduled = true;
+            m_enqueueTask(ResumeLocalfiles(watcher));
         }
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(m_watcherMutex);
+        m_watcher.reset();
+    }
+
+    if (m_bookmarks)
+    {
+        m_bookmarks->Flush();
+    }
+}
+
+void FileReader::AddWatchedLocalfile(IFileWatcher& watcher, Localfile& lf, bool created)
+{
+    SetStartPosition(lf, created);
+
+    if (!watcher.AddFile(lf.Filename()))
+    {
+        LogWarn("Cannot watch file '{}' for changes, polling it", lf.Filename());
+        m_polledFiles.insert(lf.Filename());
+        m_enqueueTask(ReadLocalfile(&lf));
+        return;
+    }
+
+    ReadWatchedLocalfile(watcher, lf);
+}
 
+void FileReader::ReadWatchedLocalfile(IFileWatcher& watcher, Localfile& lf)
+{
+    // A blocked file is retried by ResumeLocalfiles, and its rotation is followed once the old file is done
+    if (ReadAvailableLogs(lf))
+    {
         try
         {
-            if (lf->Rotated())
+            // Logs written to the old file right before the rotation are still readable through the open stream
+            if (lf.Rotated() && ReadAvailableLogs(lf) && FlushRecord(lf, true))
             {
-                LogInfo("File '{}' rotated, reloading", lf->Filename());
-                lf->Reopen();
+                LogInfo("File '{}' rotated, reloading", lf.Filename());
+                watcher.RemoveFile(lf.Filename());
+                lf.Reopen();
+                watcher.AddFile(lf.Filename());
+                ReadAvailableLogs(lf);
             }
         }
         catch (OpenError&)
         {
-            LogInfo("File inaccesible: {}", lf->Filename());
-            co_return;
+            // The file is found again when it is created back in the directory
+            LogInfo("File inaccesible: {}", lf.Filename());
+
+            if (!FlushRecord(lf, true))
+            {
+                LogWarn("The last logs of '{}' could not be queued", lf.Filename());
+            }
+
+            SaveBookmark(lf);
+            watcher.RemoveFile(lf.Filename());
+            RemoveLocalfile(lf.Filename());
+            return;
         }
 
-        co_await m_wait(std::chrono::milliseconds(m_fileWait));
+        FlushRecord(lf, false);
     }
 
-    RemoveLocalfile(lf->Filename());
+    SaveBookmark(lf);
+}
+
+void FileReader::SetStartPosition(Localfile& lf, bool created)
+{
+    if (m_bookmarks)
+    {
+        if (const auto bookmark = m_bookmarks->Get(lf.Filename()))
+        {
+            if (lf.Restore(*bookmark))
+            {
+                LogDebug("Resuming file '{}' at offset {}", lf.Filename(), bookmark->offset);
+            }
+            else
+            {
+                LogInfo("File '{}' changed since it was last read, reading from the beginning", lf.Filename());
+            }
+
+            return;
+        }
+
+        // A rotated file may show up under a new name
+        if (const auto bookmark = m_bookmarks->Find(lf.Id()); bookmark && lf.Restore(*bookmark))
+        {
+            LogDebug("Resuming file '{}' at offset {}, as it was renamed", lf.Filename(), bookmark->offset);
+            return;
+        }
+    }
+
+    if (!created)
+    {
+        lf.SeekEnd();
+    }
+}
+
+bool FileReader::ReadAvailableLogs(Localfile& lf)
+{
+    while (auto record = lf.NextRecord())
+    {
+        if (!m_pushMessage(lf.Filename(), *record, m_collectorType))
+        {
+            lf.Retry(std::move(*record));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool FileReader::FlushRecord(Localfile& lf, bool force)
+{
+    if (lf.HasUnsentRecord())
+    {
+        return false;
+    }
+
+    if (auto record = lf.FlushRecord(force); record && !m_pushMessage(lf.Filename(), *record, m_collectorType))
+    {
+        lf.Retry(std::move(*record));
+        return false;
+    }
+
+    return true;
+}
+
+Awaitable FileReader::ResumeLocalfiles(std::shared_ptr<IFileWatcher> watcher)
+{
+    auto interval = std::chrono::milliseconds(m_fileWait);
+
+    if (m_multiline)
+    {
+        interval = std::min(interval, m_multiline->timeout);
+    }
+
+    bool pending = true;
+
+    while (pending && m_keepRunning.load())
+    {
+        co_await m_wait(interval);
+
+        for (auto it = m_localfiles.begin(); it != m_localfiles.end();)
+        {
+            // The file may be removed while it is read
+            auto& lf = *it++;
+
+            // Polled files are retried by their own task
+            if (!m_polledFiles.contains(lf.Filename()))
+            {
+                ReadWatchedLocalfile(*watcher, lf);
+            }
+        }
+
+        pending = std::any_of(m_localfiles.begin(),
+                              m_localfiles.end(),
+                              [this](const Localfile& lf)
+                              {
+                                  return !m_polledFiles.contains(lf.Filename()) &&
+                                         (lf.HasPendingRecord() || lf.HasUnsentRecord());
+                              });
+    }
+
+    m_resumeScheduled = false;
+}
+
+void FileReader::SaveBookmark(Localfile& lf)
+{
+    if (m_bookmarks)
+    {
+        m_bookmarks->Set(lf.Filename(), lf.GetBookmark());
+        m_bookmarks->FlushIfDue();
+    }
 }
 
 void FileReader::AddLocalfiles(const std::list<std::string>& paths, const std::function<void(Localfile&)>& callback)
@@ -85,6 +380,12 @@ void FileReader::AddLocalfiles(const std::list<std::string>& paths, const std::f
         if (none_of(m_localfiles.begin(), m_localfiles.end(), [&path](Localfile& lf) { return lf.Filename() == path; }))
         {
             m_localfiles.emplace_back(path);
+
+            if (m_multiline)
+            {
+                m_localfiles.back().SetMultiline(*m_multiline);
+            }
+
             LogInfo("Reading log file: {}", m_localfiles.back().Filename());
             callback(m_localfiles.back());
         }
@@ -94,53 +395,184 @@ void FileReader::AddLocalfiles(const std::list<std::string>& paths, const std::f
 void FileReader::RemoveLocalfile(const std::string& filename)
 {
     m_localfiles.remove_if([&filename](Localfile& lf) { return lf.Filename() == filename; });
+    m_polledFiles.erase(filename);
 }
 
 Localfile::Localfile(std::string filename)
     : m_filename(std::move(filename))
-    , m_stream(make_shared<std::ifstream>(m_filename))
-    , m_pos()
+    , m_reader(config::logcollector::BUFFER_SIZE)
 {
-    if (m_stream->fail())
-    {
-        throw OpenError(m_filename);
-    }
+    Open();
 }
 
 Localfile::Localfile(std::shared_ptr<std::istream> stream)
     : m_filename()
     , m_stream(std::move(stream))
+    , m_reader(config::logcollector::BUFFER_SIZE)
 {
 }
 
-std::string Localfile::NextLog()
+std::string_view Localfile::NextLog()
 {
-    auto buffer = std::vector<char>(config::logcollector::BUFFER_SIZE);
+    while (auto line = m_reader.NextLine(*m_stream))
+    {
+        // The file is read in binary mode, so CRLF line endings are stripped here
+        if (!line->empty() && line->back() == '\r')
+        {
+            line->remove_suffix(1);
+        }
 
-    if (m_stream->getline(buffer.data(), config::logcollector::BUFFER_SIZE).good())
+        if (!line->empty())
+        {
+            return *line;
+        }
+    }
+
+    return {};
+}
+
+void Localfile::SetMultiline(const MultilineConfig& config)
+{
+    m_assembler.emplace(config);
+}
+
+std::optional<std::string> Localfile::NextRecord()
+{
+    if (m_unsent)
     {
-        m_pos = m_stream->tellg();
-        return {buffer.data(), static_cast<size_t>(m_stream->gcount()) - 1};
+        m_recordOffset = m_unsentOffset;
+        return std::exchange(m_unsent, std::nullopt);
     }
-    else
+
+    while (true)
     {
-        m_stream->seekg(m_pos);
-        m_stream->clear();
-        return {};
+        const auto offset = static_cast<std::int64_t>(m_reader.Position());
+        const auto log = NextLog();
+
+        if (log.empty())
+        {
+            return std::nullopt;
+        }
+
+        if (!m_assembler)
+        {
+            m_recordOffset = offset;
+            return std::string(log);
+        }
+
+        // A completed record is the pending one, or the one the line starts if there was none
+        const auto recordOffset = m_assembler->PendingOffset().value_or(offset);
+
+        if (auto record = m_assembler->Add(log, offset))
+        {
+            m_recordOffset = recordOffset;
+            return record;
+        }
+    }
+}
+
+std::optional<std::string> Localfile::FlushRecord(bool force)
+{
+    if (!m_assembler)
+    {
+        return std::nullopt;
+    }
+
+    const auto recordOffset = m_assembler->PendingOffset();
+    auto record = force ? m_assembler->Flush() : m_assembler->FlushIfExpired(std::chrono::steady_clock::now());
+
+    if (record)
+    {
+        m_recordOffset = *recordOffset;
     }
+
+    return record;
+}
+
+void Localfile::Retry(std::string record)
+{
+    m_unsent = std::move(record);
+    m_unsentOffset = m_recordOffset;
+}
+
+bool Localfile::HasPendingRecord() const
+{
+    return m_assembler && m_assembler->PendingOffset().has_value();
+}
+
+bool Localfile::HasUnsentRecord() const
+{
+    return m_unsent.has_value();
 }
 
 void Localfile::SeekEnd()
 {
     m_stream->seekg(0, std::ios::end);
+    m_reader.Reset(m_stream->tellg());
+}
+
+Bookmark Localfile::GetBookmark()
+{
+    // The head of a file only changes while it is shorter than the fingerprint
+    if (m_fingerprintSize < FINGERPRINT_SIZE)
+    {
+        const auto head = ReadHead(FINGERPRINT_SIZE);
+        m_fingerprint = Fingerprint(head);
+        m_fingerprintSize = static_cast<std::int64_t>(head.size());
+    }
+
+    // Records not pushed yet, or waiting for more lines, are read again from their first line after a restart
+    auto offset = m_assembler ? m_assembler->PendingOffset() : std::nullopt;
+
+    if (m_unsent)
+    {
+        offset = m_unsentOffset;
+    }
+
+    return {m_id, offset.value_or(m_reader.Position()), m_fingerprint, m_fingerprintSize};
+}
+
+bool Localfile::Restore(const Bookmark& bookmark)
+{
+    if (bookmark.id != m_id || bookmark.fingerprintSize < 0 || bookmark.fingerprintSize > FINGERPRINT_SIZE)
+    {
+        return false;
+    }
+
+    const auto head = ReadHead(bookmark.fingerprintSize);
+
+    if (static_cast<std::int64_t>(head.size()) != bookmark.fingerprintSize ||
+        Fingerprint(head) != bookmark.fingerprint)
+    {
+        return false;
+    }
+
+    m_stream->seekg(0, std::ios::end);
+    const auto size = static_cast<std::int64_t>(m_stream->tellg());
+
+    if (size < bookmark.offset)
+    {
+        m_stream->clear();
+        m_stream->seekg(m_reader.Offset());
+        return false;
+    }
+
+    m_stream->seekg(bookmark.offset);
+    m_reader.Reset(bookmark.offset);
+    return true;
 }
 
 bool Localfile::Rotated()
 {
     try
     {
+        if (GetFileId(m_filename) != m_id)
+        {
+            return true;
+        }
+
         auto fileSize = std::filesystem::file_size(m_filename);
-        auto streamSize = static_cast<uintmax_t>(m_stream->tellg());
+        auto streamSize = static_cast<uintmax_t>(m_reader.Offset());
         return fileSize < streamSize;
     }
     catch (std::filesystem::filesystem_error&)
@@ -151,12 +583,46 @@ bool Localfile::Rotated()
 
 void Localfile::Reopen()
 {
-    m_stream = std::make_shared<std::ifstream>(m_filename);
+    Open();
+    m_reader.Reset(0);
+    m_fingerprintSize = 0;
+}
 
-    if (m_stream->fail())
+void Localfile::Open()
+{
+    for (auto attempt = 0; attempt < MAX_OPEN_ATTEMPTS; ++attempt)
     {
-        throw OpenError(m_filename);
+        const auto id = GetFileId(m_filename);
+        auto stream = std::make_shared<std::ifstream>(m_filename, std::ios::binary);
+
+        if (stream->fail())
+        {
+            throw OpenError(m_filename);
+        }
+
+        if (GetFileId(m_filename) == id)
+        {
+            m_stream = std::move(stream);
+            m_id = id;
+            return;
+        }
     }
+
+    throw OpenError(m_filename);
+}
+
+std::string Localfile::ReadHead(std::streamsize length)
+{
+    std::string head(static_cast<std::size_t>(length), '\0');
+
+    m_stream->clear();
+    m_stream->seekg(0);
+    m_stream->read(head.data(), length);
+    head.resize(static_cast<std::size_t>(m_stream->gcount()));
+
+    m_stream->clear();
+    m_stream->seekg(m_reader.Offset());
+    return head;
 }
 
 OpenError::OpenError(const std::string& filename)
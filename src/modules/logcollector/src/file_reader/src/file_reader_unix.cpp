@@ -5,6 +5,7 @@
 #include <logger.hpp>
 
 #include <span>
+#include <sys/stat.h>
 
 using namespace logcollector;
 
@@ -40,3 +41,15 @@ void FileReader::Reload(const std::function<void(Localfile&)>& callback)
     AddLocalfiles(localfiles, callback);
     globfree(&globResult);
 }
+
+FileId logcollector::GetFileId(const std::string& filename)
+{
+    struct stat st {};
+
+    if (stat(filename.c_str(), &st) != 0)
+    {
+        throw OpenError(filename);
+    }
+
+    return {static_cast<std::uint64_t>(st.st_dev), static_cast<std::uint64_t>(st.st_ino)};
+}
@@ -39,3 +39,34 @@ void FileReader::Reload(const std::function<void(Localfile&)>& callback)
     AddLocalfiles(files, callback);
     FindClose(hFind);
 }
+
+FileId logcollector::GetFileId(const std::string& filename)
+{
+    HANDLE hFile = CreateFile(filename.c_str(),
+                              0,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        throw OpenError(filename);
+    }
+
+    BY_HANDLE_FILE_INFORMATION info;
+    const auto ok = GetFileInformationByHandle(hFile, &info);
+    CloseHandle(hFile);
+
+    if (!ok)
+    {
+        throw OpenError(filename);
+    }
+
+    ULARGE_INTEGER index;
+    index.HighPart = info.nFileIndexHigh;
+    index.LowPart = info.nFileIndexLow;
+
+    return {info.dwVolumeSerialNumber, index.QuadPart};
+}
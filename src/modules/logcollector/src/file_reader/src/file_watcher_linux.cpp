@@ -0,0 +1,182 @@
+#include "inotify_watcher.hpp"
+
+#include <logger.hpp>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <system_error>
+
+using namespace logcollector;
+
+namespace
+{
+    constexpr std::uint32_t FILE_EVENTS = IN_MODIFY | IN_MOVE_SELF | IN_DELETE_SELF | IN_ATTRIB;
+    constexpr std::uint32_t DIRECTORY_EVENTS = IN_CREATE | IN_MOVED_TO | IN_ONLYDIR;
+} // namespace
+
+InotifyWatcher::InotifyWatcher(const boost::asio::any_io_executor& executor)
+    : m_descriptor(executor)
+{
+    const auto fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "inotify_init1");
+    }
+
+    m_descriptor.assign(fd);
+}
+
+bool InotifyWatcher::AddFile(const std::string& filename)
+{
+    return AddWatch(filename, FILE_EVENTS);
+}
+
+void InotifyWatcher::RemoveFile(const std::string& filename)
+{
+    const auto it = m_watches.find(filename);
+
+    if (it == m_watches.end())
+    {
+        return;
+    }
+
+    // Fails harmlessly if the kernel already dropped the watch because the file was deleted
+    inotify_rm_watch(m_descriptor.native_handle(), it->second);
+    m_paths.erase(it->second);
+    m_watches.erase(it);
+}
+
+bool InotifyWatcher::AddDirectory(const std::string& path)
+{
+    return AddWatch(path, DIRECTORY_EVENTS);
+}
+
+boost::asio::awaitable<std::set<std::string>> InotifyWatcher::Wait()
+{
+    if (m_canceled.load())
+    {
+        co_return std::set<std::string> {};
+    }
+
+    boost::system::error_code ec;
+    co_await m_descriptor.async_wait(boost::asio::posix::stream_descriptor::wait_read,
+                                     boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+    if (ec == boost::asio::error::operation_aborted)
+    {
+        co_return std::set<std::string> {};
+    }
+
+    if (ec)
+    {
+        throw std::system_error(ec.value(), std::system_category(), "Cannot wait for file notifications");
+    }
+
+    co_return ReadEvents();
+}
+
+void InotifyWatcher::Cancel()
+{
+    m_canceled.store(true);
+
+    // The descriptor is not thread-safe, so the cancellation runs on its executor
+    boost::asio::post(m_descriptor.get_executor(),
+                      [weakSelf = weak_from_this()]()
+                      {
+                          if (const auto self = weakSelf.lock())
+                          {
+                              self->m_descriptor.cancel();
+                          }
+                      });
+}
+
+bool InotifyWatcher::AddWatch(const std::string& path, std::uint32_t mask)
+{
+    const auto wd = inotify_add_watch(m_descriptor.native_handle(), path.c_str(), mask);
+
+    if (wd < 0)
+    {
+        LogDebug("Cannot watch '{}': {}", path, std::generic_category().message(errno));
+        return false;
+    }
+
+    m_paths[wd] = path;
+    m_watches[path] = wd;
+    return true;
+}
+
+std::set<std::string> InotifyWatcher::ReadEvents()
+{
+    std::set<std::string> paths;
+
+    while (true)
+    {
+        const auto length = read(m_descriptor.native_handle(), m_buffer.data(), m_buffer.size());
+
+        if (length <= 0)
+        {
+            break;
+        }
+
+        for (auto offset = static_cast<std::size_t>(0); offset < static_cast<std::size_t>(length);)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            const auto* event = reinterpret_cast<const inotify_event*>(m_buffer.data() + offset);
+            offset += sizeof(inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                // Some events were lost, anything may have changed
+                for (const auto& [wd, path] : m_paths)
+                {
+                    paths.insert(path);
+                }
+
+                continue;
+            }
+
+            const auto it = m_paths.find(event->wd);
+
+            if (it == m_paths.end())
+            {
+                continue;
+            }
+
+            paths.insert(it->second);
+
+            if (event->mask & IN_IGNORED)
+            {
+                // The path may be watched again by now, on another inode
+                const auto watch = m_watches.find(it->second);
+
+                if (watch != m_watches.end() && watch->second == event->wd)
+                {
+                    m_watches.erase(watch);
+                }
+
+                m_paths.erase(it);
+            }
+        }
+    }
+
+    return paths;
+}
+
+std::shared_ptr<IFileWatcher> logcollector::CreateFileWatcher(const boost::asio::any_io_executor& executor)
+{
+    try
+    {
+        return std::make_shared<InotifyWatcher>(executor);
+    }
+    catch (const std::system_error& e)
+    {
+        LogWarn("Cannot watch files for changes, falling back to polling: {}", e.what());
+        return nullptr;
+    }
+}
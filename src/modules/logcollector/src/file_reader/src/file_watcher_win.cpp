@@ -0,0 +1,9 @@
+#include "file_watcher.hpp"
+
+using namespace logcollector;
+
+std::shared_ptr<IFileWatcher> logcollector::CreateFileWatcher(const boost::asio::any_io_executor&)
+{
+    // File changes are polled on this platform
+    return nullptr;
+}
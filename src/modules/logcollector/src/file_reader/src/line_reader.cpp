@@ -0,0 +1,72 @@
+#include "line_reader.hpp"
+
+#include <cstring>
+
+using namespace logcollector;
+
+LineReader::LineReader(std::size_t blockSize)
+    : m_buffer(blockSize)
+{
+}
+
+std::optional<std::string_view> LineReader::NextLine(std::istream& stream)
+{
+    while (true)
+    {
+        // memchr is vectorized by the C library, it is much faster than a byte loop
+        const auto* data = m_buffer.data();
+        const auto* newline = static_cast<const char*>(std::memchr(data + m_begin, '\n', m_end - m_begin));
+
+        if (newline != nullptr)
+        {
+            const auto length = static_cast<std::size_t>(newline - data) - m_begin;
+            const std::string_view line {data + m_begin, length};
+            m_begin += length + 1;
+            return line;
+        }
+
+        if (m_begin == 0 && m_end == m_buffer.size())
+        {
+            // The line does not fit in the buffer, hand it out in pieces
+            m_begin = m_end;
+            return std::string_view {data, m_end};
+        }
+
+        if (!Fill(stream))
+        {
+            return std::nullopt;
+        }
+    }
+}
+
+void LineReader::Reset(std::streamoff offset)
+{
+    m_begin = 0;
+    m_end = 0;
+    m_offset = offset;
+}
+
+bool LineReader::Fill(std::istream& stream)
+{
+    // Move the partial line to the front so that the rest of the buffer can be filled
+    if (m_begin > 0)
+    {
+        std::memmove(m_buffer.data(), m_buffer.data() + m_begin, m_end - m_begin);
+        m_end -= m_begin;
+        m_begin = 0;
+    }
+
+    stream.read(m_buffer.data() + m_end, static_cast<std::streamsize>(m_buffer.size() - m_end));
+    const auto count = stream.gcount();
+
+    if (count < static_cast<std::streamsize>(m_buffer.size() - m_end))
+    {
+        // End of the data available for now. The stream will be read again when the file grows
+        stream.clear();
+        stream.seekg(m_offset + count);
+    }
+
+    m_end += static_cast<std::size_t>(count);
+    m_offset += count;
+    return count > 0;
+}
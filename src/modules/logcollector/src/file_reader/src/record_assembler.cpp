@@ -0,0 +1,140 @@
+#include "record_assembler.hpp"
+
+#include <utility>
+
+using namespace logcollector;
+
+RecordAssembler::RecordAssembler(MultilineConfig config)
+    : m_config(std::move(config))
+{
+}
+
+std::optional<std::string> RecordAssembler::Add(std::string_view line, std::int64_t offset)
+{
+    if (m_config.mode == MultilineMode::Json)
+    {
+        Append(line, offset);
+        TrackBraces(line);
+
+        // Lines outside a document are records on their own
+        if (m_depth == 0 || m_record.size() >= m_config.maxSize)
+        {
+            return Take();
+        }
+
+        return std::nullopt;
+    }
+
+    std::optional<std::string> completed;
+
+    if (m_pending && (StartsRecord(line) || m_record.size() + line.size() >= m_config.maxSize))
+    {
+        completed = Take();
+    }
+
+    Append(line, offset);
+    return completed;
+}
+
+std::optional<std::string> RecordAssembler::FlushIfExpired(std::chrono::steady_clock::time_point now)
+{
+    if (!m_pending || now - m_lastLine < m_config.timeout)
+    {
+        return std::nullopt;
+    }
+
+    return Take();
+}
+
+std::optional<std::string> RecordAssembler::Flush()
+{
+    if (!m_pending)
+    {
+        return std::nullopt;
+    }
+
+    return Take();
+}
+
+std::optional<std::int64_t> RecordAssembler::PendingOffset() const
+{
+    if (!m_pending)
+    {
+        return std::nullopt;
+    }
+
+    return m_offset;
+}
+
+bool RecordAssembler::StartsRecord(std::string_view line) const
+{
+    if (m_config.mode == MultilineMode::Indent)
+    {
+        return line.empty() || (line.front() != ' ' && line.front() != '\t');
+    }
+
+    return std::regex_search(line.begin(), line.end(), *m_config.startPattern);
+}
+
+void RecordAssembler::TrackBraces(std::string_view line)
+{
+    for (const auto c : line)
+    {
+        if (m_inString)
+        {
+            if (m_escaped)
+            {
+                m_escaped = false;
+            }
+            else if (c == '\\')
+            {
+                m_escaped = true;
+            }
+            else if (c == '"')
+            {
+                m_inString = false;
+            }
+        }
+        else if (c == '"' && m_depth > 0)
+        {
+            m_inString = true;
+        }
+        else if (c == '{')
+        {
+            ++m_depth;
+        }
+        else if (c == '}' && m_depth > 0)
+        {
+            --m_depth;
+        }
+    }
+}
+
+void RecordAssembler::Append(std::string_view line, std::int64_t offset)
+{
+    if (!m_pending)
+    {
+        m_record.assign(line);
+        m_offset = offset;
+        m_pending = true;
+    }
+    else
+    {
+        m_record += '\n';
+        m_record += line;
+    }
+
+    m_lastLine = std::chrono::steady_clock::now();
+}
+
+std::string RecordAssembler::Take()
+{
+    auto record = std::move(m_record);
+
+    m_record.clear();
+    m_pending = false;
+    m_depth = 0;
+    m_inString = false;
+    m_escaped = false;
+    return record;
+}
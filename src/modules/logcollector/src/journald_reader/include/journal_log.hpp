@@ -43,7 +43,7 @@ struct JournalFilter
     /// @brief Checks if a field value matches any of the filter values
     /// @param fieldValue The value to check against filter values
     /// @return true if matches, false otherwise
-    bool Matches(const std::string& fieldValue) const
+    bool Matches(std::string_view fieldValue) const
     {
         auto values = GetValueViews();
         return std::any_of(values.begin(),
@@ -53,10 +53,42 @@ struct JournalFilter
     }
 };
 
+/// @brief Filter with its values split, ready to be evaluated on journal entries
+struct CompiledFilter
+{
+    std::string field;               ///< Field name to filter on
+    std::vector<std::string> values; ///< Alternative values to match
+    bool exact_match {true};         ///< Whether to perform exact matching or substring matching
+
+    /// @brief Checks if a field value matches any of the filter values
+    /// @param fieldValue The value to check against filter values
+    /// @return true if matches, false otherwise
+    bool Matches(std::string_view fieldValue) const
+    {
+        return std::any_of(values.begin(),
+                           values.end(),
+                           [&fieldValue, this](const auto& val)
+                           {
+                               return exact_match ? fieldValue == val
+                                                  : fieldValue.find(val) != std::string_view::npos;
+                           });
+    }
+};
+
+/// @brief Filter group split by where each filter is evaluated
+///
+/// Exact filters become journal matches, so that the journal index selects the
+/// entries. Substring filters, and exact filters that the journal cannot
+/// evaluate, are checked on each selected entry.
+struct CompiledFilterGroup
+{
+    std::vector<std::string> matches;          ///< Journal matches, in FIELD=value form
+    std::vector<CompiledFilter> journalFilters; ///< Filters evaluated by the journal through the matches
+    std::vector<CompiledFilter> entryFilters;   ///< Filters evaluated on each entry
+};
+
 /// @brief Group of filters combined with AND logic
 using FilterGroup = std::vector<JournalFilter>;
-/// @brief Set of filter groups combined with OR logic
-using FilterSet = std::vector<FilterGroup>;
 
 /// @brief Exception class for journal-related errors
 class JournalLogException : public std::runtime_error
@@ -88,6 +120,10 @@ public:
     /// @brief Opens the systemd journal
     virtual void Open();
 
+    /// @brief Opens the journal files of a directory instead of the system journal
+    /// @param path Directory with the journal files
+    virtual void OpenDirectory(const std::string& path);
+
     /// @brief Moves to next journal entry
     /// @return true if successful, false if no more entries
     virtual bool Next();
@@ -112,20 +148,38 @@ public:
     /// @throw JournalLogException if field not found
     virtual std::string GetData(const std::string& field) const;
 
+    /// @brief Retrieves field data from current journal entry without copying it
+    /// @param field Field name to retrieve
+    /// @return Field value, valid until the journal moves to another entry, or nothing if the field is not present
+    /// @throw JournalLogException if the field cannot be read
+    std::optional<std::string_view> GetDataView(const std::string& field) const;
+
     /// @brief Gets timestamp of current journal entry
     /// @return Timestamp in microseconds since epoch
     virtual uint64_t GetTimestamp() const;
 
     /// @brief Adds a group of filters with AND logic between them
+    ///
+    /// Groups added to the same journal are combined with OR logic.
+    ///
     /// @param group Group of filters to add
     /// @param ignoreIfMissing Whether to ignore missing fields
+    /// @throw JournalLogException if the group is invalid
     virtual void AddFilterGroup(const FilterGroup& group, bool ignoreIfMissing);
 
     /// @brief Gets next message that matches current filters
-    /// @param filters Set of filter groups to apply
     /// @param ignoreIfMissing Whether to ignore missing fields
     /// @return Optional containing filtered message if found
-    virtual std::optional<FilteredMessage> GetNextFilteredMessage(const FilterSet& filters, bool ignoreIfMissing);
+    virtual std::optional<FilteredMessage> GetNextFilteredMessage(bool ignoreIfMissing);
+
+    /// @brief Splits a filter group into journal matches and filters to check on each entry
+    ///
+    /// Only the first exact filter on each field becomes journal matches, since
+    /// the journal combines the matches on the same field with OR logic.
+    ///
+    /// @param group Group of filters to compile
+    /// @return Compiled filter group
+    static CompiledFilterGroup CompileFilterGroup(const FilterGroup& group);
 
     /// @brief Clears all active filters
     void FlushFilters();
@@ -138,6 +192,19 @@ public:
         return !filter.field.empty() && !filter.value.empty();
     }
 
+    /// @brief Gets a file descriptor that becomes readable when the journal changes
+    /// @return File descriptor, owned by the journal
+    /// @throw JournalLogException if the journal cannot be watched
+    virtual int GetFileDescriptor();
+
+    /// @brief Checks if changes must be polled because the file descriptor does not notify all of them
+    /// @return true if the journal must be polled, false if the file descriptor is enough
+    virtual bool NeedsPolling() const;
+
+    /// @brief Processes the changes notified through the file descriptor
+    /// @return true if entries were added or the journal files changed, false otherwise
+    virtual bool ProcessChanges();
+
     virtual std::string GetCursor() const;
     virtual bool SeekCursor(const std::string& cursor);
 
@@ -149,10 +216,10 @@ public:
     virtual bool CursorValid(const std::string& cursor) const;
 
 private:
-    struct sd_journal* m_journal;    ///< Pointer to journal structure
-    uint64_t m_currentTimestamp {0}; ///< Current entry timestamp
-    bool m_hasActiveFilters {false}; ///< Whether filters are currently active
-    FilterSet m_filters;             ///< Currently active filters
+    struct sd_journal* m_journal;               ///< Pointer to journal structure
+    uint64_t m_currentTimestamp {0};            ///< Current entry timestamp
+    bool m_hasActiveFilters {false};            ///< Whether filters are currently active
+    std::vector<CompiledFilterGroup> m_filters; ///< Currently active filters
 
     /// @brief Gets current epoch time in microseconds
     static uint64_t GetEpochTime();
@@ -162,22 +229,20 @@ private:
     /// @param operation Operation description for error message
     void ThrowIfError(int result, const std::string& operation) const;
 
-    /// @brief Applies filter set with OR logic between groups
-    /// @param filters Set of filter groups to apply
+    /// @brief Applies the active filters that the journal does not evaluate, with OR logic between groups
     /// @param ignoreIfMissing Whether to ignore missing fields
     /// @return true if any group matches, false otherwise
-    bool ApplyFilterSet(const FilterSet& filters, bool ignoreIfMissing);
+    bool ApplyFilterSet(bool ignoreIfMissing) const;
 
-    /// @brief Applies filter group with AND logic between filters
-    /// @param group Group of filters to add
+    /// @brief Applies filters with AND logic between them
+    /// @param filters Filters to apply
     /// @param ignoreIfMissing Whether to ignore missing fields
     /// @return true if all filters match, false otherwise
-    bool ApplyFilterGroup(const FilterGroup& group, bool ignoreIfMissing) const;
+    bool ApplyFilterGroup(const std::vector<CompiledFilter>& filters, bool ignoreIfMissing) const;
 
     /// @brief Processes current journal entry
-    /// @param filters Set of filter groups to apply
     /// @param ignoreIfMissing Whether to ignore missing fields
     /// @param message Filtered message structure to fill
     /// @return true if entry matches any filter, false otherwise
-    bool ProcessJournalEntry(const FilterSet& filters, bool ignoreIfMissing, FilteredMessage& message) const;
+    bool ProcessJournalEntry(bool ignoreIfMissing, FilteredMessage& message) const;
 };
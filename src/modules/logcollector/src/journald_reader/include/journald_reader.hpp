@@ -1,11 +1,16 @@
 #pragma once
 
+#include <bookmark_store.hpp>
 #include <journal_log.hpp>
 #include <reader.hpp>
 
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <regex>
 #include <string>
 
@@ -16,6 +21,10 @@ namespace logcollector
     ///
     /// This class implements journal reading functionality with filtering capabilities.
     /// It supports both single and multiple condition filtering with AND/OR logic.
+    /// The reader sleeps until the journal notifies a change, and falls back to
+    /// polling every file wait interval when the journal cannot notify changes.
+    /// The cursor of the last entry read is kept in the bookmark store, so that
+    /// entries logged while the agent was stopped are read after a restart.
     class JournaldReader : public IReader
     {
     public:
@@ -24,14 +33,16 @@ namespace logcollector
         /// @param waitFunc Wait function
         /// @param filters Group of filters to apply (AND logic between them)
         /// @param ignoreIfMissing Whether to ignore missing fields
-        /// @param fileWait Time to wait between reads in milliseconds
+        /// @param fileWait Time to wait between reads in milliseconds, when polling
+        /// @param bookmarks Store to resume from, or nullptr to always start at the end of the journal
         JournaldReader(
-            std::function<void(const std::string& location, const std::string& log, const std::string& collectorType)>
+            std::function<bool(const std::string& location, const std::string& log, const std::string& collectorType)>
                 pushMessageFunc,
             std::function<Awaitable(std::chrono::milliseconds)> waitFunc,
             FilterGroup filters,
             bool ignoreIfMissing,
-            std::time_t fileWait);
+            std::time_t fileWait,
+            std::shared_ptr<BookmarkStore> bookmarks = nullptr);
 
         /// @copydoc IReader::Run
         Awaitable Run() override;
@@ -44,11 +55,35 @@ namespace logcollector
         std::string GetFilterDescription() const;
 
     private:
-        FilterGroup m_filters;                           ///< Active filters
-        bool m_ignoreIfMissing;                          ///< Whether to ignore missing fields
-        std::unique_ptr<JournalLog> m_journal;           ///< Journal interface
-        std::chrono::milliseconds m_waitTime;            ///< Wait time between reads
-        static constexpr size_t MAX_LINE_LENGTH = 16384; ///< Maximum message length
+        /// @brief Moves to the entry after the stored cursor, or to the end of the journal if there is none
+        void SeekStart();
+
+        /// @brief Pushes all the matching entries available, and stores the cursor of the last one pushed
+        ///
+        /// An entry that cannot be pushed is left unread, so that it is read again on the next call.
+        ///
+        /// @return True if all the entries were pushed, false if the reader is blocked at an entry
+        bool ReadAvailableMessages();
+
+        /// @brief Creates a descriptor that waits for journal changes on the executor
+        /// @param executor Executor to wait on
+        /// @return The descriptor, or nullptr if the journal must be polled
+        std::shared_ptr<boost::asio::posix::stream_descriptor>
+        CreateDescriptor(const boost::asio::any_io_executor& executor);
+
+        /// @brief Waits until the journal changes
+        /// @param descriptor Descriptor of the journal
+        /// @return Awaitable result
+        Awaitable WaitForChanges(std::shared_ptr<boost::asio::posix::stream_descriptor> descriptor);
+
+        FilterGroup m_filters;                                               ///< Active filters
+        bool m_ignoreIfMissing;                                              ///< Whether to ignore missing fields
+        std::unique_ptr<JournalLog> m_journal;                               ///< Journal interface
+        std::chrono::milliseconds m_waitTime;                                ///< Wait time between reads, when polling
+        std::shared_ptr<BookmarkStore> m_bookmarks;                          ///< Store of the journal cursor
+        std::shared_ptr<boost::asio::posix::stream_descriptor> m_descriptor; ///< Journal descriptor, if notified
+        std::mutex m_descriptorMutex;                                        ///< Mutex to access the journal descriptor
+        static constexpr size_t MAX_LINE_LENGTH = 16384;                     ///< Maximum message length
     };
 
 } // namespace logcollector
@@ -2,10 +2,24 @@
 
 #include <algorithm>
 #include <cstring>
+#include <limits>
 #include <logger.hpp>
 #include <ranges>
 #include <systemd/sd-journal.h>
 
+namespace
+{
+    /// @brief Checks if a field name can be used in journal matches
+    /// @param field Field name
+    /// @return true if the name has only uppercase letters, digits and underscores, and no double underscore prefix
+    bool IsValidFieldName(std::string_view field)
+    {
+        return !field.empty() && !field.starts_with("__") &&
+               std::ranges::all_of(field,
+                                   [](char c) { return (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_'; });
+    }
+} // namespace
+
 JournalLog::JournalLog()
     : m_journal(nullptr)
 {
@@ -26,6 +40,13 @@ void JournalLog::Open()
     LogInfo("Journal opened successfully");
 }
 
+void JournalLog::OpenDirectory(const std::string& path)
+{
+    const int ret = sd_journal_open_directory(&m_journal, path.c_str(), 0);
+    ThrowIfError(ret, "open journal directory");
+    LogInfo("Journal directory {} opened successfully", path);
+}
+
 bool JournalLog::Next()
 {
     const int ret = sd_journal_next(m_journal);
@@ -71,21 +92,31 @@ bool JournalLog::SeekTimestamp(uint64_t timestamp)
 }
 
 std::string JournalLog::GetData(const std::string& field) const
+{
+    const auto data = GetDataView(field);
+
+    if (!data)
+    {
+        throw JournalLogException("Field not present in current journal entry");
+    }
+
+    return std::string(*data);
+}
+
+std::optional<std::string_view> JournalLog::GetDataView(const std::string& field) const
 {
     const void* data = nullptr;
     size_t length = 0;
     const int ret = sd_journal_get_data(m_journal, field.c_str(), &data, &length);
     if (ret == -ENOENT)
     {
-        throw JournalLogException("Field not present in current journal entry");
+        return std::nullopt;
     }
     ThrowIfError(ret, "get data");
 
-    const char* str = static_cast<const char*>(data);
-    const std::string_view full_str(str, length);
-    const size_t prefix_len = field.length() + 1;
-
-    return std::string(full_str.substr(prefix_len));
+    // The data is in FIELD=value form
+    const std::string_view fullStr(static_cast<const char*>(data), length);
+    return fullStr.substr(field.length() + 1);
 }
 
 uint64_t JournalLog::GetTimestamp() const
@@ -193,6 +224,30 @@ uint64_t JournalLog::GetEpochTime()
             .count());
 }
 
+int JournalLog::GetFileDescriptor()
+{
+    const int fd = sd_journal_get_fd(m_journal);
+    ThrowIfError(fd, "get journal file descriptor");
+    return fd;
+}
+
+bool JournalLog::NeedsPolling() const
+{
+    uint64_t timeout = 0;
+    const int ret = sd_journal_get_timeout(m_journal, &timeout);
+    ThrowIfError(ret, "get journal timeout");
+
+    // Journals on network file systems are not notified through inotify and must be checked periodically
+    return timeout != std::numeric_limits<uint64_t>::max();
+}
+
+bool JournalLog::ProcessChanges()
+{
+    const int ret = sd_journal_process(m_journal);
+    ThrowIfError(ret, "process journal changes");
+    return ret != SD_JOURNAL_NOP;
+}
+
 std::string JournalLog::GetCursor() const
 {
     char* rawCursor = nullptr;
@@ -225,6 +280,40 @@ bool JournalLog::CursorValid(const std::string& cursor) const
     return ret > 0;
 }
 
+CompiledFilterGroup JournalLog::CompileFilterGroup(const FilterGroup& group)
+{
+    CompiledFilterGroup compiled;
+
+    for (const auto& filter : group)
+    {
+        CompiledFilter compiledFilter {filter.field, {}, filter.exact_match};
+
+        for (const auto& value : filter.GetValueViews())
+        {
+            compiledFilter.values.emplace_back(value);
+        }
+
+        const bool fieldMatched = std::ranges::any_of(compiled.journalFilters,
+                                                      [&filter](const auto& journalFilter)
+                                                      { return journalFilter.field == filter.field; });
+
+        if (!filter.exact_match || fieldMatched || !IsValidFieldName(filter.field))
+        {
+            compiled.entryFilters.push_back(std::move(compiledFilter));
+            continue;
+        }
+
+        for (const auto& value : compiledFilter.values)
+        {
+            compiled.matches.push_back(filter.field + "=" + value);
+        }
+
+        compiled.journalFilters.push_back(std::move(compiledFilter));
+    }
+
+    return compiled;
+}
+
 void JournalLog::AddFilterGroup(const FilterGroup& group, bool ignoreIfMissing)
 {
     if (group.empty())
@@ -241,31 +330,36 @@ void JournalLog::AddFilterGroup(const FilterGroup& group, bool ignoreIfMissing)
 
     for (const auto& filter : group)
     {
-        for (const auto& value : filter.GetValueViews())
+        if (!IsValidFieldName(filter.field))
         {
-            std::string match = filter.field + (filter.exact_match ? "=" : "~") + std::string(value);
-            LogDebug("Adding journal match: {}", match);
-
-            const int ret = sd_journal_add_match(m_journal, match.c_str(), 0);
-            if (ret < 0)
+            if (!ignoreIfMissing)
             {
-                if (!ignoreIfMissing)
-                {
-                    ThrowIfError(ret, "add filter match");
-                }
-                LogWarn("Failed to add journal match {}: {}", match, strerror(-ret));
-                continue;
+                throw JournalLogException("Invalid journal field name: " + filter.field);
             }
+            LogWarn("Invalid journal field name {}, no entry will have it", filter.field);
         }
+    }
 
-        // Add OR condition between values of the same field
-        if (filter.GetValueViews().size() > 1)
-        {
-            ThrowIfError(sd_journal_add_disjunction(m_journal), "add filter disjunction for field values");
-        }
+    auto compiled = CompileFilterGroup(group);
+
+    // Add OR condition with the previous groups
+    if (!m_filters.empty())
+    {
+        ThrowIfError(sd_journal_add_disjunction(m_journal), "add filter disjunction");
     }
 
-    ThrowIfError(sd_journal_add_conjunction(m_journal), "add filter conjunction");
+    // Matches on the same field are combined with OR logic, and matches on different fields with AND logic
+    for (const auto& match : compiled.matches)
+    {
+        LogDebug("Adding journal match: {}", match);
+        ThrowIfError(sd_journal_add_match(m_journal, match.c_str(), match.size()), "add filter match");
+    }
+
+    LogDebug("{} filters evaluated by the journal, {} on each entry",
+             compiled.journalFilters.size(),
+             compiled.entryFilters.size());
+
+    m_filters.push_back(std::move(compiled));
     m_hasActiveFilters = true;
     LogInfo("Filter group added successfully");
 }
@@ -275,52 +369,64 @@ void JournalLog::FlushFilters()
     if (m_hasActiveFilters)
     {
         sd_journal_flush_matches(m_journal);
+        m_filters.clear();
         m_hasActiveFilters = false;
     }
 }
 
-bool JournalLog::ApplyFilterGroup(const FilterGroup& group, bool ignoreIfMissing) const
+bool JournalLog::ApplyFilterGroup(const std::vector<CompiledFilter>& filters, bool ignoreIfMissing) const
 {
-    return std::all_of(group.begin(),
-                       group.end(),
+    return std::all_of(filters.begin(),
+                       filters.end(),
                        [this, ignoreIfMissing](const auto& filter)
                        {
                            try
                            {
-                               const std::string fieldValue = GetData(filter.field);
-                               return filter.Matches(fieldValue);
+                               const auto fieldValue = GetDataView(filter.field);
+
+                               if (fieldValue)
+                               {
+                                   return filter.Matches(*fieldValue);
+                               }
                            }
                            catch (const JournalLogException&)
                            {
-                               if (!ignoreIfMissing)
-                               {
-                                   LogTrace("Field {} not present in entry, skipping...", filter.field);
-                               }
-                               return false;
+                               // A field that cannot be read is handled as missing
                            }
+
+                           if (!ignoreIfMissing)
+                           {
+                               LogTrace("Field {} not present in entry, skipping...", filter.field);
+                           }
+                           return false;
                        });
 }
 
-bool JournalLog::ApplyFilterSet(const FilterSet& filters, bool ignoreIfMissing)
+bool JournalLog::ApplyFilterSet(bool ignoreIfMissing) const
 {
-    return std::any_of(filters.begin(),
-                       filters.end(),
-                       [this, ignoreIfMissing](const auto& group) { return ApplyFilterGroup(group, ignoreIfMissing); });
+    // With a single group every entry already satisfies its journal matches
+    if (m_filters.size() == 1)
+    {
+        return ApplyFilterGroup(m_filters.front().entryFilters, ignoreIfMissing);
+    }
+
+    // With several groups an entry may have been selected by the matches of another group
+    return std::any_of(m_filters.begin(),
+                       m_filters.end(),
+                       [this, ignoreIfMissing](const auto& group)
+                       {
+                           return ApplyFilterGroup(group.journalFilters, ignoreIfMissing) &&
+                                  ApplyFilterGroup(group.entryFilters, ignoreIfMissing);
+                       });
 }
 
-bool JournalLog::ProcessJournalEntry(const FilterSet&, bool ignoreIfMissing, FilteredMessage& message) const
+bool JournalLog::ProcessJournalEntry(bool ignoreIfMissing, FilteredMessage& message) const
 {
     try
     {
         message.message = GetData("MESSAGE");
-        try
-        {
-            message.fieldValue = GetData("_SYSTEMD_UNIT");
-        }
-        catch (const JournalLogException&)
-        {
-            message.fieldValue = "unknown";
-        }
+        const auto unit = GetDataView("_SYSTEMD_UNIT");
+        message.fieldValue = unit ? std::string(*unit) : "unknown";
         return true;
     }
     catch (const JournalLogException& e)
@@ -333,8 +439,7 @@ bool JournalLog::ProcessJournalEntry(const FilterSet&, bool ignoreIfMissing, Fil
     }
 }
 
-std::optional<JournalLog::FilteredMessage> JournalLog::GetNextFilteredMessage(const FilterSet& filters,
-                                                                              bool ignoreIfMissing)
+std::optional<JournalLog::FilteredMessage> JournalLog::GetNextFilteredMessage(bool ignoreIfMissing)
 {
 
     if (!m_hasActiveFilters)
@@ -346,7 +451,7 @@ std::optional<JournalLog::FilteredMessage> JournalLog::GetNextFilteredMessage(co
     while (Next())
     {
         FilteredMessage message;
-        if (ApplyFilterSet(filters, ignoreIfMissing) && ProcessJournalEntry(filters, ignoreIfMissing, message))
+        if (ApplyFilterSet(ignoreIfMissing) && ProcessJournalEntry(ignoreIfMissing, message))
         {
             return message;
         }
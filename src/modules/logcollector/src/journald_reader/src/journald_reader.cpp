@@ -1,6 +1,12 @@
 #include "journald_reader.hpp"
 
 #include <logger.hpp>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
 #include <sstream>
 
 namespace
@@ -11,17 +17,19 @@ namespace
 namespace logcollector
 {
     JournaldReader::JournaldReader(
-        std::function<void(const std::string& location, const std::string& log, const std::string& collectorType)>
+        std::function<bool(const std::string& location, const std::string& log, const std::string& collectorType)>
             pushMessageFunc,
         std::function<Awaitable(std::chrono::milliseconds)> waitFunc,
         FilterGroup filters,
         bool ignoreIfMissing,
-        std::time_t fileWait)
+        std::time_t fileWait,
+        std::shared_ptr<BookmarkStore> bookmarks)
         : IReader(std::move(pushMessageFunc), std::move(waitFunc))
         , m_filters(std::move(filters))
         , m_ignoreIfMissing(ignoreIfMissing)
         , m_journal(std::make_unique<JournalLog>())
         , m_waitTime(std::chrono::milliseconds(fileWait))
+        , m_bookmarks(std::move(bookmarks))
     {
 
         LogInfo("Creating JournaldReader with {} filters", m_filters.size());
@@ -48,7 +56,7 @@ namespace logcollector
 
             try
             {
-                m_journal->SeekTail();
+                SeekStart();
             }
             catch (const JournalLogException& e)
             {
@@ -56,39 +64,44 @@ namespace logcollector
                 co_return;
             }
 
+            const auto executor = co_await boost::asio::this_coro::executor;
+            const auto descriptor = CreateDescriptor(executor);
+
             LogInfo("Journald reader started successfully");
 
             while (m_keepRunning.load())
             {
-                bool shouldWait = true;
-                try
+                const bool drained = ReadAvailableMessages();
+
+                if (!m_keepRunning.load())
                 {
-                    LogTrace("Checking for new journal entries...");
-                    FilterSet filterSet {m_filters};
-                    while (auto filteredMessage = m_journal->GetNextFilteredMessage(filterSet, m_ignoreIfMissing))
-                    {
-                        shouldWait = false;
-                        auto& message = filteredMessage->message;
-                        LogDebug("Found matching message for {}", GetFilterDescription());
-
-                        if (message.length() > MAX_LINE_LENGTH)
-                        {
-                            LogDebug("Truncating message of length {}", message.length());
-                            message.resize(MAX_LINE_LENGTH);
-                        }
-                        m_pushMessage(filteredMessage->fieldValue, message, COLLECTOR_TYPE);
-                    }
+                    break;
                 }
-                catch (const JournalLogException& e)
+
+                // A blocked reader retries after the wait, as the journal may not change again
+                if (descriptor && drained)
                 {
-                    LogError("Journal reading error: {}", e.what());
+                    co_await WaitForChanges(descriptor);
                 }
-
-                if (shouldWait)
+                else
                 {
                     co_await m_wait(m_waitTime);
                 }
             }
+
+            if (descriptor)
+            {
+                const std::lock_guard<std::mutex> lock(m_descriptorMutex);
+
+                // The file descriptor belongs to the journal, it must not be closed here
+                descriptor->release();
+                m_descriptor.reset();
+            }
+
+            if (m_bookmarks)
+            {
+                m_bookmarks->Flush();
+            }
         }
         catch (const JournalLogException& e)
         {
@@ -99,7 +112,163 @@ namespace logcollector
     void JournaldReader::Stop()
     {
         m_journal->FlushFilters();
-        m_keepRunning.store(false);
+
+        {
+            const std::lock_guard<std::mutex> lock(m_descriptorMutex);
+            m_keepRunning.store(false);
+
+            if (m_descriptor)
+            {
+                // The descriptor is not thread-safe, so the cancellation runs on its executor
+                boost::asio::post(m_descriptor->get_executor(),
+                                  [descriptor = m_descriptor]()
+                                  {
+                                      boost::system::error_code ec;
+                                      descriptor->cancel(ec);
+                                  });
+            }
+        }
+
         LogInfo("Journald stopped.");
     }
+
+    void JournaldReader::SeekStart()
+    {
+        const auto cursor = m_bookmarks ? m_bookmarks->GetCursor(GetFilterDescription()) : std::nullopt;
+
+        if (!cursor)
+        {
+            m_journal->SeekTail();
+            return;
+        }
+
+        if (!m_journal->SeekCursor(*cursor))
+        {
+            LogInfo("Cannot resume after the journal cursor, reading from the end of the journal");
+            m_journal->SeekTail();
+            return;
+        }
+
+        // When the stored entry does not match the filters, the journal lands on the next matching entry, which has not
+        // been read yet
+        if (!m_journal->CursorValid(*cursor))
+        {
+            m_journal->Previous();
+        }
+
+        LogDebug("Resuming journal after cursor '{}'", *cursor);
+    }
+
+    bool JournaldReader::ReadAvailableMessages()
+    {
+        bool drained = true;
+
+        try
+        {
+            LogTrace("Checking for new journal entries...");
+            while (auto filteredMessage = m_journal->GetNextFilteredMessage(m_ignoreIfMissing))
+            {
+                auto& message = filteredMessage->message;
+                LogDebug("Found matching message for {}", GetFilterDescription());
+
+                if (message.length() > MAX_LINE_LENGTH)
+                {
+                    LogDebug("Truncating message of length {}", message.length());
+                    message.resize(MAX_LINE_LENGTH);
+                }
+
+                if (!m_pushMessage(filteredMessage->fieldValue, message, COLLECTOR_TYPE))
+                {
+                    // Step back so that the next read returns this entry again
+                    if (!m_journal->Previous())
+                    {
+                        m_journal->SeekHead();
+                    }
+
+                    drained = false;
+                    break;
+                }
+            }
+        }
+        catch (const JournalLogException& e)
+        {
+            LogError("Journal reading error: {}", e.what());
+        }
+
+        if (!m_bookmarks)
+        {
+            return drained;
+        }
+
+        try
+        {
+            m_bookmarks->SetCursor(GetFilterDescription(), m_journal->GetCursor());
+            m_bookmarks->FlushIfDue();
+        }
+        catch (const JournalLogException&)
+        {
+            // The journal has no current entry yet
+        }
+
+        return drained;
+    }
+
+    std::shared_ptr<boost::asio::posix::stream_descriptor>
+    JournaldReader::CreateDescriptor(const boost::asio::any_io_executor& executor)
+    {
+        try
+        {
+            const int fd = m_journal->GetFileDescriptor();
+
+            if (m_journal->NeedsPolling())
+            {
+                LogInfo("Journal changes are not notified, polling every {} ms", m_waitTime.count());
+                return nullptr;
+            }
+
+            const std::lock_guard<std::mutex> lock(m_descriptorMutex);
+            m_descriptor = std::make_shared<boost::asio::posix::stream_descriptor>(executor, fd);
+            return m_descriptor;
+        }
+        catch (const JournalLogException& e)
+        {
+            LogWarn("Cannot wait for journal changes, polling every {} ms: {}", m_waitTime.count(), e.what());
+            return nullptr;
+        }
+    }
+
+    Awaitable JournaldReader::WaitForChanges(std::shared_ptr<boost::asio::posix::stream_descriptor> descriptor)
+    {
+        while (m_keepRunning.load())
+        {
+            boost::system::error_code ec;
+            co_await descriptor->async_wait(boost::asio::posix::stream_descriptor::wait_read,
+                                            boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+            if (ec)
+            {
+                if (ec != boost::asio::error::operation_aborted)
+                {
+                    LogError("Cannot wait for journal changes: {}", ec.message());
+                    co_await m_wait(m_waitTime);
+                }
+
+                co_return;
+            }
+
+            try
+            {
+                // Draining the notifications is needed for the descriptor to stop being readable
+                if (m_journal->ProcessChanges())
+                {
+                    co_return;
+                }
+            }
+            catch (const JournalLogException& e)
+            {
+                LogError("Journal reading error: {}", e.what());
+                co_return;
+            }
+        }
+    }
 } // namespace logcollector
@@ -4,8 +4,8 @@
 #include <boost/asio/detached.hpp>
 #include <boost/asio/redirect_error.hpp>
 #include <config.h>
+#include <configuration_parser_utils.hpp>
 #include <logger.hpp>
-#include <timeHelper.hpp>
 
 #include <chrono>
 #include <iomanip>
@@ -13,12 +13,69 @@
 #include <sstream>
 
 #include "file_reader.hpp"
+#include "rate_limiter.hpp"
+#include "timestamp_cache.hpp"
 
 using namespace logcollector;
 
 namespace logcollector
 {
     constexpr int ACTIVE_READERS_WAIT_MS = 10;
+    constexpr auto BOOKMARKS_FILE = "logcollector_bookmarks.json";
+    constexpr auto BOOKMARKS_FLUSH_INTERVAL = std::chrono::seconds(5);
+
+    /// @brief Gets the multiline settings of a file pattern
+    /// @param configs Multiline settings of all the file patterns
+    /// @param location File pattern
+    /// @return The multiline settings, or nothing if the pattern has none or they are invalid
+    std::optional<MultilineConfig> GetMultilineConfig(const YAML::Node& configs, const std::string& location)
+    {
+        for (const auto& config : configs)
+        {
+            if (!config.IsMap() || config["location"].as<std::string>("") != location)
+            {
+                continue;
+            }
+
+            try
+            {
+                MultilineConfig multiline;
+                const auto mode = config["mode"].as<std::string>("regex");
+
+                if (mode == "regex")
+                {
+                    multiline.mode = MultilineMode::Regex;
+                    multiline.startPattern = std::make_shared<const std::regex>(
+                        config["start_pattern"].as<std::string>(), std::regex::optimize);
+                }
+                else if (mode == "indent")
+                {
+                    multiline.mode = MultilineMode::Indent;
+                }
+                else if (mode == "json")
+                {
+                    multiline.mode = MultilineMode::Json;
+                }
+                else
+                {
+                    LogWarn("Invalid multiline mode '{}' for '{}', reading single lines", mode, location);
+                    return std::nullopt;
+                }
+
+                multiline.timeout = std::chrono::milliseconds(
+                    ParseTimeUnit(config["timeout"].as<std::string>(config::logcollector::DEFAULT_MULTILINE_TIMEOUT)));
+                multiline.maxSize = config::logcollector::MULTILINE_MAX_SIZE;
+                return multiline;
+            }
+            catch (const std::exception& e)
+            {
+                LogWarn("Invalid multiline settings for '{}', reading single lines: {}", location, e.what());
+                return std::nullopt;
+            }
+        }
+
+        return std::nullopt;
+    }
 }
 
 void Logcollector::Run()
@@ -65,6 +122,17 @@ void Logcollector::Setup(std::shared_ptr<const configuration::ConfigurationParse
     m_enabled =
         configurationParser->GetConfigOrDefault(config::logcollector::DEFAULT_ENABLED, "logcollector", "enabled");
 
+    m_bookmarks = std::make_shared<BookmarkStore>(
+        configurationParser->GetConfigOrDefault(config::DEFAULT_DATA_PATH, "agent", "path.data") + "/" + BOOKMARKS_FILE,
+        BOOKMARKS_FLUSH_INTERVAL);
+
+    if (const auto maxEps =
+            configurationParser->GetConfigOrDefault(config::logcollector::DEFAULT_MAX_EPS, "logcollector", "max_eps");
+        maxEps > 0)
+    {
+        m_rateLimiter = std::make_shared<RateLimiter>(maxEps);
+    }
+
     SetupFileReader(configurationParser);
     AddPlatformSpecificReader(configurationParser);
 }
@@ -81,17 +149,22 @@ void Logcollector::SetupFileReader(const std::shared_ptr<const configuration::Co
 
     const auto localfiles = configurationParser->GetConfigOrDefault(localFilesDefault, "logcollector", "localfiles");
 
+    const auto multilineConfigs = configurationParser->GetConfigOrDefault<YAML::Node>(
+        YAML::Node(YAML::NodeType::Sequence), "logcollector", "multiline");
+
     for (const auto& lf : localfiles)
     {
         AddReader(std::make_shared<FileReader>(
             [this](const std::string& location, const std::string& log, const std::string& collectorType)
-            { PushMessage(location, log, collectorType); },
+            { return PushMessage(location, log, collectorType); },
             // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
             [this](std::chrono::milliseconds duration) -> Awaitable { co_await Wait(duration); },
             [this](Awaitable task) { EnqueueTask(std::move(task)); },
             lf,
             fileWait,
-            reloadInterval));
+            reloadInterval,
+            m_bookmarks,
+            GetMultilineConfig(multilineConfigs, lf)));
     }
 }
 
@@ -99,6 +172,15 @@ void Logcollector::Stop()
 {
     CleanAllReaders();
     m_taskManager.Stop();
+
+    if (const auto statistics = GetStatistics(); statistics.throttled || statistics.blocked || statistics.dropped)
+    {
+        LogInfo("Logs not queued when read: {} throttled, {} blocked by a full queue, {} dropped.",
+                statistics.throttled,
+                statistics.blocked,
+                statistics.dropped);
+    }
+
     LogInfo("Logcollector module stopped.");
 }
 
@@ -132,34 +214,106 @@ void Logcollector::SetPushMessageFunction(const std::function<int(Message)>& pus
     m_pushMessage = pushMessage;
 }
 
-void Logcollector::PushMessage(const std::string& location, const std::string& log, const std::string& collectorType)
+bool Logcollector::PushMessage(const std::string& location, const std::string& log, const std::string& collectorType)
+{
+    return PushMessage(location, log, collectorType, location);
+}
+
+bool Logcollector::PushMessage(const std::string& location,
+                               const std::string& log,
+                               const std::string& collectorType,
+                               const std::string& source)
+{
+    if (m_rateLimiter && !m_rateLimiter->TryAcquire(source))
+    {
+        ++m_throttled;
+        return false;
+    }
+
+    if (!QueueMessage(location, log, collectorType))
+    {
+        // The log is read again when the queue has room, so it must not be charged twice to its source
+        if (m_rateLimiter)
+        {
+            m_rateLimiter->Release(source);
+        }
+
+        ++m_blocked;
+        return false;
+    }
+
+    return true;
+}
+
+bool Logcollector::PushMessageOrDrop(const std::string& location,
+                                     const std::string& log,
+                                     const std::string& collectorType)
+{
+    if (!QueueMessage(location, log, collectorType))
+    {
+        ++m_dropped;
+        return false;
+    }
+
+    return true;
+}
+
+bool Logcollector::QueueMessage(const std::string& location, const std::string& log, const std::string& collectorType)
 {
     if (!m_pushMessage)
     {
         throw std::runtime_error("Message queue not set, cannot send message.");
     }
 
-    auto metadata = nlohmann::json::object();
-    auto data = nlohmann::json::object();
+    // Readers may push from their own threads, so each thread keeps its own formatter
+    thread_local TimestampCache timestamps;
 
-    metadata["module"] = m_moduleName;
-    metadata["collector"] = collectorType;
+    nlohmann::json::object_t event;
+    event.emplace("original", log);
+    event.emplace("created", timestamps.Now());
+
+    nlohmann::json::object_t data;
 
     if (collectorType == FILE_READER_TYPE)
     {
-        data["log"]["file"]["path"] = location;
+        data.emplace("log", nlohmann::json::object_t {{"file", nlohmann::json::object_t {{"path", location}}}});
     }
     else
     {
-        data["event"]["provider"] = location;
+        event.emplace("provider", location);
     }
-    data["event"]["original"] = log;
-    data["event"]["created"] = Utils::getCurrentISO8601();
+    data.emplace("event", std::move(event));
+
+    auto message =
+        Message(MessageType::STATELESS, std::move(data), m_moduleName, collectorType, GetMetadata(collectorType));
 
-    auto message = Message(MessageType::STATELESS, data, m_moduleName, collectorType, metadata.dump());
-    m_pushMessage(message);
+    // The queue stores nothing when it is full
+    if (m_pushMessage(std::move(message)) == 0)
+    {
+        return false;
+    }
 
     LogTrace("Message pushed: '{}':'{}'", location, log);
+    return true;
+}
+
+LogcollectorStatistics Logcollector::GetStatistics() const
+{
+    return {m_throttled.load(), m_blocked.load(), m_dropped.load()};
+}
+
+const std::string& Logcollector::GetMetadata(const std::string& collectorType)
+{
+    const std::lock_guard<std::mutex> lock(m_metadataMutex);
+    auto it = m_metadata.find(collectorType);
+
+    if (it == m_metadata.end())
+    {
+        const nlohmann::json metadata {{"module", m_moduleName}, {"collector", collectorType}};
+        it = m_metadata.emplace(collectorType, metadata.dump()).first;
+    }
+
+    return it->second;
 }
 
 void Logcollector::AddReader(std::shared_ptr<IReader> reader)
@@ -1,6 +1,7 @@
 #include <logcollector.hpp>
 
 #include <config.h>
+#include <logger.hpp>
 #include <macos_reader.hpp>
 
 #include <algorithm>
@@ -52,6 +53,11 @@ namespace logcollector
 
         auto macosConfig = configurationParser->GetConfigOrDefault(defaultMacOsConfig, "logcollector", "macos");
 
+        if (m_rateLimiter && !macosConfig.empty())
+        {
+            LogWarn("max_eps does not apply to macOS logs, as they cannot be held back without losing them.");
+        }
+
         for (auto& entry : macosConfig)
         {
             const auto query = entry["query"];
@@ -60,7 +66,7 @@ namespace logcollector
             const auto typeList = SplitAndTrim(types);
             AddReader(std::make_shared<MacOSReader>(
                 [this](const std::string& location, const std::string& log, const std::string& collectorType)
-                { PushMessage(location, log, collectorType); },
+                { return PushMessageOrDrop(location, log, collectorType); },
                 // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
                 [this](std::chrono::milliseconds duration) -> Awaitable { co_await Wait(duration); },
                 fileWait,
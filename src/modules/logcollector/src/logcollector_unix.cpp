@@ -3,6 +3,8 @@
 #include <logcollector.hpp>
 
 #include <memory>
+#include <string>
+#include <utility>
 
 namespace logcollector
 {
@@ -16,6 +18,24 @@ namespace logcollector
         const auto fileWait = configurationParser->GetTimeConfigOrDefault(
             config::logcollector::DEFAULT_FILE_WAIT, "logcollector", "read_interval");
 
+        // A reader stops at an entry it cannot push and retries it, so all its entries share one rate limit: a limit
+        // per unit would let a noisy unit hold back the other units of the reader.
+        auto readerIndex = 0;
+        const auto addReader = [this, fileWait, &readerIndex](FilterGroup filters, bool ignoreIfMissing)
+        {
+            const auto source = "journald#" + std::to_string(readerIndex++);
+
+            AddReader(std::make_shared<JournaldReader>(
+                [this, source](const std::string& location, const std::string& log, const std::string& collectorType)
+                { return PushMessage(location, log, collectorType, source); },
+                // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+                [this](std::chrono::milliseconds duration) -> Awaitable { co_await Wait(duration); },
+                std::move(filters),
+                ignoreIfMissing,
+                fileWait,
+                m_bookmarks));
+        };
+
         for (const auto& config : journaldConfigs)
         {
             if (!config.IsMap())
@@ -37,31 +57,16 @@ namespace logcollector
                 if (!filters.empty())
                 {
                     // Create a reader with all conditions
-                    AddReader(std::make_shared<JournaldReader>(
-                        [this](const std::string& location, const std::string& log, const std::string& collectorType)
-                        { PushMessage(location, log, collectorType); },
-                        // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
-                        [this](std::chrono::milliseconds duration) -> Awaitable { co_await Wait(duration); },
-                        filters,
-                        config["ignore_if_missing"].as<bool>(false),
-                        fileWait));
+                    addReader(std::move(filters), config["ignore_if_missing"].as<bool>(false));
                 }
             }
             else
             {
                 // Single condition case
-                const FilterGroup filters {{config["field"].as<std::string>(),
-                                            config["value"].as<std::string>(),
-                                            config["exact_match"].as<bool>(true)}};
-
-                AddReader(std::make_shared<JournaldReader>(
-                    [this](const std::string& location, const std::string& log, const std::string& collectorType)
-                    { PushMessage(location, log, collectorType); },
-                    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
-                    [this](std::chrono::milliseconds duration) -> Awaitable { co_await Wait(duration); },
-                    filters,
-                    config["ignore_if_missing"].as<bool>(false),
-                    fileWait));
+                addReader({{config["field"].as<std::string>(),
+                            config["value"].as<std::string>(),
+                            config["exact_match"].as<bool>(true)}},
+                          config["ignore_if_missing"].as<bool>(false));
             }
         }
     }
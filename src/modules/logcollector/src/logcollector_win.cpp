@@ -1,6 +1,7 @@
 #include "event_reader_win.hpp"
 
 #include <config.h>
+#include <logger.hpp>
 #include <timeHelper.hpp>
 
 #include <chrono>
@@ -21,13 +22,18 @@ namespace logcollector
 
         auto windowsConfig = configurationParser->GetConfigOrDefault(defaultWinOsConfig, "logcollector", "windows");
 
+        if (m_rateLimiter && !windowsConfig.empty())
+        {
+            LogWarn("max_eps does not apply to Windows events, as they cannot be held back without losing them.");
+        }
+
         for (auto& entry : windowsConfig)
         {
             const auto channel = entry["channel"];
             const auto query = entry["query"];
             AddReader(std::make_shared<winevt::WindowsEventTracerReader>(
                 [this](const std::string& location, const std::string& log, const std::string& collectorType)
-                { PushMessage(location, log, collectorType); },
+                { return PushMessageOrDrop(location, log, collectorType); },
                 // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
                 [this](std::chrono::milliseconds duration) -> Awaitable { co_await Wait(duration); },
                 channel,
@@ -34,7 +34,7 @@ namespace logcollector
         /// @param query An optional query string using `NSPredicate` syntax for additional log filtering.
         /// @param logTypes A vector of log type strings to further filter log entries.
         MacOSReader(
-            std::function<void(const std::string& location, const std::string& log, const std::string& collectorType)>
+            std::function<bool(const std::string& location, const std::string& log, const std::string& collectorType)>
                 pushMessageFunc,
             std::function<Awaitable(std::chrono::milliseconds)> waitFunc,
             const std::time_t waitInMillis,
@@ -53,7 +53,7 @@ namespace logcollector
         /// @param logTypes A vector of log type strings to further filter log entries.
         MacOSReader(
             std::unique_ptr<IOSLogStoreWrapper> osLogStoreWrapper,
-            std::function<void(const std::string& location, const std::string& log, const std::string& collectorType)>
+            std::function<bool(const std::string& location, const std::string& log, const std::string& collectorType)>
                 pushMessageFunc,
             std::function<Awaitable(std::chrono::milliseconds)> waitFunc,
             const std::time_t waitInMillis,
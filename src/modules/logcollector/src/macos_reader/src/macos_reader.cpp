@@ -14,7 +14,7 @@ namespace logcollector
 {
 
     MacOSReader::MacOSReader(
-        std::function<void(const std::string& location, const std::string& log, const std::string& collectorType)>
+        std::function<bool(const std::string& location, const std::string& log, const std::string& collectorType)>
             pushMessageFunc,
         std::function<Awaitable(std::chrono::milliseconds)> waitFunc,
         const std::time_t waitInMillis,
@@ -34,7 +34,7 @@ namespace logcollector
 
     MacOSReader::MacOSReader(
         std::unique_ptr<IOSLogStoreWrapper> osLogStoreWrapper,
-        std::function<void(const std::string& location, const std::string& log, const std::string& collectorType)>
+        std::function<bool(const std::string& location, const std::string& log, const std::string& collectorType)>
             pushMessageFunc,
         std::function<Awaitable(std::chrono::milliseconds)> waitFunc,
         const std::time_t waitInMillis,
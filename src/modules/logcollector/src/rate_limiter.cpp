@@ -0,0 +1,94 @@
+#include "rate_limiter.hpp"
+
+#include <algorithm>
+
+using namespace logcollector;
+
+namespace
+{
+    /// @brief Gets the number of tokens a bucket holds when full
+    /// @param rate Tokens added per second
+    /// @return At least one token, so that rates below one event per second let events through
+    double Capacity(double rate)
+    {
+        return std::max(rate, 1.0);
+    }
+} // namespace
+
+RateLimiter::RateLimiter(double eventsPerSecond)
+    : m_rate(std::max(eventsPerSecond, 0.0))
+{
+}
+
+bool RateLimiter::TryAcquire(const std::string& source, std::chrono::steady_clock::time_point now)
+{
+    if (m_rate == 0)
+    {
+        return true;
+    }
+
+    const auto capacity = Capacity(m_rate);
+
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Sources come and go, such as files rotated to new names, so their buckets are dropped once idle. Checking
+    // at most once per refill period keeps it off the path of each event.
+    if (now - m_lastEviction >= std::chrono::duration<double>(capacity / m_rate))
+    {
+        EvictIdle(now);
+    }
+
+    auto [it, inserted] = m_buckets.try_emplace(source, Bucket {capacity, now});
+    auto& bucket = it->second;
+
+    if (!inserted)
+    {
+        const auto elapsed = std::chrono::duration<double>(now - bucket.lastRefill).count();
+        bucket.tokens = std::min(capacity, bucket.tokens + elapsed * m_rate);
+        bucket.lastRefill = now;
+    }
+
+    if (bucket.tokens < 1)
+    {
+        return false;
+    }
+
+    bucket.tokens -= 1;
+    return true;
+}
+
+void RateLimiter::EvictIdle(std::chrono::steady_clock::time_point now)
+{
+    const auto capacity = Capacity(m_rate);
+
+    std::erase_if(m_buckets,
+                  [this, now, capacity](const auto& entry)
+                  {
+                      const auto& bucket = entry.second;
+                      const auto elapsed = std::chrono::duration<double>(now - bucket.lastRefill).count();
+                      return bucket.tokens + elapsed * m_rate >= capacity;
+                  });
+
+    m_lastEviction = now;
+}
+
+std::size_t RateLimiter::Sources() const
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    return m_buckets.size();
+}
+
+void RateLimiter::Release(const std::string& source)
+{
+    if (m_rate == 0)
+    {
+        return;
+    }
+
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (const auto it = m_buckets.find(source); it != m_buckets.end())
+    {
+        it->second.tokens = std::min(Capacity(m_rate), it->second.tokens + 1);
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace logcollector
+{
+    /// @brief Per-source event rate limiter
+    ///
+    /// Each source has a token bucket that holds up to one second of events
+    /// and refills at the configured rate, so short bursts are let through
+    /// while the sustained rate of a source is capped. Sources do not share
+    /// tokens, so a noisy source does not slow down the others.
+    ///
+    /// A bucket that has been refilled to capacity is no different from a new
+    /// one, so the buckets of idle sources are dropped.
+    class RateLimiter
+    {
+    public:
+        /// @brief Constructor
+        /// @param eventsPerSecond Maximum sustained rate of each source, 0 for no limit
+        RateLimiter(double eventsPerSecond);
+
+        /// @brief Takes a token from the bucket of a source
+        /// @param source Source of the event
+        /// @param now Current time
+        /// @return True if the event may be sent, false if the source exceeds its rate
+        bool TryAcquire(const std::string& source,
+                        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+        /// @brief Gives back a token taken for an event that could not be sent after all
+        /// @param source Source of the event
+        void Release(const std::string& source);
+
+        /// @brief Gets the number of sources with a bucket
+        /// @return Number of buckets kept
+        std::size_t Sources() const;
+
+    private:
+        /// @brief Token bucket of a source
+        struct Bucket
+        {
+            /// @brief Available tokens
+            double tokens;
+
+            /// @brief Time of the last refill
+            std::chrono::steady_clock::time_point lastRefill;
+        };
+
+        /// @brief Tokens added per second to each bucket
+        double m_rate;
+
+        /// @brief Drops the buckets that are full again. m_mutex must be held
+        /// @param now Current time
+        void EvictIdle(std::chrono::steady_clock::time_point now);
+
+        /// @brief Time of the last eviction of idle buckets
+        std::chrono::steady_clock::time_point m_lastEviction;
+
+        /// @brief Mutex to access the buckets, as readers may push from their own threads
+        mutable std::mutex m_mutex;
+
+        /// @brief Token buckets by source
+        std::unordered_map<std::string, Bucket> m_buckets;
+    };
+} // namespace logcollector
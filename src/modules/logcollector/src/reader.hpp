@@ -17,7 +17,7 @@ namespace logcollector
     public:
         /// @brief Constructor
         IReader(
-            std::function<void(const std::string& location, const std::string& log, const std::string& collectorType)>
+            std::function<bool(const std::string& location, const std::string& log, const std::string& collectorType)>
                 pushMessageFunc,
             std::function<Awaitable(std::chrono::milliseconds)> waitFunc)
             : m_pushMessage(pushMessageFunc)
@@ -38,8 +38,9 @@ namespace logcollector
     protected:
         /// @brief Push message function
         /// @param message The message to push
-        /// @return The result of the push operation
-        std::function<void(const std::string& location, const std::string& log, const std::string& collectorType)>
+        /// @return True if the message was queued, false if the queue is full or the source exceeds its rate, in which
+        /// case the reader should keep its position and retry later
+        std::function<bool(const std::string& location, const std::string& log, const std::string& collectorType)>
             m_pushMessage;
 
         /// @brief Wait function
@@ -0,0 +1,61 @@
+#include "timestamp_cache.hpp"
+
+#include <cstddef>
+
+using namespace logcollector;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+
+namespace
+{
+    /// @brief Writes a zero-padded number over the characters of a string
+    /// @param text String to write to
+    /// @param position Position of the first digit
+    /// @param width Number of digits
+    /// @param value Number to write
+    void WriteNumber(std::string& text, std::size_t position, std::size_t width, long long value)
+    {
+        for (auto i = position + width; i > position; --i)
+        {
+            text[i - 1] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+    }
+} // namespace
+
+std::string TimestampCache::Format(std::chrono::system_clock::time_point time)
+{
+    const auto second = std::chrono::floor<std::chrono::seconds>(time);
+
+    if (m_prefix.empty() || second != m_second)
+    {
+        const auto day = std::chrono::floor<std::chrono::days>(second);
+        const std::chrono::year_month_day date {day};
+        const std::chrono::hh_mm_ss clock {second - day};
+
+        m_prefix = "0000-00-00T00:00:00";
+        WriteNumber(m_prefix, 0, 4, static_cast<int>(date.year()));
+        WriteNumber(m_prefix, 5, 2, static_cast<unsigned>(date.month()));
+        WriteNumber(m_prefix, 8, 2, static_cast<unsigned>(date.day()));
+        WriteNumber(m_prefix, 11, 2, clock.hours().count());
+        WriteNumber(m_prefix, 14, 2, clock.minutes().count());
+        WriteNumber(m_prefix, 17, 2, clock.seconds().count());
+        m_second = second;
+    }
+
+    std::string timestamp;
+    timestamp.reserve(m_prefix.size() + 5);
+    timestamp += m_prefix;
+    timestamp += ".000Z";
+    WriteNumber(
+        timestamp, m_prefix.size() + 1, 3, std::chrono::duration_cast<std::chrono::milliseconds>(time - second).count());
+
+    return timestamp;
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+
+std::string TimestampCache::Now()
+{
+    return Format(std::chrono::system_clock::now());
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+namespace logcollector
+{
+    /// @brief Timestamp formatter that reuses the date and time of the last formatted second
+    ///
+    /// Formats time points in UTC as ISO 8601 with milliseconds, like
+    /// Utils::getCurrentISO8601. Logs usually come in bursts, so only the
+    /// milliseconds change between most calls. Instances are not thread-safe.
+    class TimestampCache
+    {
+    public:
+        /// @brief Formats a time point
+        /// @param time Time point
+        /// @return Timestamp like "2025-01-22T21:45:01.916Z"
+        std::string Format(std::chrono::system_clock::time_point time);
+
+        /// @brief Formats the current time
+        /// @return Timestamp like "2025-01-22T21:45:01.916Z"
+        std::string Now();
+
+    private:
+        /// @brief Second of the cached date and time
+        std::chrono::sys_seconds m_second {};
+
+        /// @brief Date and time of the cached second, like "2025-01-22T21:45:01"
+        std::string m_prefix;
+    };
+} // namespace logcollector
@@ -27,7 +27,7 @@ namespace logcollector::winevt
         /// @param channelRefreshInterval channel query refresh interval in millisecconds.
         /// @param winAPI wrapper of winevt methods.
         WindowsEventTracerReader(
-            std::function<void(const std::string& location, const std::string& log, const std::string& collectorType)>
+            std::function<bool(const std::string& location, const std::string& log, const std::string& collectorType)>
                 pushMessageFunc,
             std::function<Awaitable(std::chrono::milliseconds)> waitFunc,
             const std::string channel,
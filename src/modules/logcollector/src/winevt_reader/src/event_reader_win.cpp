@@ -16,7 +16,7 @@ namespace logcollector::winevt
 {
 
     WindowsEventTracerReader::WindowsEventTracerReader(
-        std::function<void(const std::string& location, const std::string& log, const std::string& collectorType)>
+        std::function<bool(const std::string& location, const std::string& log, const std::string& collectorType)>
             pushMessageFunc,
         std::function<Awaitable(std::chrono::milliseconds)> waitFunc,
         const std::string channel,
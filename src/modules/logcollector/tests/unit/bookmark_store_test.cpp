@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+
+#include <bookmark_store.hpp>
+#include <tempfile.hpp>
+
+using namespace logcollector;
+
+namespace
+{
+    const std::string BOOKMARKS_PATH = "/tmp/logcollector_bookmarks_test.json";
+    const std::string LOG_PATH = "/tmp/logcollector_bookmarks_test.log";
+    const Bookmark BOOKMARK {{1, 2}, 3, 4, 5}; // NOLINT
+} // namespace
+
+class BookmarkStoreTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        std::filesystem::remove(BOOKMARKS_PATH);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(BOOKMARKS_PATH);
+    }
+};
+
+TEST_F(BookmarkStoreTest, PersistsBookmarksOnFlush)
+{
+    auto file = TempFile(LOG_PATH);
+
+    {
+        BookmarkStore store(BOOKMARKS_PATH, std::chrono::hours(1));
+        store.Set(LOG_PATH, BOOKMARK);
+        EXPECT_EQ(store.Get(LOG_PATH), BOOKMARK);
+        EXPECT_FALSE(store.Get("/tmp/B.log").has_value());
+        store.Flush();
+    }
+
+    BookmarkStore store(BOOKMARKS_PATH, std::chrono::hours(1));
+    EXPECT_EQ(store.Get(LOG_PATH), BOOKMARK);
+}
+
+TEST_F(BookmarkStoreTest, DropsBookmarksOfMissingFilesOnFlush)
+{
+    auto file = TempFile(LOG_PATH);
+
+    {
+        BookmarkStore store(BOOKMARKS_PATH, std::chrono::hours(1));
+        store.Set(LOG_PATH, BOOKMARK);
+        store.Set("/tmp/missing.log", {{1, 3}, 3, 4, 5}); // NOLINT
+        store.Flush();
+    }
+
+    BookmarkStore store(BOOKMARKS_PATH, std::chrono::hours(1));
+    EXPECT_EQ(store.Get(LOG_PATH), BOOKMARK);
+    EXPECT_FALSE(store.Get("/tmp/missing.log").has_value());
+    EXPECT_FALSE(store.Find({1, 3}).has_value());
+}
+
+TEST_F(BookmarkStoreTest, DropsBookmarksNotAskedForSinceLoadOnFlush)
+{
+    auto file = TempFile(LOG_PATH);
+    auto otherFile = TempFile(LOG_PATH + ".1");
+    const Bookmark otherBookmark {{1, 3}, 3, 4, 5}; // NOLINT
+
+    {
+        BookmarkStore store(BOOKMARKS_PATH, std::chrono::hours(1));
+        store.Set(LOG_PATH, BOOKMARK);
+        store.Set(otherFile.Path(), otherBookmark);
+        store.Flush();
+    }
+
+    {
+        // Only the first file still matches a pattern
+        BookmarkStore store(BOOKMARKS_PATH, std::chrono::hours(1));
+        EXPECT_TRUE(store.Get(LOG_PATH).has_value());
+        store.Set(LOG_PATH, {{1, 2}, 10, 4, 5}); // NOLINT
+        store.Flush();
+    }
+
+    BookmarkStore store(BOOKMARKS_PATH, std::chrono::hours(1));
+    EXPECT_EQ(store.Get(LOG_PATH)->offset, 10);
+    EXPECT_FALSE(store.Get(otherFile.Path()).has_value());
+}
+
+TEST_F(BookmarkStoreTest, PersistsJournalCursorsOnFlush)
+{
+    {
+        BookmarkStore store(BOOKMARKS_PATH, std::chrono::hours(1));
+        store.SetCursor("cron", "s=1;i=2");
+        EXPECT_EQ(store.GetCursor("cron"), "s=1;i=2");
+        EXPECT_FALSE(store.GetCursor("sshd").has_value());
+        store.Flush();
+    }
+
+    const BookmarkStore store(BOOKMARKS_PATH, std::chrono::hours(1));
+    EXPECT_EQ(store.GetCursor("cron"), "s=1;i=2");
+}
+
+TEST_F(BookmarkStoreTest, FindsBookmarksByFileId)
+{
+    BookmarkStore store(BOOKMARKS_PATH, std::chrono::hours(1));
+    store.Set("/tmp/A.log", BOOKMARK);
+
+    EXPECT_EQ(store.Find(BOOKMARK.id), BOOKMARK);
+    EXPECT_FALSE(store.Find({1, 3}).has_value());
+
+    store.Set("/tmp/A.log", {{1, 3}, 3, 4, 5}); // NOLINT
+    EXPECT_FALSE(store.Find(BOOKMARK.id).has_value());
+    EXPECT_TRUE(store.Find({1, 3}).has_value());
+}
+
+TEST_F(BookmarkStoreTest, FlushIfDueWaitsForInterval)
+{
+    BookmarkStore store(BOOKMARKS_PATH, std::chrono::hours(1));
+    store.Set("/tmp/A.log", BOOKMARK);
+    store.FlushIfDue();
+    EXPECT_FALSE(std::filesystem::exists(BOOKMARKS_PATH));
+
+    BookmarkStore eagerStore(BOOKMARKS_PATH, std::chrono::milliseconds(0));
+    eagerStore.Set("/tmp/A.log", BOOKMARK);
+    eagerStore.FlushIfDue();
+    EXPECT_TRUE(std::filesystem::exists(BOOKMARKS_PATH));
+}
+
+TEST_F(BookmarkStoreTest, StartsEmptyOnInvalidFile)
+{
+    auto file = TempFile(BOOKMARKS_PATH, "not json");
+
+    BookmarkStore store(BOOKMARKS_PATH, std::chrono::hours(1));
+    EXPECT_FALSE(store.Get("/tmp/A.log").has_value());
+}
+
+TEST(Fingerprint, DependsOnContent)
+{
+    EXPECT_EQ(Fingerprint("Hello World"), Fingerprint("Hello World"));
+    EXPECT_NE(Fingerprint("Hello World"), Fingerprint("Hello world"));
+    EXPECT_NE(Fingerprint(""), Fingerprint("Hello World"));
+}
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <filesystem>
 #include <list>
 #include <spdlog/spdlog.h>
 #include <sstream>
@@ -40,6 +41,32 @@ TEST(Localfile, PartialLine)
     ASSERT_EQ(answer, "Hello World");
 }
 
+TEST(Localfile, SkipsEmptyLinesAndCarriageReturns)
+{
+    auto stream = std::make_shared<std::stringstream>();
+    auto lf = Localfile(stream);
+
+    *stream << "First\r\n\n\r\nSecond\n";
+    ASSERT_EQ(lf.NextLog(), "First");
+    ASSERT_EQ(lf.NextLog(), "Second");
+    ASSERT_EQ(lf.NextLog(), "");
+}
+
+TEST(Localfile, ReadsLinesAppendedToFile)
+{
+    auto fileA = TempFile("/tmp/A.log", "First\nSec");
+    auto lf = Localfile("/tmp/A.log");
+
+    ASSERT_EQ(lf.NextLog(), "First");
+    ASSERT_EQ(lf.NextLog(), "");
+
+    fileA.Write("ond\nThird\n");
+    ASSERT_EQ(lf.NextLog(), "Second");
+    ASSERT_EQ(lf.NextLog(), "Third");
+    ASSERT_EQ(lf.NextLog(), "");
+    ASSERT_FALSE(lf.Rotated());
+}
+
 TEST(Localfile, OpenError)
 {
     try
@@ -83,6 +110,91 @@ TEST(Localfile, Deleted)
     }
 }
 
+TEST(Localfile, RestoresBookmark)
+{
+    auto fileA = TempFile("/tmp/A.log", "First\nSecond\nThi");
+    auto lf = Localfile("/tmp/A.log");
+
+    ASSERT_EQ(lf.NextLog(), "First");
+    ASSERT_EQ(lf.NextLog(), "Second");
+    ASSERT_EQ(lf.NextLog(), "");
+
+    const auto bookmark = lf.GetBookmark();
+    ASSERT_EQ(bookmark.id, lf.Id());
+    ASSERT_EQ(bookmark.offset, 13); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+
+    fileA.Write("rd\n");
+
+    auto resumed = Localfile("/tmp/A.log");
+    ASSERT_TRUE(resumed.Restore(bookmark));
+    ASSERT_EQ(resumed.NextLog(), "Third");
+    ASSERT_EQ(resumed.NextLog(), "");
+}
+
+TEST(Localfile, RetriesUnsentRecord)
+{
+    auto fileA = TempFile("/tmp/A.log", "First\nSecond\nThird\n");
+    auto lf = Localfile("/tmp/A.log");
+
+    ASSERT_EQ(lf.NextRecord(), "First");
+
+    auto second = lf.NextRecord();
+    ASSERT_EQ(second, "Second");
+    lf.Retry(std::move(*second));
+
+    // The bookmark stays at the record until it is taken again
+    ASSERT_TRUE(lf.HasUnsentRecord());
+    ASSERT_EQ(lf.GetBookmark().offset, 6); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+
+    ASSERT_EQ(lf.NextRecord(), "Second");
+    ASSERT_FALSE(lf.HasUnsentRecord());
+    ASSERT_EQ(lf.NextRecord(), "Third");
+    ASSERT_FALSE(lf.NextRecord().has_value());
+    ASSERT_EQ(lf.GetBookmark().offset, 19); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+}
+
+TEST(Localfile, RejectsBookmarkOfReplacedFile)
+{
+    Bookmark bookmark;
+
+    {
+        auto fileA = TempFile("/tmp/A.log", "First\nSecond\n");
+        auto lf = Localfile("/tmp/A.log");
+        lf.SeekEnd();
+        bookmark = lf.GetBookmark();
+    }
+
+    auto fileA = TempFile("/tmp/A.log", "Other\n");
+    auto lf = Localfile("/tmp/A.log");
+
+    ASSERT_FALSE(lf.Restore(bookmark));
+    ASSERT_EQ(lf.NextLog(), "Other");
+}
+
+TEST(Localfile, RotatedByRename)
+{
+    auto fileA = TempFile("/tmp/A.log", "First\n");
+    auto lf = Localfile("/tmp/A.log");
+
+    ASSERT_EQ(lf.NextLog(), "First");
+    ASSERT_FALSE(lf.Rotated());
+
+    fileA.Write("Second\n");
+    std::filesystem::rename("/tmp/A.log", "/tmp/A.log.1");
+    auto newFileA = TempFile("/tmp/A.log", "Third\n");
+    ASSERT_TRUE(lf.Rotated());
+
+    // The rest of the old file is still readable before reopening
+    ASSERT_EQ(lf.NextLog(), "Second");
+    ASSERT_EQ(lf.NextLog(), "");
+
+    lf.Reopen();
+    ASSERT_FALSE(lf.Rotated());
+    ASSERT_EQ(lf.NextLog(), "Third");
+
+    std::filesystem::remove("/tmp/A.log.1");
+}
+
 TEST(FileReader, Reload)
 {
     spdlog::default_logger()->sinks().clear();
@@ -100,6 +212,7 @@ TEST(FileReader, Reload)
     auto regex = "/tmp/file*.log";
     const Logcollector logcollector;
     auto dummyPush = [](const std::string&, const std::string&, const std::string&) {
+        return true;
     };
     auto dummyWait = [](std::chrono::milliseconds) -> Awaitable
     {
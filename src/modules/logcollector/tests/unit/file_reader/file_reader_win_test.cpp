@@ -48,6 +48,17 @@ TEST(Localfile, PartialLine)
     ASSERT_EQ(answer, "Hello World");
 }
 
+TEST(Localfile, SkipsEmptyLinesAndCarriageReturns)
+{
+    auto stream = std::make_shared<std::stringstream>();
+    auto lf = Localfile(stream);
+
+    *stream << "First\r\n\n\r\nSecond\n";
+    ASSERT_EQ(lf.NextLog(), "First");
+    ASSERT_EQ(lf.NextLog(), "Second");
+    ASSERT_EQ(lf.NextLog(), "");
+}
+
 TEST(Localfile, OpenError)
 {
     try
@@ -110,6 +121,7 @@ TEST(FileReader, Reload)
     auto regex = TMP_FILE_DIR + std::string("*.log");
 
     const auto dummyPush = [](const std::string&, const std::string&, const std::string&) {
+        return true;
     };
     const auto dummyWait = [](std::chrono::milliseconds) -> Awaitable
     {
@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <file_reader.hpp>
+#include <inotify_watcher.hpp>
+#include <tempfile.hpp>
+
+using namespace logcollector;
+
+namespace
+{
+    const std::string WATCH_DIR = "/tmp/logcollector_watch";
+} // namespace
+
+class InotifyWatcherTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        std::filesystem::remove_all(WATCH_DIR);
+        std::filesystem::create_directories(WATCH_DIR);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(WATCH_DIR);
+    }
+
+    std::set<std::string> WaitEvents(const std::shared_ptr<IFileWatcher>& watcher)
+    {
+        std::set<std::string> paths;
+        boost::asio::co_spawn(
+            m_ioContext,
+            [&]() -> Awaitable { paths = co_await watcher->Wait(); },
+            boost::asio::detached);
+        m_ioContext.run();
+        m_ioContext.restart();
+        return paths;
+    }
+
+    boost::asio::io_context m_ioContext;
+};
+
+TEST_F(InotifyWatcherTest, NotifiesFileChanges)
+{
+    auto fileA = TempFile(WATCH_DIR + "/A.log");
+    auto fileB = TempFile(WATCH_DIR + "/B.log");
+    auto watcher = std::make_shared<InotifyWatcher>(m_ioContext.get_executor());
+
+    ASSERT_TRUE(watcher->AddFile(fileA.Path()));
+    ASSERT_TRUE(watcher->AddFile(fileB.Path()));
+
+    fileA.Write("Hello\n");
+    fileA.Write("World\n");
+
+    EXPECT_EQ(WaitEvents(watcher), std::set<std::string> {fileA.Path()});
+}
+
+TEST_F(InotifyWatcherTest, NotifiesNewFilesInDirectory)
+{
+    auto watcher = std::make_shared<InotifyWatcher>(m_ioContext.get_executor());
+
+    ASSERT_TRUE(watcher->AddDirectory(WATCH_DIR));
+    ASSERT_FALSE(watcher->AddDirectory(WATCH_DIR + "/missing"));
+
+    auto fileA = TempFile(WATCH_DIR + "/A.log");
+
+    EXPECT_EQ(WaitEvents(watcher), std::set<std::string> {WATCH_DIR});
+}
+
+TEST_F(InotifyWatcherTest, StopsNotifyingRemovedFiles)
+{
+    auto fileA = TempFile(WATCH_DIR + "/A.log");
+    auto fileB = TempFile(WATCH_DIR + "/B.log");
+    auto watcher = std::make_shared<InotifyWatcher>(m_ioContext.get_executor());
+
+    ASSERT_TRUE(watcher->AddFile(fileA.Path()));
+    ASSERT_TRUE(watcher->AddFile(fileB.Path()));
+    watcher->RemoveFile(fileA.Path());
+
+    fileA.Write("Hello\n");
+    fileB.Write("World\n");
+
+    EXPECT_EQ(WaitEvents(watcher), std::set<std::string> {fileB.Path()});
+}
+
+TEST_F(InotifyWatcherTest, CancelEndsWait)
+{
+    auto watcher = std::make_shared<InotifyWatcher>(m_ioContext.get_executor());
+    ASSERT_TRUE(watcher->AddDirectory(WATCH_DIR));
+
+    watcher->Cancel();
+
+    EXPECT_TRUE(WaitEvents(watcher).empty());
+}
+
+TEST_F(InotifyWatcherTest, FileReaderReadsOnNotifications)
+{
+    auto fileA = TempFile(WATCH_DIR + "/A.log", "Old\n");
+    std::vector<std::string> logs;
+
+    FileReader reader(
+        [&logs](const std::string&, const std::string& log, const std::string&)
+        {
+            logs.push_back(log);
+            return true;
+        },
+        [](std::chrono::milliseconds) -> Awaitable { co_return; },
+        [](Awaitable) {},
+        WATCH_DIR + "/*.log",
+        500,    // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+        60000); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+
+    boost::asio::co_spawn(m_ioContext, reader.Run(), boost::asio::detached);
+    boost::asio::co_spawn(
+        m_ioContext,
+        [&]() -> Awaitable
+        {
+            boost::asio::steady_timer timer(m_ioContext);
+
+            timer.expires_after(std::chrono::milliseconds(50)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            fileA.Write("New\n");
+
+            // A file created after the start is read from its beginning
+            auto fileB = TempFile(WATCH_DIR + "/B.log", "First\n");
+
+            timer.expires_after(std::chrono::milliseconds(50)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            reader.Stop();
+        },
+        boost::asio::detached);
+
+    m_ioContext.run();
+
+    // Changes notified together are read in path order
+    std::sort(logs.begin(), logs.end());
+    EXPECT_EQ(logs, (std::vector<std::string> {"First", "New"}));
+}
+
+TEST_F(InotifyWatcherTest, FileReaderRetriesLogsThatCannotBePushed)
+{
+    auto fileA = TempFile(WATCH_DIR + "/A.log", "Old\n");
+    std::vector<std::string> logs;
+    int rejected = 0;
+
+    FileReader reader(
+        [&logs, &rejected](const std::string&, const std::string& log, const std::string&)
+        {
+            // The queue is full the first time the second log is pushed
+            if (log == "Second" && rejected++ == 0)
+            {
+                return false;
+            }
+
+            logs.push_back(log);
+            return true;
+        },
+        // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+        [this](std::chrono::milliseconds duration) -> Awaitable
+        {
+            boost::asio::steady_timer timer(m_ioContext);
+            timer.expires_after(duration);
+            co_await timer.async_wait(boost::asio::use_awaitable);
+        },
+        [this](Awaitable task) { boost::asio::co_spawn(m_ioContext, std::move(task), boost::asio::detached); },
+        WATCH_DIR + "/*.log",
+        20,     // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+        60000); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+
+    boost::asio::co_spawn(m_ioContext, reader.Run(), boost::asio::detached);
+    boost::asio::co_spawn(
+        m_ioContext,
+        [&]() -> Awaitable
+        {
+            boost::asio::steady_timer timer(m_ioContext);
+
+            timer.expires_after(std::chrono::milliseconds(50)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            fileA.Write("First\nSecond\nThird\n");
+
+            timer.expires_after(std::chrono::milliseconds(200)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            reader.Stop();
+        },
+        boost::asio::detached);
+
+    m_ioContext.run();
+
+    // The rejected log is pushed again without skipping or repeating any log
+    EXPECT_EQ(rejected, 2);
+    EXPECT_EQ(logs, (std::vector<std::string> {"First", "Second", "Third"}));
+}
@@ -0,0 +1,152 @@
+#include <journal_log.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace
+{
+    const std::string BENCHMARK_DIR = "benchmark_journal";
+    const std::string EXPORT_FILE_NAME = "benchmark_journal.export";
+    const std::string JOURNAL_REMOTE = "/lib/systemd/systemd-journal-remote";
+    constexpr std::size_t DEFAULT_ENTRIES = 1000000;
+    constexpr std::size_t UNITS = 100;
+    constexpr std::uint64_t FIRST_TIMESTAMP = 1735689600000000;
+
+    /// @brief Filters of the benchmark: one unit out of UNITS, with a message substring.
+    const FilterGroup FILTERS {{"_SYSTEMD_UNIT", "unit7.service", true},
+                               {"PRIORITY", "6", true},
+                               {"MESSAGE", "session", false}};
+
+    /// @brief Writes a journal in export format, and converts it with systemd-journal-remote.
+    bool CreateJournal(std::size_t entries)
+    {
+        {
+            std::ofstream file(EXPORT_FILE_NAME, std::ios::binary);
+
+            for (std::size_t i = 0; i < entries; ++i)
+            {
+                file << "__REALTIME_TIMESTAMP=" << FIRST_TIMESTAMP + i << "\n"
+                     << "__MONOTONIC_TIMESTAMP=" << i + 1 << "\n"
+                     << "_BOOT_ID=0123456789abcdef0123456789abcdef\n"
+                     << "_SYSTEMD_UNIT=unit" << i % UNITS << ".service\n"
+                     << "PRIORITY=" << i % 8 << "\n"
+                     << "MESSAGE=pam_unix(cron:session): session " << (i % 2 ? "opened" : "closed")
+                     << " for user root, request " << i << "\n\n";
+            }
+        }
+
+        std::filesystem::create_directories(BENCHMARK_DIR);
+        const auto command =
+            JOURNAL_REMOTE + " --output=" + BENCHMARK_DIR + "/benchmark.journal " + EXPORT_FILE_NAME + " 2>/dev/null";
+        const bool created = std::system(command.c_str()) == 0; // NOLINT(cert-env33-c)
+
+        std::filesystem::remove(EXPORT_FILE_NAME);
+        return created;
+    }
+
+    /// @brief Selects the entries the way JournalLog used to: every entry is copied and checked in user space.
+    std::size_t ReadLegacy(const std::string& directory)
+    {
+        JournalLog journal;
+        journal.OpenDirectory(directory);
+        journal.SeekHead();
+
+        std::size_t count = 0;
+
+        while (journal.Next())
+        {
+            const bool matches = std::all_of(FILTERS.begin(),
+                                             FILTERS.end(),
+                                             [&journal](const auto& filter)
+                                             {
+                                                 try
+                                                 {
+                                                     return filter.Matches(journal.GetData(filter.field));
+                                                 }
+                                                 catch (const JournalLogException&)
+                                                 {
+                                                     return false;
+                                                 }
+                                             });
+
+            if (matches)
+            {
+                journal.GetData("MESSAGE");
+                ++count;
+            }
+        }
+
+        return count;
+    }
+
+    /// @brief Selects the entries with the filters compiled into journal matches.
+    std::size_t ReadCompiled(const std::string& directory)
+    {
+        JournalLog journal;
+        journal.OpenDirectory(directory);
+        journal.AddFilterGroup(FILTERS, false);
+        journal.SeekHead();
+
+        std::size_t count = 0;
+
+        while (journal.GetNextFilteredMessage(false))
+        {
+            ++count;
+        }
+
+        return count;
+    }
+
+    /// @brief Runs a reader and prints the time it takes.
+    void Measure(const std::string& name, std::size_t (*read)(const std::string&), const std::string& directory)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const auto count = read(directory);
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << name << ": " << count << " matching entries in " << seconds << " s\n";
+    }
+} // namespace
+
+/// @brief Measures journal filtering. Usage: benchmark_JournalLog [number of entries | journal directory]
+///
+/// Without a directory, a synthetic journal is generated with systemd-journal-remote.
+int main(int argc, char** argv)
+{
+    const std::string argument = argc > 1 ? argv[1] : "";
+    auto directory = argument;
+
+    if (argument.empty() || !std::filesystem::is_directory(argument))
+    {
+        const std::size_t entries = argument.empty() ? DEFAULT_ENTRIES : std::stoul(argument);
+
+        if (!CreateJournal(entries))
+        {
+            std::cerr << "Cannot create the journal, " << JOURNAL_REMOTE << " is needed\n";
+            std::filesystem::remove_all(BENCHMARK_DIR);
+            return 1;
+        }
+
+        directory = BENCHMARK_DIR;
+    }
+
+    // Read once so that both readers find the journal in the page cache
+    ReadCompiled(directory);
+
+    Measure("GetData", ReadLegacy, directory);
+    Measure("Journal matches", ReadCompiled, directory);
+
+    if (directory == BENCHMARK_DIR)
+    {
+        std::filesystem::remove_all(BENCHMARK_DIR);
+    }
+
+    return 0;
+}
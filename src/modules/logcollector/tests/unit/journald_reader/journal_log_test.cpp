@@ -69,6 +69,30 @@ TEST_F(JournalLogTests, FilterMatching)
     }
 }
 
+TEST_F(JournalLogTests, FilterCompilation)
+{
+    const FilterGroup group {{"_SYSTEMD_UNIT", "cron.service|ssh.service", true},
+                             {"PRIORITY", "3", true},
+                             {"PRIORITY", "4", true},
+                             {"SYSLOG_IDENTIFIER", "sys", false},
+                             {"lowercase", "value", true}};
+
+    const auto compiled = JournalLog::CompileFilterGroup(group);
+
+    EXPECT_THAT(compiled.matches,
+                ElementsAre("_SYSTEMD_UNIT=cron.service", "_SYSTEMD_UNIT=ssh.service", "PRIORITY=3"));
+    ASSERT_EQ(compiled.journalFilters.size(), 2);
+    EXPECT_EQ(compiled.journalFilters[0].values, (std::vector<std::string> {"cron.service", "ssh.service"}));
+
+    // A second exact filter on the same field would be combined with OR logic by the journal
+    ASSERT_EQ(compiled.entryFilters.size(), 3);
+    EXPECT_EQ(compiled.entryFilters[0].field, "PRIORITY");
+    EXPECT_EQ(compiled.entryFilters[1].field, "SYSLOG_IDENTIFIER");
+    EXPECT_TRUE(compiled.entryFilters[1].Matches("systemd"));
+    EXPECT_FALSE(compiled.entryFilters[1].Matches("kernel"));
+    EXPECT_EQ(compiled.entryFilters[2].field, "lowercase");
+}
+
 TEST_F(JournalLogTests, BasicJournalOperations)
 {
     auto group = CreateBasicFilterGroup();
@@ -101,8 +125,7 @@ TEST_F(JournalLogTests, MessageProcessing)
     auto group = CreateBasicFilterGroup();
     journal->AddFilterGroup(group, true);
 
-    const FilterSet filters {group};
-    auto message = journal->GetNextFilteredMessage(filters, true);
+    auto message = journal->GetNextFilteredMessage(true);
 
     if (message)
     {
@@ -117,4 +140,15 @@ TEST_F(JournalLogTests, ErrorHandling)
 
     const FilterGroup invalidGroup {{"", "value", true}};
     EXPECT_THROW(journal->AddFilterGroup(invalidGroup, false), JournalLogException);
+
+    const FilterGroup invalidFieldGroup {{"lowercase", "value", true}};
+    EXPECT_THROW(journal->AddFilterGroup(invalidFieldGroup, false), JournalLogException);
+    EXPECT_NO_THROW(journal->AddFilterGroup(invalidFieldGroup, true));
+}
+
+TEST_F(JournalLogTests, ChangeNotification)
+{
+    EXPECT_GE(journal->GetFileDescriptor(), 0);
+    EXPECT_NO_THROW(journal->NeedsPolling());
+    EXPECT_NO_THROW(journal->ProcessChanges());
 }
@@ -22,6 +22,7 @@ protected:
     JournaldReader CreateReader()
     {
         auto dummyPush = [](const std::string&, const std::string&, const std::string&) {
+            return true;
         };
         auto dummyWait = [](std::chrono::milliseconds) -> Awaitable
         {
@@ -64,6 +65,7 @@ TEST_F(JournaldReaderTests, FilterHandling)
         {{{"UNIT", "service1", true}, {"PRIORITY", "3|4|5", true}}, "2 conditions"}};
 
     auto dummyPush = [](const std::string&, const std::string&, const std::string&) {
+        return true;
     };
     auto dummyWait = [](std::chrono::milliseconds) -> Awaitable
     {
@@ -0,0 +1,106 @@
+#include <file_reader.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace logcollector;
+
+namespace
+{
+    const std::string BENCHMARK_FILE_NAME = "benchmark_line_reader.log";
+    constexpr std::size_t DEFAULT_FILE_SIZE_MB = 2048;
+    constexpr std::size_t BYTES_PER_MB = 1024 * 1024;
+    constexpr std::streamsize LEGACY_BUFFER_SIZE = 4096;
+
+    /// @brief Writes a file of access log lines of about the given size.
+    void CreateFile(std::size_t size)
+    {
+        std::ofstream file(BENCHMARK_FILE_NAME, std::ios::binary);
+        std::string chunk;
+
+        for (int i = 0; chunk.size() < BYTES_PER_MB; ++i)
+        {
+            chunk += "192.168.0." + std::to_string(i % 256) + " - - [01/Jan/2025:00:00:" + std::to_string(i % 60) +
+                     " +0000] \"GET /index.html?id=" + std::to_string(i) +
+                     " HTTP/1.1\" 200 5120 \"-\" \"Mozilla/5.0 (X11; Linux x86_64)\"\n";
+        }
+
+        for (std::size_t written = 0; written < size; written += chunk.size())
+        {
+            file.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        }
+    }
+
+    /// @brief Reads the file the way Localfile::NextLog used to: a buffer per line, getline and tellg.
+    std::size_t ReadLegacy()
+    {
+        std::ifstream stream(BENCHMARK_FILE_NAME);
+        std::streampos pos;
+        std::size_t bytes = 0;
+
+        while (true)
+        {
+            auto buffer = std::vector<char>(LEGACY_BUFFER_SIZE);
+
+            if (!stream.getline(buffer.data(), LEGACY_BUFFER_SIZE).good())
+            {
+                stream.seekg(pos);
+                stream.clear();
+                break;
+            }
+
+            pos = stream.tellg();
+            bytes += static_cast<std::size_t>(stream.gcount());
+        }
+
+        return bytes;
+    }
+
+    /// @brief Reads the file with Localfile.
+    std::size_t ReadLocalfile()
+    {
+        Localfile lf(BENCHMARK_FILE_NAME);
+        std::size_t bytes = 0;
+
+        for (auto log = lf.NextLog(); !log.empty(); log = lf.NextLog())
+        {
+            bytes += log.size() + 1;
+        }
+
+        return bytes;
+    }
+
+    /// @brief Runs a reader and prints its throughput.
+    void Measure(const std::string& name, std::size_t (*read)())
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const auto bytes = read();
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << name << ": " << bytes / BYTES_PER_MB << " MB in " << seconds << " s ("
+                  << static_cast<double>(bytes) / BYTES_PER_MB / seconds << " MB/s)\n";
+    }
+} // namespace
+
+/// @brief Measures Localfile read throughput. Usage: benchmark_LineReader [file size in MB]
+int main(int argc, char** argv)
+{
+    const std::size_t sizeMb = argc > 1 ? std::stoul(argv[1]) : DEFAULT_FILE_SIZE_MB;
+
+    CreateFile(sizeMb * BYTES_PER_MB);
+
+    // Read once so that both readers find the file in the page cache
+    ReadLocalfile();
+
+    Measure("getline", ReadLegacy);
+    Measure("LineReader", ReadLocalfile);
+
+    std::filesystem::remove(BENCHMARK_FILE_NAME);
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include <line_reader.hpp>
+
+using namespace logcollector;
+
+TEST(LineReader, SplitsLines)
+{
+    std::stringstream stream("first\nsecond\n\nthird\n");
+    LineReader reader(1024); // NOLINT
+
+    EXPECT_EQ(reader.NextLine(stream), "first");
+    EXPECT_EQ(reader.NextLine(stream), "second");
+    EXPECT_EQ(reader.NextLine(stream), "");
+    EXPECT_EQ(reader.NextLine(stream), "third");
+    EXPECT_FALSE(reader.NextLine(stream).has_value());
+    EXPECT_EQ(reader.Offset(), 20);
+}
+
+TEST(LineReader, KeepsPartialLineUntilTerminated)
+{
+    std::stringstream stream;
+    LineReader reader(1024); // NOLINT
+
+    stream << "Hello";
+    EXPECT_FALSE(reader.NextLine(stream).has_value());
+
+    stream << " World";
+    EXPECT_FALSE(reader.NextLine(stream).has_value());
+
+    stream << "\nNext";
+    EXPECT_EQ(reader.NextLine(stream), "Hello World");
+    EXPECT_FALSE(reader.NextLine(stream).has_value());
+}
+
+TEST(LineReader, CarriesLinesAcrossBlocks)
+{
+    std::stringstream stream("abc\ndefgh\nij\nklmnopq\n");
+    LineReader reader(8); // NOLINT
+
+    EXPECT_EQ(reader.NextLine(stream), "abc");
+    EXPECT_EQ(reader.NextLine(stream), "defgh");
+    EXPECT_EQ(reader.NextLine(stream), "ij");
+    EXPECT_EQ(reader.NextLine(stream), "klmnopq");
+    EXPECT_FALSE(reader.NextLine(stream).has_value());
+}
+
+TEST(LineReader, SplitsLinesLongerThanBuffer)
+{
+    std::stringstream stream("abcdefghij\n");
+    LineReader reader(4); // NOLINT
+
+    EXPECT_EQ(reader.NextLine(stream), "abcd");
+    EXPECT_EQ(reader.NextLine(stream), "efgh");
+    EXPECT_EQ(reader.NextLine(stream), "ij");
+    EXPECT_FALSE(reader.NextLine(stream).has_value());
+}
+
+TEST(LineReader, ResetDiscardsBufferedData)
+{
+    std::stringstream stream;
+    LineReader reader(1024); // NOLINT
+
+    stream << "partial";
+    EXPECT_FALSE(reader.NextLine(stream).has_value());
+    EXPECT_EQ(reader.Offset(), 7);
+
+    stream.seekg(0, std::ios::end);
+    reader.Reset(stream.tellg());
+    stream << "line\n";
+
+    EXPECT_EQ(reader.NextLine(stream), "line");
+    EXPECT_EQ(reader.Offset(), 12);
+}
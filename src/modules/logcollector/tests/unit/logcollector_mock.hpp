@@ -21,7 +21,7 @@ namespace logcollector
                     ::testing::Invoke([](std::chrono::milliseconds) -> boost::asio::awaitable<void> { co_return; }));
 
             this->SetPushMessageFunction([](Message) -> int // NOLINT(performance-unnecessary-value-param)
-                                         { return 0; });
+                                         { return 1; });
         }
 
         void SetupFileReader(std::shared_ptr<const configuration::ConfigurationParser> configurationParser)
@@ -29,6 +29,11 @@ namespace logcollector
             Logcollector::SetupFileReader(configurationParser);
         }
 
+        bool PushMessageOrDrop(const std::string& location, const std::string& log, const std::string& collectorType)
+        {
+            return Logcollector::PushMessageOrDrop(location, log, collectorType);
+        }
+
         MOCK_METHOD(void, AddReader, (std::shared_ptr<IReader> reader), (override));
         MOCK_METHOD(void, EnqueueTask, (Awaitable task), (override));
         MOCK_METHOD(boost::asio::awaitable<void>, Wait, (std::chrono::milliseconds ms), (override));
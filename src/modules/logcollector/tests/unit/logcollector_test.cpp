@@ -19,6 +19,7 @@ TEST(Logcollector, AddReader)
     auto logcollector = LogcollectorMock();
     auto a = TempFile("/tmp/A.log");
     auto dummyPush = [](const std::string&, const std::string&, const std::string&) {
+        return true;
     };
     auto dummyWait = [](std::chrono::milliseconds) -> Awaitable
     {
@@ -112,6 +113,91 @@ TEST(Logcollector, PushMessageApp)
     ASSERT_EQ(capturedMessage.metaData, METADATA);
 }
 
+TEST(Logcollector, PushMessageReportsFullQueue)
+{
+    PushMessageMock mock;
+    LogcollectorMock logcollector;
+
+    logcollector.SetPushMessageFunction([&mock](Message message) { return mock.Call(std::move(message)); });
+
+    EXPECT_CALL(mock, Call(::testing::_)).WillOnce(::testing::Return(0)).WillOnce(::testing::Return(1));
+
+    ASSERT_FALSE(logcollector.PushMessage("/test/location", "test log", "file"));
+    ASSERT_TRUE(logcollector.PushMessage("/test/location", "test log", "file"));
+
+    const auto statistics = logcollector.GetStatistics();
+    ASSERT_EQ(statistics.blocked, 1);
+    ASSERT_EQ(statistics.throttled, 0);
+    ASSERT_EQ(statistics.dropped, 0);
+}
+
+TEST(Logcollector, PushMessageKeepsRateTokenIfQueueIsFull)
+{
+    auto constexpr CONFIG_RAW = R"(
+    logcollector:
+      max_eps: 1
+    )";
+
+    PushMessageMock mock;
+    LogcollectorMock logcollector;
+    logcollector.Setup(std::make_shared<configuration::ConfigurationParser>(std::string(CONFIG_RAW)));
+    logcollector.SetPushMessageFunction([&mock](Message message) { return mock.Call(std::move(message)); });
+
+    EXPECT_CALL(mock, Call(::testing::_)).WillOnce(::testing::Return(0)).WillOnce(::testing::Return(1));
+
+    ASSERT_FALSE(logcollector.PushMessage("/test/location", "test log", "file"));
+    ASSERT_TRUE(logcollector.PushMessage("/test/location", "test log", "file"));
+    ASSERT_FALSE(logcollector.PushMessage("/test/location", "test log", "file"));
+
+    const auto statistics = logcollector.GetStatistics();
+    ASSERT_EQ(statistics.blocked, 1);
+    ASSERT_EQ(statistics.throttled, 1);
+}
+
+TEST(Logcollector, PushMessageLimitsBySource)
+{
+    auto constexpr CONFIG_RAW = R"(
+    logcollector:
+      max_eps: 1
+    )";
+
+    LogcollectorMock logcollector;
+    logcollector.Setup(std::make_shared<configuration::ConfigurationParser>(std::string(CONFIG_RAW)));
+    logcollector.SetPushMessageFunction([](Message) { return 1; }); // NOLINT(performance-unnecessary-value-param)
+
+    ASSERT_TRUE(logcollector.PushMessage("cron.service", "test log", "journald", "journald#0"));
+    ASSERT_FALSE(logcollector.PushMessage("sshd.service", "test log", "journald", "journald#0"));
+    ASSERT_TRUE(logcollector.PushMessage("sshd.service", "test log", "journald", "journald#1"));
+}
+
+TEST(Logcollector, PushMessageOrDropIsNotRateLimited)
+{
+    auto constexpr CONFIG_RAW = R"(
+    logcollector:
+      max_eps: 1
+    )";
+
+    PushMessageMock mock;
+    LogcollectorMock logcollector;
+    logcollector.Setup(std::make_shared<configuration::ConfigurationParser>(std::string(CONFIG_RAW)));
+    logcollector.SetPushMessageFunction([&mock](Message message) { return mock.Call(std::move(message)); });
+
+    EXPECT_CALL(mock, Call(::testing::_))
+        .WillOnce(::testing::Return(1))
+        .WillOnce(::testing::Return(1))
+        .WillOnce(::testing::Return(0));
+
+    ASSERT_TRUE(logcollector.PushMessageOrDrop("System", "test log", "windows-eventlog"));
+    ASSERT_TRUE(logcollector.PushMessageOrDrop("System", "test log", "windows-eventlog"));
+    ASSERT_FALSE(logcollector.PushMessageOrDrop("System", "test log", "windows-eventlog"));
+
+    // A log lost by a full queue is only counted as dropped
+    const auto statistics = logcollector.GetStatistics();
+    ASSERT_EQ(statistics.dropped, 1);
+    ASSERT_EQ(statistics.blocked, 0);
+    ASSERT_EQ(statistics.throttled, 0);
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -15,6 +15,7 @@
 namespace
 {
     const auto DUMMY_PUSH = [](const std::string&, const std::string&, const std::string&) {
+        return true;
     };
     const auto DUMMY_WAIT = [](std::chrono::milliseconds) -> logcollector::Awaitable
     {
@@ -151,6 +152,7 @@ namespace macos_reader_tests
             EXPECT_THAT(dumpedData, ::testing::HasSubstr("2023-01-01T00"));
             EXPECT_THAT(dumpedData, ::testing::HasSubstr("Sample log message "));
             macOSReader->Stop();
+            return true;
         };
 
         macOSReader =
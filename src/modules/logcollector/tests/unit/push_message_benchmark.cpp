@@ -0,0 +1,88 @@
+#include <logcollector.hpp>
+
+#include <file_reader.hpp>
+#include <timeHelper.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+using namespace logcollector;
+
+namespace
+{
+    constexpr std::size_t DEFAULT_MESSAGES = 1000000;
+    const std::string LOCATION = "/var/log/auth.log";
+    const std::string LOG = "2025-01-22T18:45:01.555243-03:00 box CRON[23505]: pam_unix(cron:session): session "
+                            "closed for user root";
+
+    /// @brief Builds the messages the way Logcollector::PushMessage used to.
+    class LegacyLogcollector
+    {
+    public:
+        explicit LegacyLogcollector(std::function<int(Message)> pushMessage)
+            : m_pushMessage(std::move(pushMessage))
+        {
+        }
+
+        void PushMessage(const std::string& location, const std::string& log, const std::string& collectorType)
+        {
+            auto metadata = nlohmann::json::object();
+            auto data = nlohmann::json::object();
+
+            metadata["module"] = m_moduleName;
+            metadata["collector"] = collectorType;
+
+            data["log"]["file"]["path"] = location;
+            data["event"]["original"] = log;
+            data["event"]["created"] = Utils::getCurrentISO8601();
+
+            auto message = Message(MessageType::STATELESS, data, m_moduleName, collectorType, metadata.dump());
+            m_pushMessage(message);
+        }
+
+    private:
+        const std::string m_moduleName = "logcollector";
+        std::function<int(Message)> m_pushMessage;
+    };
+
+    /// @brief Pushes the messages and prints the time it takes.
+    template<typename T>
+    void Measure(const std::string& name, T& logcollector, std::size_t messages)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        for (std::size_t i = 0; i < messages; ++i)
+        {
+            logcollector.PushMessage(LOCATION, LOG, FILE_READER_TYPE);
+        }
+
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << name << ": " << messages << " messages in " << seconds << " s ("
+                  << seconds * 1e9 / static_cast<double>(messages) << " ns/message)\n"; // NOLINT
+    }
+} // namespace
+
+/// @brief Measures the construction of file messages. Usage: benchmark_PushMessage [number of messages]
+int main(int argc, char** argv)
+{
+    const std::size_t messages = argc > 1 ? std::stoul(argv[1]) : DEFAULT_MESSAGES;
+    std::size_t size = 0;
+
+    // The queue takes the message by value, like the agent's push function
+    const auto pushMessage = [&size](Message message) // NOLINT(performance-unnecessary-value-param)
+    {
+        size += message.metaData.size() + message.data.size();
+        return 1;
+    };
+
+    LegacyLogcollector legacy(pushMessage);
+    Logcollector logcollector;
+    logcollector.SetPushMessageFunction(pushMessage);
+
+    Measure("Legacy", legacy, messages);
+    Measure("PushMessage", logcollector, messages);
+
+    return size > 0 ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+
+#include <rate_limiter.hpp>
+
+using namespace logcollector;
+
+TEST(RateLimiter, UnlimitedWithoutRate)
+{
+    RateLimiter limiter(0);
+    const auto now = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < 1000; ++i) // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    {
+        ASSERT_TRUE(limiter.TryAcquire("source", now));
+    }
+}
+
+TEST(RateLimiter, LimitsEachSourceToItsRate)
+{
+    RateLimiter limiter(10); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    const auto now = std::chrono::steady_clock::now();
+
+    // A burst of one second of events is let through
+    for (int i = 0; i < 10; ++i) // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    {
+        ASSERT_TRUE(limiter.TryAcquire("noisy", now));
+    }
+
+    EXPECT_FALSE(limiter.TryAcquire("noisy", now));
+
+    // Other sources keep their own tokens
+    EXPECT_TRUE(limiter.TryAcquire("quiet", now));
+
+    // Tokens are refilled at the rate
+    const auto later = now + std::chrono::milliseconds(250); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    EXPECT_TRUE(limiter.TryAcquire("noisy", later));
+    EXPECT_TRUE(limiter.TryAcquire("noisy", later));
+    EXPECT_FALSE(limiter.TryAcquire("noisy", later));
+}
+
+TEST(RateLimiter, LetsEventsThroughBelowOnePerSecond)
+{
+    RateLimiter limiter(0.5); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    const auto now = std::chrono::steady_clock::now();
+
+    EXPECT_TRUE(limiter.TryAcquire("source", now));
+    EXPECT_FALSE(limiter.TryAcquire("source", now + std::chrono::seconds(1)));
+    EXPECT_TRUE(limiter.TryAcquire("source", now + std::chrono::seconds(2)));
+}
+
+TEST(RateLimiter, ReleaseGivesTokenBack)
+{
+    RateLimiter limiter(1);
+    const auto now = std::chrono::steady_clock::now();
+
+    EXPECT_TRUE(limiter.TryAcquire("source", now));
+    limiter.Release("source");
+    EXPECT_TRUE(limiter.TryAcquire("source", now));
+    EXPECT_FALSE(limiter.TryAcquire("source", now));
+
+    // A bucket never holds more than its capacity
+    limiter.Release("source");
+    limiter.Release("source");
+    EXPECT_TRUE(limiter.TryAcquire("source", now));
+    EXPECT_FALSE(limiter.TryAcquire("source", now));
+}
+
+TEST(RateLimiter, DropsBucketsOfIdleSources)
+{
+    RateLimiter limiter(10); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    const auto now = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < 100; ++i) // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    {
+        ASSERT_TRUE(limiter.TryAcquire("app-" + std::to_string(i) + ".log", now));
+    }
+
+    EXPECT_EQ(limiter.Sources(), 100);
+
+    // Only the source still sending keeps a bucket once the others are full again
+    const auto later = now + std::chrono::seconds(2);
+    EXPECT_TRUE(limiter.TryAcquire("app-100.log", later));
+    EXPECT_EQ(limiter.Sources(), 1);
+}
+
+TEST(RateLimiter, KeepsBucketsOfBusySources)
+{
+    RateLimiter limiter(10); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    const auto now = std::chrono::steady_clock::now();
+
+    EXPECT_TRUE(limiter.TryAcquire("quiet", now));
+
+    for (int i = 0; i < 10; ++i) // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    {
+        ASSERT_TRUE(limiter.TryAcquire("noisy", now));
+    }
+
+    const auto soon = now + std::chrono::milliseconds(500); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    for (int i = 0; i < 5; ++i)                             // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    {
+        ASSERT_TRUE(limiter.TryAcquire("noisy", soon));
+    }
+
+    // The idle source is dropped, the busy one keeps its partly refilled bucket and stays limited
+    const auto later = now + std::chrono::milliseconds(1250); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    for (int i = 0; i < 7; ++i)                               // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    {
+        ASSERT_TRUE(limiter.TryAcquire("noisy", later));
+    }
+
+    EXPECT_FALSE(limiter.TryAcquire("noisy", later));
+    EXPECT_EQ(limiter.Sources(), 1);
+}
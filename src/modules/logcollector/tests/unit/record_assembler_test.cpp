@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <regex>
+
+#include <record_assembler.hpp>
+
+using namespace logcollector;
+
+namespace
+{
+    MultilineConfig MakeConfig(MultilineMode mode, std::size_t maxSize = 1024) // NOLINT
+    {
+        MultilineConfig config;
+        config.mode = mode;
+        config.startPattern = std::make_shared<const std::regex>("^\\d{4}-\\d{2}-\\d{2}", std::regex::optimize);
+        config.timeout = std::chrono::milliseconds(100); // NOLINT
+        config.maxSize = maxSize;
+        return config;
+    }
+} // namespace
+
+TEST(RecordAssembler, JoinsLinesUntilNextStartPattern)
+{
+    RecordAssembler assembler(MakeConfig(MultilineMode::Regex));
+
+    EXPECT_FALSE(assembler.Add("2025-01-01 Exception", 0).has_value());
+    EXPECT_FALSE(assembler.Add("  at Foo.bar()", 21).has_value());
+    EXPECT_FALSE(assembler.Add("  at Foo.main()", 36).has_value());
+    EXPECT_EQ(assembler.Add("2025-01-01 Next", 52), "2025-01-01 Exception\n  at Foo.bar()\n  at Foo.main()");
+    EXPECT_EQ(assembler.Flush(), "2025-01-01 Next");
+    EXPECT_FALSE(assembler.Flush().has_value());
+}
+
+TEST(RecordAssembler, JoinsIndentedLines)
+{
+    RecordAssembler assembler(MakeConfig(MultilineMode::Indent));
+
+    EXPECT_FALSE(assembler.Add("Traceback:", 0).has_value());
+    EXPECT_FALSE(assembler.Add("\tFile \"a.py\"", 11).has_value());
+    EXPECT_FALSE(assembler.Add("    raise Error", 24).has_value());
+    EXPECT_EQ(assembler.Add("Error: failed", 40), "Traceback:\n\tFile \"a.py\"\n    raise Error");
+    EXPECT_EQ(assembler.Flush(), "Error: failed");
+}
+
+TEST(RecordAssembler, JoinsJsonDocuments)
+{
+    RecordAssembler assembler(MakeConfig(MultilineMode::Json));
+
+    EXPECT_EQ(assembler.Add("plain line", 0), "plain line");
+    EXPECT_FALSE(assembler.Add("{", 11).has_value());
+    EXPECT_FALSE(assembler.Add("  \"text\": \"not a } brace\",", 13).has_value());
+    EXPECT_FALSE(assembler.Add("  \"nested\": {\"a\": 1}", 40).has_value());
+    EXPECT_EQ(assembler.Add("}", 61), "{\n  \"text\": \"not a } brace\",\n  \"nested\": {\"a\": 1}\n}");
+    EXPECT_EQ(assembler.Add("{\"single\": true}", 63), "{\"single\": true}");
+    EXPECT_FALSE(assembler.PendingOffset().has_value());
+}
+
+TEST(RecordAssembler, FlushesAfterTimeout)
+{
+    RecordAssembler assembler(MakeConfig(MultilineMode::Regex));
+
+    EXPECT_FALSE(assembler.FlushIfExpired(std::chrono::steady_clock::now()).has_value());
+
+    assembler.Add("2025-01-01 Last record", 0);
+    assembler.Add("  continued", 23);
+
+    EXPECT_FALSE(assembler.FlushIfExpired(std::chrono::steady_clock::now()).has_value());
+    EXPECT_EQ(assembler.FlushIfExpired(std::chrono::steady_clock::now() + std::chrono::seconds(1)),
+              "2025-01-01 Last record\n  continued");
+    EXPECT_FALSE(assembler.Flush().has_value());
+}
+
+TEST(RecordAssembler, TracksOffsetOfPendingRecord)
+{
+    RecordAssembler assembler(MakeConfig(MultilineMode::Regex));
+
+    EXPECT_FALSE(assembler.PendingOffset().has_value());
+
+    assembler.Add("2025-01-01 First", 0);
+    assembler.Add("  continued", 17);
+    EXPECT_EQ(assembler.PendingOffset(), 0);
+
+    assembler.Add("2025-01-01 Second", 29);
+    EXPECT_EQ(assembler.PendingOffset(), 29);
+
+    assembler.Flush();
+    EXPECT_FALSE(assembler.PendingOffset().has_value());
+}
+
+TEST(RecordAssembler, SplitsRecordsLongerThanMaxSize)
+{
+    RecordAssembler assembler(MakeConfig(MultilineMode::Regex, 16)); // NOLINT
+
+    EXPECT_FALSE(assembler.Add("2025-01-01 Head", 0).has_value());
+    EXPECT_EQ(assembler.Add("  long continuation", 16), "2025-01-01 Head");
+    EXPECT_EQ(assembler.Flush(), "  long continuation");
+}
@@ -0,0 +1,28 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <regex>
+
+#include <timestamp_cache.hpp>
+
+using namespace logcollector;
+using namespace std::chrono;
+
+TEST(TimestampCache, FormatsIso8601)
+{
+    TimestampCache timestamps;
+    const auto time = sys_days {year {2025} / January / 22} + hours {21} + minutes {45} + seconds {1} + milliseconds {16};
+
+    EXPECT_EQ(timestamps.Format(time), "2025-01-22T21:45:01.016Z");
+    EXPECT_EQ(timestamps.Format(time + milliseconds {900}), "2025-01-22T21:45:01.916Z");
+    EXPECT_EQ(timestamps.Format(time + seconds {1}), "2025-01-22T21:45:02.016Z");
+    EXPECT_EQ(timestamps.Format(time - days {22}), "2024-12-31T21:45:01.016Z");
+}
+
+TEST(TimestampCache, FormatsCurrentTime)
+{
+    TimestampCache timestamps;
+    const std::regex iso8601(R"(^\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}\.\d{3}Z$)");
+
+    EXPECT_TRUE(std::regex_match(timestamps.Now(), iso8601));
+}
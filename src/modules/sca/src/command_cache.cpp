@@ -0,0 +1,46 @@
+#include <command_cache.hpp>
+
+#include <utility>
+
+CommandCache::CommandCache(std::size_t maxSize, CommandExecFunc commandExecFunc)
+    : m_commandExecFunc(commandExecFunc ? std::move(commandExecFunc) : Utils::Exec)
+    , m_maxSize(maxSize)
+{
+}
+
+void CommandCache::StartScan(const std::string& policyId)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_scannedPolicies.insert(policyId).second)
+    {
+        m_results.clear();
+        m_size = 0;
+        m_scannedPolicies = {policyId};
+    }
+}
+
+std::optional<Utils::ExecResult> CommandCache::Exec(const std::string& command)
+{
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (const auto it = m_results.find(command); it != m_results.end())
+        {
+            return it->second;
+        }
+    }
+
+    // The command runs unlocked, so that other commands are not held up by it
+    auto result = m_commandExecFunc(command);
+    const auto size = command.size() + (result ? result->StdOut.size() + result->StdErr.size() : 0);
+
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_size + size <= m_maxSize && m_results.emplace(command, result).second)
+    {
+        m_size += size;
+    }
+
+    return result;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cmdHelper.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+/// @brief Results of the commands run by the command rules of a round of policy scans
+///
+/// Policies often run the same commands many times, in several checks and in
+/// several policies. The first run of a command line is cached, and later runs
+/// in the same round of scans take its result from the cache. A round ends when
+/// a policy that already scanned in it starts a new scan.
+class CommandCache
+{
+public:
+    /// @brief Function that runs a command and returns its result
+    using CommandExecFunc = std::function<std::optional<Utils::ExecResult>(const std::string&)>;
+
+    /// @brief Constructor
+    /// @param maxSize Maximum size in bytes of the cached command lines and outputs
+    /// @param commandExecFunc Function to run the commands, or nullptr to run them with Utils::Exec
+    explicit CommandCache(std::size_t maxSize, CommandExecFunc commandExecFunc = nullptr);
+
+    /// @brief Notifies that a policy starts a scan, discarding the cached results if a new round starts
+    /// @param policyId Policy ID
+    void StartScan(const std::string& policyId);
+
+    /// @brief Runs a command, or takes its result from the cache
+    /// @param command Command line
+    /// @return The result of the command, or nothing if it could not be run
+    std::optional<Utils::ExecResult> Exec(const std::string& command);
+
+private:
+    /// @brief Function to run the commands
+    CommandExecFunc m_commandExecFunc;
+
+    /// @brief Maximum size in bytes of the cached command lines and outputs
+    std::size_t m_maxSize;
+
+    /// @brief Size in bytes of the cached command lines and outputs
+    std::size_t m_size = 0;
+
+    /// @brief Results by command line
+    std::unordered_map<std::string, std::optional<Utils::ExecResult>> m_results;
+
+    /// @brief Policies that scanned in the current round
+    std::unordered_set<std::string> m_scannedPolicies;
+
+    /// @brief Mutex to protect the cache
+    std::mutex m_mutex;
+};
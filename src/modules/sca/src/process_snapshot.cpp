@@ -0,0 +1,72 @@
+#include <process_snapshot.hpp>
+
+#include <sysInfo.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+    /// @brief Reads the names of the running processes
+    ///
+    /// On Linux, only the name of each process is read from /proc. Elsewhere,
+    /// the names are taken from the process information of the system.
+    ///
+    /// @return Process names
+    std::unordered_set<std::string> ReadProcessNames()
+    {
+        std::unordered_set<std::string> names;
+
+#if defined(__linux__)
+        for (const auto& entry : std::filesystem::directory_iterator("/proc"))
+        {
+            const auto pid = entry.path().filename().string();
+
+            if (pid.find_first_not_of("0123456789") != std::string::npos)
+            {
+                continue;
+            }
+
+            // The process may have exited since the directory was listed
+            std::ifstream comm(entry.path() / "comm");
+            std::string name;
+
+            if (std::getline(comm, name))
+            {
+                names.insert(std::move(name));
+            }
+        }
+#else
+        SysInfo().processes(
+            [&names](nlohmann::json& procJson)
+            {
+                if (procJson.contains("name") && procJson["name"].is_string())
+                {
+                    names.insert(procJson["name"].get<std::string>());
+                }
+            });
+#endif
+
+        return names;
+    }
+} // namespace
+
+ProcessSnapshot::ProcessSnapshot(GetProcessNamesFunc getProcessNames)
+    : m_getProcessNames(getProcessNames ? std::move(getProcessNames) : ReadProcessNames)
+{
+}
+
+void ProcessSnapshot::Reset()
+{
+    m_names.reset();
+}
+
+bool ProcessSnapshot::Contains(const std::string& name)
+{
+    if (!m_names)
+    {
+        m_names = m_getProcessNames();
+    }
+
+    return m_names->contains(name);
+}
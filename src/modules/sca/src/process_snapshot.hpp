@@ -0,0 +1,37 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_set>
+
+/// @brief Names of the running processes, shared by the process rules of a policy scan
+///
+/// The names are read on the first lookup after a reset, so a scan walks the
+/// process list once no matter how many process rules it evaluates.
+class ProcessSnapshot
+{
+public:
+    /// @brief Function that returns the names of the running processes
+    using GetProcessNamesFunc = std::function<std::unordered_set<std::string>()>;
+
+    /// @brief Constructor
+    /// @param getProcessNames Function to read the process names, or nullptr to read them from the system
+    explicit ProcessSnapshot(GetProcessNamesFunc getProcessNames = nullptr);
+
+    /// @brief Discards the names read, so that the next lookup reads them again
+    void Reset();
+
+    /// @brief Checks if a process is running
+    /// @param name Process name
+    /// @return True if a process with that name was running when the names were read
+    /// @throws std::exception if the process names cannot be read
+    bool Contains(const std::string& name);
+
+private:
+    /// @brief Function to read the process names
+    GetProcessNamesFunc m_getProcessNames;
+
+    /// @brief Process names, if read since the last reset
+    std::optional<std::unordered_set<std::string>> m_names;
+};
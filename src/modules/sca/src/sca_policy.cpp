@@ -9,10 +9,16 @@
 #include <boost/asio/this_coro.hpp>
 #include <boost/asio/use_awaitable.hpp>
 
-SCAPolicy::SCAPolicy(std::string id, Check requirements, std::vector<Check> checks)
+SCAPolicy::SCAPolicy(std::string id,
+                     Check requirements,
+                     std::vector<Check> checks,
+                     std::shared_ptr<ProcessSnapshot> processSnapshot,
+                     std::shared_ptr<CommandCache> commandCache)
     : m_id(std::move(id))
     , m_requirements(std::move(requirements))
     , m_checks(std::move(checks))
+    , m_processSnapshot(std::move(processSnapshot))
+    , m_commandCache(std::move(commandCache))
 {
 }
 
@@ -20,6 +26,8 @@ SCAPolicy::SCAPolicy(SCAPolicy&& other) noexcept
     : m_id(std::move(other.m_id))
     , m_requirements(std::move(other.m_requirements))
     , m_checks(std::move(other.m_checks))
+    , m_processSnapshot(std::move(other.m_processSnapshot))
+    , m_commandCache(std::move(other.m_commandCache))
     , m_keepRunning(other.m_keepRunning.load())
     , m_scanInProgress(other.m_scanInProgress.load())
 {
@@ -52,6 +60,17 @@ SCAPolicy::Run(std::time_t scanInterval,
 void SCAPolicy::Scan(
     const std::function<void(const std::string&, const std::string&, const std::string&)>& reportCheckResult)
 {
+    // The process rules of this scan share one reading of the process list
+    if (m_processSnapshot)
+    {
+        m_processSnapshot->Reset();
+    }
+
+    if (m_commandCache)
+    {
+        m_commandCache->StartScan(m_id);
+    }
+
     auto requirementsOk = sca::CheckResult::Passed;
 
     if (!m_requirements.rules.empty())
@@ -23,7 +23,16 @@ class SCAPolicy : public ISCAPolicy
 {
 public:
     /// @brief Constructor
-    explicit SCAPolicy(std::string id, Check requirements, std::vector<Check> checks);
+    /// @param id Policy id
+    /// @param requirements Requirements of the policy
+    /// @param checks Checks of the policy
+    /// @param processSnapshot Process names shared by the process rules, refreshed on each scan
+    /// @param commandCache Command results shared with the other policies, notified of each scan
+    explicit SCAPolicy(std::string id,
+                       Check requirements,
+                       std::vector<Check> checks,
+                       std::shared_ptr<ProcessSnapshot> processSnapshot = nullptr,
+                       std::shared_ptr<CommandCache> commandCache = nullptr);
 
     /// @brief Move constructor
     SCAPolicy(SCAPolicy&& other) noexcept;
@@ -46,6 +55,8 @@ private:
     std::string m_id;
     Check m_requirements;
     std::vector<Check> m_checks;
+    std::shared_ptr<ProcessSnapshot> m_processSnapshot;
+    std::shared_ptr<CommandCache> m_commandCache;
     std::atomic<bool> m_keepRunning {true};
     std::atomic<bool> m_scanInProgress {false};
 };
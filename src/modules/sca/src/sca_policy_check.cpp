@@ -9,6 +9,7 @@
 #include <sysInfo.hpp>
 #include <sysInfoInterface.hpp>
 
+#include <algorithm>
 #include <stack>
 #include <stdexcept>
 
@@ -150,11 +151,25 @@ RuleResult FileRuleEvaluator::CheckFileExistence()
 
 CommandRuleEvaluator::CommandRuleEvaluator(PolicyEvaluationContext ctx,
                                            std::unique_ptr<IFileSystemWrapper> fileSystemWrapper,
-                                           CommandExecFunc commandExecFunc)
+                                           CommandExecFunc commandExecFunc,
+                                           std::shared_ptr<CommandCache> commandCache)
     : RuleEvaluator(std::move(ctx), std::move(fileSystemWrapper))
-    , m_commandExecFunc(commandExecFunc ? std::move(commandExecFunc) : [](const std::string& cmd)
-                            { return Utils::Exec(cmd); })
+    , m_commandExecFunc(std::move(commandExecFunc))
 {
+    if (!m_commandExecFunc && commandCache)
+    {
+        m_commandExecFunc = [commandCache = std::move(commandCache)](const std::string& cmd)
+        {
+            return commandCache->Exec(cmd);
+        };
+    }
+    else if (!m_commandExecFunc)
+    {
+        m_commandExecFunc = [](const std::string& cmd)
+        {
+            return Utils::Exec(cmd);
+        };
+    }
 }
 
 RuleResult CommandRuleEvaluator::Evaluate()
@@ -396,7 +411,8 @@ RuleResult DirRuleEvaluator::CheckDirectoryExistence()
 ProcessRuleEvaluator::ProcessRuleEvaluator(PolicyEvaluationContext ctx,
                                            std::unique_ptr<IFileSystemWrapper> fileSystemWrapper,
                                            std::unique_ptr<ISysInfo> sysInfo,
-                                           GetProcessesFunc getProcesses)
+                                           GetProcessesFunc getProcesses,
+                                           std::shared_ptr<ProcessSnapshot> processSnapshot)
     : RuleEvaluator(std::move(ctx), std::move(fileSystemWrapper))
     , m_sysInfo(std::move(sysInfo))
     , m_getProcesses(getProcesses ? std::move(getProcesses) : [this]()
@@ -414,6 +430,7 @@ ProcessRuleEvaluator::ProcessRuleEvaluator(PolicyEvaluationContext ctx,
 
                          return processNames;
                      })
+    , m_processSnapshot(getProcesses ? nullptr : std::move(processSnapshot))
 {
 }
 
@@ -423,16 +440,9 @@ RuleResult ProcessRuleEvaluator::Evaluate()
 
     auto result = RuleResult::NotFound;
 
-    if (const auto processes = TryFunc([this] { return m_getProcesses(); }))
+    if (const auto running = TryFunc([this] { return IsProcessRunning(); }))
     {
-        for (const auto& process : processes.value())
-        {
-            if (process == m_ctx.rule)
-            {
-                result = RuleResult::Found;
-                break;
-            }
-        }
+        result = running.value() ? RuleResult::Found : RuleResult::NotFound;
     }
     else
     {
@@ -444,11 +454,24 @@ RuleResult ProcessRuleEvaluator::Evaluate()
     return m_ctx.isNegated ? (result == RuleResult::Found ? RuleResult::NotFound : RuleResult::Found) : result;
 }
 
+bool ProcessRuleEvaluator::IsProcessRunning()
+{
+    if (m_processSnapshot)
+    {
+        return m_processSnapshot->Contains(m_ctx.rule);
+    }
+
+    const auto processes = m_getProcesses();
+    return std::find(processes.begin(), processes.end(), m_ctx.rule) != processes.end();
+}
+
 std::unique_ptr<IRuleEvaluator>
 RuleEvaluatorFactory::CreateEvaluator(const std::string& input,
                                       std::unique_ptr<IFileSystemWrapper> fileSystemWrapper,
                                       std::unique_ptr<IFileIOUtils> fileUtils,
-                                      std::unique_ptr<ISysInfo> sysInfo)
+                                      std::unique_ptr<ISysInfo> sysInfo,
+                                      std::shared_ptr<ProcessSnapshot> processSnapshot,
+                                      std::shared_ptr<CommandCache> commandCache)
 {
     if (!fileSystemWrapper)
     {
@@ -495,10 +518,13 @@ RuleEvaluatorFactory::CreateEvaluator(const std::string& input,
         case sca::WM_SCA_TYPE_REGISTRY: return std::make_unique<RegistryRuleEvaluator>(ctx);
 #endif
         case sca::WM_SCA_TYPE_PROCESS:
-            return std::make_unique<ProcessRuleEvaluator>(ctx, std::move(fileSystemWrapper), std::move(sysInfo));
+            return std::make_unique<ProcessRuleEvaluator>(
+                ctx, std::move(fileSystemWrapper), std::move(sysInfo), nullptr, std::move(processSnapshot));
         case sca::WM_SCA_TYPE_DIR:
             return std::make_unique<DirRuleEvaluator>(ctx, std::move(fileSystemWrapper), std::move(fileUtils));
-        case sca::WM_SCA_TYPE_COMMAND: return std::make_unique<CommandRuleEvaluator>(ctx, std::move(fileSystemWrapper));
+        case sca::WM_SCA_TYPE_COMMAND:
+            return std::make_unique<CommandRuleEvaluator>(
+                ctx, std::move(fileSystemWrapper), nullptr, std::move(commandCache));
         default: return nullptr;
     }
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cmdHelper.hpp>
+#include <command_cache.hpp>
+#include <process_snapshot.hpp>
 #include <ifile_io_utils.hpp>
 #include <ifilesystem_wrapper.hpp>
 #include <sysInfoInterface.hpp>
@@ -72,9 +74,15 @@ public:
     /// @brief Function that takes a command and returns the output and error as a pair of strings.
     using CommandExecFunc = std::function<std::optional<Utils::ExecResult>(const std::string&)>;
 
+    /// @brief Constructor
+    /// @param ctx Evaluation context
+    /// @param fileSystemWrapper File system wrapper
+    /// @param commandExecFunc Function that runs the command, it takes precedence over the cache
+    /// @param commandCache Command results shared by the command rules of a round of policy scans
     CommandRuleEvaluator(PolicyEvaluationContext ctx,
                          std::unique_ptr<IFileSystemWrapper> fileSystemWrapper = nullptr,
-                         CommandExecFunc commandExecFunc = nullptr);
+                         CommandExecFunc commandExecFunc = nullptr,
+                         std::shared_ptr<CommandCache> commandCache = nullptr);
 
     RuleResult Evaluate() override;
 
@@ -104,16 +112,29 @@ class ProcessRuleEvaluator : public RuleEvaluator
 public:
     using GetProcessesFunc = std::function<std::vector<std::string>()>;
 
+    /// @brief Constructor
+    /// @param ctx Evaluation context
+    /// @param fileSystemWrapper File system wrapper
+    /// @param sysInfo System information, to list the processes when there is no snapshot
+    /// @param getProcesses Function that lists the processes, it takes precedence over the snapshot
+    /// @param processSnapshot Process names shared by the process rules of the policy scan
     ProcessRuleEvaluator(PolicyEvaluationContext ctx,
                          std::unique_ptr<IFileSystemWrapper> fileSystemWrapper = nullptr,
                          std::unique_ptr<ISysInfo> sysInfo = nullptr,
-                         GetProcessesFunc getProcesses = nullptr);
+                         GetProcessesFunc getProcesses = nullptr,
+                         std::shared_ptr<ProcessSnapshot> processSnapshot = nullptr);
 
     RuleResult Evaluate() override;
 
 private:
+    /// @brief Checks if the process of the rule is running
+    /// @return True if it is running, false if not
+    /// @throws std::exception if the processes cannot be listed
+    bool IsProcessRunning();
+
     std::unique_ptr<ISysInfo> m_sysInfo = nullptr;
     GetProcessesFunc m_getProcesses = nullptr;
+    std::shared_ptr<ProcessSnapshot> m_processSnapshot = nullptr;
 };
 
 /// @brief Subclass of RuleEvaluator that evaluates registry-related rules
@@ -162,5 +183,7 @@ public:
     CreateEvaluator(const std::string& input,
                     std::unique_ptr<IFileSystemWrapper> fileSystemWrapper = nullptr,
                     std::unique_ptr<IFileIOUtils> fileUtils = nullptr,
-                    std::unique_ptr<ISysInfo> sysInfo = nullptr);
+                    std::unique_ptr<ISysInfo> sysInfo = nullptr,
+                    std::shared_ptr<ProcessSnapshot> processSnapshot = nullptr,
+                    std::shared_ptr<CommandCache> commandCache = nullptr);
 };
@@ -4,11 +4,13 @@
 #include <sca_policy_parser.hpp>
 #include <sca_utils.hpp>
 
+#include <config.h>
 #include <dbsync.hpp>
 #include <filesystem_wrapper.hpp>
 #include <logger.hpp>
 
 #include <algorithm>
+#include <limits>
 
 SCAPolicyLoader::SCAPolicyLoader(std::shared_ptr<IFileSystemWrapper> fileSystemWrapper,
                                  std::shared_ptr<const configuration::ConfigurationParser> configurationParser,
@@ -38,6 +40,18 @@ SCAPolicyLoader::SCAPolicyLoader(std::shared_ptr<IFileSystemWrapper> fileSystemW
 
     m_customPoliciesPaths = loadPoliciesPathsFromConfig("policies");
     m_disabledPoliciesPaths = loadPoliciesPathsFromConfig("policies_disabled");
+
+    const auto commandCacheSize =
+        configurationParser->GetBytesConfigInRangeOrDefault(config::sca::DEFAULT_COMMAND_CACHE_SIZE,
+                                                            0,
+                                                            std::numeric_limits<std::size_t>::max(),
+                                                            "sca",
+                                                            "command_cache_size");
+
+    if (commandCacheSize > 0)
+    {
+        m_commandCache = std::make_shared<CommandCache>(commandCacheSize);
+    }
 }
 
 std::vector<std::unique_ptr<ISCAPolicy>> SCAPolicyLoader::LoadPolicies(const CreateEventsFunc& createEvents) const
@@ -68,7 +82,7 @@ std::vector<std::unique_ptr<ISCAPolicy>> SCAPolicyLoader::LoadPolicies(const Cre
 
                 const PolicyParser parser(path);
 
-                if (auto policy = parser.ParsePolicy(policiesAndChecks); policy)
+                if (auto policy = parser.ParsePolicy(policiesAndChecks, m_commandCache); policy)
                 {
                     policies.emplace_back(std::move(policy));
                 }
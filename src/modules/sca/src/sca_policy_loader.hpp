@@ -1,5 +1,6 @@
 #pragma once
 
+#include <command_cache.hpp>
 #include <isca_policy.hpp>
 
 #include <configuration_parser.hpp>
@@ -80,5 +81,8 @@ private:
     std::vector<std::filesystem::path> m_customPoliciesPaths;
     std::vector<std::filesystem::path> m_disabledPoliciesPaths;
 
+    /// @brief Command results shared by the loaded policies, nullptr if the cache is disabled
+    std::shared_ptr<CommandCache> m_commandCache;
+
     std::shared_ptr<IDBSync> m_dBSync;
 };
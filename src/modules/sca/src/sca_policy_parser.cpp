@@ -131,10 +131,12 @@ bool PolicyParser::IsValidYamlFile(const std::filesystem::path& filename) const
     }
 }
 
-std::unique_ptr<ISCAPolicy> PolicyParser::ParsePolicy(nlohmann::json& policiesAndChecks) const
+std::unique_ptr<ISCAPolicy> PolicyParser::ParsePolicy(nlohmann::json& policiesAndChecks,
+                                                      std::shared_ptr<CommandCache> commandCache) const
 {
     std::vector<Check> checks;
     Check requirements;
+    const auto processSnapshot = std::make_shared<ProcessSnapshot>();
 
     std::string policyId;
 
@@ -168,7 +170,8 @@ std::unique_ptr<ISCAPolicy> PolicyParser::ParsePolicy(nlohmann::json& policiesAn
             for (const auto& rule : requirementsNode["rules"])
             {
                 std::unique_ptr<IRuleEvaluator> RuleEvaluator =
-                    RuleEvaluatorFactory::CreateEvaluator(rule.as<std::string>());
+                    RuleEvaluatorFactory::CreateEvaluator(
+                        rule.as<std::string>(), nullptr, nullptr, nullptr, processSnapshot, commandCache);
                 if (RuleEvaluator != nullptr)
                 {
                     requirements.rules.push_back(std::move(RuleEvaluator));
@@ -205,7 +208,8 @@ std::unique_ptr<ISCAPolicy> PolicyParser::ParsePolicy(nlohmann::json& policiesAn
                     for (const auto& rule : checkNode["rules"])
                     {
                         const auto ruleStr = rule.as<std::string>();
-                        if (auto ruleEvaluator = RuleEvaluatorFactory::CreateEvaluator(ruleStr))
+                        if (auto ruleEvaluator = RuleEvaluatorFactory::CreateEvaluator(
+                                ruleStr, nullptr, nullptr, nullptr, processSnapshot, commandCache))
                         {
                             check.rules.push_back(std::move(ruleEvaluator));
                             checkWithValidRules["rules"].push_back(ruleStr);
@@ -236,7 +240,8 @@ std::unique_ptr<ISCAPolicy> PolicyParser::ParsePolicy(nlohmann::json& policiesAn
         return nullptr;
     }
 
-    return std::make_unique<SCAPolicy>(policyId, std::move(requirements), std::move(checks));
+    return std::make_unique<SCAPolicy>(
+        policyId, std::move(requirements), std::move(checks), processSnapshot, std::move(commandCache));
 }
 
 // NOLINTNEXTLINE(misc-no-recursion)
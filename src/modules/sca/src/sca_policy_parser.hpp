@@ -1,5 +1,6 @@
 #pragma once
 
+#include <command_cache.hpp>
 #include <isca_policy.hpp>
 
 #include <nlohmann/json.hpp>
@@ -56,8 +57,10 @@ public:
     /// information on policies and checks for reporting usage.
     ///
     /// @param policiesAndChecks JSON object to be filled with extracted data.
+    /// @param commandCache Command results shared by the policies, or nullptr to run every command.
     /// @return A populated SCAPolicy object.
-    std::unique_ptr<ISCAPolicy> ParsePolicy(nlohmann::json& policiesAndChecks) const;
+    std::unique_ptr<ISCAPolicy> ParsePolicy(nlohmann::json& policiesAndChecks,
+                                            std::shared_ptr<CommandCache> commandCache = nullptr) const;
 
 private:
     /// @brief Recursively replaces variables in the YAML node with their values.
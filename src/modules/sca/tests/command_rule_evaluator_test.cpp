@@ -173,3 +173,56 @@ TEST_F(CommandRuleEvaluatorTest, CommandExecutionReturnsNulloptIsInvalid)
     auto evaluator = CreateEvaluator();
     EXPECT_EQ(evaluator.Evaluate(), RuleResult::Invalid);
 }
+
+TEST_F(CommandRuleEvaluatorTest, SharedCacheRunsEachCommandOncePerRound)
+{
+    m_ctx.rule = "some command";
+    m_ctx.pattern = std::string("expected output");
+
+    int runs = 0;
+    auto cache = std::make_shared<CommandCache>(1024, // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+                                                [&runs](const std::string&)
+                                                {
+                                                    ++runs;
+                                                    const Utils::ExecResult result {
+                                                        .StdOut = "expected output\n", .StdErr = "", .ExitCode = 0};
+                                                    return std::make_optional<Utils::ExecResult>(result);
+                                                });
+
+    CommandRuleEvaluator first {m_ctx, std::make_unique<MockFileSystemWrapper>(), nullptr, cache};
+    CommandRuleEvaluator second {m_ctx, std::make_unique<MockFileSystemWrapper>(), nullptr, cache};
+
+    cache->StartScan("policy_a");
+    EXPECT_EQ(first.Evaluate(), RuleResult::Found);
+    cache->StartScan("policy_b");
+    EXPECT_EQ(second.Evaluate(), RuleResult::Found);
+    EXPECT_EQ(runs, 1);
+
+    // A policy that already scanned in the round starts a new one
+    cache->StartScan("policy_a");
+    EXPECT_EQ(first.Evaluate(), RuleResult::Found);
+    EXPECT_EQ(runs, 2);
+}
+
+TEST_F(CommandRuleEvaluatorTest, CacheDoesNotKeepResultsOverItsSize)
+{
+    m_ctx.rule = "some command";
+    m_ctx.pattern = std::nullopt;
+
+    int runs = 0;
+    auto cache = std::make_shared<CommandCache>(16, // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+                                                [&runs](const std::string&)
+                                                {
+                                                    ++runs;
+                                                    const Utils::ExecResult result {
+                                                        .StdOut = "a long command output", .StdErr = "", .ExitCode = 0};
+                                                    return std::make_optional<Utils::ExecResult>(result);
+                                                });
+
+    CommandRuleEvaluator evaluator {m_ctx, std::make_unique<MockFileSystemWrapper>(), nullptr, cache};
+
+    cache->StartScan("policy_a");
+    EXPECT_EQ(evaluator.Evaluate(), RuleResult::Found);
+    EXPECT_EQ(evaluator.Evaluate(), RuleResult::Found);
+    EXPECT_EQ(runs, 2);
+}
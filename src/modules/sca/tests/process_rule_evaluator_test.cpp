@@ -84,3 +84,37 @@ TEST_F(ProcessRuleEvaluatorTest, ProcessListRetrievalFailsReturnsInvalid)
     auto evaluator = CreateEvaluator();
     EXPECT_EQ(evaluator.Evaluate(), RuleResult::Invalid);
 }
+
+TEST_F(ProcessRuleEvaluatorTest, SharedSnapshotIsReadOncePerScan)
+{
+    int reads = 0;
+    auto snapshot = std::make_shared<ProcessSnapshot>(
+        [&reads]
+        {
+            ++reads;
+            return std::unordered_set<std::string> {"init", "sshd"};
+        });
+
+    ProcessRuleEvaluator sshd({.rule = "sshd"}, nullptr, nullptr, nullptr, snapshot);
+    ProcessRuleEvaluator nginx({.rule = "nginx"}, nullptr, nullptr, nullptr, snapshot);
+    ProcessRuleEvaluator notNginx({.rule = "nginx", .isNegated = true}, nullptr, nullptr, nullptr, snapshot);
+
+    EXPECT_EQ(sshd.Evaluate(), RuleResult::Found);
+    EXPECT_EQ(nginx.Evaluate(), RuleResult::NotFound);
+    EXPECT_EQ(notNginx.Evaluate(), RuleResult::Found);
+    EXPECT_EQ(reads, 1);
+
+    // A new scan reads the processes again
+    snapshot->Reset();
+    EXPECT_EQ(sshd.Evaluate(), RuleResult::Found);
+    EXPECT_EQ(reads, 2);
+}
+
+TEST_F(ProcessRuleEvaluatorTest, SnapshotReadFailureReturnsInvalid)
+{
+    auto snapshot = std::make_shared<ProcessSnapshot>([]() -> std::unordered_set<std::string>
+                                                      { throw std::runtime_error("Failed to read /proc"); });
+
+    ProcessRuleEvaluator evaluator({.rule = "sshd"}, nullptr, nullptr, nullptr, snapshot);
+    EXPECT_EQ(evaluator.Evaluate(), RuleResult::Invalid);
+}